@@ -0,0 +1,103 @@
+/* Copyright 2024 AISys. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <assert.h>
+
+//For supported communication primitives.
+#include <pidcomm.h>
+
+#ifndef DPU_BINARY_USER
+#define DPU_BINARY_USER "./bin/dpu_user"
+#endif
+
+#ifndef DPU_BINARY_RELOCATE
+#define DPU_BINARY_RELOCATE "./bin/data_relocate"
+#endif
+
+/*
+ * Small-message AllReduce latency.
+ * 0: AllReduce while the relocation program stays resident in the DPUs
+ * 1: AllReduce right after the user program was loaded back, which forces PID-Comm to swap the relocation program in again
+ * 2: AllReduce that gives the DPUs back with the user program (default behavior), both programs are swapped from cached images
+ * 6: dpu_load() of the relocation program alone
+ */
+int main(int argc, char **argv) {
+    struct dpu_set_t dpu_set;
+    Timer timer;
+
+    uint32_t nr_dpus = (argc > 1) ? atoi(argv[1]) : 1024;
+    uint32_t nr_iter = (argc > 2) ? atoi(argv[2]) : 100;
+    char* comm = (argc > 3) ? argv[3] : "100";
+
+    uint32_t dimension = 3;
+    uint32_t axis_len[3];
+    axis_len[0] = (nr_dpus < 32) ? nr_dpus : 32;
+    axis_len[1] = nr_dpus / axis_len[0];
+    axis_len[2] = 1;
+
+    uint32_t start_offset = 0;
+    uint32_t target_offset = 0;
+    uint32_t buffer_offset = 1024*1024*32;
+
+    DPU_ASSERT(dpu_alloc_comm(nr_dpus, NULL, &dpu_set, 1));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_USER, NULL));
+    hypercube_manager* manager = init_hypercube_manager(dpu_set, dimension, axis_len);
+
+    printf("nr_dpus=%u, axis=(%u, %u, %u), comm=%s, iterations=%u\n", nr_dpus, axis_len[0], axis_len[1], axis_len[2], comm, nr_iter);
+    printf("bytes/dpu\tresident (us)\treload (us)\tpreserve (us)\tdpu_load (us)\n");
+
+    //The smallest message is 8 bytes for each DPU in the communicator
+    for(uint32_t data_size_per_dpu = 8*axis_len[0]; data_size_per_dpu <= 64*1024; data_size_per_dpu *= 2){
+        resetTimer(&timer);
+        pidcomm_set_preserve_program(manager, false);
+
+        //warm-up, which also makes the relocation program resident
+        pidcomm_all_reduce(manager, comm, data_size_per_dpu, start_offset, target_offset, buffer_offset, sizeof(int32_t), 0);
+
+        for(uint32_t iter=0; iter<nr_iter; iter++){
+            startTimer(&timer, 0);
+            pidcomm_all_reduce(manager, comm, data_size_per_dpu, start_offset, target_offset, buffer_offset, sizeof(int32_t), 0);
+            stopTimer(&timer, 0);
+            timer.time[3] += timer.time[0];
+        }
+
+        for(uint32_t iter=0; iter<nr_iter; iter++){
+            DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_USER, NULL));
+            startTimer(&timer, 1);
+            pidcomm_all_reduce(manager, comm, data_size_per_dpu, start_offset, target_offset, buffer_offset, sizeof(int32_t), 0);
+            stopTimer(&timer, 1);
+            timer.time[4] += timer.time[1];
+        }
+
+        pidcomm_set_preserve_program(manager, true);
+        DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_USER, NULL));
+        for(uint32_t iter=0; iter<nr_iter; iter++){
+            startTimer(&timer, 2);
+            pidcomm_all_reduce(manager, comm, data_size_per_dpu, start_offset, target_offset, buffer_offset, sizeof(int32_t), 0);
+            stopTimer(&timer, 2);
+            timer.time[5] += timer.time[2];
+        }
+
+        for(uint32_t iter=0; iter<nr_iter; iter++){
+            startTimer(&timer, 6);
+            DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE, NULL));
+            stopTimer(&timer, 6);
+            timer.time[7] += timer.time[6];
+        }
+        DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_USER, NULL));
+
+        printf("%u\t\t%.2f\t\t%.2f\t\t%.2f\t\t%.2f\n", data_size_per_dpu, timer.time[3]/nr_iter, timer.time[4]/nr_iter, timer.time[5]/nr_iter, timer.time[7]/nr_iter);
+    }
+
+    free(manager);
+    DPU_ASSERT(dpu_free(dpu_set));
+    return 0;
+}
@@ -0,0 +1,6 @@
+make clean
+NR_TASKLETS=16 make all
+# number of dpu / iterations per message size / communication dimensions
+./bin/host 1024 100 100
+./bin/host 1024 100 010
+./bin/host 256 100 100
@@ -0,0 +1,93 @@
+/* Copyright 2024 AISys. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <assert.h>
+
+//For supported communication primitives.
+#include <pidcomm.h>
+
+#ifndef DPU_BINARY_USER
+#define DPU_BINARY_USER "./bin/dpu_user"
+#endif
+
+#define NR_DPUS_PER_RANK 64
+
+/*
+ * Host streaming bandwidth of the reduction kernels, in GB/s per rank pair.
+ * Every DPU of the hypercube contributes data_size_per_dpu bytes, which the host reads once and writes back once.
+ * The bandwidth is the bytes read from a pair of ranks (128 DPUs) divided by the time of the collective.
+ * Run it with the driver before and after a change of the kernels to compare them.
+ */
+static double gb_per_s_per_rank_pair(uint32_t nr_dpus, uint32_t data_size_per_dpu, double time_us){
+    double nr_rank_pairs = (double)nr_dpus / (2*NR_DPUS_PER_RANK);
+    if(nr_rank_pairs < 1) nr_rank_pairs = 1;
+    return ((double)data_size_per_dpu * nr_dpus / nr_rank_pairs) / (time_us * 1000);
+}
+
+int main(int argc, char **argv) {
+    struct dpu_set_t dpu_set;
+    Timer timer;
+
+    uint32_t nr_dpus = (argc > 1) ? atoi(argv[1]) : 128;
+    uint32_t nr_iter = (argc > 2) ? atoi(argv[2]) : 20;
+    char* comm = (argc > 3) ? argv[3] : "100";
+
+    uint32_t dimension = 3;
+    uint32_t axis_len[3];
+    axis_len[0] = (nr_dpus < 32) ? nr_dpus : 32;
+    axis_len[1] = nr_dpus / axis_len[0];
+    axis_len[2] = 1;
+
+    uint32_t nr_comm_dpus = 1;
+    for(uint32_t dim = 0; dim < dimension; dim++){
+        if(comm[dim] == '1') nr_comm_dpus *= axis_len[dim];
+    }
+
+    uint32_t start_offset = 0;
+    uint32_t target_offset = 0;
+    uint32_t buffer_offset = 1024*1024*32;
+
+    DPU_ASSERT(dpu_alloc_comm(nr_dpus, NULL, &dpu_set, 1));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_USER, NULL));
+    hypercube_manager* manager = init_hypercube_manager(dpu_set, dimension, axis_len);
+    pidcomm_set_preserve_program(manager, false);
+
+    printf("nr_dpus=%u, axis=(%u, %u, %u), comm=%s, iterations=%u\n", nr_dpus, axis_len[0], axis_len[1], axis_len[2], comm, nr_iter);
+    printf("bytes/dpu\tAllReduce (GB/s/rank pair)\tReduceScatter (GB/s/rank pair)\n");
+
+    //from 64 bytes per communicating DPU up to 16MB per DPU
+    for(uint32_t data_size_per_dpu = 64*nr_comm_dpus; data_size_per_dpu <= 16*1024*1024; data_size_per_dpu *= 4){
+        resetTimer(&timer);
+
+        //warm-up, which also makes the relocation program resident
+        pidcomm_all_reduce(manager, comm, data_size_per_dpu, start_offset, target_offset, buffer_offset, sizeof(int32_t), 0);
+
+        for(uint32_t iter=0; iter<nr_iter; iter++){
+            startTimer(&timer, 0);
+            pidcomm_all_reduce(manager, comm, data_size_per_dpu, start_offset, target_offset, buffer_offset, sizeof(int32_t), 0);
+            stopTimer(&timer, 0);
+            timer.time[2] += timer.time[0];
+
+            startTimer(&timer, 1);
+            pidcomm_reduce_scatter(manager, comm, data_size_per_dpu, start_offset, target_offset, buffer_offset, sizeof(int32_t), PIDCOMM_SUM);
+            stopTimer(&timer, 1);
+            timer.time[3] += timer.time[1];
+        }
+
+        printf("%u\t\t%.2f\t\t\t\t%.2f\n", data_size_per_dpu,
+            gb_per_s_per_rank_pair(nr_dpus, data_size_per_dpu, timer.time[2]/nr_iter),
+            gb_per_s_per_rank_pair(nr_dpus, data_size_per_dpu, timer.time[3]/nr_iter));
+    }
+
+    free(manager);
+    DPU_ASSERT(dpu_free(dpu_set));
+    return 0;
+}
@@ -0,0 +1,6 @@
+make clean
+NR_TASKLETS=16 make all
+# number of dpu / iterations per size / communication dimensions
+./bin/host 128 20 100
+./bin/host 128 20 010
+./bin/host 1024 20 100
@@ -142,6 +142,9 @@ int main(int argc, char **argv) {
     printf("%s, done!\n", fileName);
 
     struct dpu_set_t dpu_set, dpu;
+    //Kernels are loaded once, then swapped back from their cached image with dpu_restore_program().
+    //A reference is kept on each of them so that loading another kernel does not free them.
+    struct dpu_program_t *gnn_kernel_1 = NULL, *gnn_kernel_2 = NULL, *data_relocate_ag = NULL;
 
     //num of dpu ranks
     uint32_t nr_of_dpus = nr_dpus;
@@ -172,13 +175,16 @@ int main(int argc, char **argv) {
 
     //Allocate DPUs and load binary
     DPU_ASSERT(dpu_alloc_comm(nr_dpus, NULL, &dpu_set, 1));
-    DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_1, NULL));
+    DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_1, &gnn_kernel_1));
+    dpu_take_program_ref(gnn_kernel_1);
     DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
     printf("[INFO] Allocated %d DPU(s)\n", nr_of_dpus);
     printf("[INFO] Allocated %d TASKLET(s) per DPU\n", NR_TASKLETS);
 
     //Set hypercube configuration
     hypercube_manager* hypercube_manager = init_hypercube_manager(dpu_set, dimension, axis_len);
+    //Every collective is followed by a kernel swap, so there is no need to restore the program the collective found
+    pidcomm_set_preserve_program(hypercube_manager, false);
 
     /*******************************************************************************/
 
@@ -486,12 +492,8 @@ int main(int argc, char **argv) {
     //total size : max num of non-zero elements * sizeof(elem_t)
     DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, max_nnz_per_dpu * sizeof(struct elem_t), DPU_XFER_DEFAULT));
 
-    //we send in another pair because the transposed data will be used on other cycles.
-    i = 0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus) {
-        DPU_ASSERT(dpu_prepare_xfer(dpu, A->nnzs + max_nnz_per_dpu * transpose_num(i, nr_of_partitions)));
-    }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, max_nnz_per_dpu * sizeof(struct elem_t), max_nnz_per_dpu * sizeof(struct elem_t), DPU_XFER_DEFAULT));
+    //the transposed data used on the other cycles is the partition of the mirrored DPU, swapped on the DPUs instead of sent again
+    pidcomm_transpose(hypercube_manager, "11", max_nnz_per_dpu, 1, sizeof(struct elem_t), 0, max_nnz_per_dpu * sizeof(struct elem_t), false);
 
     // Copy input feature to DPUs
     i = 0;
@@ -562,7 +564,8 @@ int main(int argc, char **argv) {
     }
 
     //load other binary file to dpu
-    DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_2, NULL));
+    DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_2, &gnn_kernel_2));
+    dpu_take_program_ref(gnn_kernel_2);
 
     //compute final result for correctness
     struct Matrix *y_final;
@@ -665,7 +668,8 @@ int main(int argc, char **argv) {
 
     /************************************Relocate data for faster communication*******************************************************/
 
-    DPU_ASSERT(dpu_load(dpu_set, DATA_RELOCATE_AG, NULL));
+    DPU_ASSERT(dpu_load(dpu_set, DATA_RELOCATE_AG, &data_relocate_ag));
+    dpu_take_program_ref(data_relocate_ag);
 
     for(int i=0; i<nr_dpus; i++){
         dpu_argument[i].start_offset = 16*1024*1024;
@@ -695,7 +699,7 @@ int main(int argc, char **argv) {
     //for the other cycles
     for(int cycle = 2; cycle <= cycle_num; cycle++){
 
-        DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_1, NULL));
+        DPU_ASSERT(dpu_restore_program(dpu_set, gnn_kernel_1));
 
         //send A & feature info to DPU
         startTimer(&timer, 1);
@@ -760,7 +764,7 @@ int main(int argc, char **argv) {
 
 
         //the second part
-        DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_2, NULL));
+        DPU_ASSERT(dpu_restore_program(dpu_set, gnn_kernel_2));
 
         //send arguments to DPU
         DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
@@ -837,7 +841,7 @@ int main(int argc, char **argv) {
 
     /*************************************Relocate data for faster communication*******************************************************/
 
-        DPU_ASSERT(dpu_load(dpu_set, DATA_RELOCATE_AG, NULL));
+        DPU_ASSERT(dpu_restore_program(dpu_set, data_relocate_ag));
 
         for(int i=0; i<nr_dpus; i++){
             dpu_argument[i].start_offset = 16*1024*1024;
@@ -870,7 +874,7 @@ int main(int argc, char **argv) {
         cycle++;
         if(cycle > cycle_num) goto EXIT;
 
-        DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_1, NULL));
+        DPU_ASSERT(dpu_restore_program(dpu_set, gnn_kernel_1));
 
 
         startTimer(&timer, 1);
@@ -935,7 +939,7 @@ int main(int argc, char **argv) {
         /*****************************the second part**************************************/
 
         //the second part
-        DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_2, NULL));
+        DPU_ASSERT(dpu_restore_program(dpu_set, gnn_kernel_2));
 
         //send arguments to DPU
         DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
@@ -1024,6 +1028,9 @@ EXIT :
 
     //add deallocation later
 
+    dpu_free_program(gnn_kernel_1);
+    dpu_free_program(gnn_kernel_2);
+    dpu_free_program(data_relocate_ag);
     DPU_ASSERT(dpu_free(dpu_set));
 
     printf("\ntotal exec. time = %f\n", total_time);
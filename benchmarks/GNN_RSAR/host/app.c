@@ -85,6 +85,9 @@ int main(int argc, char **argv) {
     printf("%s, done!\n", fileName);
 
     struct dpu_set_t dpu_set, dpu;
+    //Kernels are loaded once, then swapped back from their cached image with dpu_restore_program().
+    //A reference is kept on each of them so that loading another kernel does not free them.
+    struct dpu_program_t *gnn_kernel_1 = NULL, *data_relocate_comm = NULL, *gnn_kernel_2 = NULL;
 
 
     uint32_t nr_of_dpus = nr_dpus;
@@ -115,13 +118,16 @@ int main(int argc, char **argv) {
 
     //Allocate DPUs and load binary
     DPU_ASSERT(dpu_alloc_comm(nr_dpus, NULL, &dpu_set, 1));
-    DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_1, NULL));
+    DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_1, &gnn_kernel_1));
+    dpu_take_program_ref(gnn_kernel_1);
     DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_of_dpus));
     printf("[INFO] Allocated %d DPU(s)\n", nr_of_dpus);
     printf("[INFO] Allocated %d TASKLET(s) per DPU\n", NR_TASKLETS);
 
     //Set hypercube configuration
     hypercube_manager* hypercube_manager = init_hypercube_manager(dpu_set, dimension, axis_len);
+    //Every collective is followed by a kernel swap, so there is no need to restore the program the collective found
+    pidcomm_set_preserve_program(hypercube_manager, false);
 
     /*******************************************************************************/
 
@@ -452,12 +458,8 @@ int main(int argc, char **argv) {
     //total size : max num of non-zero elements * sizeof(elem_t)
     DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, max_nnz_per_dpu * sizeof(struct elem_t), DPU_XFER_DEFAULT));
 
-    //we send in another pair because the transposed data will be used on other cycles. 
-    i = 0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus) {
-        DPU_ASSERT(dpu_prepare_xfer(dpu, A->nnzs + max_nnz_per_dpu * transpose_num(i, nr_of_partitions)));
-    }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, max_nnz_per_dpu * sizeof(struct elem_t), max_nnz_per_dpu * sizeof(struct elem_t), DPU_XFER_DEFAULT));
+    //the transposed data used on the other cycles is the partition of the mirrored DPU, swapped on the DPUs instead of sent again
+    pidcomm_transpose(hypercube_manager, "11", max_nnz_per_dpu, 1, sizeof(struct elem_t), 0, max_nnz_per_dpu * sizeof(struct elem_t), false);
 
     // Copy input feature to DPUs
     i = 0;
@@ -476,7 +478,8 @@ int main(int argc, char **argv) {
 
 /*****************************Relocate data for faster communication************************************/
 
-    DPU_ASSERT(dpu_load(dpu_set, DATA_RELOCATE_COMM, NULL));
+    DPU_ASSERT(dpu_load(dpu_set, DATA_RELOCATE_COMM, &data_relocate_comm));
+    dpu_take_program_ref(data_relocate_comm);
 
     target_offset = 63*512*1024;
 
@@ -535,7 +538,7 @@ int main(int argc, char **argv) {
 
 
         startTimer(&timer, 4);
-        pidcomm_reduce_scatter(hypercube_manager, "100", total_data_size, start_offset, target_offset, buffer_offset, sizeof(T));
+        pidcomm_reduce_scatter(hypercube_manager, "100", total_data_size, start_offset, target_offset, buffer_offset, sizeof(T), PIDCOMM_SUM);
         stopTimer(&timer, 4);
     }
 
@@ -561,7 +564,8 @@ int main(int argc, char **argv) {
 
 
     //load other binary file to dpu
-    DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_2, NULL));
+    DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_2, &gnn_kernel_2));
+    dpu_take_program_ref(gnn_kernel_2);
 
 
     //Allocate new_feat and sub_result matrices for each DPU
@@ -667,7 +671,7 @@ int main(int argc, char **argv) {
     //continue for the remaining cycles
     for(int cycle = 2; cycle <= cycle_num; cycle++){
 
-        DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_1, NULL));
+        DPU_ASSERT(dpu_restore_program(dpu_set, gnn_kernel_1));
 
         //send A & feature info to DPU
         i = 0;
@@ -703,7 +707,7 @@ int main(int argc, char **argv) {
 
 /*****************************Relocate data for faster communication************************************/
 
-        DPU_ASSERT(dpu_load(dpu_set, DATA_RELOCATE_COMM, NULL));
+        DPU_ASSERT(dpu_restore_program(dpu_set, data_relocate_comm));
 
         target_offset = 63*512*1024;
 
@@ -753,7 +757,7 @@ int main(int argc, char **argv) {
             total_data_size = feature->ncols * max_rows_per_dpu_A * sizeof(T);
 
             startTimer(&timer, 5);
-            pidcomm_reduce_scatter(hypercube_manager, "010", total_data_size, start_offset, target_offset, buffer_offset, sizeof(T));
+            pidcomm_reduce_scatter(hypercube_manager, "010", total_data_size, start_offset, target_offset, buffer_offset, sizeof(T), PIDCOMM_SUM);
             stopTimer(&timer, 5);
         }
 
@@ -763,7 +767,7 @@ int main(int argc, char **argv) {
 
         //the second part
 
-        DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_2, NULL));
+        DPU_ASSERT(dpu_restore_program(dpu_set, gnn_kernel_2));
 
         //send arguments to dpu
         i = 0;
@@ -847,7 +851,7 @@ int main(int argc, char **argv) {
         cycle++;
         if(cycle > cycle_num) goto EXIT;
 
-        DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_1, NULL));
+        DPU_ASSERT(dpu_restore_program(dpu_set, gnn_kernel_1));
 
         i = 0;
         DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
@@ -883,7 +887,7 @@ int main(int argc, char **argv) {
 
 /*****************************Relocate data for faster communication************************************/
 
-        DPU_ASSERT(dpu_load(dpu_set, DATA_RELOCATE_COMM, NULL));
+        DPU_ASSERT(dpu_restore_program(dpu_set, data_relocate_comm));
 
         target_offset = 63*512*1024;
 
@@ -934,7 +938,7 @@ int main(int argc, char **argv) {
             total_data_size = feature->ncols * max_rows_per_dpu_A * sizeof(T);
 
             startTimer(&timer, 5);
-            pidcomm_reduce_scatter(hypercube_manager, "100", total_data_size, start_offset, target_offset, buffer_offset, sizeof(T));
+            pidcomm_reduce_scatter(hypercube_manager, "100", total_data_size, start_offset, target_offset, buffer_offset, sizeof(T), PIDCOMM_SUM);
             stopTimer(&timer, 5);
         }
 
@@ -946,7 +950,7 @@ int main(int argc, char **argv) {
 
         //the second part
 
-        DPU_ASSERT(dpu_load(dpu_set, GNN_KERNEL_2, NULL));
+        DPU_ASSERT(dpu_restore_program(dpu_set, gnn_kernel_2));
 
         //send arguments to dpu
         i = 0;
@@ -1017,7 +1021,7 @@ int main(int argc, char **argv) {
 
             startTimer(&timer, 9);
 
-            pidcomm_reduce_scatter(hypercube_manager, "100", total_data_size, start_offset, target_offset, buffer_offset, sizeof(T));
+            pidcomm_reduce_scatter(hypercube_manager, "100", total_data_size, start_offset, target_offset, buffer_offset, sizeof(T), PIDCOMM_SUM);
             
             //for checking
             DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus) {
@@ -1040,6 +1044,9 @@ EXIT :
 
     //add deallocation later
 
+    dpu_free_program(gnn_kernel_1);
+    dpu_free_program(data_relocate_comm);
+    dpu_free_program(gnn_kernel_2);
     DPU_ASSERT(dpu_free(dpu_set));
 
     return 0;
@@ -0,0 +1,113 @@
+/* Copyright 2024 AISys. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <assert.h>
+
+//For supported communication primitives.
+#include <pidcomm.h>
+
+#ifndef DPU_BINARY_USER
+#define DPU_BINARY_USER "./bin/dpu_user"
+#endif
+
+#define NR_SCHEDULES 2
+#define MAX_NR_SHAPES 64
+
+/*
+ * AllReduce and AlltoAll time of the host collective engines, for every hypercube shape of nr_dpus DPUs.
+ * static: one task per thread, the iterations are split evenly among the threads
+ * stealing: several tasks per thread, idle threads steal tasks on the same channel first
+ */
+static const char* schedule_name[NR_SCHEDULES] = {"static", "stealing"};
+static const char* schedule_profile[NR_SCHEDULES] = {"commWorkStealing=false", "commWorkStealing=true"};
+
+int main(int argc, char **argv) {
+    struct dpu_set_t dpu_set;
+    Timer timer;
+
+    uint32_t nr_dpus = (argc > 1) ? atoi(argv[1]) : 256;
+    uint32_t nr_iter = (argc > 2) ? atoi(argv[2]) : 20;
+    char* comm = (argc > 3) ? argv[3] : "100";
+    uint32_t bytes_per_comm_dpu = (argc > 4) ? atoi(argv[4]) : 1024;
+
+    uint32_t dimension = 3;
+    uint32_t axis_len[3];
+    uint32_t shapes[MAX_NR_SHAPES][3];
+    uint32_t nr_shapes = 0;
+
+    uint32_t start_offset = 0;
+    uint32_t target_offset = 0;
+    uint32_t buffer_offset = 1024*1024*32;
+
+    double all_reduce_time[NR_SCHEDULES][MAX_NR_SHAPES];
+    double alltoall_time[NR_SCHEDULES][MAX_NR_SHAPES];
+
+    //x and y take every power of two from 2 to 64, z takes the remaining DPUs
+    for(uint32_t x = 2; x <= 64; x *= 2){
+        for(uint32_t y = 2; y <= 64; y *= 2){
+            if(nr_dpus % (x*y) != 0 || nr_shapes == MAX_NR_SHAPES) continue;
+            shapes[nr_shapes][0] = x;
+            shapes[nr_shapes][1] = y;
+            shapes[nr_shapes][2] = nr_dpus / (x*y);
+            nr_shapes++;
+        }
+    }
+
+    for(uint32_t schedule = 0; schedule < NR_SCHEDULES; schedule++){
+        //the schedule of the collective engines is a property of the allocation
+        DPU_ASSERT(dpu_alloc_comm(nr_dpus, schedule_profile[schedule], &dpu_set, 1));
+        DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_USER, NULL));
+        hypercube_manager* manager = init_hypercube_manager(dpu_set, dimension, axis_len);
+        pidcomm_set_preserve_program(manager, false);
+
+        for(uint32_t shape = 0; shape < nr_shapes; shape++){
+            uint32_t nr_comm_dpus = 1;
+            for(uint32_t dim = 0; dim < dimension; dim++){
+                axis_len[dim] = shapes[shape][dim];
+                if(comm[dim] == '1') nr_comm_dpus *= axis_len[dim];
+            }
+            uint32_t data_size_per_dpu = bytes_per_comm_dpu * nr_comm_dpus;
+
+            resetTimer(&timer);
+
+            //warm-up, which also starts the thread pool
+            pidcomm_all_reduce(manager, comm, data_size_per_dpu, start_offset, target_offset, buffer_offset, sizeof(int32_t), 0);
+
+            for(uint32_t iter=0; iter<nr_iter; iter++){
+                startTimer(&timer, 0);
+                pidcomm_all_reduce(manager, comm, data_size_per_dpu, start_offset, target_offset, buffer_offset, sizeof(int32_t), 0);
+                stopTimer(&timer, 0);
+                timer.time[2] += timer.time[0];
+
+                startTimer(&timer, 1);
+                pidcomm_alltoall(manager, comm, data_size_per_dpu, start_offset, target_offset, buffer_offset);
+                stopTimer(&timer, 1);
+                timer.time[3] += timer.time[1];
+            }
+
+            all_reduce_time[schedule][shape] = timer.time[2]/nr_iter;
+            alltoall_time[schedule][shape] = timer.time[3]/nr_iter;
+        }
+
+        free(manager);
+        DPU_ASSERT(dpu_free(dpu_set));
+    }
+
+    printf("nr_dpus=%u, comm=%s, bytes/communicating dpu=%u, iterations=%u\n", nr_dpus, comm, bytes_per_comm_dpu, nr_iter);
+    printf("shape\t\tAllReduce %s (us)\tAllReduce %s (us)\tAlltoAll %s (us)\tAlltoAll %s (us)\n",
+        schedule_name[0], schedule_name[1], schedule_name[0], schedule_name[1]);
+    for(uint32_t shape = 0; shape < nr_shapes; shape++){
+        printf("%ux%ux%u\t\t%.2f\t\t\t%.2f\t\t\t%.2f\t\t\t%.2f\n", shapes[shape][0], shapes[shape][1], shapes[shape][2],
+            all_reduce_time[0][shape], all_reduce_time[1][shape], alltoall_time[0][shape], alltoall_time[1][shape]);
+    }
+
+    return 0;
+}
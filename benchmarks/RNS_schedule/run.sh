@@ -0,0 +1,6 @@
+make clean
+NR_TASKLETS=16 make all
+# number of dpu / iterations per shape / communication dimensions / bytes per communicating DPU
+./bin/host 256 20 100 1024
+./bin/host 256 20 010 1024
+./bin/host 1024 20 100 1024
@@ -0,0 +1,212 @@
+/* Copyright 2024 AISys. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dpu.h>
+#include <dpu_log.h>
+#include <unistd.h>
+#include <assert.h>
+
+//For supported communication primitives.
+#include <pidcomm.h>
+
+#ifndef DPU_BINARY_USER
+#define DPU_BINARY_USER "./bin/dpu_user"
+#endif
+
+typedef int32_t T;
+
+/*
+ * AllGatherv and ReduceScatterv on uneven row partitions, checked against host references
+ * (allgather and reducescatter_x/_y of the GNN benchmarks' support/merge.h), and timed against
+ * the padded AllGather and ReduceScatter that move max_rows_per_dpu rows for every DPU.
+ */
+
+//DPU holding the given rank in the communicator of dpu, the first communicating axis varying fastest
+static uint32_t comm_member(uint32_t* axis_len, char* comm, uint32_t dpu, uint32_t rank){
+    uint32_t stride = 1;
+    uint32_t member = 0;
+
+    for(uint32_t dim = 0; dim < 3; dim++){
+        uint32_t coord = dpu % axis_len[dim];
+        if(comm[dim] == '1'){
+            coord = rank % axis_len[dim];
+            rank /= axis_len[dim];
+        }
+        member += coord * stride;
+        stride *= axis_len[dim];
+        dpu /= axis_len[dim];
+    }
+    return member;
+}
+
+static void copy_packed(struct dpu_set_t dpu_set, dpu_xfer_t xfer, T* buffer, uint32_t offset, uint32_t length){
+    struct dpu_set_t dpu;
+    uint32_t i;
+
+    DPU_FOREACH(dpu_set, dpu, i){
+        DPU_ASSERT(dpu_prepare_xfer(dpu, (uint8_t*)buffer + (size_t)i * length));
+    }
+    DPU_ASSERT(dpu_push_xfer(dpu_set, xfer, DPU_MRAM_HEAP_POINTER_NAME, offset, length, DPU_XFER_DEFAULT));
+}
+
+//The MRAM past the real receive size of each DPU must keep the sentinel written before the collective
+#define SENTINEL 0x5a
+
+static uint32_t count_overwritten(uint8_t* result, uint32_t recv_size, uint32_t area_size){
+    uint32_t overwritten = 0;
+
+    for(uint32_t byte = recv_size; byte < area_size; byte++){
+        if(result[byte] != SENTINEL) overwritten++;
+    }
+    return overwritten;
+}
+
+int main(int argc, char **argv) {
+    struct dpu_set_t dpu_set;
+    Timer timer;
+
+    uint32_t nr_dpus = (argc > 1) ? atoi(argv[1]) : 256;
+    uint32_t nr_iter = (argc > 2) ? atoi(argv[2]) : 20;
+    char* comm = (argc > 3) ? argv[3] : "100";
+    uint32_t ncols = (argc > 4) ? atoi(argv[4]) : 16;
+
+    uint32_t dimension = 3;
+    uint32_t axis_len[3];
+    axis_len[0] = (nr_dpus < 32) ? nr_dpus : 32;
+    axis_len[1] = nr_dpus / axis_len[0];
+    axis_len[2] = 1;
+
+    uint32_t start_offset = 0;
+    uint32_t target_offset = 1024*1024*16;
+    uint32_t buffer_offset = 1024*1024*32;
+
+    uint32_t num_comm_dpu = 1;
+    for(uint32_t dim = 0; dim < dimension; dim++){
+        if(comm[dim] == '1') num_comm_dpu *= axis_len[dim];
+    }
+
+    //uneven row split, as produced by feat_partition_by_row, with rows of an even number of columns to keep 8-byte chunks
+    ncols += ncols % 2;
+    uint32_t* rows = malloc(sizeof(uint32_t) * nr_dpus);
+    uint32_t* counts = malloc(sizeof(uint32_t) * nr_dpus);
+    uint32_t max_rows_per_dpu = 0;
+    for(uint32_t dpu = 0; dpu < nr_dpus; dpu++){
+        rows[dpu] = 4 + (dpu * 7) % 13;
+        counts[dpu] = rows[dpu] * ncols * sizeof(T);
+        if(rows[dpu] > max_rows_per_dpu) max_rows_per_dpu = rows[dpu];
+    }
+    uint32_t max_chunk = max_rows_per_dpu * ncols * sizeof(T);
+    uint32_t max_total = max_chunk * num_comm_dpu;
+
+    T* dpu_data = malloc((size_t)nr_dpus * max_total);
+    T* dpu_result = malloc((size_t)nr_dpus * max_total);
+    uint32_t errors = 0;
+
+    DPU_ASSERT(dpu_alloc_comm(nr_dpus, NULL, &dpu_set, 1));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_USER, NULL));
+    hypercube_manager* manager = init_hypercube_manager(dpu_set, dimension, axis_len);
+
+    //AllGatherv: every DPU receives the rows of its communicator in rank order
+    for(uint32_t dpu = 0; dpu < nr_dpus; dpu++){
+        T* chunk = (T*)((uint8_t*)dpu_data + (size_t)dpu * max_total);
+        for(uint32_t elem = 0; elem < counts[dpu] / sizeof(T); elem++){
+            chunk[elem] = dpu * 1000 + elem;
+        }
+    }
+    copy_packed(dpu_set, DPU_XFER_TO_DPU, dpu_data, start_offset, max_total);
+    memset(dpu_result, SENTINEL, (size_t)nr_dpus * max_total);
+    copy_packed(dpu_set, DPU_XFER_TO_DPU, dpu_result, target_offset, max_total);
+    pidcomm_allgatherv(manager, comm, counts, start_offset, target_offset);
+    copy_packed(dpu_set, DPU_XFER_FROM_DPU, dpu_result, target_offset, max_total);
+
+    uint32_t overwritten = 0;
+    for(uint32_t dpu = 0; dpu < nr_dpus; dpu++){
+        T* result = (T*)((uint8_t*)dpu_result + (size_t)dpu * max_total);
+        uint32_t pos = 0;
+        for(uint32_t rank = 0; rank < num_comm_dpu; rank++){
+            uint32_t src = comm_member(axis_len, comm, dpu, rank);
+            for(uint32_t elem = 0; elem < counts[src] / sizeof(T); elem++, pos++){
+                if(result[pos] != (T)(src * 1000 + elem)) errors++;
+            }
+        }
+        overwritten += count_overwritten((uint8_t*)result, pos * sizeof(T), max_total);
+    }
+    printf("AllGatherv: %s, bytes past the receive sizes overwritten: %u\n", (errors || overwritten) ? "FAIL" : "OK", overwritten);
+
+    //ReduceScatterv: every DPU holds a partial chunk for each member and receives the sum of its own chunk
+    for(uint32_t dpu = 0; dpu < nr_dpus; dpu++){
+        T* partial = (T*)((uint8_t*)dpu_data + (size_t)dpu * max_total);
+        uint32_t pos = 0;
+        for(uint32_t rank = 0; rank < num_comm_dpu; rank++){
+            uint32_t dst = comm_member(axis_len, comm, dpu, rank);
+            for(uint32_t elem = 0; elem < counts[dst] / sizeof(T); elem++, pos++){
+                partial[pos] = dpu + elem * 3;
+            }
+        }
+    }
+    copy_packed(dpu_set, DPU_XFER_TO_DPU, dpu_data, start_offset, max_total);
+    memset(dpu_result, SENTINEL, (size_t)nr_dpus * max_chunk);
+    copy_packed(dpu_set, DPU_XFER_TO_DPU, dpu_result, target_offset, max_chunk);
+    pidcomm_reduce_scatterv(manager, comm, counts, start_offset, target_offset, PIDCOMM_INT32, PIDCOMM_SUM);
+    copy_packed(dpu_set, DPU_XFER_FROM_DPU, dpu_result, target_offset, max_chunk);
+
+    errors = 0;
+    overwritten = 0;
+    for(uint32_t dpu = 0; dpu < nr_dpus; dpu++){
+        T* result = (T*)((uint8_t*)dpu_result + (size_t)dpu * max_chunk);
+        uint32_t first = comm_member(axis_len, comm, dpu, 0);
+        for(uint32_t elem = 0; elem < counts[dpu] / sizeof(T); elem++){
+            T sum = 0;
+            for(uint32_t rank = 0; rank < num_comm_dpu; rank++){
+                sum += comm_member(axis_len, comm, first, rank) + elem * 3;
+            }
+            if(result[elem] != sum) errors++;
+        }
+        overwritten += count_overwritten((uint8_t*)result, counts[dpu], max_chunk);
+    }
+    printf("ReduceScatterv: %s, bytes past the receive sizes overwritten: %u\n", (errors || overwritten) ? "FAIL" : "OK", overwritten);
+
+    //time against the padded collectives
+    resetTimer(&timer);
+    pidcomm_set_preserve_program(manager, false);
+    for(uint32_t iter = 0; iter < nr_iter; iter++){
+        startTimer(&timer, 0);
+        pidcomm_allgather(manager, comm, max_total, start_offset, target_offset, buffer_offset);
+        stopTimer(&timer, 0);
+        timer.time[4] += timer.time[0];
+
+        startTimer(&timer, 1);
+        pidcomm_allgatherv(manager, comm, counts, start_offset, target_offset);
+        stopTimer(&timer, 1);
+        timer.time[5] += timer.time[1];
+
+        startTimer(&timer, 2);
+        pidcomm_reduce_scatter(manager, comm, max_total, start_offset, target_offset, buffer_offset, PIDCOMM_INT32, PIDCOMM_SUM);
+        stopTimer(&timer, 2);
+        timer.time[6] += timer.time[2];
+
+        startTimer(&timer, 3);
+        pidcomm_reduce_scatterv(manager, comm, counts, start_offset, target_offset, PIDCOMM_INT32, PIDCOMM_SUM);
+        stopTimer(&timer, 3);
+        timer.time[7] += timer.time[3];
+    }
+
+    printf("nr_dpus=%u, axis=(%u, %u, %u), comm=%s, ncols=%u, max_rows_per_dpu=%u, iterations=%u\n",
+        nr_dpus, axis_len[0], axis_len[1], axis_len[2], comm, ncols, max_rows_per_dpu, nr_iter);
+    printf("AllGather padded (us)\tAllGatherv (us)\tReduceScatter padded (us)\tReduceScatterv (us)\n");
+    printf("%.2f\t\t\t%.2f\t\t%.2f\t\t\t\t%.2f\n", timer.time[4]/nr_iter, timer.time[5]/nr_iter, timer.time[6]/nr_iter, timer.time[7]/nr_iter);
+
+    free(rows);
+    free(counts);
+    free(dpu_data);
+    free(dpu_result);
+    free(manager);
+    DPU_ASSERT(dpu_free(dpu_set));
+
+    return 0;
+}
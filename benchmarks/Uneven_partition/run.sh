@@ -0,0 +1,6 @@
+make clean
+NR_TASKLETS=16 make all
+# number of dpu / iterations / communication dimensions / feature columns
+./bin/host 256 20 100 16
+./bin/host 256 20 010 16
+./bin/host 1024 20 100 64
@@ -0,0 +1,1682 @@
+/* Copyright 2024 AISys. All rights reserved.
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <defs.h>
+#include <mram.h>
+#include <alloc.h>
+#include <perfcounter.h>
+#include <barrier.h>
+#include <seqread.h>
+
+#include "../support/common.h"
+
+#define COMM_UNIT_SIZE 8
+
+__host dpu_arguments_comm_t DPU_INPUT_ARGUMENTS_RS1;
+
+//initialize tasklets. each are barriers for 8, 4, and 2 tasklets. 
+BARRIER_INIT(tasklet_8_barrier, NR_TASKLETS/2);
+BARRIER_INIT(tasklet_4_barrier, NR_TASKLETS/4);
+BARRIER_INIT(tasklet_2_barrier, NR_TASKLETS/8);
+
+uint32_t max_words_per_dpu;
+//nonzero blocks found by each tasklet, for the sparse compaction
+uint32_t sparse_count[8];
+
+/*
+ * In this function we aim to reorder the target data we are using for
+ * communication. The data will be ordered in the following order
+ * DPU 0's Word#1, DPU 1's Word#1, ... DPU 7's Word#1, DPU 0's word#2 ...  for DPU 0,
+ * DPU 1's word#1, DPU 2's Word#1, ... DPU 0's Word#1, DPU 1's Word#1, ... for DPU 1 
+ * and so on. Missing words will be filled with a 0 for alignment.
+ */
+static void relocate_clockwise(uint32_t tasklet_id){
+
+    //set arguments for use
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t total_data_size = DPU_INPUT_ARGUMENTS_RS1.total_data_size;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t dpu_num = DPU_INPUT_ARGUMENTS_RS1.each_dpu;
+    uint32_t no_rotate = DPU_INPUT_ARGUMENTS_RS1.no_rotate;
+    uint32_t comm_type = DPU_INPUT_ARGUMENTS_RS1.comm_type; //whether it contains the x axis
+    uint32_t a_length = DPU_INPUT_ARGUMENTS_RS1.a_length; //length of the x-axis
+
+    uint32_t original_addr; // address for word to move
+    uint32_t target_addr; //target address for word to move 
+
+
+    if(num_comm_dpu % 8 == 0){
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        barrier_wait(&tasklet_8_barrier);
+    
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + 8){
+            for(int iteration =0; iteration < iter; iteration++){
+
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                barrier_wait(&tasklet_8_barrier);
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = (target_dpu_num - dpu_num) % 8;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/8) * 8 * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+                barrier_wait(&tasklet_8_barrier);
+            }
+        }
+    }
+
+    //cases where the length of x-axis is smaller than 8
+    else if(num_comm_dpu == 4 || num_comm_dpu == 2){
+
+        if(tasklet_id >= num_comm_dpu) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+        else barrier_wait(&tasklet_2_barrier);
+    
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + num_comm_dpu){
+            for(int iteration =0; iteration < iter; iteration++){
+
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+
+                if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+                else barrier_wait(&tasklet_2_barrier);
+
+                //do not rotate word if no_rotate is on
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                //set target offset and offset
+                else{
+                    offset = (target_dpu_num - dpu_num) % num_comm_dpu;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/num_comm_dpu) * num_comm_dpu * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+                
+
+                if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+                else barrier_wait(&tasklet_2_barrier);
+            }
+        }
+    }
+}
+
+/*
+ * In this function we aim to reorder the target data we are using for
+ * communication. The data will be ordered in the following order
+ * DPU 7's Word#1, DPU 6's Word#1, ... DPU 0's Word#1, DPU 0's word#2 ...  for DPU 0,
+ * DPU 0's word#1, DPU 7's Word#1, ... DPU 1's Word#1, DPU 7's Word#2, ... for DPU 1 
+ * and so on. Missing words will be filled with a 0 for alignment.
+ */
+static void relocate_reverse_clockwise(uint32_t tasklet_id){
+
+    //set arguments for use
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t total_data_size = DPU_INPUT_ARGUMENTS_RS1.total_data_size;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t dpu_num = DPU_INPUT_ARGUMENTS_RS1.each_dpu;
+    uint32_t no_rotate = DPU_INPUT_ARGUMENTS_RS1.no_rotate;
+    uint32_t comm_type = DPU_INPUT_ARGUMENTS_RS1.comm_type; //whether it contains the x axis
+    uint32_t a_length = DPU_INPUT_ARGUMENTS_RS1.a_length; //length of the x-axis
+    uint32_t num_comm_rg = DPU_INPUT_ARGUMENTS_RS1.num_comm_rg; // number of PEs participating in communication in each entangled group 
+
+
+    uint32_t original_addr; // address for word to move
+    uint32_t target_addr; //target address for word to move
+
+
+    if((num_comm_dpu %8 == 0) && (num_comm_rg == 8)){
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        barrier_wait(&tasklet_8_barrier);
+    
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + 8){
+            for(int iteration =0; iteration < iter; iteration++){
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+                //else just read all 2k bytes
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                barrier_wait(&tasklet_8_barrier);
+
+                //do not rotate word if no_rotate is on
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                //set target offset and offset
+                else{
+                    offset = (dpu_num - target_dpu_num) % 8;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/8) * 8 * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+               barrier_wait(&tasklet_8_barrier);
+            }
+        }
+    }
+
+    //cases where the length of x-axis is smaller than 8
+    else if(num_comm_rg < 8 && !comm_type){
+        if(tasklet_id >= num_comm_rg) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + num_comm_rg){
+            for(int iteration =0; iteration < iter; iteration++){
+
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = ((dpu_num) - target_dpu_num) % (num_comm_rg);
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/num_comm_rg) * num_comm_rg * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+            }
+        }
+    }
+
+    else if(num_comm_rg < 8 && comm_type){
+        if(tasklet_id >= (8/num_comm_rg)) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + (8/num_comm_rg)){
+            for(int iteration =0; iteration < iter; iteration++){
+
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = ((dpu_num/(8/num_comm_rg)) - target_dpu_num) % (num_comm_rg);
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/(num_comm_rg)) * (num_comm_rg) * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+            }
+        }
+    }
+    
+    else if(num_comm_dpu == 4 || num_comm_dpu == 2){
+
+        if(tasklet_id >= num_comm_dpu) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+        else barrier_wait(&tasklet_2_barrier);
+    
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + num_comm_dpu){
+            for(int iteration =0; iteration < iter; iteration++){
+
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+
+                if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+                else barrier_wait(&tasklet_2_barrier);
+
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = (dpu_num - target_dpu_num) % num_comm_dpu;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/num_comm_dpu) * num_comm_dpu * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+
+                if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+                else barrier_wait(&tasklet_2_barrier);
+            }
+        }
+    }
+}
+
+/*
+ * In this function we aim to reorder the target data we are using for
+ * communication. The data will be ordered in the following order
+ * DPU 0's Word#1, DPU 1's Word#1, ... DPU 7's Word#1, DPU 0's word#2 ...  for DPU 0,
+ * DPU 7's word#1, DPU 0's Word#1, ... DPU 1's Word#1, DPU 7's Word#1, ... for DPU 1 
+ * and so on. Missing words will be filled with a 0 for alignment.
+ */
+static void relocate_counterclockwise(uint32_t tasklet_id){
+
+    //set arguments for use
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t total_data_size = DPU_INPUT_ARGUMENTS_RS1.total_data_size;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t dpu_num = DPU_INPUT_ARGUMENTS_RS1.each_dpu;
+    uint32_t no_rotate = DPU_INPUT_ARGUMENTS_RS1.no_rotate;
+
+    uint32_t original_addr; // address for word to move
+    uint32_t target_addr; //address for word to 
+
+
+    if(num_comm_dpu%8 == 0){
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        barrier_wait(&tasklet_8_barrier);
+
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        uint32_t chunk_num, offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + 8){
+            for(int iteration =0; iteration < iter; iteration++){
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset +  max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                barrier_wait(&tasklet_8_barrier);
+
+                //do not rotate if no_rotate is on
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                //set offset and target address to rotate data order
+                else{
+                    offset = (target_dpu_num + dpu_num) % 8;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/8) * 8 * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+                barrier_wait(&tasklet_8_barrier);
+            }
+        }
+    }
+
+    //cases where the length of x-axis is smaller than 8
+    else if(num_comm_dpu == 4 || num_comm_dpu == 2){
+
+        if(tasklet_id >= num_comm_dpu) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+        else barrier_wait(&tasklet_2_barrier);
+    
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        uint32_t chunk_num, offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + num_comm_dpu){
+            for(int iteration =0; iteration < iter; iteration++){
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+                else barrier_wait(&tasklet_2_barrier);
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = (target_dpu_num + dpu_num) % num_comm_dpu;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/num_comm_dpu) * num_comm_dpu * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+                if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+                else barrier_wait(&tasklet_2_barrier);
+            }
+        }
+    }
+}
+
+/*
+ * In this function we aim to reorder the target data we are using for
+ * communication. The data will be ordered to correctly order after
+ * AllReduce y axis communication
+ */
+static void relocate_incremental_counterclockwise(uint32_t tasklet_id){
+
+    //set arguments for use
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t total_data_size = DPU_INPUT_ARGUMENTS_RS1.total_data_size;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t dpu_num = DPU_INPUT_ARGUMENTS_RS1.each_dpu;
+    uint32_t no_rotate = DPU_INPUT_ARGUMENTS_RS1.no_rotate;
+
+    uint32_t original_addr; // address for word to move
+    uint32_t target_addr; //target address for word to move 
+
+    max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+    barrier_wait(&tasklet_8_barrier);
+
+    //cache is used to move one word at a time to the right place
+    T* word_cache = (T*) mem_alloc(2048);
+
+    //num of words each tasklet should move
+    uint32_t iter;
+    if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+    else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+    uint32_t row_index, col_index, leftover_num;
+    uint32_t chunk_num, offset;
+
+    //for each target dpu data block, relocate them all somewhere else
+    if(num_comm_dpu %8 == 0){
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + 8){
+            for(int iteration =0; iteration < iter; iteration++){
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (/* words_per_dpu[target_dpu_num] */max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                barrier_wait(&tasklet_8_barrier);
+
+                //do not rotate word if no_rotate is on
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                //set target offset and offset
+                else{
+                    offset = (target_dpu_num + dpu_num - dpu_num%8) % 8;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/8) * 8 * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+                barrier_wait(&tasklet_8_barrier);
+            }
+        }
+    }
+
+    //cases where the length of x-axis is smaller than 8
+    else if(num_comm_dpu == 4 || num_comm_dpu == 2){
+
+        if(tasklet_id >= num_comm_dpu) return;
+
+        if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+        else barrier_wait(&tasklet_2_barrier);
+
+        int target_dpu_num = tasklet_id;
+        for(int iteration =0; iteration < iter; iteration++){
+
+            //address to read the word from
+            original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+            //if there are zero_padded words
+            if(iteration == iter - 1){
+                leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                    word_cache[i] = 0;
+                }
+                leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+            }
+
+            else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+            if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+            else barrier_wait(&tasklet_2_barrier);
+
+            if(tasklet_id < num_comm_dpu){
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = (target_dpu_num + dpu_num - dpu_num % num_comm_dpu) % num_comm_dpu;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/num_comm_dpu) * num_comm_dpu * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+            }
+
+            if(num_comm_dpu == 4) barrier_wait(&tasklet_4_barrier);
+            else barrier_wait(&tasklet_2_barrier);
+        }
+    }
+}
+
+/*
+ * In this function we aim to reorder the target data we are using for
+ * communication. The data will be ordered to correctly order for
+ * AlltoAll communication when x-axis length is 2 & y-axis length is 2.
+ * Rotation scheme is different as x-axis length is 2.
+ * Rotating scheme is decided on if x-axis is included in communication,
+ * and if number of PEs participating in communication in each entangled group 
+ * is smaller than 8 or not
+ */
+static void relocate_modified_clockwise(uint32_t tasklet_id){
+
+    //set arguments for use
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t total_data_size = DPU_INPUT_ARGUMENTS_RS1.total_data_size;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t dpu_num = DPU_INPUT_ARGUMENTS_RS1.each_dpu;
+    uint32_t no_rotate = DPU_INPUT_ARGUMENTS_RS1.no_rotate;
+    uint32_t comm_type = DPU_INPUT_ARGUMENTS_RS1.comm_type; //whether it contains the x axis
+    uint32_t a_length = DPU_INPUT_ARGUMENTS_RS1.a_length; //length of the x-axis
+    uint32_t num_comm_rg = DPU_INPUT_ARGUMENTS_RS1.num_comm_rg; // number of PEs participating in communication in each entangled group 
+
+    //number of words tied together for communication
+    uint32_t num_words_per_comm = COMM_UNIT_SIZE/sizeof(T);
+
+    uint32_t original_addr; // address for word to move
+    uint32_t target_addr; //address for word to 
+
+
+    if(num_comm_rg < 8 && !comm_type){
+        if(tasklet_id >= 4) return;
+        
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + 4){
+            for(int iteration =0; iteration < iter; iteration++){
+
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                barrier_wait(&tasklet_4_barrier);
+
+                //do not rotate word if no_rotate is on
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                //set target offset and offset
+                else{
+                    offset = ((dpu_num) - target_dpu_num) % 2;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + (target_dpu_num/2) * 2 * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+                barrier_wait(&tasklet_4_barrier);
+            }
+        }
+
+        num_comm_dpu = num_comm_dpu/2;
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        //num of words each tasklet should move
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        if(tasklet_id >= 2) return;
+
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + 2){
+            for(int iteration =0; iteration < iter; iteration++){
+
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = ((dpu_num/4) - target_dpu_num) % 2;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/2) * 2 * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+            }
+        }
+    }
+
+    else if(num_comm_rg < 8 && comm_type){
+        
+        if(tasklet_id >= 2) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + 2){
+            for(int iteration =0; iteration < iter; iteration++){
+
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                //do not rotate word if no_rotate is on
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                //set target offset and offset
+                else{
+                    offset = ((dpu_num/2) - target_dpu_num) % 2;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/2) * 2 * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+            }
+        }
+    }
+}
+
+/*
+ * In this function we aim to reorder the target data we are using for
+ * communication. The data will be ordered to correctly order for
+ * AlltoAll communication when x-axis length is 2 & y-axis length is 4.
+ * Rotation scheme is different as x-axis length is 2.
+ * Rotating scheme is decided on if x-axis is included in communication,
+ * and if number of PEs participating in communication in each entangled group 
+ * is smaller than 8 or not
+ */
+static void relocate_clockwise_short(uint32_t tasklet_id){
+
+    //set arguments for use
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t total_data_size = DPU_INPUT_ARGUMENTS_RS1.total_data_size;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t dpu_num = DPU_INPUT_ARGUMENTS_RS1.each_dpu;
+    uint32_t no_rotate = DPU_INPUT_ARGUMENTS_RS1.no_rotate;
+    uint32_t comm_type = DPU_INPUT_ARGUMENTS_RS1.comm_type; //whether the communication contains the x axis
+    uint32_t a_length = DPU_INPUT_ARGUMENTS_RS1.a_length; //length of the x-axis
+    uint32_t num_comm_rg = DPU_INPUT_ARGUMENTS_RS1.num_comm_rg; // number of PEs participating in communication in each entangled group 
+
+    uint32_t original_addr; // address for word to move
+    uint32_t target_addr; //target address for word to move
+
+
+    if(!comm_type){
+
+        if(tasklet_id >= num_comm_rg) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+    
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + num_comm_rg){
+            for(int iteration =0; iteration < iter; iteration++){
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                if(num_comm_rg == 4) barrier_wait(&tasklet_4_barrier);
+                else if(num_comm_rg == 2) barrier_wait(&tasklet_2_barrier);
+
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = (target_dpu_num - dpu_num) % num_comm_rg;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/num_comm_rg) * num_comm_rg * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+                if(num_comm_rg == 4) barrier_wait(&tasklet_4_barrier);
+                else if(num_comm_rg == 2) barrier_wait(&tasklet_2_barrier);
+            }
+        }
+    }
+
+    else if(comm_type){
+
+        if(tasklet_id >= num_comm_rg) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+    
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + num_comm_rg){
+            for(int iteration =0; iteration < iter; iteration++){
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = (target_dpu_num - dpu_num/(8/num_comm_rg)) % num_comm_rg;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/num_comm_rg) * num_comm_rg * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+            }
+        }
+    }
+}
+
+/*
+ * In this function we aim to reorder the target data we are using for
+ * communication. The data will be ordered to correctly order for
+ * AlltoAll communication when x-axis length is 2 & y-axis length is 2.
+ * Rotation scheme is different as x-axis length is 2.
+ * Rotating scheme is decided on if x-axis is included in communication,
+ * and if number of PEs participating in communication in each entangled group 
+ * is smaller than 8 or not
+ */
+static void relocate_modified_reverse_clockwise(uint32_t tasklet_id){
+
+    //set arguments for use
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t total_data_size = DPU_INPUT_ARGUMENTS_RS1.total_data_size;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t dpu_num = DPU_INPUT_ARGUMENTS_RS1.each_dpu;
+    uint32_t no_rotate = DPU_INPUT_ARGUMENTS_RS1.no_rotate;
+    uint32_t comm_type = DPU_INPUT_ARGUMENTS_RS1.comm_type; //whether the communication contains the x axis
+    uint32_t a_length = DPU_INPUT_ARGUMENTS_RS1.a_length; //length of the x-axis
+    uint32_t num_comm_rg = DPU_INPUT_ARGUMENTS_RS1.num_comm_rg; // number of PEs participating in communication in each entangled group 
+
+    uint32_t original_addr; // address for word to move
+    uint32_t target_addr; //address for word to 
+
+
+    if(!comm_type){
+
+        if(tasklet_id >= num_comm_rg) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+    
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + num_comm_rg){
+            for(int iteration =0; iteration < iter; iteration++){
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                barrier_wait(&tasklet_2_barrier);
+
+                //do not rotate word if no_rotate is on
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                //set target offset and offset
+                else{
+                    offset = (target_dpu_num - dpu_num) % num_comm_rg;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + (target_dpu_num/num_comm_rg) * num_comm_rg * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+                barrier_wait(&tasklet_2_barrier);
+            }
+        }
+
+        num_comm_dpu = num_comm_dpu/2;
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+
+        //extra rotation is needed to fit relocation needs for this case
+
+        //num of words each tasklet should move
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + num_comm_rg){
+            for(int iteration =0; iteration < iter; iteration++){
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                barrier_wait(&tasklet_2_barrier);
+
+                //do not rotate word if no_rotate is on
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                //set target offset and offset
+                else{
+                    offset = (target_dpu_num - dpu_num/4) % num_comm_rg;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/num_comm_rg) * num_comm_rg * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+                barrier_wait(&tasklet_2_barrier);
+
+            }
+        }
+    }
+
+    else if(comm_type){
+
+        if(tasklet_id >= num_comm_rg) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+    
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + num_comm_rg){
+            for(int iteration =0; iteration < iter; iteration++){
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = (target_dpu_num - dpu_num/2) % num_comm_rg;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/num_comm_rg) * num_comm_rg * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+            }
+        }
+    }
+}
+
+/*
+ * In this function we aim to reorder the target data we are using for
+ * communication. The data will be ordered to correctly order for
+ * AlltoAll communication when x-axis length is 2 & y-axis length is 4.
+ * Rotation scheme is different as x-axis length is 2.
+ * Rotating scheme is decided on if x-axis is included in communication,
+ * and if number of PEs participating in communication in each entangled group 
+ * is smaller than 8 or not
+ */
+static void relocate_reverse_clockwise_short(uint32_t tasklet_id){
+
+    //set arguments for use
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t total_data_size = DPU_INPUT_ARGUMENTS_RS1.total_data_size;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t dpu_num = DPU_INPUT_ARGUMENTS_RS1.each_dpu;
+    uint32_t no_rotate = DPU_INPUT_ARGUMENTS_RS1.no_rotate;
+    uint32_t comm_type = DPU_INPUT_ARGUMENTS_RS1.comm_type; //whether the communication contains the x axis
+    uint32_t a_length = DPU_INPUT_ARGUMENTS_RS1.a_length; //length of the x-axis
+    uint32_t num_comm_rg = DPU_INPUT_ARGUMENTS_RS1.num_comm_rg; // number of PEs participating in communication in each entangled group 
+
+    uint32_t original_addr; // address for word to move
+    uint32_t target_addr; //address for word to 
+
+
+    if(!comm_type){
+
+        if(tasklet_id >= num_comm_rg) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+    
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + num_comm_rg){
+            for(int iteration =0; iteration < iter; iteration++){
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+                if(num_comm_rg == 4) barrier_wait(&tasklet_4_barrier);
+                else if(num_comm_rg == 2) barrier_wait(&tasklet_2_barrier);
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = (dpu_num - target_dpu_num) % num_comm_rg;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/num_comm_rg) * num_comm_rg * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+
+                if(num_comm_rg == 4) barrier_wait(&tasklet_4_barrier);
+                else if(num_comm_rg == 2) barrier_wait(&tasklet_2_barrier);
+            }
+        }
+    }
+
+    else if(comm_type){
+
+        if(tasklet_id >= num_comm_rg) return;
+
+        max_words_per_dpu = (total_data_size / (num_comm_dpu * sizeof(T)));
+    
+        //cache is used to move one word at a time to the right place
+        T* word_cache = (T*) mem_alloc(2048);
+
+        //num of words each tasklet should move
+        uint32_t iter;
+        if((max_words_per_dpu * sizeof(T)) % 2048 == 0) iter = (max_words_per_dpu * sizeof(T)) / 2048;
+        else iter = (max_words_per_dpu * sizeof(T)) / 2048 + 1;
+
+        uint32_t row_index, col_index, leftover_num;
+        int offset;
+
+        //for each target dpu data block, relocate them all somewhere else
+        for(int target_dpu_num = tasklet_id; target_dpu_num < num_comm_dpu; target_dpu_num = target_dpu_num + num_comm_rg){
+            for(int iteration =0; iteration < iter; iteration++){
+                //address to read the word from
+                original_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + max_words_per_dpu * target_dpu_num *sizeof(T) + 2048*iteration;
+
+                //if there are zero_padded words
+                if(iteration == iter - 1){
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                    mram_read((__mram_ptr void const *) (original_addr), word_cache, leftover_num * sizeof(T));
+                    for(int i= leftover_num; i<(max_words_per_dpu) - (2048/sizeof(T))*iteration; i++){
+                        word_cache[i] = 0;
+                    }
+                    leftover_num = (max_words_per_dpu) - (2048/sizeof(T))*iteration;
+                }
+                else mram_read((__mram_ptr void const *) (original_addr), word_cache, 2048);
+
+
+                if(no_rotate){
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + max_words_per_dpu * target_dpu_num*sizeof(T) + 2048*iteration;
+                }
+                else{
+                    offset = (dpu_num/(8/num_comm_rg) - target_dpu_num) % num_comm_rg;
+                    target_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + target_offset + (target_dpu_num/num_comm_rg) * num_comm_rg * max_words_per_dpu * sizeof(T) + offset * max_words_per_dpu * sizeof(T) + 2048*iteration;
+                }
+                if(iteration == iter - 1) mram_write(word_cache, (__mram_ptr void*) target_addr, leftover_num * sizeof(T));
+                else mram_write(word_cache, (__mram_ptr void*) target_addr, 2048);
+            }
+        }
+    }
+}
+
+/*
+ * Quantized collectives. The vector is cut into num_comm_dpu chunks, one per member, and every chunk into blocks of
+ * quant_block int32 words that share a power-of-two scale. Each DPU picks the scales of its own blocks, and each
+ * chunk travels in a slot holding its quantized words followed by the shift of each of its blocks, one byte per block
+ * padded to 8 bytes, so the host can decode every word with the scale of the DPU it comes from.
+ */
+static uint32_t quant_shift(int64_t magnitude, uint32_t quant_size){
+    int64_t quant_max = (quant_size == 1) ? 127 : 32767;
+    uint32_t shift = 0;
+
+    while(shift < 31 && ((magnitude + ((1LL << shift) >> 1)) >> shift) > quant_max) shift++;
+    return shift;
+}
+
+static uint32_t quant_words(uint32_t block, uint32_t nr_words, uint32_t quant_block){
+    return (nr_words - block * quant_block < quant_block) ? nr_words - block * quant_block : quant_block;
+}
+
+//largest magnitude of every block of every chunk, as int64 at target_offset in the order of the chunks
+static void quant_block_max(uint32_t tasklet_id){
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t quant_block = DPU_INPUT_ARGUMENTS_RS1.quant_block;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t chunk_words = DPU_INPUT_ARGUMENTS_RS1.total_data_size / sizeof(int32_t) / num_comm_dpu;
+    uint32_t nr_blocks = (chunk_words + quant_block - 1) / quant_block;
+
+    int32_t* word_cache = (int32_t*) mem_alloc(QUANT_MAX_BLOCK * sizeof(int32_t));
+    int64_t* magnitude = (int64_t*) mem_alloc(sizeof(int64_t));
+
+    for(uint32_t item = tasklet_id; item < num_comm_dpu * nr_blocks; item += 8){
+        uint32_t chunk = item / nr_blocks;
+        uint32_t block = item % nr_blocks;
+        uint32_t words = quant_words(block, chunk_words, quant_block);
+
+        mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + start_offset + (chunk * chunk_words + block * quant_block) * sizeof(int32_t)), word_cache, words * sizeof(int32_t));
+        *magnitude = 0;
+        for(uint32_t i = 0; i < words; i++){
+            int64_t value = word_cache[i] < 0 ? -(int64_t)word_cache[i] : word_cache[i];
+            if(value > *magnitude) *magnitude = value;
+        }
+        mram_write(magnitude, (__mram_ptr void*) (DPU_MRAM_HEAP_POINTER + target_offset + item * sizeof(int64_t)), sizeof(int64_t));
+    }
+}
+
+/*
+ * The chunks of int32 words at start_offset to quantized words in the slots of the table of count_slot_t at
+ * table_offset, from target_offset, rounded to the nearest. The 8 blocks whose shifts share an 8-byte word belong to
+ * one tasklet.
+ */
+static void quantize(uint32_t tasklet_id){
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t table_offset = DPU_INPUT_ARGUMENTS_RS1.table_offset;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t quant_size = DPU_INPUT_ARGUMENTS_RS1.quant_size;
+    uint32_t quant_block = DPU_INPUT_ARGUMENTS_RS1.quant_block;
+    uint32_t chunk_words = DPU_INPUT_ARGUMENTS_RS1.total_data_size / sizeof(int32_t) / num_comm_dpu;
+    uint32_t nr_blocks = (chunk_words + quant_block - 1) / quant_block;
+    uint32_t nr_groups = (nr_blocks + 7) / 8;
+
+    int32_t* word_cache = (int32_t*) mem_alloc(QUANT_MAX_BLOCK * sizeof(int32_t));
+    int16_t* quant_cache = (int16_t*) mem_alloc(QUANT_MAX_BLOCK * sizeof(int16_t));
+    uint8_t* shift_cache = (uint8_t*) mem_alloc(8);
+    count_slot_t* entry = (count_slot_t*) mem_alloc(sizeof(count_slot_t));
+
+    for(uint32_t item = tasklet_id; item < num_comm_dpu * nr_groups; item += 8){
+        uint32_t chunk = item / nr_groups;
+        uint32_t group = item % nr_groups;
+
+        mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + table_offset + chunk * sizeof(count_slot_t)), entry, sizeof(count_slot_t));
+        uint32_t slot = target_offset + entry->slot;
+
+        for(uint32_t i = 0; i < 8; i++) shift_cache[i] = 0;
+        for(uint32_t block = group * 8; block < (group + 1) * 8 && block < nr_blocks; block++){
+            uint32_t words = quant_words(block, chunk_words, quant_block);
+            int64_t magnitude = 0;
+
+            mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + start_offset + (chunk * chunk_words + block * quant_block) * sizeof(int32_t)), word_cache, words * sizeof(int32_t));
+            for(uint32_t i = 0; i < words; i++){
+                int64_t value = word_cache[i] < 0 ? -(int64_t)word_cache[i] : word_cache[i];
+                if(value > magnitude) magnitude = value;
+            }
+
+            uint32_t shift = quant_shift(magnitude, quant_size);
+            int64_t half = (1LL << shift) >> 1;
+            for(uint32_t i = 0; i < words; i++){
+                int32_t value = (int32_t)(((int64_t)word_cache[i] + half) >> shift);
+                if(quant_size == 1) ((int8_t*)quant_cache)[i] = (int8_t)value;
+                else quant_cache[i] = (int16_t)value;
+            }
+            shift_cache[block % 8] = shift;
+            mram_write(quant_cache, (__mram_ptr void*) (DPU_MRAM_HEAP_POINTER + slot + block * quant_block * quant_size), words * quant_size);
+        }
+        mram_write(shift_cache, (__mram_ptr void*) (DPU_MRAM_HEAP_POINTER + slot + chunk_words * quant_size + group * 8), 8);
+    }
+}
+
+//The slots of the table at table_offset, from start_offset, back to the chunks of int32 words at target_offset
+static void dequantize(uint32_t tasklet_id){
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t table_offset = DPU_INPUT_ARGUMENTS_RS1.table_offset;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t quant_size = DPU_INPUT_ARGUMENTS_RS1.quant_size;
+    uint32_t quant_block = DPU_INPUT_ARGUMENTS_RS1.quant_block;
+    uint32_t chunk_words = DPU_INPUT_ARGUMENTS_RS1.total_data_size / sizeof(int32_t) / num_comm_dpu;
+    uint32_t nr_blocks = (chunk_words + quant_block - 1) / quant_block;
+    uint32_t nr_groups = (nr_blocks + 7) / 8;
+
+    int32_t* word_cache = (int32_t*) mem_alloc(QUANT_MAX_BLOCK * sizeof(int32_t));
+    int16_t* quant_cache = (int16_t*) mem_alloc(QUANT_MAX_BLOCK * sizeof(int16_t));
+    uint8_t* shift_cache = (uint8_t*) mem_alloc(8);
+    count_slot_t* entry = (count_slot_t*) mem_alloc(sizeof(count_slot_t));
+
+    for(uint32_t item = tasklet_id; item < num_comm_dpu * nr_groups; item += 8){
+        uint32_t chunk = item / nr_groups;
+        uint32_t group = item % nr_groups;
+
+        mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + table_offset + chunk * sizeof(count_slot_t)), entry, sizeof(count_slot_t));
+        uint32_t slot = start_offset + entry->slot;
+
+        mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + slot + chunk_words * quant_size + group * 8), shift_cache, 8);
+        for(uint32_t block = group * 8; block < (group + 1) * 8 && block < nr_blocks; block++){
+            uint32_t words = quant_words(block, chunk_words, quant_block);
+            uint32_t shift = shift_cache[block % 8];
+
+            mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + slot + block * quant_block * quant_size), quant_cache, words * quant_size);
+            for(uint32_t i = 0; i < words; i++){
+                int32_t value = (quant_size == 1) ? ((int8_t*)quant_cache)[i] : quant_cache[i];
+                word_cache[i] = (int32_t)((int64_t)value << shift);
+            }
+            mram_write(word_cache, (__mram_ptr void*) (DPU_MRAM_HEAP_POINTER + target_offset + (chunk * chunk_words + block * quant_block) * sizeof(int32_t)), words * sizeof(int32_t));
+        }
+    }
+}
+
+/*
+ * Sparse collectives. The total_data_size bytes at start_offset are written at target_offset as the number of nonzero
+ * blocks of SPARSE_BLOCK bytes (uint64), a bitmap of the nonzero blocks padded to 64-bit words, and the nonzero blocks
+ * packed in order. Every tasklet handles a contiguous range of bitmap words, so the blocks of a tasklet are written
+ * after the blocks counted by the tasklets before it.
+ */
+#define SPARSE_CHUNK_BLOCKS (2048 / SPARSE_BLOCK)
+
+static bool sparse_is_zero(uint64_t* block){
+    for(uint32_t i = 0; i < SPARSE_BLOCK / sizeof(uint64_t); i++){
+        if(block[i] != 0) return false;
+    }
+    return true;
+}
+
+static void sparse_compact(uint32_t tasklet_id){
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t nr_blocks = DPU_INPUT_ARGUMENTS_RS1.total_data_size / SPARSE_BLOCK;
+    uint32_t nr_words = (nr_blocks + 63) / 64;
+    uint32_t header_size = sizeof(uint64_t) * (1 + nr_words);
+    uint32_t words_per_tasklet = (nr_words + 7) / 8;
+    uint32_t word_begin = tasklet_id * words_per_tasklet;
+    uint32_t word_end = (word_begin + words_per_tasklet < nr_words) ? word_begin + words_per_tasklet : nr_words;
+
+    uint64_t* block_cache = (uint64_t*) mem_alloc(SPARSE_CHUNK_BLOCKS * SPARSE_BLOCK);
+    uint64_t* bitmap = (uint64_t*) mem_alloc(sizeof(uint64_t));
+    uint32_t count = 0;
+
+    for(uint32_t word = word_begin; word < word_end; word++){
+        *bitmap = 0;
+        for(uint32_t chunk = word * 64; chunk < (word + 1) * 64 && chunk < nr_blocks; chunk += SPARSE_CHUNK_BLOCKS){
+            uint32_t blocks = (nr_blocks - chunk < SPARSE_CHUNK_BLOCKS) ? nr_blocks - chunk : SPARSE_CHUNK_BLOCKS;
+
+            mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + start_offset + chunk * SPARSE_BLOCK), block_cache, blocks * SPARSE_BLOCK);
+            for(uint32_t i = 0; i < blocks; i++){
+                if(!sparse_is_zero(block_cache + i * (SPARSE_BLOCK / sizeof(uint64_t)))) *bitmap |= 1ULL << (chunk - word * 64 + i);
+            }
+        }
+        count += __builtin_popcountll(*bitmap);
+        mram_write(bitmap, (__mram_ptr void*) (DPU_MRAM_HEAP_POINTER + target_offset + sizeof(uint64_t) * (1 + word)), sizeof(uint64_t));
+    }
+    sparse_count[tasklet_id] = count;
+
+    barrier_wait(&tasklet_8_barrier);
+
+    uint32_t position = 0;
+    for(uint32_t i = 0; i < tasklet_id; i++) position += sparse_count[i];
+    if(tasklet_id == 7){
+        *bitmap = position + count;
+        mram_write(bitmap, (__mram_ptr void*) (DPU_MRAM_HEAP_POINTER + target_offset), sizeof(uint64_t));
+    }
+
+    for(uint32_t word = word_begin; word < word_end; word++){
+        mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + target_offset + sizeof(uint64_t) * (1 + word)), bitmap, sizeof(uint64_t));
+        for(uint32_t chunk = word * 64; chunk < (word + 1) * 64 && chunk < nr_blocks; chunk += SPARSE_CHUNK_BLOCKS){
+            uint32_t blocks = (nr_blocks - chunk < SPARSE_CHUNK_BLOCKS) ? nr_blocks - chunk : SPARSE_CHUNK_BLOCKS;
+            uint64_t chunk_bits = (*bitmap >> (chunk - word * 64)) & ((blocks < 64) ? (1ULL << blocks) - 1 : ~0ULL);
+
+            //chunks without nonzero blocks are not read again
+            if(chunk_bits == 0) continue;
+            mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + start_offset + chunk * SPARSE_BLOCK), block_cache, blocks * SPARSE_BLOCK);
+            for(uint32_t i = 0; i < blocks; i++){
+                if(!((chunk_bits >> i) & 1)) continue;
+                mram_write(block_cache + i * (SPARSE_BLOCK / sizeof(uint64_t)), (__mram_ptr void*) (DPU_MRAM_HEAP_POINTER + target_offset + header_size + position * SPARSE_BLOCK), SPARSE_BLOCK);
+                position++;
+            }
+        }
+    }
+}
+
+/*
+ * Grouped collectives. The table of copy_segment_t at start_offset lists total_data_size segments. Every segment is
+ * cut into pieces of 2048 bytes, and the pieces of all segments are dealt to the tasklets in turn, so that many
+ * short segments and a few long ones are both spread over the 8 tasklets.
+ */
+static void copy_segments(uint32_t tasklet_id){
+    uint32_t table_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t nr_segments = DPU_INPUT_ARGUMENTS_RS1.total_data_size;
+
+    uint64_t* piece_cache = (uint64_t*) mem_alloc(2048);
+    copy_segment_t* segment = (copy_segment_t*) mem_alloc(sizeof(copy_segment_t));
+    uint32_t piece = 0;
+
+    for(uint32_t i = 0; i < nr_segments; i++){
+        mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + table_offset + i * sizeof(copy_segment_t)), segment, sizeof(copy_segment_t));
+        for(uint32_t done = 0; done < segment->length; done += 2048, piece++){
+            uint32_t length = (segment->length - done < 2048) ? segment->length - done : 2048;
+
+            if(piece % 8 != tasklet_id) continue;
+            mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + segment->src_offset + done), piece_cache, length);
+            mram_write(piece_cache, (__mram_ptr void*) (DPU_MRAM_HEAP_POINTER + segment->dst_offset + done), length);
+        }
+    }
+}
+
+/*
+ * alltoallv. The table at table_offset holds a count_slot_t per peer, in the order of the communicator ranks. With
+ * pack, the chunks packed one after the other at start_offset are copied to target_offset + slot, where the chunks
+ * of the 8 DPUs of a rotate group for one host pass line up. Without it, the chunks are copied back from
+ * start_offset + slot and packed one after the other at target_offset. The pieces are dealt as in copy_segments().
+ */
+static void relocate_counts(uint32_t tasklet_id, bool pack){
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t target_offset = DPU_INPUT_ARGUMENTS_RS1.target_offset;
+    uint32_t table_offset = DPU_INPUT_ARGUMENTS_RS1.table_offset;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+
+    uint64_t* piece_cache = (uint64_t*) mem_alloc(2048);
+    count_slot_t* entry = (count_slot_t*) mem_alloc(sizeof(count_slot_t));
+    uint32_t piece = 0;
+    uint32_t displ = 0;
+
+    for(uint32_t i = 0; i < num_comm_dpu; i++){
+        mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + table_offset + i * sizeof(count_slot_t)), entry, sizeof(count_slot_t));
+        uint32_t src_offset = pack ? start_offset + displ : start_offset + entry->slot;
+        uint32_t dst_offset = pack ? target_offset + entry->slot : target_offset + displ;
+
+        for(uint32_t done = 0; done < entry->count; done += 2048, piece++){
+            uint32_t length = (entry->count - done < 2048) ? entry->count - done : 2048;
+
+            if(piece % 8 != tasklet_id) continue;
+            mram_read((__mram_ptr void const *) (DPU_MRAM_HEAP_POINTER + src_offset + done), piece_cache, length);
+            mram_write(piece_cache, (__mram_ptr void*) (DPU_MRAM_HEAP_POINTER + dst_offset + done), length);
+        }
+        displ += entry->count;
+    }
+}
+
+/*
+ * In-place relocation for the collectives that have no communication buffer. The chunks of every group of
+ * num_comm_rg chunks are permuted as relocate_clockwise() (chunk t to (t - dpu) % num_comm_rg) or as
+ * relocate_reverse_clockwise() (chunk t to (dpu - t) % num_comm_rg), but within start_offset. Each 2048-byte
+ * column of a group belongs to one tasklet, which follows the cycles of the permutation with two caches: the chunk
+ * in hand is written over the next one only after that one has been read. The columns are disjoint, so the
+ * tasklets never wait for each other.
+ */
+static uint32_t cycle_target(uint32_t chunk, uint32_t dpu_num, uint32_t group, bool reverse){
+    return reverse ? (dpu_num + group - chunk) % group : (chunk + group - dpu_num % group) % group;
+}
+
+static void relocate_cycle(uint32_t tasklet_id, bool reverse){
+    uint32_t start_offset = DPU_INPUT_ARGUMENTS_RS1.start_offset;
+    uint32_t total_data_size = DPU_INPUT_ARGUMENTS_RS1.total_data_size;
+    uint32_t num_comm_dpu = DPU_INPUT_ARGUMENTS_RS1.num_comm_dpu;
+    uint32_t dpu_num = DPU_INPUT_ARGUMENTS_RS1.each_dpu % DPU_INPUT_ARGUMENTS_RS1.num_comm_rg;
+    uint32_t group = DPU_INPUT_ARGUMENTS_RS1.num_comm_rg;
+
+    uint32_t chunk_size = total_data_size / num_comm_dpu;
+    uint32_t nr_columns = (chunk_size + 2047) / 2048;
+    uint32_t nr_items = (num_comm_dpu / group) * nr_columns;
+
+    uint64_t* cache_in_hand = (uint64_t*) mem_alloc(2048);
+    uint64_t* cache_next = (uint64_t*) mem_alloc(2048);
+
+    for(uint32_t item = tasklet_id; item < nr_items; item += 8){
+        uint32_t column = item % nr_columns;
+        uint32_t length = (chunk_size - column * 2048 < 2048) ? chunk_size - column * 2048 : 2048;
+        uint32_t group_addr = (uint32_t) DPU_MRAM_HEAP_POINTER + start_offset + (item / nr_columns) * group * chunk_size + column * 2048;
+
+        for(uint32_t first = 0; first < group; first++){
+            uint32_t chunk = cycle_target(first, dpu_num, group, reverse);
+
+            //every cycle is followed once, from its smallest chunk
+            while(chunk > first) chunk = cycle_target(chunk, dpu_num, group, reverse);
+            if(chunk != first || cycle_target(first, dpu_num, group, reverse) == first) continue;
+
+            mram_read((__mram_ptr void const *) (group_addr + first * chunk_size), cache_in_hand, length);
+            chunk = first;
+            do{
+                uint32_t next = cycle_target(chunk, dpu_num, group, reverse);
+                uint64_t* swap = cache_in_hand;
+
+                if(next != first) mram_read((__mram_ptr void const *) (group_addr + next * chunk_size), cache_next, length);
+                mram_write(cache_in_hand, (__mram_ptr void*) (group_addr + next * chunk_size), length);
+                cache_in_hand = cache_next;
+                cache_next = swap;
+                chunk = next;
+            } while(chunk != first);
+        }
+    }
+}
+
+/*
+ * Resident relocation program of PID-Comm. All relocation schemes share this binary
+ * and DPU_INPUT_ARGUMENTS_RS1.mode selects the one to run, so a collective only
+ * pushes its arguments and launches instead of loading a new program.
+ * Data is moved in 8-byte words, so the same binary serves every data type.
+ */
+int main(){
+
+    uint32_t tasklet_id = me();
+
+    //use only 8 tasklets
+    if(tasklet_id >= 8) goto PASS;
+
+    if(tasklet_id == 0) mem_reset();
+
+    barrier_wait(&tasklet_8_barrier);
+
+    switch(DPU_INPUT_ARGUMENTS_RS1.mode){
+
+        case RELOCATE_CLOCKWISE:
+            relocate_clockwise(tasklet_id);
+            break;
+
+        case RELOCATE_REVERSE_CLOCKWISE:
+            relocate_reverse_clockwise(tasklet_id);
+            break;
+
+        case RELOCATE_COUNTERCLOCKWISE:
+            relocate_counterclockwise(tasklet_id);
+            break;
+
+        case RELOCATE_INCREMENTAL_COUNTERCLOCKWISE:
+            relocate_incremental_counterclockwise(tasklet_id);
+            break;
+
+        case RELOCATE_MODIFIED_CLOCKWISE:
+            relocate_modified_clockwise(tasklet_id);
+            break;
+
+        case RELOCATE_CLOCKWISE_SHORT:
+            relocate_clockwise_short(tasklet_id);
+            break;
+
+        case RELOCATE_MODIFIED_REVERSE_CLOCKWISE:
+            relocate_modified_reverse_clockwise(tasklet_id);
+            break;
+
+        case RELOCATE_REVERSE_CLOCKWISE_SHORT:
+            relocate_reverse_clockwise_short(tasklet_id);
+            break;
+
+        case RELOCATE_QUANT_BLOCK_MAX:
+            quant_block_max(tasklet_id);
+            break;
+
+        case RELOCATE_QUANTIZE:
+            quantize(tasklet_id);
+            break;
+
+        case RELOCATE_DEQUANTIZE:
+            dequantize(tasklet_id);
+            break;
+
+        case RELOCATE_SPARSE_COMPACT:
+            sparse_compact(tasklet_id);
+            break;
+
+        case RELOCATE_COPY_SEGMENTS:
+            copy_segments(tasklet_id);
+            break;
+
+        case RELOCATE_CYCLE_CLOCKWISE:
+            relocate_cycle(tasklet_id, false);
+            break;
+
+        case RELOCATE_CYCLE_REVERSE_CLOCKWISE:
+            relocate_cycle(tasklet_id, true);
+            break;
+
+        case RELOCATE_PACK_COUNTS:
+            relocate_counts(tasklet_id, true);
+            break;
+
+        case RELOCATE_UNPACK_COUNTS:
+            relocate_counts(tasklet_id, false);
+            break;
+
+        default:
+            break;
+    }
+
+PASS:
+    
+    printf("\n");
+    return 0;
+}
@@ -38,16 +38,157 @@ typedef struct {
     struct dpu_set_t dpu_set;
     uint32_t dimension;
     uint32_t* axis_len;
+    struct dpu_program_t* relocate_program; //resident relocation program, managed by PID-Comm
+    bool preserve_program; //restore the program found on the DPUs once a collective completes
+    uint32_t algorithm; //PIDCOMM_ALGORITHM of alltoall, reduce_scatter, all_reduce and allgather
+    bool log_algorithm; //print the path taken by each call of them
+    struct pidcomm_cost_model* cost_models; //measured by pidcomm_calibrate(), managed by PID-Comm
+    struct pidcomm_mram_allocator* mram; //regions handed out by pidcomm_mram_alloc(), managed by PID-Comm
 } hypercube_manager;
 
+//Persistent collective plan
+typedef struct pidcomm_plan pidcomm_plan_t;
+
+//Handle of a non-blocking collective
+typedef struct pidcomm_request pidcomm_request_t;
+
+//Data types of the reducing collectives. Signed integer types are given by their size in bytes, so sizeof(T) can still be passed.
+//The low byte is the element size and the high byte the kind; bf16 and fp16 are accumulated in fp32.
+typedef enum {
+    PIDCOMM_INT8 = 1,
+    PIDCOMM_INT16 = 2,
+    PIDCOMM_INT32 = 4,
+    PIDCOMM_INT64 = 8,
+    PIDCOMM_FLOAT32 = 0x104,
+    PIDCOMM_BFLOAT16 = 0x202,
+    PIDCOMM_FLOAT16 = 0x302,
+    PIDCOMM_UINT8 = 0x401,
+    PIDCOMM_UINT16 = 0x402,
+    PIDCOMM_UINT32 = 0x404,
+    PIDCOMM_UINT64 = 0x408,
+} PIDCOMM_DTYPE;
+
+#define PIDCOMM_DTYPE_SIZE(dtype) ((dtype) & 0xff)
+
+//Reduction operators. Saturating sums clamp integers to their range and are plain sums for floating-point types.
+//The bitwise operators reduce the raw bits of the elements, including floating-point ones.
+typedef enum {
+    PIDCOMM_SUM = 0,
+    PIDCOMM_MAX = 1,
+    PIDCOMM_SAT_SUM = 2,
+    PIDCOMM_MIN = 3,
+    PIDCOMM_PROD = 4,
+    PIDCOMM_BAND = 5,
+    PIDCOMM_BOR = 6,
+    PIDCOMM_BXOR = 7,
+} PIDCOMM_OPERATOR;
+
+//Paths of alltoall, reduce_scatter, all_reduce and allgather, blocking, grouped, non-blocking or planned
+typedef enum {
+    PIDCOMM_ALGO_RNS = 0, //rotate-and-stream through the relocation kernels (default)
+    PIDCOMM_ALGO_HOST = 1, //read the data to the host, combine it there and write it back
+    PIDCOMM_ALGO_HYBRID = 2, //all_reduce only: rotate-and-stream reduce_scatter, then allgather on the host
+    PIDCOMM_ALGO_AUTO = 3, //the cheapest path according to the cost model measured by pidcomm_calibrate()
+} PIDCOMM_ALGORITHM;
+
+//Largest number of int32 words sharing a scale in the quantized collectives
+#define PIDCOMM_QUANT_MAX_BLOCK 512
+
+//Bytes of a block of the sparse collectives, the unit of their bitmaps
+#define PIDCOMM_SPARSE_BLOCK 64
+
+//Passed as the buffer offset of a collective to borrow its communication buffer from pidcomm_mram_alloc()
+#define PIDCOMM_AUTO_BUFFER UINT32_MAX
+
 /**
  * @brief Initialize the hypercube manager
  * @param dpu_set the identifier of the DPU set
- * @param dimension the number of dimensions of the hypercube
- * @param axis_len the array that contains the length of each side in the hypercube
+ * @param dimension the number of dimensions of the hypercube, e.g. 4 or 5 for batch x heads x rows x cols decompositions
+ * @param axis_len the array that contains the length of each side in the hypercube, copied by the manager
  */
 hypercube_manager* init_hypercube_manager(struct dpu_set_t dpu_set, uint32_t dimension, uint32_t* axis_len);
 
+/**
+ * @brief Choose whether collectives give the DPUs back with the program they found loaded (default) or leave the relocation program loaded.
+ *        The program is restored from an image cached by dpu_load, so the ELF file is not read again.
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param preserve_program true to restore the program after each collective
+ */
+void
+pidcomm_set_preserve_program(hypercube_manager* manager, bool preserve_program);
+
+/**
+ * @brief Restrict the MRAM allocator of the hypercube to [base, base + capacity), e.g. to keep regions laid out by hand
+ * below base. Must be called before the first pidcomm_mram_alloc(); the allocator uses the whole 64MB otherwise.
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param base the byte offset from the DPU's MRAM heap where the allocator starts
+ * @param capacity the number of bytes managed by the allocator
+ */
+void
+pidcomm_mram_init(hypercube_manager* manager, uint32_t base, uint32_t capacity);
+
+/**
+ * @brief Reserve the same MRAM region on every DPU of the hypercube. Offsets are multiples of 8 bytes, and regions of
+ * 2KB or more start on a 2KB boundary. Collectives given PIDCOMM_AUTO_BUFFER borrow their buffer from the allocator.
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param size the number of bytes of the region
+ * @return the byte offset of the region from the DPU's MRAM heap
+ */
+uint32_t
+pidcomm_mram_alloc(hypercube_manager* manager, uint32_t size);
+
+/**
+ * @brief Release a region reserved with pidcomm_mram_alloc()
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param offset the offset returned by pidcomm_mram_alloc()
+ */
+void
+pidcomm_mram_free(hypercube_manager* manager, uint32_t offset);
+
+/**
+ * @brief Utilization of the MRAM allocator
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param used receives the number of bytes reserved
+ * @param peak receives the highest number of bytes reserved so far
+ * @param largest_free receives the size of the largest region that can still be reserved, before alignment
+ */
+void
+pidcomm_mram_usage(hypercube_manager* manager, uint32_t* used, uint32_t* peak, uint32_t* largest_free);
+
+/**
+ * @brief Print the utilization of the MRAM allocator and its regions
+ * @param manager the hypercube manager that contains information about the hypercube
+ */
+void
+pidcomm_mram_report(hypercube_manager* manager);
+
+/**
+ * @brief Choose the path of alltoall, reduce_scatter, all_reduce and allgather, including the grouped, non-blocking,
+ *        planned and pipelined ones. Shapes whose rotate groups do not fit always take the host path
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param algorithm the PIDCOMM_ALGORITHM. With PIDCOMM_ALGO_AUTO, collectives whose communicator and data type were not
+ *        calibrated use rotate-and-stream. PIDCOMM_ALGO_HYBRID only changes all_reduce
+ * @param log_algorithm print the path taken by each call, and the estimated costs of the calibrated ones, to stderr
+ */
+void
+pidcomm_set_algorithm(hypercube_manager* manager, uint32_t algorithm, bool log_algorithm);
+
+/**
+ * @brief Measure the cost of every path of alltoall, reduce_scatter, all_reduce and allgather on a communicator, at sizes
+ *        doubling from 8 bytes per communicating DPU up to max_data_size bytes. Calls between two measured sizes
+ *        interpolate their costs. The data and the buffer are overwritten
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @param max_data_size the largest number of bytes for each DPUs
+ * @param size the PIDCOMM_DTYPE reduced by reduce_scatter and all_reduce, which are calibrated for each data type
+ */
+void
+pidcomm_calibrate(hypercube_manager* manager, char* comm, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset,
+                    uint32_t max_data_size, uint32_t size);
+
 /**
  * @brief broadcast() for PID-Comm
  * @param manager the hypercube manager that contains information about the hypercube
@@ -58,6 +199,61 @@ hypercube_manager* init_hypercube_manager(struct dpu_set_t dpu_set, uint32_t dim
 void
 pidcomm_broadcast(hypercube_manager* manager, uint32_t total_data_size, uint32_t target_offset, void* data);
 
+/**
+ * @brief broadcast the data of one DPU to the other members of its communicator
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param root the rank of the source DPU in each communicator, the first communicating axis varying fastest
+ * @param total_data_size the number of bytes to broadcast, a multiple of 8
+ * @param offset the byte offset from the DPU's MRAM address of the data, on the root and on the other members
+ */
+void
+pidcomm_bcast(hypercube_manager* manager, char* comm, uint32_t root, uint32_t total_data_size, uint32_t offset);
+
+/**
+ * @brief cyclic shift along one axis: every DPU sends its block to the DPU k positions further on the axis
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param axis the index of the axis
+ * @param k the distance of the shift, negative to shift backwards
+ * @param total_data_size the number of bytes of each block, a multiple of 8
+ * @param src_offset the byte offset from the DPU's MRAM address of the block to send
+ * @param dst_offset the byte offset from the DPU's MRAM address where to copy the received block. The blocks are
+ * rotated and streamed between the rotate groups when the set has whole ranks and the received block does not overlap
+ * the sent one; they go through the host otherwise
+ */
+void
+pidcomm_shift(hypercube_manager* manager, uint32_t axis, int32_t k, uint32_t total_data_size, uint32_t src_offset, uint32_t dst_offset);
+
+/**
+ * @brief point-to-point exchange of one block per DPU
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param destination destination[dpu] is the index of the DPU that receives the block of the DPU, or UINT32_MAX to
+ * send nothing. Two DPUs cannot send to the same DPU
+ * @param total_data_size the number of bytes of each block, a multiple of 8
+ * @param src_offset the byte offset from the DPU's MRAM address of the block to send
+ * @param dst_offset the byte offset from the DPU's MRAM address where to copy the received block. The blocks are
+ * rotated and streamed between the rotate groups when the set has whole ranks and the received block does not overlap
+ * the sent one; they go through the host otherwise
+ */
+void
+pidcomm_sendrecv(hypercube_manager* manager, uint32_t* destination, uint32_t total_data_size, uint32_t src_offset, uint32_t dst_offset);
+
+/**
+ * @brief transpose of a matrix distributed in blocks over the grid of the two communicating axes: the block of the DPU
+ * at (i, j) moves to the DPU at (j, i)
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string with the two axes of the grid, which must have the same length
+ * @param rows the number of rows of each block
+ * @param cols the number of columns of each block
+ * @param size the size of an element in bytes. The size of a block must be a multiple of 8
+ * @param src_offset the byte offset from the DPU's MRAM address of the block
+ * @param dst_offset the byte offset from the DPU's MRAM address where to copy the received block, src_offset to transpose in place
+ * @param transpose_block also transpose each row-major block, so that the whole matrix is transposed. Out of place only
+ * on the rotate-and-stream path, and for element sizes that divide 8 or are multiples of 8
+ */
+void
+pidcomm_transpose(hypercube_manager* manager, char* comm, uint32_t rows, uint32_t cols, uint32_t size, uint32_t src_offset, uint32_t dst_offset, bool transpose_block);
+
 /**
  * @brief alltoall() for PID-Comm
  * @param manager the hypercube manager that contains information about the hypercube
@@ -65,7 +261,7 @@ pidcomm_broadcast(hypercube_manager* manager, uint32_t total_data_size, uint32_t
  * @param total_data_size the number of bytes for each DPUs
  * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
  * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
- * @param buffer_offset the size of the buffer in bytes
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
  */
 void
 pidcomm_alltoall(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset);
@@ -77,11 +273,12 @@ pidcomm_alltoall(hypercube_manager* manager, char* comm, uint32_t total_data_siz
  * @param total_data_size the number of bytes for each DPUs
  * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
  * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
- * @param buffer_offset the size of the buffer in bytes
- * @param size the size of the datatype
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
  */
 void
-pidcomm_reduce_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset, uint32_t size);
+pidcomm_reduce_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type);
 
 /**
  * @brief all_reduce() for PID-Comm
@@ -90,9 +287,9 @@ pidcomm_reduce_scatter(hypercube_manager* manager, char* comm, uint32_t total_da
  * @param total_data_size the number of bytes for each DPUs
  * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
  * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
- * @param buffer_offset the size of the buffer in bytes
- * @param size the size of the datatype
- * @param reduce_type the type of reduction operation. 1 for sum operation and 2 for max operation
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
  */
 void
 pidcomm_all_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type);
@@ -104,46 +301,413 @@ pidcomm_all_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_s
  * @param total_data_size the number of bytes for each DPUs
  * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
  * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
- * @param buffer_offset the size of the buffer in bytes
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
  */
 void
 pidcomm_allgather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset);
 
 /**
- * @brief reduce() for PID-Comm
+ * @brief reduce() for PID-Comm. Shapes whose rotate groups do not fit run on the host with the same host buffer layout
  * @param manager the hypercube manager that contains information about the hypercube
  * @param comm the bitmap string that contains the target dimensions
  * @param total_data_size the number of bytes for each DPUs
  * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
- * @param buffer_offset the size of the buffer in bytes
- * @param size the size of the datatype
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
  * @param host_buffer the host buffer containing the data to copy
  */
 void
-pidcomm_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t buffer_offset, uint32_t size, void** host_buffer);
+pidcomm_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type, void** host_buffer);
 
 /**
- * @brief gather() for PID-Comm
+ * @brief gather() for PID-Comm. Shapes whose rotate groups do not fit run on the host with the same host buffer layout
  * @param manager the hypercube manager that contains information about the hypercube
  * @param comm the bitmap string that contains the target dimensions
  * @param total_data_size the number of bytes for each DPUs
  * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
- * @param buffer_offset the size of the buffer in bytes
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
  * @param host_buffer the host buffer containing the data to copy
  */
 void
 pidcomm_gather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t buffer_offset, void** host_buffer);
 
 /**
- * @brief scatter() for PID-Comm
+ * @brief scatter() for PID-Comm. Shapes whose rotate groups do not fit run on the host with the same host buffer layout
  * @param manager the hypercube manager that contains information about the hypercube
  * @param comm the bitmap string that contains the target dimensions
  * @param total_data_size the number of bytes for each DPUs
  * @param start_offset the byte offset from the DPU's MRAM address where the data to copy
- * @param buffer_offset the size of the buffer in bytes
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
  * @param host_buffer the host buffer where the data is copied
  */
 void
 pidcomm_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t buffer_offset, void** host_buffer);
 
+/**
+ * @brief alltoall() with a byte count for every pair of DPUs. Each DPU packs its chunks at start_offset in the order of
+ * the communicator ranks, and receives the chunks packed at target_offset in the order of the source ranks.
+ * Ranks number the members of a communicator with the first communicating axis varying fastest.
+ * On full ranks the chunks are packed into slots borrowed from pidcomm_mram_alloc(), and only the lines of the longest
+ * chunk of each pair of rotate groups are rotated and streamed.
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param send_counts send_counts[dpu * num_comm_dpu + rank] is the number of bytes the DPU sends to the member of its
+ * communicator with this rank, a multiple of 8
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data. Each DPU reads only its own
+ * send bytes and has only its own receive bytes written, so the MRAM past its receive size is left untouched
+ */
+void
+pidcomm_alltoallv(hypercube_manager* manager, char* comm, uint32_t* send_counts, uint32_t start_offset, uint32_t target_offset);
+
+/**
+ * @brief allgather() with a different chunk size for each DPU. The chunks of the communicator are packed at
+ * target_offset in rank order.
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param counts counts[dpu] is the number of bytes the DPU contributes, a multiple of 8
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data. Each DPU has only the chunks
+ * of its communicator written, so the MRAM past their total size is left untouched
+ */
+void
+pidcomm_allgatherv(hypercube_manager* manager, char* comm, uint32_t* counts, uint32_t start_offset, uint32_t target_offset);
+
+/**
+ * @brief reduce_scatter() with a different chunk size for each DPU. Every DPU holds at start_offset one chunk per
+ * member of its communicator, packed in rank order, and receives the reduction of its own chunk at target_offset.
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param counts counts[dpu] is the number of bytes of the chunk reduced into the DPU, a multiple of 8
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data. Each DPU has only its own
+ * counts[dpu] bytes written, so the MRAM past them is left untouched
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
+ */
+void
+pidcomm_reduce_scatterv(hypercube_manager* manager, char* comm, uint32_t* counts, uint32_t start_offset, uint32_t target_offset, uint32_t size, uint32_t reduce_type);
+
+/**
+ * @brief all_reduce() combined on the host: the data is read once from every DPU, reduced on the host and written back once
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs, a multiple of 8
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
+ */
+void
+pidcomm_host_all_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t size, uint32_t reduce_type);
+
+/**
+ * @brief all_reduce(SUM) of int32 data exchanged as int8 or int16 words. Every DPU quantizes each block of quant_block
+ * words with its own power-of-two scale, so the host streams 4x (int8) or 2x (int16) fewer bytes, decodes the words
+ * of every DPU with its scales and sums them in 64 bits. The reduced chunks are quantized again for the allgather.
+ * The start data is left intact: the scales and the quantized words are staged in regions of pidcomm_mram_alloc().
+ * When the error of the quantized result would exceed max_error, or the set has partial ranks, the int32 words are
+ * exchanged exactly instead.
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer of the exact exchange in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from
+ *        pidcomm_mram_alloc()
+ * @param quant_type PIDCOMM_INT8 or PIDCOMM_INT16, the accuracy of the exchanged words
+ * @param quant_block the int32 words sharing a scale, a multiple of 8 up to PIDCOMM_QUANT_MAX_BLOCK. Smaller blocks follow
+ *        the magnitudes of the data more closely, at one byte of scale per block
+ * @param max_error the largest absolute error accepted for a result word, UINT64_MAX to always quantize
+ * @param error_bound if not NULL, receives the largest absolute error of a result word, 0 when the words were exchanged exactly
+ */
+void
+pidcomm_all_reduce_quantized(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset,
+                    uint32_t quant_type, uint32_t quant_block, uint64_t max_error, uint64_t* error_bound);
+
+/**
+ * @brief reduce_scatter(SUM) of int32 data exchanged as int8 or int16 words, see pidcomm_all_reduce_quantized()
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer of the exact exchange in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from
+ *        pidcomm_mram_alloc()
+ * @param quant_type PIDCOMM_INT8 or PIDCOMM_INT16, the accuracy of the exchanged words
+ * @param quant_block the int32 words sharing a scale, a multiple of 8 up to PIDCOMM_QUANT_MAX_BLOCK
+ * @param max_error the largest absolute error accepted for a result word, UINT64_MAX to always quantize
+ * @param error_bound if not NULL, receives the largest absolute error of a result word, 0 when the words were exchanged exactly
+ */
+void
+pidcomm_reduce_scatter_quantized(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset,
+                    uint32_t quant_type, uint32_t quant_block, uint64_t max_error, uint64_t* error_bound);
+
+/**
+ * @brief all_reduce() of mostly-zero data. Every DPU compacts its data into a bitmap of the nonzero blocks of
+ * PIDCOMM_SPARSE_BLOCK bytes followed by the nonzero blocks, so the host reads only the nonzero blocks of each DPU
+ * and merges only the blocks nonzero on a member. Zero blocks enter the reduction as zeros.
+ * A sparse result is written in the same format: the number of nonzero blocks (uint64), the bitmap padded to 64-bit
+ * words, and the nonzero blocks in order. Nothing is written past the nonzero blocks of a DPU.
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs, a multiple of PIDCOMM_SPARSE_BLOCK
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the offset from start_offset where the data is compacted, total_data_size bytes after a header of 8 bytes and one bit per block, or PIDCOMM_AUTO_BUFFER
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
+ * @param sparse_output write the result in the sparse format instead of dense
+ */
+void
+pidcomm_sparse_all_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type, bool sparse_output);
+
+/**
+ * @brief reduce_scatter() of mostly-zero data, see pidcomm_sparse_all_reduce()
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs, with chunks that are multiples of PIDCOMM_SPARSE_BLOCK
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the offset from start_offset where the data is compacted, total_data_size bytes after a header of 8 bytes and one bit per block, or PIDCOMM_AUTO_BUFFER
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
+ * @param sparse_output write the chunk in the sparse format instead of dense
+ */
+void
+pidcomm_sparse_reduce_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type, bool sparse_output);
+
+/**
+ * @brief allgather() of mostly-zero data, see pidcomm_sparse_all_reduce(). As in allgather(), total_data_size is the
+ * gathered size and every DPU contributes total_data_size / (DPUs of the communicator) bytes from start_offset
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes gathered on each DPU, whose chunk per DPU is a multiple of PIDCOMM_SPARSE_BLOCK
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the offset from start_offset where the chunk is compacted, the chunk size after a header of 8 bytes and one bit per block, or PIDCOMM_AUTO_BUFFER
+ * @param sparse_output write the gathered data in the sparse format instead of dense
+ */
+void
+pidcomm_sparse_allgather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset, bool sparse_output);
+
+/**
+ * @brief alltoall() whose result overwrites the data, with no communication buffer. The chunks of each DPU are
+ * permuted in place, and the rotate-and-stream pass swaps the line of DPU s holding the chunk for DPU d with the
+ * line of d holding the chunk for s. Shapes whose first axis does not fill whole rotate groups are combined on the host.
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param offset the byte offset from the DPU's MRAM address of the data and of the result
+ */
+void
+pidcomm_alltoall_inplace(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t offset);
+
+/**
+ * @brief create a persistent plan for alltoall(). The plan can be executed any number of times with pidcomm_execute()
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @return the plan, to be released with pidcomm_plan_free()
+ */
+pidcomm_plan_t*
+pidcomm_plan_alltoall(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset);
+
+/**
+ * @brief create a persistent plan for reduce_scatter(). The plan can be executed any number of times with pidcomm_execute()
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
+ * @return the plan, to be released with pidcomm_plan_free()
+ */
+pidcomm_plan_t*
+pidcomm_plan_reduce_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type);
+
+/**
+ * @brief create a persistent plan for all_reduce(). The plan can be executed any number of times with pidcomm_execute()
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
+ * @return the plan, to be released with pidcomm_plan_free()
+ */
+pidcomm_plan_t*
+pidcomm_plan_all_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type);
+
+/**
+ * @brief create an all_reduce() plan that is executed in stages of whole ranks. The relocation kernels of the next and
+ * previous stages run on their DPUs while the host streams the current stage. The host cannot stream the MRAM of DPUs
+ * that are running, so the data is not split into byte segments, which would keep the same ranks busy in every step.
+ * When the outermost axis of the hypercube communicates, every communicator spans all ranks and the plan runs in a
+ * single stage, without overlap; this is reported on stderr and by pidcomm_plan_nr_stages().
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
+ * @param nr_stages the maximum number of stages, lowered until it divides the ranks and the outermost axis
+ * @return the plan, to be released with pidcomm_plan_free()
+ */
+pidcomm_plan_t*
+pidcomm_plan_all_reduce_pipelined(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type, uint32_t nr_stages);
+
+/**
+ * @brief number of stages a plan is executed in
+ * @param plan the plan
+ * @return 1 unless the plan was created by pidcomm_plan_all_reduce_pipelined() and could be split
+ */
+uint32_t
+pidcomm_plan_nr_stages(pidcomm_plan_t* plan);
+
+/**
+ * @brief create a persistent plan for allgather(). The plan can be executed any number of times with pidcomm_execute()
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @return the plan, to be released with pidcomm_plan_free()
+ */
+pidcomm_plan_t*
+pidcomm_plan_allgather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset);
+
+/**
+ * @brief execute a collective plan
+ * @param plan the plan created by one of the pidcomm_plan_* functions
+ */
+void
+pidcomm_execute(pidcomm_plan_t* plan);
+
+/**
+ * @brief release a collective plan and the buffers it owns
+ * @param plan the plan created by one of the pidcomm_plan_* functions
+ */
+void
+pidcomm_plan_free(pidcomm_plan_t* plan);
+
+/**
+ * @brief start alltoall() without waiting for it. Collectives that were not waited for run one after the other, in the order they were started.
+ *        The DPUs of the hypercube must not be used until the request completes; blocking collectives wait for the pending requests first.
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @return the request, to be completed with pidcomm_test(), pidcomm_wait() or pidcomm_waitall()
+ */
+pidcomm_request_t*
+pidcomm_ialltoall(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset);
+
+/**
+ * @brief start a group of collectives. Until the matching pidcomm_group_end(), pidcomm_alltoall(), pidcomm_reduce_scatter(),
+ * pidcomm_all_reduce() and pidcomm_allgather() are recorded instead of executed. Any other PID-Comm call first executes
+ * the collectives recorded so far. Groups can be nested
+ */
+void
+pidcomm_group_start(void);
+
+/**
+ * @brief execute the collectives recorded since the outermost pidcomm_group_start(). The recorded collectives must not
+ * depend on each other: those with the same primitive, communicator, data type and operator run together, at the place
+ * of the first of them. All-reduces of neighbouring slices (the start and target offsets of each one follow those of
+ * another) with the same buffer offset run as a single all_reduce(). Collectives whose buffer_offset is
+ * PIDCOMM_AUTO_BUFFER are fused into one collective on a staging area borrowed from pidcomm_mram_alloc(): one
+ * relocation launch packs their chunks, one rotate-and-stream pass moves them and one launch copies the results to
+ * their targets
+ */
+void
+pidcomm_group_end(void);
+
+/**
+ * @brief start reduce_scatter() without waiting for it, see pidcomm_ialltoall()
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
+ * @return the request, to be completed with pidcomm_test(), pidcomm_wait() or pidcomm_waitall()
+ */
+pidcomm_request_t*
+pidcomm_ireduce_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type);
+
+/**
+ * @brief start all_reduce() without waiting for it, see pidcomm_ialltoall()
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @param size the data type (PIDCOMM_DTYPE), or the size of an integer datatype
+ * @param reduce_type the reduction operator (PIDCOMM_OPERATOR)
+ * @return the request, to be completed with pidcomm_test(), pidcomm_wait() or pidcomm_waitall()
+ */
+pidcomm_request_t*
+pidcomm_iall_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type);
+
+/**
+ * @brief start allgather() without waiting for it, see pidcomm_ialltoall()
+ * @param manager the hypercube manager that contains information about the hypercube
+ * @param comm the bitmap string that contains the target dimensions
+ * @param total_data_size the number of bytes for each DPUs
+ * @param start_offset the byte offset from the DPU's MRAM address where the data is copied
+ * @param target_offset the byte offset from the DPU's MRAM address where to copy the data
+ * @param buffer_offset the size of the buffer in bytes, or PIDCOMM_AUTO_BUFFER to borrow it from pidcomm_mram_alloc()
+ * @return the request, to be completed with pidcomm_test(), pidcomm_wait() or pidcomm_waitall()
+ */
+pidcomm_request_t*
+pidcomm_iallgather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset);
+
+/**
+ * @brief start a collective plan without waiting for it, see pidcomm_ialltoall(). The plan must not be freed until the request completes.
+ * @param plan the plan created by one of the pidcomm_plan_* functions
+ * @return the request, to be completed with pidcomm_test(), pidcomm_wait() or pidcomm_waitall()
+ */
+pidcomm_request_t*
+pidcomm_start(pidcomm_plan_t* plan);
+
+/**
+ * @brief check whether a non-blocking collective has completed. A completed request is released and must not be used again.
+ * @param request the request returned by pidcomm_start() or one of the pidcomm_i* functions
+ * @return true if the collective has completed
+ */
+bool
+pidcomm_test(pidcomm_request_t* request);
+
+/**
+ * @brief wait for a non-blocking collective to complete and release the request
+ * @param request the request returned by pidcomm_start() or one of the pidcomm_i* functions
+ */
+void
+pidcomm_wait(pidcomm_request_t* request);
+
+/**
+ * @brief wait for several non-blocking collectives to complete and release their requests
+ * @param nr_requests the number of requests
+ * @param requests the requests returned by pidcomm_start() or the pidcomm_i* functions
+ */
+void
+pidcomm_waitall(uint32_t nr_requests, pidcomm_request_t** requests);
+
 #endif
\ No newline at end of file
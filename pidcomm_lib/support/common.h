@@ -28,6 +28,47 @@
 #define DIV 3 // Shift right to divide by sizeof(T)
 #endif
 
+/* Largest number of int32 words sharing a scale in the quantized collectives, 2KB per DMA transfer */
+#define QUANT_MAX_BLOCK 512
+
+/* Bytes of a block of the sparse collectives */
+#define SPARSE_BLOCK 64
+
+/* Copy of length bytes from src_offset to dst_offset, for the grouped collectives */
+typedef struct {
+    uint32_t src_offset;
+    uint32_t dst_offset;
+    uint32_t length;
+    uint32_t padding;
+} copy_segment_t;
+
+/* Bytes exchanged with a peer and where they sit in the packed area, for alltoallv */
+typedef struct {
+    uint32_t count;
+    uint32_t slot;
+} count_slot_t;
+
+/* Relocation schemes implemented by the resident data_relocate binary */
+typedef enum {
+    RELOCATE_CLOCKWISE = 0,
+    RELOCATE_REVERSE_CLOCKWISE,
+    RELOCATE_COUNTERCLOCKWISE,
+    RELOCATE_INCREMENTAL_COUNTERCLOCKWISE,
+    RELOCATE_MODIFIED_CLOCKWISE,
+    RELOCATE_CLOCKWISE_SHORT,
+    RELOCATE_MODIFIED_REVERSE_CLOCKWISE,
+    RELOCATE_REVERSE_CLOCKWISE_SHORT,
+    RELOCATE_QUANT_BLOCK_MAX, //largest magnitude of each block of each chunk of int32 words, at target_offset
+    RELOCATE_QUANTIZE, //int32 chunks to int8/int16 slots, every block with its own power-of-two scale
+    RELOCATE_DEQUANTIZE, //int8/int16 slots back to int32 chunks
+    RELOCATE_SPARSE_COMPACT, //bitmap of the nonzero blocks followed by the nonzero blocks
+    RELOCATE_COPY_SEGMENTS, //table of copy_segment_t, for the grouped collectives
+    RELOCATE_CYCLE_CLOCKWISE, //RELOCATE_CLOCKWISE within start_offset, following the cycles of the permutation
+    RELOCATE_CYCLE_REVERSE_CLOCKWISE, //RELOCATE_REVERSE_CLOCKWISE within start_offset, likewise
+    RELOCATE_PACK_COUNTS, //chunks of the counts in the table at table_offset, to their slots
+    RELOCATE_UNPACK_COUNTS, //chunks back from their slots, one after the other
+} relocate_mode_t;
+
 /* Structures used by both the host and the dpu to communicate information */
 typedef struct {
     uint32_t start_offset;
@@ -40,6 +81,10 @@ typedef struct {
     uint32_t comm_type;
     uint32_t a_length;
     uint32_t num_comm_rg;
+    uint32_t mode;
+    uint32_t quant_size; //bytes of a quantized word
+    uint32_t quant_block; //int32 words sharing a scale, a multiple of 8 up to QUANT_MAX_BLOCK
+    uint32_t table_offset; //count_slot_t of each peer, for the pack, unpack and quantization modes
 } dpu_arguments_comm_t;
 
 
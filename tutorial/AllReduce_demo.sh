@@ -1,4 +1,5 @@
 #source ../upmem-2021.3.0_opt/upmem_env.sh
 dpu-upmem-dpurte-clang -Wall -Wextra -g -Isupport -O2 -DNR_TASKLETS=16 -o bin/dpu_user dpu_user.c
+dpu-upmem-dpurte-clang -g -O2 -DNR_TASKLETS=16 -DINT64 -o bin/data_relocate ../pidcomm_lib/data_relocate/data_relocate.c
 gcc --std=c99 -o bin/example_allreduce example_allreduce.c -DT=int32_t -DF=int32_t -DUPMEM_HOME=UPMEM_HOME -fopenmp `dpu-pkg-config --cflags --libs dpu`
 ./bin/example_allreduce
\ No newline at end of file
@@ -18,6 +18,20 @@
  * @brief C API for DPU program operations.
  */
 
+/**
+ * @brief An IRAM or WRAM segment of a DPU program, as written by the loader.
+ */
+struct dpu_program_segment_t {
+    /** Whether the segment targets IRAM (WRAM otherwise). */
+    bool is_iram;
+    /** Start address, in instructions for IRAM and in words for WRAM. */
+    uint32_t address;
+    /** Size, in instructions for IRAM and in words for WRAM. */
+    uint32_t size;
+    /** Patched content of the segment. */
+    void *content;
+};
+
 /**
  * @brief Information from a DPU program.
  */
@@ -57,6 +71,11 @@ struct dpu_program_t {
 
     /** Path to the DPU program binary if it exists, NULL otherwise. */
     char *program_path;
+
+    /** Number of cached IRAM and WRAM segments. */
+    uint32_t nr_segments;
+    /** IRAM and WRAM image cached when loading, used by dpu_restore_program. NULL if the image could not be cached. */
+    struct dpu_program_segment_t *segments;
 };
 
 /**
@@ -96,6 +115,16 @@ dpu_get_program(struct dpu_t *dpu);
 void
 dpu_set_program(struct dpu_t *dpu, struct dpu_program_t *program);
 
+/**
+ * @brief Writes the cached IRAM and WRAM image of a program back to the DPUs of the set, without reading its ELF again.
+ *        MRAM is left untouched. If the program has no cached image, it is loaded again from its path.
+ * @param dpu_set the identifier of the DPU set
+ * @param program the program, which must have been loaded with dpu_load or dpu_load_from_memory
+ * @return Whether the operation was successful.
+ */
+dpu_error_t
+dpu_restore_program(struct dpu_set_t dpu_set, struct dpu_program_t *program);
+
 /**
  * @param elf_info raw ELF information on the program stored when loading
  * @param path the path to print for debug purpose
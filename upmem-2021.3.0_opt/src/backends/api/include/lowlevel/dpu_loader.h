@@ -99,4 +99,16 @@ dpu_loader_fill_rank_context(dpu_loader_context_t context, struct dpu_rank_t *ra
 dpu_error_t
 dpu_elf_load(dpu_elf_file_t file, dpu_loader_context_t context);
 
+/**
+ * @brief Stores in the program the IRAM and WRAM content that dpu_elf_load writes for the specified ELF file,
+ *        so that dpu_restore_program can write it again without reading the ELF file.
+ *        Nothing is cached when the IRAM must be patched for profiling or when the file is a core dump.
+ * @param file the ELF file of the program
+ * @param rank a DPU rank the program is loaded on, used to patch the content
+ * @param program the program in which the image is stored
+ * @return Whether the operation was successful.
+ */
+dpu_error_t
+dpu_elf_cache_image(dpu_elf_file_t file, struct dpu_rank_t *rank, struct dpu_program_t *program);
+
 #endif // DPU_LOADER_H
@@ -12,6 +12,7 @@
 #include <dpu_error.h>
 #include <dpu_description.h>
 #include <dpu_management.h>
+#include <dpu_memory.h>
 #include <dpu_loader.h>
 #include <dpu_internals.h>
 #include <dpu_program.h>
@@ -110,6 +111,125 @@ end:
     return status;
 }
 
+static dpu_error_t
+restore_segments_for_rank(struct dpu_rank_t *rank, struct dpu_program_t *program)
+{
+    dpu_error_t status = DPU_OK;
+
+    for (uint32_t each_segment = 0; each_segment < program->nr_segments; ++each_segment) {
+        struct dpu_program_segment_t *segment = &program->segments[each_segment];
+
+        if (segment->size == 0)
+            continue;
+
+        if (segment->is_iram) {
+            status = dpu_copy_to_iram_for_rank(rank, (iram_addr_t)segment->address, segment->content, (iram_size_t)segment->size);
+        } else {
+            status = dpu_copy_to_wram_for_rank(rank, (wram_addr_t)segment->address, segment->content, (wram_size_t)segment->size);
+        }
+        if (status != DPU_OK) {
+            break;
+        }
+    }
+
+    return status;
+}
+
+dpu_error_t
+dpu_restore_rank(struct dpu_rank_t *rank, struct dpu_program_t *program)
+{
+    dpu_error_t status;
+    dpu_description_t description = dpu_get_description(rank);
+    uint8_t nr_of_control_interfaces = description->hw.topology.nr_of_control_interfaces;
+    uint8_t nr_of_dpus_per_control_interface = description->hw.topology.nr_of_dpus_per_control_interface;
+
+    if ((status = dpu_fill_profiling_info(rank,
+             (iram_addr_t)program->mcount_address,
+             (iram_addr_t)program->ret_mcount_address,
+             (wram_addr_t)program->thread_profiling_address,
+             (wram_addr_t)program->perfcounter_end_value_address,
+             program->profiling_symbols))
+        != DPU_OK) {
+        goto end;
+    }
+
+    dpu_lock_rank(rank);
+
+    if ((status = restore_segments_for_rank(rank, program)) != DPU_OK) {
+        goto unlock_rank;
+    }
+
+    for (dpu_slice_id_t each_slice = 0; each_slice < nr_of_control_interfaces; ++each_slice) {
+        for (dpu_member_id_t each_dpu = 0; each_dpu < nr_of_dpus_per_control_interface; ++each_dpu) {
+            struct dpu_t *dpu = DPU_GET_UNSAFE(rank, each_slice, each_dpu);
+
+            if (!dpu->enabled)
+                continue;
+
+            struct dpu_program_t *previous_program = dpu_get_program(dpu);
+            dpu_take_program_ref(program);
+            dpu_free_program(previous_program);
+            dpu_set_program(dpu, program);
+        }
+    }
+
+unlock_rank:
+    dpu_unlock_rank(rank);
+end:
+    return status;
+}
+
+static dpu_error_t
+dpu_restore_dpu(struct dpu_t *dpu, struct dpu_program_t *program)
+{
+    dpu_error_t status = DPU_OK;
+
+    if (!dpu->enabled) {
+        status = DPU_ERR_DPU_DISABLED;
+        goto end;
+    }
+
+    struct dpu_rank_t *rank = dpu_get_rank(dpu);
+
+    if ((status = dpu_fill_profiling_info(rank,
+             (iram_addr_t)program->mcount_address,
+             (iram_addr_t)program->ret_mcount_address,
+             (wram_addr_t)program->thread_profiling_address,
+             (wram_addr_t)program->perfcounter_end_value_address,
+             program->profiling_symbols))
+        != DPU_OK) {
+        goto end;
+    }
+
+    dpu_lock_rank(rank);
+
+    for (uint32_t each_segment = 0; each_segment < program->nr_segments; ++each_segment) {
+        struct dpu_program_segment_t *segment = &program->segments[each_segment];
+
+        if (segment->size == 0)
+            continue;
+
+        if (segment->is_iram) {
+            status = dpu_copy_to_iram_for_dpu(dpu, (iram_addr_t)segment->address, segment->content, (iram_size_t)segment->size);
+        } else {
+            status = dpu_copy_to_wram_for_dpu(dpu, (wram_addr_t)segment->address, segment->content, (wram_size_t)segment->size);
+        }
+        if (status != DPU_OK) {
+            goto unlock_rank;
+        }
+    }
+
+    struct dpu_program_t *previous_program = dpu_get_program(dpu);
+    dpu_take_program_ref(program);
+    dpu_free_program(previous_program);
+    dpu_set_program(dpu, program);
+
+unlock_rank:
+    dpu_unlock_rank(rank);
+end:
+    return status;
+}
+
 typedef dpu_error_t (*load_elf_program_fct_t)(dpu_elf_file_t *elf_info,
     const char *path,
     uint8_t *buffer,
@@ -117,21 +237,27 @@ typedef dpu_error_t (*load_elf_program_fct_t)(dpu_elf_file_t *elf_info,
     struct dpu_program_t *program,
     mram_size_t mram_size_hint);
 
-static dpu_description_t
-get_set_description(struct dpu_set_t *set)
+static struct dpu_rank_t *
+get_set_rank(struct dpu_set_t *set)
 {
-    struct dpu_rank_t *rank = NULL;
-
     switch (set->kind) {
         case DPU_SET_RANKS:
-            rank = set->list.ranks[0];
-            break;
+            return set->list.ranks[0];
         case DPU_SET_DPU:
-            rank = set->dpu->rank;
-            break;
+            return set->dpu->rank;
         default:
             return NULL;
     }
+}
+
+static dpu_description_t
+get_set_description(struct dpu_set_t *set)
+{
+    struct dpu_rank_t *rank = get_set_rank(set);
+
+    if (rank == NULL) {
+        return NULL;
+    }
 
     return dpu_get_description(rank);
 }
@@ -153,6 +279,8 @@ dpu_load_generic(struct dpu_set_t dpu_set,
         goto end;
     }
     dpu_init_program_ref(runtime);
+    runtime->nr_segments = 0;
+    runtime->segments = NULL;
 
     dpu_description_t description = get_set_description(&dpu_set);
 
@@ -199,6 +327,11 @@ dpu_load_generic(struct dpu_set_t dpu_set,
             goto free_runtime;
     }
 
+    /* The cached image is an optimization for dpu_restore_program, the load succeeded without it */
+    if (dpu_elf_cache_image(elf_info, get_set_rank(&dpu_set), runtime) != DPU_OK) {
+        LOG_FN(WARNING, "could not cache the program image, dpu_restore_program will load \"%s\" again", path);
+    }
+
     if (program != NULL) {
         *program = runtime;
     }
@@ -258,3 +391,44 @@ dpu_load(struct dpu_set_t dpu_set, const char *binary_path, struct dpu_program_t
 
     return dpu_load_generic(dpu_set, binary_path, NULL, 0, program, __dpu_load_elf_program);
 }
+
+__API_SYMBOL__ dpu_error_t
+dpu_restore_program(struct dpu_set_t dpu_set, struct dpu_program_t *program)
+{
+    LOG_FN(DEBUG, "%p", program);
+
+    dpu_error_t status = DPU_OK;
+
+    if (program->segments == NULL) {
+        if (program->program_path == NULL) {
+            return DPU_ERR_NO_PROGRAM_LOADED;
+        }
+        return dpu_load(dpu_set, program->program_path, NULL);
+    }
+
+    switch (dpu_set.kind) {
+        case DPU_SET_RANKS: {
+            uint32_t nr_jobs_per_rank;
+            struct dpu_thread_job_sync sync;
+            DPU_THREAD_JOB_GET_JOBS(
+                dpu_set.list.ranks, dpu_set.list.nr_ranks, nr_jobs_per_rank, jobs, &sync, true /*sync*/, status);
+
+            struct dpu_rank_t *rank __attribute__((unused));
+            struct dpu_thread_job *job;
+            DPU_THREAD_JOB_SET_JOBS(dpu_set.list.ranks, rank, dpu_set.list.nr_ranks, jobs, job, &sync, true /*sync*/, {
+                job->type = DPU_THREAD_JOB_RESTORE;
+                job->load_info.runtime = program;
+            });
+
+            status = dpu_thread_job_do_jobs(dpu_set.list.ranks, dpu_set.list.nr_ranks, nr_jobs_per_rank, jobs, true, &sync);
+        } break;
+        case DPU_SET_DPU:
+            status = dpu_restore_dpu(dpu_set.dpu, program);
+            break;
+        default:
+            status = DPU_ERR_INTERNAL;
+            break;
+    }
+
+    return status;
+}
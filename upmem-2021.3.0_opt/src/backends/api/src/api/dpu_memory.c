@@ -18,6 +18,8 @@
 #include <dpu_thread_job.h>
 
 #include <stdint.h>
+#include <string.h>
+#include <pthread.h>
 #include <sys/time.h>
 #define T int32_t
 
@@ -773,23 +775,13 @@ dpu_RNS_symbol(
 }
 
 //gather
-/*__API_SYMBOL__ dpu_error_t
+__API_SYMBOL__ dpu_error_t
 gather(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, void ** host_buffer)
 {
     dpu_error_t status = DPU_OK;
     struct dpu_rank_t *rank_set = comm_dpu_set->list.ranks[0];
     status = rank_set->handler_context->handler->gather_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, comm_type, communication_buffer_offset, dimension, axis_len, comm_axis, host_buffer);
     return status;
-}*/
-
-__API_SYMBOL__ dpu_error_t
-gather(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, void ** host_buffer)
-{
-    dpu_error_t status = DPU_OK;
-    dimension+=0; alltoall_comm_type+=0; comm_axis[0]+=0;
-    struct dpu_rank_t *rank_set = comm_dpu_set->list.ranks[0];
-    status = rank_set->handler_context->handler->gather_x_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, axis_len[0], axis_len[1], axis_len[2], 0, communication_buffer_offset, host_buffer);
-    return status;
 }
 
 __API_SYMBOL__ dpu_error_t
@@ -830,11 +822,11 @@ gather_xz(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t ds
 
 //reduce
 __API_SYMBOL__ dpu_error_t
-reduce(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t total_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t data_type, void ** host_buffer)
+reduce(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t total_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t data_type, uint32_t reduce_type, void ** host_buffer)
 {
     dpu_error_t status = DPU_OK;
     struct dpu_rank_t *rank_set = comm_dpu_set->list.ranks[0];
-    status = rank_set->handler_context->handler->reduce_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, total_length, comm_type, communication_buffer_offset, dimension, axis_len, comm_axis, data_type, host_buffer);
+    status = rank_set->handler_context->handler->reduce_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, total_length, comm_type, communication_buffer_offset, dimension, axis_len, comm_axis, data_type, reduce_type, host_buffer);
     return status;
 }
 
@@ -885,29 +877,29 @@ scatter_y(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t ds
 }
 
 __API_SYMBOL__ dpu_error_t
-reduce_scatter(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size)
+reduce_scatter(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size, uint32_t reduce_type)
 {
     dpu_error_t status = DPU_OK;
     struct dpu_rank_t *rank_set = comm_dpu_set->list.ranks[0];
-    status = rank_set->handler_context->handler->reduce_scatter_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, comm_type, communication_buffer_offset, dimension, axis_len, comm_axis, size);
+    status = rank_set->handler_context->handler->reduce_scatter_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, comm_type, communication_buffer_offset, dimension, axis_len, comm_axis, size, reduce_type);
     return status;
 }
 
 __API_SYMBOL__ dpu_error_t
-reduce_scatter_cpu_x(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size)
+reduce_scatter_cpu_x(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type)
 {
     dpu_error_t status = DPU_OK;
     struct dpu_rank_t *rank_set = comm_dpu_set->list.ranks[0];
-    status = rank_set->handler_context->handler->reduce_scatter_cpu_x_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, a, b, c, alltoall_comm_type, communication_buffer_offset, size);
+    status = rank_set->handler_context->handler->reduce_scatter_cpu_x_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, a, b, c, alltoall_comm_type, communication_buffer_offset, size, reduce_type);
     return status;
 }
 
 __API_SYMBOL__ dpu_error_t
-reduce_scatter_cpu_y(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size)
+reduce_scatter_cpu_y(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type)
 {
     dpu_error_t status = DPU_OK;
     struct dpu_rank_t *rank_set = comm_dpu_set->list.ranks[0];
-    status = rank_set->handler_context->handler->reduce_scatter_cpu_y_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, a, b, c, alltoall_comm_type, communication_buffer_offset, size);
+    status = rank_set->handler_context->handler->reduce_scatter_cpu_y_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, a, b, c, alltoall_comm_type, communication_buffer_offset, size, reduce_type);
     return status;
 }
 
@@ -1028,90 +1020,79 @@ all_to_all_z(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t
     return status;
 }
 
+__API_SYMBOL__ dpu_error_t
+all_to_all_inplace(struct dpu_set_t *comm_dpu_set, uint32_t start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis)
+{
+    dpu_error_t status = DPU_OK;
+    struct dpu_rank_t *rank_set = comm_dpu_set->list.ranks[0];
+    status = rank_set->handler_context->handler->all_to_all_inplace_rns(comm_dpu_set, start_offset, byte_length, comm_type, dimension, axis_len, comm_axis);
+    return status;
+}
 
+//point-to-point
+__API_SYMBOL__ dpu_error_t
+permute(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t* source)
+{
+    dpu_error_t status = DPU_OK;
+    struct dpu_rank_t *rank_set = comm_dpu_set->list.ranks[0];
+    status = rank_set->handler_context->handler->permute_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, source);
+    return status;
+}
 
-/*PID-Comm*/
-#ifndef DPU_BINARY_RELOCATE_CLOCKWISE
-#define DPU_BINARY_RELOCATE_CLOCKWISE "./bin/data_relocate_clockwise"
-#endif
-#ifndef DPU_BINARY_RELOCATE_CLOCKWISE_INT8
-#define DPU_BINARY_RELOCATE_CLOCKWISE_INT8 "./bin/data_relocate_clockwise_int8"
-#endif
-#ifndef DPU_BINARY_RELOCATE_CLOCKWISE_INT32
-#define DPU_BINARY_RELOCATE_CLOCKWISE_INT32 "./bin/data_relocate_clockwise_int32"
-#endif
-
-#ifndef DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE
-#define DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE "./bin/data_relocate_reverse_clockwise"
-#endif
-#ifndef DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_INT8
-#define DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_INT8 "./bin/data_relocate_reverse_clockwise_int8"
-#endif
-#ifndef DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_INT32
-#define DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_INT32 "./bin/data_relocate_reverse_clockwise_int32"
-#endif
-
-#ifndef DPU_BINARY_RELOCATE_COUNTERCLOCKWISE
-#define DPU_BINARY_RELOCATE_COUNTERCLOCKWISE "./bin/data_relocate_counterclockwise"
-#endif
-#ifndef DPU_BINARY_RELOCATE_COUNTERCLOCKWISE_INT8
-#define DPU_BINARY_RELOCATE_COUNTERCLOCKWISE_INT8 "./bin/data_relocate_counterclockwise_int8"
-#endif
-#ifndef DPU_BINARY_RELOCATE_COUNTERCLOCKWISE_INT32
-#define DPU_BINARY_RELOCATE_COUNTERCLOCKWISE_INT32 "./bin/data_relocate_counterclockwise_int32"
-#endif
+__API_SYMBOL__ dpu_error_t
+transpose(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t num_tiles, uint32_t num_rg, uint32_t* tile_src_rg, uint32_t* tile_dst_rg, uint32_t swap, uint32_t rows, uint32_t cols, uint32_t size)
+{
+    dpu_error_t status = DPU_OK;
+    struct dpu_rank_t *rank_set = comm_dpu_set->list.ranks[0];
+    status = rank_set->handler_context->handler->transpose_rns(comm_dpu_set, src_start_offset, dst_start_offset, byte_length, num_tiles, num_rg, tile_src_rg, tile_dst_rg, swap, rows, cols, size);
+    return status;
+}
 
-#ifndef DPU_BINARY_RELOCATE_INCREMENTAL_COUNTERCLOCKWISE
-#define DPU_BINARY_RELOCATE_INCREMENTAL_COUNTERCLOCKWISE "./bin/data_relocate_incremental_counterclockwise"
-#endif
-#ifndef DPU_BINARY_RELOCATE_INCREMENTAL_COUNTERCLOCKWISE_INT8
-#define DPU_BINARY_RELOCATE_INCREMENTAL_COUNTERCLOCKWISE_INT8 "./bin/data_relocate_incremental_counterclockwise_int8"
-#endif
-#ifndef DPU_BINARY_RELOCATE_INCREMENTAL_COUNTERCLOCKWISE_INT32
-#define DPU_BINARY_RELOCATE_INCREMENTAL_COUNTERCLOCKWISE_INT32 "./bin/data_relocate_incremental_counterclockwise_int32"
-#endif
+__API_SYMBOL__ dpu_error_t
+all_to_all_v(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t num_passes, uint32_t* passes)
+{
+    dpu_error_t status = DPU_OK;
+    struct dpu_rank_t *rank_set = comm_dpu_set->list.ranks[0];
+    status = rank_set->handler_context->handler->all_to_all_v_rns(comm_dpu_set, src_start_offset, dst_start_offset, num_passes, passes);
+    return status;
+}
 
-#ifndef DPU_BINARY_RELOCATE_MODIFIED_CLOCKWISE
-#define DPU_BINARY_RELOCATE_MODIFIED_CLOCKWISE "./bin/data_relocate_modified_clockwise"
-#endif
-#ifndef DPU_BINARY_RELOCATE_MODIFIED_CLOCKWISE_INT8
-#define DPU_BINARY_RELOCATE_MODIFIED_CLOCKWISE_INT8 "./bin/data_relocate_modified_clockwise_int8"
-#endif
-#ifndef DPU_BINARY_RELOCATE_MODIFIED_CLOCKWISE_INT32
-#define DPU_BINARY_RELOCATE_MODIFIED_CLOCKWISE_INT32 "./bin/data_relocate_modified_clockwise_int32"
-#endif
+__API_SYMBOL__ dpu_error_t
+reduce_quantized(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t chunk_words, uint32_t quant_size, uint32_t quant_block, uint32_t* source_start, uint32_t* sources)
+{
+    dpu_error_t status = DPU_OK;
+    struct dpu_rank_t *rank_set = comm_dpu_set->list.ranks[0];
+    status = rank_set->handler_context->handler->reduce_quantized_rns(comm_dpu_set, src_start_offset, dst_start_offset, chunk_words, quant_size, quant_block, source_start, sources);
+    return status;
+}
 
-#ifndef DPU_BINARY_RELOCATE_CLOCKWISE_SHORT
-#define DPU_BINARY_RELOCATE_CLOCKWISE_SHORT "./bin/data_relocate_clockwise_short"
-#endif
-#ifndef DPU_BINARY_RELOCATE_CLOCKWISE_SHORT_INT8
-#define DPU_BINARY_RELOCATE_CLOCKWISE_SHORT_INT8 "./bin/data_relocate_clockwise_short_int8"
-#endif
-#ifndef DPU_BINARY_RELOCATE_CLOCKWISE_SHORT_INT32
-#define DPU_BINARY_RELOCATE_CLOCKWISE_SHORT_INT32 "./bin/data_relocate_clockwise_short_int32"
-#endif
 
-#ifndef DPU_BINARY_RELOCATE_MODIFIED_REVERSE_CLOCKWISE
-#define DPU_BINARY_RELOCATE_MODIFIED_REVERSE_CLOCKWISE "./bin/data_relocate_modified_reverse_clockwise"
-#endif
-#ifndef DPU_BINARY_RELOCATE_MODIFIED_REVERSE_CLOCKWISE_INT8
-#define DPU_BINARY_RELOCATE_MODIFIED_REVERSE_CLOCKWISE_INT8 "./bin/data_relocate_modified_reverse_clockwise"
-#endif
-#ifndef DPU_BINARY_RELOCATE_MODIFIED_REVERSE_CLOCKWISE_INT32
-#define DPU_BINARY_RELOCATE_MODIFIED_REVERSE_CLOCKWISE_INT32 "./bin/data_relocate_modified_reverse_clockwise"
-#endif
 
-#ifndef DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_SHORT
-#define DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_SHORT "./bin/data_relocate_reverse_clockwise_short"
-#endif
-#ifndef DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_SHORT_INT8
-#define DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_SHORT_INT8 "./bin/data_relocate_reverse_clockwise_short_int8"
-#endif
-#ifndef DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_SHORT_INT32
-#define DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_SHORT_INT32 "./bin/data_relocate_reverse_clockwise_short_int32"
+/*PID-Comm*/
+#ifndef DPU_BINARY_RELOCATE
+#define DPU_BINARY_RELOCATE "./bin/data_relocate"
 #endif
 
-
+/* Relocation schemes implemented by the resident data_relocate binary */
+typedef enum {
+    RELOCATE_CLOCKWISE = 0,
+    RELOCATE_REVERSE_CLOCKWISE,
+    RELOCATE_COUNTERCLOCKWISE,
+    RELOCATE_INCREMENTAL_COUNTERCLOCKWISE,
+    RELOCATE_MODIFIED_CLOCKWISE,
+    RELOCATE_CLOCKWISE_SHORT,
+    RELOCATE_MODIFIED_REVERSE_CLOCKWISE,
+    RELOCATE_REVERSE_CLOCKWISE_SHORT,
+    RELOCATE_QUANT_BLOCK_MAX, //largest magnitude of each block of each chunk of int32 words, at target_offset
+    RELOCATE_QUANTIZE, //int32 chunks to int8/int16 slots, every block with its own power-of-two scale
+    RELOCATE_DEQUANTIZE, //int8/int16 slots back to int32 chunks
+    RELOCATE_SPARSE_COMPACT, //bitmap of the nonzero blocks followed by the nonzero blocks
+    RELOCATE_COPY_SEGMENTS, //table of copy_segment_t, for the grouped collectives
+    RELOCATE_CYCLE_CLOCKWISE, //RELOCATE_CLOCKWISE within start_offset, following the cycles of the permutation
+    RELOCATE_CYCLE_REVERSE_CLOCKWISE, //RELOCATE_REVERSE_CLOCKWISE within start_offset, likewise
+    RELOCATE_PACK_COUNTS, //chunks of the counts in the table at table_offset, to their slots
+    RELOCATE_UNPACK_COUNTS, //chunks back from their slots, one after the other
+} relocate_mode_t;
 
 typedef struct {
     uint32_t start_offset;
@@ -1124,8 +1105,26 @@ typedef struct {
     uint32_t comm_type;
     uint32_t a_length;
     uint32_t num_comm_rg;
+    uint32_t mode;
+    uint32_t quant_size; //bytes of a quantized word
+    uint32_t quant_block; //int32 words sharing a scale, a multiple of 8 up to QUANT_MAX_BLOCK
+    uint32_t table_offset; //count_slot_t of each peer, for the pack, unpack and quantization modes
 } dpu_arguments_comm_t;
 
+//Mirrored from copy_segment_t in common.h
+typedef struct {
+    uint32_t src_offset;
+    uint32_t dst_offset;
+    uint32_t length;
+    uint32_t padding;
+} copy_segment_t;
+
+//Mirrored from count_slot_t in common.h
+typedef struct {
+    uint32_t count;
+    uint32_t slot;
+} count_slot_t;
+
 //Timer.h
 typedef struct Timer{
     struct timeval startTime[12];
@@ -1164,933 +1163,3207 @@ typedef struct {
     struct dpu_set_t dpu_set;
     uint32_t dimension;
     uint32_t* axis_len;
+    struct dpu_program_t* relocate_program; //resident relocation program, reloaded only when the user program replaced it
+    bool preserve_program; //restore the program found on the DPUs once a collective completes
+    uint32_t algorithm; //PIDCOMM_ALGORITHM of alltoall, reduce_scatter, all_reduce and allgather
+    bool log_algorithm; //print the path taken by each call of them
+    struct pidcomm_cost_model* cost_models; //measured by pidcomm_calibrate()
+    struct pidcomm_mram_allocator* mram; //regions handed out by pidcomm_mram_alloc()
 } hypercube_manager;
 
+//Paths of the collectives, mirrored from PIDCOMM_ALGORITHM in pidcomm.h
+#define PIDCOMM_ALGO_RNS 0
+#define PIDCOMM_ALGO_HOST 1
+#define PIDCOMM_ALGO_HYBRID 2
+#define PIDCOMM_ALGO_AUTO 3
+
 __API_SYMBOL__
 hypercube_manager* init_hypercube_manager(struct dpu_set_t dpu_set, uint32_t dimension, uint32_t* axis_len){
     hypercube_manager* manager = malloc(sizeof(hypercube_manager));
 
     manager->dpu_set = dpu_set;
     manager->dimension = dimension;
-    manager->axis_len = axis_len;
+    manager->axis_len = malloc(sizeof(uint32_t) * dimension);
+    memcpy(manager->axis_len, axis_len, sizeof(uint32_t) * dimension);
+    manager->relocate_program = NULL;
+    manager->preserve_program = true;
+    manager->algorithm = PIDCOMM_ALGO_RNS;
+    manager->log_algorithm = false;
+    manager->cost_models = NULL;
+    manager->mram = NULL;
 
     return manager;
 }
 
-//Supported Communication Primitives
 __API_SYMBOL__
-void pidcomm_broadcast(hypercube_manager* manager, uint32_t total_data_size, uint32_t target_offset, void* data){
-    struct dpu_set_t dpu_set = manager -> dpu_set;
-    DPU_ASSERT(dpu_broadcast_to(dpu_set, DPU_MRAM_HEAP_POINTER_NAME, target_offset, data, total_data_size, DPU_XFER_DEFAULT));
+void pidcomm_set_preserve_program(hypercube_manager* manager, bool preserve_program){
+    manager->preserve_program = preserve_program;
 }
 
+//MRAM regions of a hypercube, in offsets from DPU_MRAM_HEAP_POINTER. The same region is reserved on every DPU.
+//Offsets are multiples of 8 bytes, and regions of 2KB or more start on a 2KB boundary, the largest DPU DMA transfer.
+#define PIDCOMM_MRAM_SIZE (64 * 1024 * 1024)
+#define PIDCOMM_MRAM_ALIGN 8
+#define PIDCOMM_MRAM_DMA_SIZE 2048
+#define PIDCOMM_AUTO_BUFFER UINT32_MAX
+
+typedef struct pidcomm_mram_region {
+    uint32_t offset;
+    uint32_t size;
+    struct pidcomm_mram_region* next;
+} pidcomm_mram_region_t;
+
+typedef struct pidcomm_mram_allocator {
+    uint32_t base;
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t peak;
+    pidcomm_mram_region_t* regions; //sorted by offset
+    pthread_mutex_t mutex; //collectives posted with pidcomm_start() release their buffer from the progress thread
+} pidcomm_mram_allocator_t;
+
+//Restrict the allocator to [base, base + capacity), e.g. to keep the regions laid out by hand. Must be called before
+//the first allocation; the whole MRAM is used otherwise.
 __API_SYMBOL__
-void pidcomm_alltoall(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
-                        uint32_t target_offset, uint32_t buffer_offset){
-
-    struct dpu_set_t dpu_set = manager->dpu_set;
-    uint32_t dimension = manager->dimension;
-    uint32_t* axis_len = manager->axis_len;
-
-    uint32_t* comm_axis = malloc(sizeof(uint32_t) * dimension);
-
-    for(uint32_t dim=0; dim<dimension; dim++){
-        comm_axis[dim] = (int)(*(comm+dim))-48;
-    }
-
-
-    struct dpu_set_t dpu;
-    uint32_t nr_dpus;
-    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
-    dpu_arguments_comm_t* dpu_argument = (dpu_arguments_comm_t*) malloc(sizeof(dpu_arguments_comm_t) * nr_dpus);
-    uint32_t num_comm_dpu = 1;
-    uint32_t comm_type;
-
-    if(comm_axis[0] == 1){
-        comm_type = 0;
+void pidcomm_mram_init(hypercube_manager* manager, uint32_t base, uint32_t capacity){
+    if(manager->mram != NULL){
+        fprintf(stderr, "PID-Comm: the MRAM allocator is already in use\n");
+        DPU_ASSERT(DPU_ERR_ALLOCATION);
     }
-    else comm_type = 1;
+    manager->mram = calloc(1, sizeof(pidcomm_mram_allocator_t));
+    manager->mram->base = base;
+    manager->mram->capacity = capacity;
+    pthread_mutex_init(&manager->mram->mutex, NULL);
+}
 
-    for(uint32_t dim=0; dim<dimension; dim++){
-        if(comm_axis[dim]==1){
-            num_comm_dpu *= axis_len[dim];
+//First fit in the gaps between the regions
+__API_SYMBOL__
+uint32_t pidcomm_mram_alloc(hypercube_manager* manager, uint32_t size){
+    if(manager->mram == NULL) pidcomm_mram_init(manager, 0, PIDCOMM_MRAM_SIZE);
+
+    pidcomm_mram_allocator_t* mram = manager->mram;
+    uint32_t align = size >= PIDCOMM_MRAM_DMA_SIZE ? PIDCOMM_MRAM_DMA_SIZE : PIDCOMM_MRAM_ALIGN;
+    uint64_t end = (uint64_t)mram->base + mram->capacity;
+    uint64_t offset = mram->base;
+    pidcomm_mram_region_t** link;
+
+    size = (size + PIDCOMM_MRAM_ALIGN - 1) / PIDCOMM_MRAM_ALIGN * PIDCOMM_MRAM_ALIGN;
+
+    pthread_mutex_lock(&mram->mutex);
+    for(link = &mram->regions; ; link = &(*link)->next){
+        uint64_t gap_end = *link != NULL ? (*link)->offset : end;
+
+        offset = (offset + align - 1) / align * align;
+        if(offset + size <= gap_end) break;
+        if(*link == NULL){
+            pthread_mutex_unlock(&mram->mutex);
+            fprintf(stderr, "PID-Comm: no MRAM region of %u bytes left, %u of %u bytes used\n", size, mram->used, mram->capacity);
+            DPU_ASSERT(DPU_ERR_ALLOCATION);
+            return 0;
         }
+        offset = (uint64_t)(*link)->offset + (*link)->size;
     }
 
-    T** result = (T**) calloc(nr_dpus, sizeof(T*));
-    for(int i=0; i<nr_dpus; i++)
-        result[i] = (T*) calloc(8/sizeof(T), sizeof(T));
-    int i;
+    pidcomm_mram_region_t* region = malloc(sizeof(pidcomm_mram_region_t));
+    region->offset = (uint32_t)offset;
+    region->size = size;
+    region->next = *link;
+    *link = region;
+    mram->used += size;
+    if(mram->used > mram->peak) mram->peak = mram->used;
+    pthread_mutex_unlock(&mram->mutex);
+
+    return (uint32_t)offset;
+}
 
-    uint32_t num_comm_rg = 1;
-    for(uint32_t dim=0, len = 1; dim<dimension, len<8; len*=axis_len[dim], dim++){
-        if(comm_axis[dim] == 1){
-            if (axis_len[dim] <= (8/len)) num_comm_rg *= axis_len[dim];
-            else num_comm_rg *= (8/len);
+__API_SYMBOL__
+void pidcomm_mram_free(hypercube_manager* manager, uint32_t offset){
+    pidcomm_mram_allocator_t* mram = manager->mram;
+
+    if(mram != NULL){
+        pthread_mutex_lock(&mram->mutex);
+        for(pidcomm_mram_region_t** link = &mram->regions; *link != NULL; link = &(*link)->next){
+            pidcomm_mram_region_t* region = *link;
+            if(region->offset != offset) continue;
+
+            *link = region->next;
+            mram->used -= region->size;
+            free(region);
+            pthread_mutex_unlock(&mram->mutex);
+            return;
         }
-        if(num_comm_rg >= 8) num_comm_rg = 8;
+        pthread_mutex_unlock(&mram->mutex);
     }
+    fprintf(stderr, "PID-Comm: MRAM offset %u was not returned by pidcomm_mram_alloc()\n", offset);
+    DPU_ASSERT(DPU_ERR_INVALID_MRAM_ACCESS);
+}
 
-    //relocate before kernel
-    if(!comm_type){
+//Bytes reserved, highest number of bytes reserved so far, and largest region that can still be allocated
+__API_SYMBOL__
+void pidcomm_mram_usage(hypercube_manager* manager, uint32_t* used, uint32_t* peak, uint32_t* largest_free){
+    pidcomm_mram_allocator_t* mram = manager->mram;
+
+    *used = 0;
+    *peak = 0;
+    *largest_free = PIDCOMM_MRAM_SIZE;
+    if(mram == NULL) return;
+
+    pthread_mutex_lock(&mram->mutex);
+    uint64_t offset = mram->base;
+    *used = mram->used;
+    *peak = mram->peak;
+    *largest_free = 0;
+    for(pidcomm_mram_region_t* region = mram->regions; ; region = region->next){
+        uint64_t gap_end = region != NULL ? region->offset : (uint64_t)mram->base + mram->capacity;
+        if(gap_end - offset > *largest_free) *largest_free = (uint32_t)(gap_end - offset);
+        if(region == NULL) break;
+        offset = (uint64_t)region->offset + region->size;
+    }
+    pthread_mutex_unlock(&mram->mutex);
+}
 
-        //DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_RELOCATE_2"), NULL));
-        DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE, NULL));
+__API_SYMBOL__
+void pidcomm_mram_report(hypercube_manager* manager){
+    uint32_t used, peak, largest_free;
+    uint32_t capacity = manager->mram != NULL ? manager->mram->capacity : PIDCOMM_MRAM_SIZE;
+
+    pidcomm_mram_usage(manager, &used, &peak, &largest_free);
+    printf("PID-Comm: MRAM %u of %u bytes used (%.1f%%), peak %u bytes, largest free region %u bytes\n",
+        used, capacity, 100.0 * used / capacity, peak, largest_free);
+    if(manager->mram == NULL) return;
+
+    pthread_mutex_lock(&manager->mram->mutex);
+    for(pidcomm_mram_region_t* region = manager->mram->regions; region != NULL; region = region->next){
+        printf("PID-Comm:   [%u, %u) %u bytes\n", region->offset, region->offset + region->size, region->size);
+    }
+    pthread_mutex_unlock(&manager->mram->mutex);
+}
 
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset;
-            dpu_argument[i].target_offset = start_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-        }
+//Communication buffer of size bytes borrowed from the allocator when a collective is given PIDCOMM_AUTO_BUFFER.
+//Returns the region to release, or PIDCOMM_AUTO_BUFFER when the caller provided the buffer.
+static uint32_t pidcomm_borrow_buffer(hypercube_manager* manager, uint32_t size, uint32_t start_offset, uint32_t* buffer_offset){
+    if(*buffer_offset != PIDCOMM_AUTO_BUFFER) return PIDCOMM_AUTO_BUFFER;
 
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));     
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+    uint32_t region = pidcomm_mram_alloc(manager, size);
+    //the buffer offsets are added to the source offset modulo 2^32
+    *buffer_offset = region - start_offset;
+    return region;
+}
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
-    }
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
-    }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
+static void pidcomm_return_buffer(hypercube_manager* manager, uint32_t region){
+    if(region != PIDCOMM_AUTO_BUFFER) pidcomm_mram_free(manager, region);
+}
 
-    all_to_all(&dpu_set, start_offset, start_offset, total_data_size/num_comm_dpu, comm_type, buffer_offset, dimension, axis_len, comm_axis);
+static void pidcomm_wait_pending(void);
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
-    }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
+//Supported Communication Primitives
+__API_SYMBOL__
+void pidcomm_broadcast(hypercube_manager* manager, uint32_t total_data_size, uint32_t target_offset, void* data){
+    struct dpu_set_t dpu_set = manager -> dpu_set;
+    pidcomm_wait_pending();
+    DPU_ASSERT(dpu_broadcast_to(dpu_set, DPU_MRAM_HEAP_POINTER_NAME, target_offset, data, total_data_size, DPU_XFER_DEFAULT));
+}
 
+//Reduction operators, mirrored from PIDCOMM_OPERATOR in pidcomm.h. The bitwise operators come last.
+#define PIDCOMM_OP_SUM 0
+#define PIDCOMM_OP_MAX 1
+#define PIDCOMM_OP_SAT_SUM 2
+#define PIDCOMM_OP_MIN 3
+#define PIDCOMM_OP_PROD 4
+#define PIDCOMM_OP_BAND 5
+#define PIDCOMM_OP_BOR 6
+#define PIDCOMM_OP_BXOR 7
+
+//Data types, mirrored from PIDCOMM_DTYPE in pidcomm.h: low byte element size, high byte kind
+#define PIDCOMM_DTYPE_SIZE(dtype) ((dtype) & 0xff)
+#define PIDCOMM_DTYPE_KIND(dtype) ((dtype) >> 8)
+#define PIDCOMM_DTYPE_KIND_INT 0
+#define PIDCOMM_DTYPE_KIND_FLOAT32 1
+#define PIDCOMM_DTYPE_KIND_BFLOAT16 2
+#define PIDCOMM_DTYPE_KIND_FLOAT16 3
+#define PIDCOMM_DTYPE_KIND_UINT 4
+
+//Collective plans
+typedef enum {
+    PIDCOMM_PLAN_ALLTOALL,
+    PIDCOMM_PLAN_REDUCE_SCATTER,
+    PIDCOMM_PLAN_ALL_REDUCE,
+    PIDCOMM_PLAN_ALLGATHER,
+    PIDCOMM_PLAN_REDUCE,
+    PIDCOMM_PLAN_GATHER,
+    PIDCOMM_PLAN_SCATTER,
+} pidcomm_plan_type_t;
+
+//Relocation kernel launched before or after the rotate-and-stream pass. dpu_argument is NULL when the step is not needed.
+typedef struct {
+    relocate_mode_t mode;
+    dpu_arguments_comm_t* dpu_argument;
+} pidcomm_relocation_t;
+
+typedef struct pidcomm_plan {
+    hypercube_manager* manager;
+    pidcomm_plan_type_t type;
+    char* comm;
+    bool on_host; //the rotate groups do not fit the shape, so the collective is combined on the host
+    bool in_place; //the rotate-and-stream pass swaps the lines of the source region instead of writing a buffer
+    uint32_t dimension; //shape the collective runs on, see pidcomm_set_shape()
+    uint32_t* axis_len;
+    uint32_t* comm_axis;
+    uint32_t nr_dpus;
+    uint32_t comm_type;
+    uint32_t num_comm_dpu;
+    uint32_t num_comm_rg;
 
-    //relocate after kernel
-    if(axis_len[0]==2 && axis_len[1]==2 && ((comm_axis[0]==1 && comm_axis[1]==0 && comm_axis[2]==1) || (comm_axis[0]==0 && comm_axis[1]==1 && comm_axis[2]==0))){
-        //DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_ALLTOALL_22"), NULL));
-        DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_MODIFIED_CLOCKWISE, NULL));
-
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset + buffer_offset;
-            dpu_argument[i].target_offset = target_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = 2;
+    uint32_t total_data_size;
+    uint32_t start_offset;
+    uint32_t target_offset;
+    uint32_t buffer_offset;
+    uint32_t buffer_region; //communication buffer borrowed from the MRAM allocator, PIDCOMM_AUTO_BUFFER if none
+    uint32_t byte_length; //bytes exchanged between each pair of DPUs by the rotate-and-stream pass
+    uint32_t size;
+    uint32_t reduce_type;
+    uint32_t sync_offset; //MRAM offset read to synchronize the DPUs before the rotate-and-stream pass
+
+    pidcomm_relocation_t before;
+    pidcomm_relocation_t after;
+    uint64_t* sync_buffer;
+
+    uint32_t nr_stages; //rank slices of a pipelined plan, 0 when the plan runs on the whole set at once
+    struct pidcomm_plan** stages;
+} pidcomm_plan_t;
+
+static void pidcomm_run_host(hypercube_manager* manager, pidcomm_plan_type_t type, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t size, uint32_t reduce_type);
+static void pidcomm_run_host_rooted(hypercube_manager* manager, pidcomm_plan_type_t type, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t size, uint32_t reduce_type, void** host_buffer);
+static uint32_t pidcomm_comm_size(hypercube_manager* manager, const char* comm, uint32_t nr_dpus);
+static uint32_t pidcomm_select_algorithm(pidcomm_plan_t* plan);
+void pidcomm_plan_free(pidcomm_plan_t* plan);
+
+static const char* pidcomm_plan_name[] = {"alltoall", "reduce_scatter", "all_reduce", "allgather"};
+
+//The rotate-group selection looks at the first three axes, so smaller shapes are padded with axes of length 1
+#define PIDCOMM_MIN_DIMENSION 3
+
+//Collectives run on a canonical shape of the hypercube: axes of length 1 are dropped and neighbouring axes that
+//both communicate (or both do not) are merged, which keeps the DPU order and the members of every communicator.
+//A 4x2 "11" plane is then streamed as one axis of 8 DPUs, and a 12x2 "11" plane as one axis of 24 DPUs.
+//Axes missing from the end of the comm string do not communicate.
+static void pidcomm_set_shape(pidcomm_plan_t* plan, hypercube_manager* manager, const char* comm){
+    uint32_t dimension = 0;
+    size_t comm_length = strlen(comm);
+
+    plan->axis_len = malloc(sizeof(uint32_t) * (manager->dimension + PIDCOMM_MIN_DIMENSION));
+    plan->comm_axis = malloc(sizeof(uint32_t) * (manager->dimension + PIDCOMM_MIN_DIMENSION));
+    for(uint32_t dim=0; dim<manager->dimension; dim++){
+        uint32_t is_comm = dim < comm_length && comm[dim] == '1';
+        if(manager->axis_len[dim] == 1) continue;
+        if(dimension > 0 && plan->comm_axis[dimension-1] == is_comm){
+            plan->axis_len[dimension-1] *= manager->axis_len[dim];
         }
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-                
+        else{
+            plan->axis_len[dimension] = manager->axis_len[dim];
+            plan->comm_axis[dimension] = is_comm;
+            dimension++;
         }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
-
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
     }
-    else if(!comm_type  || (axis_len[0]<8 && comm_axis[1]==1) || (axis_len[0]*axis_len[1]==4 && (comm_axis[1] == 1 || comm_axis[2] == 1)) ){
-        //DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_ALLTOALL_X_2"), NULL));
-        DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE, NULL));
+    for(; dimension<PIDCOMM_MIN_DIMENSION; dimension++){
+        plan->axis_len[dimension] = 1;
+        plan->comm_axis[dimension] = 0;
+    }
+    plan->dimension = dimension;
+}
 
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset + buffer_offset;
-            dpu_argument[i].target_offset = target_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = num_comm_rg;
-        }
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-                
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+//The rotate-and-stream pass addresses every DPU of a rank, so a rank with disabled DPUs leaves holes in its rotate groups
+static bool pidcomm_has_full_ranks(struct dpu_set_t dpu_set){
+    if(dpu_set.kind != DPU_SET_RANKS) return false;
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
-    }
-    else{
-        //DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_RELOCATE_2"), NULL));
-        DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE, NULL));
+    for(uint32_t each_rank=0; each_rank<dpu_set.list.nr_ranks; each_rank++){
+        struct dpu_rank_t* rank = dpu_set.list.ranks[each_rank];
+        struct dpu_set_t rank_set = {.kind = DPU_SET_RANKS, .list = {.nr_ranks = 1, .ranks = &dpu_set.list.ranks[each_rank]}};
+        uint32_t nr_dpus;
 
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset+ buffer_offset;
-            dpu_argument[i].target_offset = target_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 1;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
+        DPU_ASSERT(dpu_get_nr_dpus(rank_set, &nr_dpus));
+        if(nr_dpus != (uint32_t)rank->description->hw.topology.nr_of_control_interfaces * rank->description->hw.topology.nr_of_dpus_per_control_interface){
+            return false;
         }
+    }
+    return true;
+}
 
-        
+//The rotate groups of 8 DPUs must not straddle two communicators: the first axis has to fill whole groups,
+//or be 2 or 4 DPUs long with the second axis completing the groups.
+static bool pidcomm_is_supported_shape(pidcomm_plan_t* plan){
+    uint32_t* axis_len = plan->axis_len;
 
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-                
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+    if(!pidcomm_has_full_ranks(plan->manager->dpu_set)) return false;
+    if(axis_len[0] % 8 == 0) return true;
+    if(axis_len[0] == 2 && axis_len[1] == 2) return axis_len[2] % 2 == 0;
+    return (axis_len[0] == 2 || axis_len[0] == 4) && (axis_len[0] * axis_len[1]) % 8 == 0;
+}
 
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
-    }
+//2x2 hypercubes communicating along "101" or "010" use the modified relocation kernels
+static bool pidcomm_is_modified_22(uint32_t* axis_len, uint32_t* comm_axis){
+    return axis_len[0]==2 && axis_len[1]==2 && ((comm_axis[0]==1 && comm_axis[1]==0 && comm_axis[2]==1) || (comm_axis[0]==0 && comm_axis[1]==1 && comm_axis[2]==0));
 }
 
-__API_SYMBOL__
-void pidcomm_reduce_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
-                        uint32_t target_offset, uint32_t buffer_offset, uint32_t size){
+//Rotate groups shorter than 8 DPUs use the short relocation kernels
+static bool pidcomm_is_short(pidcomm_plan_t* plan){
+    return plan->axis_len[0] < 8 && plan->num_comm_rg < 8 && plan->num_comm_rg > 1;
+}
 
-    struct dpu_set_t dpu_set = manager->dpu_set;
-    uint32_t dimension = manager->dimension;
-    uint32_t* axis_len = manager->axis_len;
+static pidcomm_plan_t* pidcomm_plan_create(hypercube_manager* manager, pidcomm_plan_type_t type, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type){
+
+    pidcomm_plan_t* plan = (pidcomm_plan_t*) calloc(1, sizeof(pidcomm_plan_t));
+    size_t comm_length = strlen(comm);
+
+    plan->manager = manager;
+    plan->type = type;
+    plan->comm = malloc(comm_length + 1);
+    memcpy(plan->comm, comm, comm_length + 1);
+    pidcomm_set_shape(plan, manager, comm);
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &plan->nr_dpus));
 
-    uint32_t* comm_axis = malloc(sizeof(uint32_t) * dimension);
+    uint32_t dimension = plan->dimension;
+    uint32_t* axis_len = plan->axis_len;
+    uint32_t hypercube_dpus = 1;
 
     for(uint32_t dim=0; dim<dimension; dim++){
-        comm_axis[dim] = (int)(*(comm+dim))-48;
+        hypercube_dpus *= axis_len[dim];
+    }
+    if(hypercube_dpus != plan->nr_dpus){
+        fprintf(stderr, "PID-Comm: the hypercube does not match the %u DPUs of the set\n", plan->nr_dpus);
+        DPU_ASSERT(DPU_ERR_INVALID_DPU_SET);
+    }
+    //shapes whose rotate groups straddle communicators or miss disabled DPUs keep working through the host path
+    if(!pidcomm_is_supported_shape(plan)){
+        plan->on_host = true;
+        if(manager->log_algorithm){
+            fprintf(stderr, "PID-Comm: %s does not fill whole rotate groups of 8 DPUs, combined on the host\n", comm);
+        }
     }
 
-    struct dpu_set_t dpu;
-    uint32_t nr_dpus;
-    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
-    dpu_arguments_comm_t* dpu_argument = (dpu_arguments_comm_t*) malloc(sizeof(dpu_arguments_comm_t) * nr_dpus);
-    uint32_t num_comm_dpu = 1;
-    uint32_t comm_type;
-
-    if(comm_axis[0] == 1){
-        comm_type = 0;
+    if(plan->comm_axis[0] == 1){
+        plan->comm_type = 0;
     }
-    else comm_type = 1;
+    else plan->comm_type = 1;
 
+    plan->num_comm_dpu = 1;
     for(uint32_t dim=0; dim<dimension; dim++){
-        if(comm_axis[dim]==1){
-            num_comm_dpu *= axis_len[dim];
+        if(plan->comm_axis[dim]==1){
+            plan->num_comm_dpu *= axis_len[dim];
         }
     }
 
-    uint32_t num_comm_rg = 1;
-    for(uint32_t dim=0, len = 1; dim<dimension, len<8; len*=axis_len[dim], dim++){
-        if(comm_axis[dim] == 1){
-            if (axis_len[dim] <= (8/len)) num_comm_rg *= axis_len[dim];
-            else num_comm_rg *= (8/len);
+    plan->num_comm_rg = 1;
+    for(uint32_t dim=0, len = 1; dim<dimension && len<8; len*=axis_len[dim], dim++){
+        if(plan->comm_axis[dim] == 1){
+            if (axis_len[dim] <= (8/len)) plan->num_comm_rg *= axis_len[dim];
+            else plan->num_comm_rg *= (8/len);
         }
-        if(num_comm_rg >= 8) num_comm_rg = 8;
+        if(plan->num_comm_rg >= 8) plan->num_comm_rg = 8;
     }
 
-    T** result = (T**) calloc(nr_dpus, sizeof(T*));
-    for(int i=0; i<nr_dpus; i++)
-        result[i] = (T*) calloc(8/sizeof(T), sizeof(T));
-    int i;
-
-    if(axis_len[0]==2 && axis_len[1]==2 && ( ((comm_axis[0]==0) && (comm_axis[1]==1) && (comm_axis[2]==0)) || ((comm_axis[0]==1) && (comm_axis[1]==0) && (comm_axis[2]==1)))){
-        // if(size==1) DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_RS_22_INT8"), NULL));
-        // else DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_RS_22_INT32"), NULL));
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_MODIFIED_REVERSE_CLOCKWISE_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_MODIFIED_REVERSE_CLOCKWISE_INT32, NULL));
-
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset;
-            dpu_argument[i].target_offset = start_offset + buffer_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = 2;
-            dpu_argument[i].num_comm_rg = 2;
-        }
+    //the relocation program moves 8-byte words, so a chunk with a shorter tail would be truncated
+    if(type <= PIDCOMM_PLAN_ALLGATHER && total_data_size % (8 * plan->num_comm_dpu) != 0){
+        fprintf(stderr, "PID-Comm: %u bytes do not split into chunks of multiples of 8 bytes among the %u DPUs of a communicator\n",
+            total_data_size, plan->num_comm_dpu);
+        DPU_ASSERT(DPU_ERR_INVALID_MEMORY_TRANSFER);
+    }
 
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+    plan->total_data_size = total_data_size;
+    plan->start_offset = start_offset;
+    plan->target_offset = target_offset;
+    //the host path needs no communication buffer
+    plan->buffer_region = plan->on_host ? PIDCOMM_AUTO_BUFFER : pidcomm_borrow_buffer(manager, total_data_size, start_offset, &buffer_offset);
+    plan->buffer_offset = buffer_offset;
+    plan->byte_length = total_data_size / plan->num_comm_dpu;
+    //the bitwise operators reduce the raw bits, so floating-point data is reduced as integers of the same size
+    plan->size = reduce_type >= PIDCOMM_OP_BAND ? (size & 0xff) : size;
+    plan->reduce_type = reduce_type;
+    plan->sync_buffer = (uint64_t*) calloc(plan->nr_dpus, sizeof(uint64_t));
+
+    return plan;
+}
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+static void pidcomm_set_relocation(pidcomm_plan_t* plan, pidcomm_relocation_t* step, relocate_mode_t mode, uint32_t start_offset, uint32_t target_offset,
+                        bool no_rotate, uint32_t a_length, uint32_t num_comm_rg){
+
+    step->mode = mode;
+    step->dpu_argument = (dpu_arguments_comm_t*) calloc(plan->nr_dpus, sizeof(dpu_arguments_comm_t));
+
+    for(uint32_t i=0; i<plan->nr_dpus; i++){
+        step->dpu_argument[i].each_dpu = i;
+        step->dpu_argument[i].start_offset = start_offset;
+        step->dpu_argument[i].target_offset = target_offset;
+        step->dpu_argument[i].total_data_size = plan->total_data_size;
+        step->dpu_argument[i].num_comm_dpu = plan->num_comm_dpu;
+        step->dpu_argument[i].no_rotate = no_rotate;
+        step->dpu_argument[i].comm_type = plan->comm_type;
+        step->dpu_argument[i].a_length = a_length;
+        step->dpu_argument[i].num_comm_rg = num_comm_rg;
+        step->dpu_argument[i].mode = mode;
     }
+}
 
-    else if(axis_len[0] < 8 && ((num_comm_rg < 8) && (num_comm_rg > 1) )){
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_SHORT_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_SHORT_INT32, NULL));
+//Load the relocation program unless it is still resident on every DPU of the manager
+static void pidcomm_load_relocation(hypercube_manager* manager){
+    struct dpu_set_t dpu_set = manager->dpu_set;
+    struct dpu_set_t dpu;
+    struct dpu_program_t* program;
 
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset;
-            dpu_argument[i].target_offset = start_offset + buffer_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = num_comm_rg;
+    if(manager->relocate_program != NULL){
+        bool resident = true;
+        DPU_FOREACH(dpu_set, dpu){
+            if(dpu_get_program(dpu.dpu) != manager->relocate_program){
+                resident = false;
+                break;
+            }
         }
-            
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
+        if(!resident){
+            //write the cached image back instead of parsing the ELF again
+            DPU_ASSERT(dpu_restore_program(dpu_set, manager->relocate_program));
         }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
-
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+        return;
     }
-    //relocate before kernel
-    else if(!comm_type){
-
-        // if(size==1) DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_RELOCATE_2_INT8"), NULL));
-        // else DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_RELOCATE_2_INT32"), NULL));
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_INT32, NULL));
-
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset;
-            dpu_argument[i].target_offset = start_offset + buffer_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = num_comm_rg;
-        }
-            
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
-    }
-    else{
-        // if(size==1) DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_RELOCATE_2_INT8"), NULL));
-        // else DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_RELOCATE_2_INT32"), NULL));
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_INT32, NULL));
+    DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE, &program));
+    //keep a reference so that the program cannot be freed and its address reused while the manager points to it
+    dpu_take_program_ref(program);
+    manager->relocate_program = program;
+}
 
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].start_offset = start_offset;
-            dpu_argument[i].target_offset = start_offset + buffer_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 1;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-        }
+//Program running on the DPUs before a collective, restored by pidcomm_restore_program once the collective completes
+static struct dpu_program_t* pidcomm_save_program(hypercube_manager* manager){
+    struct dpu_set_t dpu;
+    struct dpu_program_t* program = NULL;
 
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            dpu_argument[i].each_dpu = i;
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+    if(!manager->preserve_program) return NULL;
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+    DPU_FOREACH(manager->dpu_set, dpu){
+        program = dpu_get_program(dpu.dpu);
+        break;
     }
+    if(program == NULL || program == manager->relocate_program) return NULL;
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
-    }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, start_offset + buffer_offset, 8, DPU_XFER_DEFAULT));
+    //loading the relocation program drops the references the DPUs hold on the program
+    dpu_take_program_ref(program);
+    return program;
+}
 
-    reduce_scatter(&dpu_set, start_offset, target_offset, total_data_size/num_comm_dpu, comm_type, buffer_offset, dimension, axis_len, comm_axis, size);
-    
+static void pidcomm_restore_program(hypercube_manager* manager, struct dpu_program_t* program){
+    struct dpu_set_t dpu;
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
-    }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
+    if(program == NULL) return;
 
+    DPU_FOREACH(manager->dpu_set, dpu){
+        if(dpu_get_program(dpu.dpu) != program){
+            DPU_ASSERT(dpu_restore_program(manager->dpu_set, program));
+        }
+        break;
+    }
+    dpu_free_program(program);
 }
 
-__API_SYMBOL__
-void pidcomm_all_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, \
-                    uint32_t buffer_offset, uint32_t size, uint32_t reduce_type){
-
-    struct dpu_set_t dpu_set = manager->dpu_set;
-    uint32_t dimension = manager->dimension;
-    uint32_t* axis_len = manager->axis_len;
+static void pidcomm_run_relocation(pidcomm_plan_t* plan, pidcomm_relocation_t* step, dpu_launch_policy_t policy){
+    struct dpu_set_t dpu_set = plan->manager->dpu_set;
+    struct dpu_set_t dpu;
+    uint32_t i;
 
-    uint32_t* comm_axis = malloc(sizeof(uint32_t) * dimension);
+    pidcomm_load_relocation(plan->manager);
 
-    for(uint32_t dim=0; dim<dimension; dim++){
-        comm_axis[dim] = (int)(*(comm+dim))-48;
+    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, plan->nr_dpus){
+        DPU_ASSERT(dpu_prepare_xfer(dpu, step->dpu_argument+i));
     }
+    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
 
-    struct dpu_set_t dpu;
-    uint32_t nr_dpus;
-    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
-    dpu_arguments_comm_t* dpu_argument = (dpu_arguments_comm_t*) malloc(sizeof(dpu_arguments_comm_t) * nr_dpus);
-    uint32_t num_comm_dpu = 1;
-    uint32_t comm_type;
+    // Run kernel on DPUs
+    DPU_ASSERT(dpu_launch(dpu_set, policy));
+}
 
-    if(comm_axis[0] == 1){
-        comm_type = 0;
-    }
-    else comm_type = 1;
+static void pidcomm_sync(pidcomm_plan_t* plan, uint32_t offset){
+    struct dpu_set_t dpu_set = plan->manager->dpu_set;
+    struct dpu_set_t dpu;
+    uint32_t i;
 
-    for(uint32_t dim=0; dim<dimension; dim++){
-        if(comm_axis[dim]==1){
-            num_comm_dpu *= axis_len[dim];
-        }
+    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, plan->nr_dpus){
+        DPU_ASSERT(dpu_prepare_xfer(dpu, plan->sync_buffer+i));
     }
+    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, offset, 8, DPU_XFER_DEFAULT));
+}
 
-    T** result = (T**) calloc(nr_dpus, sizeof(T*));
-    for(int i=0; i<nr_dpus; i++)
-        result[i] = (T*) calloc(8/sizeof(T), sizeof(T));
-    int i;
+//relocate after kernel for AlltoAll and AllGather
+static void pidcomm_set_gather_relocation(pidcomm_plan_t* plan){
+    uint32_t* axis_len = plan->axis_len;
+    uint32_t* comm_axis = plan->comm_axis;
+    uint32_t start_offset = plan->start_offset + plan->buffer_offset;
 
-    uint32_t num_comm_rg = 1;
-    for(uint32_t dim=0, len = 1; dim<dimension, len<8; len*=axis_len[dim], dim++){
-        if(comm_axis[dim] == 1){
-            if (axis_len[dim] <= (8/len)) num_comm_rg *= axis_len[dim];
-            else num_comm_rg *= (8/len);
-        }
-        if(num_comm_rg >= 8) num_comm_rg = 8;
+    if(pidcomm_is_modified_22(axis_len, comm_axis)){
+        pidcomm_set_relocation(plan, &plan->after, RELOCATE_MODIFIED_CLOCKWISE, start_offset, plan->target_offset, 0, axis_len[0], 2);
     }
+    else if(!plan->comm_type || (axis_len[0]<8 && comm_axis[1]==1) || (axis_len[0]*axis_len[1]==4 && (comm_axis[1] == 1 || comm_axis[2] == 1))){
+        pidcomm_set_relocation(plan, &plan->after, RELOCATE_REVERSE_CLOCKWISE, start_offset, plan->target_offset, 0, axis_len[0], plan->num_comm_rg);
+    }
+    else{
+        pidcomm_set_relocation(plan, &plan->after, RELOCATE_CLOCKWISE, start_offset, plan->target_offset, 1, axis_len[0], plan->num_comm_rg);
+    }
+}
 
-    //relocate before kernel
-    if(axis_len[0]==2 && axis_len[1]==2 && ( ((comm_axis[0]==0) && (comm_axis[1]==1) && (comm_axis[2]==0)) || ((comm_axis[0]==1) && (comm_axis[1]==0) && (comm_axis[2]==1)))){
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_MODIFIED_REVERSE_CLOCKWISE_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_MODIFIED_REVERSE_CLOCKWISE_INT32, NULL));
-
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset;
-            dpu_argument[i].target_offset = start_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = 2;
-            dpu_argument[i].num_comm_rg = 2;
-        }
+__API_SYMBOL__
+pidcomm_plan_t* pidcomm_plan_alltoall(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset){
 
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+    pidcomm_plan_t* plan = pidcomm_plan_create(manager, PIDCOMM_PLAN_ALLTOALL, comm, total_data_size, start_offset, target_offset, buffer_offset, 0, 0);
+    if(plan->on_host) return plan;
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+    //relocate before kernel
+    if(!plan->comm_type){
+        pidcomm_set_relocation(plan, &plan->before, RELOCATE_CLOCKWISE, start_offset, start_offset, 0, plan->axis_len[0], plan->num_comm_rg);
     }
+    pidcomm_set_gather_relocation(plan);
 
-    else if(axis_len[0] < 8 && ((num_comm_rg < 8) && (num_comm_rg > 1) )){
-        // if(size==1) DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_RS_24_INT8"), NULL));
-        // else DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_RS_24_INT32"), NULL));
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_SHORT_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_SHORT_INT32, NULL));
+    return plan;
+}
 
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset;
-            dpu_argument[i].target_offset = start_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = num_comm_rg;
-        }
-            
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+//The line of DPU s holding the chunk for DPU d and the line of d holding the chunk for s trade places, so the pass
+//needs no buffer. The relocations permute the chunks of each DPU in place by following the cycles of the rotation.
+static pidcomm_plan_t* pidcomm_plan_alltoall_inplace(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t offset){
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+    pidcomm_plan_t* plan = pidcomm_plan_create(manager, PIDCOMM_PLAN_ALLTOALL, comm, total_data_size, offset, offset, 0, 0, 0);
+    if(plan->on_host) return plan;
 
+    //the swap pairs whole rotate groups, so groups shared by several communicators are combined on the host
+    if(plan->axis_len[0] % 8 != 0){
+        plan->on_host = true;
+        return plan;
+    }
+    plan->in_place = true;
+    if(!plan->comm_type){
+        pidcomm_set_relocation(plan, &plan->before, RELOCATE_CYCLE_CLOCKWISE, offset, offset, 0, plan->axis_len[0], plan->num_comm_rg);
+        pidcomm_set_relocation(plan, &plan->after, RELOCATE_CYCLE_REVERSE_CLOCKWISE, offset, offset, 0, plan->axis_len[0], plan->num_comm_rg);
     }
-    else if(!comm_type){
 
-        // if(size==1) DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_RELOCATE_2_INT8"), NULL));
-        // else DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_RELOCATE_2_INT32"), NULL));
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_INT32, NULL));
-        // if(size==1) DPU_ASSERT(dpu_load(dpu_set, getenv("DPU1_INT8"), NULL));
-        // else DPU_ASSERT(dpu_load(dpu_set, getenv("DPU1_INT32"), NULL));
+    return plan;
+}
 
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset;
-            dpu_argument[i].target_offset = start_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = num_comm_rg;
-        }
-            
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+__API_SYMBOL__
+pidcomm_plan_t* pidcomm_plan_reduce_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type){
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
-    }
+    pidcomm_plan_t* plan = pidcomm_plan_create(manager, PIDCOMM_PLAN_REDUCE_SCATTER, comm, total_data_size, start_offset, target_offset, buffer_offset, size, reduce_type);
+    uint32_t* axis_len = plan->axis_len;
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
+    if(plan->on_host) return plan;
+
+    //relocate before kernel
+    if(pidcomm_is_modified_22(axis_len, plan->comm_axis)){
+        pidcomm_set_relocation(plan, &plan->before, RELOCATE_MODIFIED_REVERSE_CLOCKWISE, start_offset, start_offset + plan->buffer_offset, 0, 2, 2);
+    }
+    else if(pidcomm_is_short(plan)){
+        pidcomm_set_relocation(plan, &plan->before, RELOCATE_CLOCKWISE_SHORT, start_offset, start_offset + plan->buffer_offset, 0, axis_len[0], plan->num_comm_rg);
     }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
+    else{
+        pidcomm_set_relocation(plan, &plan->before, RELOCATE_CLOCKWISE, start_offset, start_offset + plan->buffer_offset, plan->comm_type, axis_len[0], plan->num_comm_rg);
+    }
+    plan->sync_offset = start_offset + plan->buffer_offset;
 
+    return plan;
+}
 
-    //kernel function of All-Reduce
-    all_reduce(&dpu_set, start_offset, start_offset, total_data_size/num_comm_dpu, comm_type, buffer_offset, dimension, axis_len, comm_axis, size, reduce_type);
-    
+__API_SYMBOL__
+pidcomm_plan_t* pidcomm_plan_all_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, \
+                    uint32_t buffer_offset, uint32_t size, uint32_t reduce_type){
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
-    }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
+    pidcomm_plan_t* plan = pidcomm_plan_create(manager, PIDCOMM_PLAN_ALL_REDUCE, comm, total_data_size, start_offset, target_offset, buffer_offset, size, reduce_type);
+    uint32_t* axis_len = plan->axis_len;
 
+    if(plan->on_host) return plan;
 
     //relocate before kernel
-    if(axis_len[0]==2 && axis_len[1]==2 && ((comm_axis[0]==1 && comm_axis[1]==0 && comm_axis[2]==1) || (comm_axis[0]==0 && comm_axis[1]==1 && comm_axis[2]==0))){
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_MODIFIED_CLOCKWISE_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_MODIFIED_CLOCKWISE_INT32, NULL));
-
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset + buffer_offset;
-            dpu_argument[i].target_offset = target_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = 2;
-        }
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-                
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
-
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+    if(pidcomm_is_modified_22(axis_len, plan->comm_axis)){
+        pidcomm_set_relocation(plan, &plan->before, RELOCATE_MODIFIED_REVERSE_CLOCKWISE, start_offset, start_offset, 0, 2, 2);
+    }
+    else if(pidcomm_is_short(plan)){
+        pidcomm_set_relocation(plan, &plan->before, RELOCATE_CLOCKWISE_SHORT, start_offset, start_offset, 0, axis_len[0], plan->num_comm_rg);
+    }
+    else if(!plan->comm_type){
+        pidcomm_set_relocation(plan, &plan->before, RELOCATE_CLOCKWISE, start_offset, start_offset, 0, axis_len[0], plan->num_comm_rg);
+    }
+
+    //relocate after kernel
+    if(pidcomm_is_modified_22(axis_len, plan->comm_axis)){
+        pidcomm_set_relocation(plan, &plan->after, RELOCATE_MODIFIED_CLOCKWISE, start_offset + plan->buffer_offset, target_offset, 0, axis_len[0], 2);
+    }
+    else if(pidcomm_is_short(plan)){
+        pidcomm_set_relocation(plan, &plan->after, RELOCATE_REVERSE_CLOCKWISE_SHORT, start_offset + plan->buffer_offset, target_offset, 0, axis_len[0], plan->num_comm_rg);
+    }
+    else if(!plan->comm_type){
+        pidcomm_set_relocation(plan, &plan->after, RELOCATE_COUNTERCLOCKWISE, start_offset + plan->buffer_offset, target_offset, 0, axis_len[0], plan->num_comm_rg);
+    }
+    else{
+        pidcomm_set_relocation(plan, &plan->after, RELOCATE_INCREMENTAL_COUNTERCLOCKWISE, start_offset + plan->buffer_offset, target_offset, 0, axis_len[0], plan->num_comm_rg);
+    }
+
+    return plan;
+}
+
+__API_SYMBOL__
+pidcomm_plan_t* pidcomm_plan_allgather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset){
+
+    pidcomm_plan_t* plan = pidcomm_plan_create(manager, PIDCOMM_PLAN_ALLGATHER, comm, total_data_size, start_offset, target_offset, buffer_offset, 0, 0);
+    if(plan->on_host) return plan;
+
+    pidcomm_set_gather_relocation(plan);
+
+    return plan;
+}
+
+//A pipelined plan that cannot be split runs in a single stage, which the caller is told about
+static pidcomm_plan_t* pidcomm_single_stage(pidcomm_plan_t* plan, uint32_t nr_stages, const char* reason){
+    if(nr_stages > 1){
+        fprintf(stderr, "PID-Comm: the pipelined all_reduce along %s runs in a single stage: %s\n", plan->comm, reason);
+    }
+    return plan;
+}
+
+//Split an all_reduce into stages of whole ranks along the outermost axis, which must not communicate.
+//The host can only stream the MRAM of DPUs that are not running, so the relocation kernels of one stage are
+//overlapped with the rotate-and-stream pass of another stage instead of with another segment on the same DPUs:
+//byte segments of one communicator would occupy the same ranks in every step and could not overlap at all.
+__API_SYMBOL__
+pidcomm_plan_t* pidcomm_plan_all_reduce_pipelined(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, \
+                    uint32_t buffer_offset, uint32_t size, uint32_t reduce_type, uint32_t nr_stages){
+
+    pidcomm_plan_t* plan = pidcomm_plan_all_reduce(manager, comm, total_data_size, start_offset, target_offset, buffer_offset, size, reduce_type);
+    struct dpu_set_t dpu_set = manager->dpu_set;
+    uint32_t split = plan->dimension;
+    uint32_t max_stages = nr_stages;
+
+    if(plan->on_host) return pidcomm_single_stage(plan, nr_stages, "the collective is combined on the host");
+    for(uint32_t dim=0; dim<plan->dimension; dim++){
+        if(plan->axis_len[dim] > 1) split = dim;
+    }
+    if(split == plan->dimension || plan->comm_axis[split] == 1){
+        return pidcomm_single_stage(plan, nr_stages, "every communicator spans all ranks, as the outermost axis communicates");
+    }
+    if(dpu_set.kind != DPU_SET_RANKS || plan->nr_dpus % dpu_set.list.nr_ranks != 0){
+        return pidcomm_single_stage(plan, nr_stages, "the DPUs are not split evenly among whole ranks");
+    }
+
+    //every stage takes the same number of ranks and of slices of the outermost axis
+    while(nr_stages > 1 && (dpu_set.list.nr_ranks % nr_stages != 0 || plan->axis_len[split] % nr_stages != 0)){
+        nr_stages--;
+    }
+    if(nr_stages < 2){
+        return pidcomm_single_stage(plan, max_stages, "no number of stages divides both the ranks and the outermost axis");
+    }
+
+    char* stage_comm = malloc(plan->dimension + 1);
+    for(uint32_t dim=0; dim<plan->dimension; dim++){
+        stage_comm[dim] = plan->comm_axis[dim] ? '1' : '0';
+    }
+    stage_comm[plan->dimension] = '\0';
+
+    uint32_t nr_stage_ranks = dpu_set.list.nr_ranks / nr_stages;
+    plan->nr_stages = nr_stages;
+    plan->stages = malloc(sizeof(pidcomm_plan_t*) * nr_stages);
+    for(uint32_t stage=0; stage<nr_stages; stage++){
+        struct dpu_set_t stage_set = {
+            .kind = DPU_SET_RANKS,
+            .list = {.nr_ranks = nr_stage_ranks, .ranks = dpu_set.list.ranks + stage * nr_stage_ranks},
+        };
+        hypercube_manager* stage_manager = init_hypercube_manager(stage_set, plan->dimension, plan->axis_len);
+
+        stage_manager->axis_len[split] /= nr_stages;
+        //the pipelined plan saves and restores the user program once for the whole set
+        stage_manager->preserve_program = false;
+        plan->stages[stage] = pidcomm_plan_all_reduce(stage_manager, stage_comm, total_data_size, start_offset, target_offset, plan->buffer_offset, size, reduce_type);
+    }
+    free(stage_comm);
+
+    return plan;
+}
+
+//Host side of the collective: rotate-and-stream pass on the relocated data
+static void pidcomm_stream(pidcomm_plan_t* plan){
+    struct dpu_set_t dpu_set = plan->manager->dpu_set;
+
+    switch(plan->type){
+        case PIDCOMM_PLAN_ALLTOALL:
+            if(plan->in_place){
+                all_to_all_inplace(&dpu_set, plan->start_offset, plan->byte_length, plan->comm_type, plan->dimension, plan->axis_len, plan->comm_axis);
+                break;
+            }
+            all_to_all(&dpu_set, plan->start_offset, plan->start_offset, plan->byte_length, plan->comm_type, plan->buffer_offset, plan->dimension, plan->axis_len, plan->comm_axis);
+            break;
+        case PIDCOMM_PLAN_REDUCE_SCATTER:
+            reduce_scatter(&dpu_set, plan->start_offset, plan->target_offset, plan->byte_length, plan->comm_type, plan->buffer_offset, plan->dimension, plan->axis_len, plan->comm_axis, plan->size, plan->reduce_type);
+            break;
+        case PIDCOMM_PLAN_ALL_REDUCE:
+            all_reduce(&dpu_set, plan->start_offset, plan->start_offset, plan->byte_length, plan->comm_type, plan->buffer_offset, plan->dimension, plan->axis_len, plan->comm_axis, plan->size, plan->reduce_type);
+            break;
+        case PIDCOMM_PLAN_ALLGATHER:
+            all_gather(&dpu_set, plan->start_offset, plan->start_offset, plan->byte_length, plan->comm_type, plan->buffer_offset, plan->dimension, plan->axis_len, plan->comm_axis);
+            break;
+        default:
+            //reduce, gather and scatter carry a host buffer and are executed by their pidcomm_* call
+            break;
+    }
+}
+
+//While the host streams stage s, stage s+1 relocates its data and stage s-1 moves its result to target_offset
+static void pidcomm_run_pipelined(pidcomm_plan_t* plan){
+    hypercube_manager* manager = plan->manager;
+    struct dpu_program_t* user_program = pidcomm_save_program(manager);
+
+    pidcomm_load_relocation(manager);
+    for(uint32_t stage=0; stage<plan->nr_stages; stage++){
+        plan->stages[stage]->manager->relocate_program = manager->relocate_program;
+    }
+
+    if(plan->stages[0]->before.dpu_argument != NULL){
+        pidcomm_run_relocation(plan->stages[0], &plan->stages[0]->before, DPU_ASYNCHRONOUS);
+    }
+    for(uint32_t stage=0; stage<plan->nr_stages; stage++){
+        pidcomm_plan_t* current = plan->stages[stage];
+
+        DPU_ASSERT(dpu_sync(current->manager->dpu_set));
+        pidcomm_sync(current, current->sync_offset);
+
+        if(stage + 1 < plan->nr_stages && plan->stages[stage+1]->before.dpu_argument != NULL){
+            pidcomm_run_relocation(plan->stages[stage+1], &plan->stages[stage+1]->before, DPU_ASYNCHRONOUS);
+        }
+
+        pidcomm_stream(current);
+        pidcomm_sync(current, 0);
+
+        if(current->after.dpu_argument != NULL){
+            pidcomm_run_relocation(current, &current->after, DPU_ASYNCHRONOUS);
+        }
+    }
+    DPU_ASSERT(dpu_sync(manager->dpu_set));
+    pidcomm_sync(plan, 0);
+
+    pidcomm_restore_program(manager, user_program);
+}
+
+static void pidcomm_run_rns(pidcomm_plan_t* plan){
+    hypercube_manager* manager = plan->manager;
+    struct dpu_program_t* user_program;
+
+    if(plan->nr_stages > 1){
+        pidcomm_run_pipelined(plan);
+        return;
+    }
+    user_program = pidcomm_save_program(manager);
+
+    if(plan->before.dpu_argument != NULL){
+        pidcomm_run_relocation(plan, &plan->before, DPU_SYNCHRONOUS);
+    }
+    pidcomm_sync(plan, plan->sync_offset);
+
+    pidcomm_stream(plan);
+    pidcomm_sync(plan, 0);
+
+    if(plan->after.dpu_argument != NULL){
+        pidcomm_run_relocation(plan, &plan->after, DPU_SYNCHRONOUS);
+        pidcomm_sync(plan, 0);
+    }
+    pidcomm_restore_program(manager, user_program);
+}
+
+//all_reduce as a rotate-and-stream reduce_scatter into target_offset, whose chunks the host then gathers in place
+static void pidcomm_run_hybrid(pidcomm_plan_t* plan){
+    hypercube_manager* manager = plan->manager;
+    pidcomm_plan_t* scatter_plan = pidcomm_plan_reduce_scatter(manager, plan->comm, plan->total_data_size, plan->start_offset,
+        plan->target_offset, plan->buffer_offset, plan->size, plan->reduce_type);
+
+    pidcomm_run_rns(scatter_plan);
+    pidcomm_plan_free(scatter_plan);
+    pidcomm_run_host(manager, PIDCOMM_PLAN_ALLGATHER, plan->comm, plan->total_data_size, plan->target_offset, plan->target_offset, 0, 0);
+}
+
+//Every collective built on a plan, blocking, grouped, non-blocking or pipelined, takes its path here
+static void pidcomm_run_plan(pidcomm_plan_t* plan){
+    switch(pidcomm_select_algorithm(plan)){
+        case PIDCOMM_ALGO_HOST:
+            pidcomm_run_host(plan->manager, plan->type, plan->comm, plan->total_data_size, plan->start_offset, plan->target_offset, plan->size, plan->reduce_type);
+            break;
+        case PIDCOMM_ALGO_HYBRID:
+            pidcomm_run_hybrid(plan);
+            break;
+        default:
+            pidcomm_run_rns(plan);
+            break;
+    }
+}
+
+__API_SYMBOL__
+uint32_t pidcomm_plan_nr_stages(pidcomm_plan_t* plan){
+    return plan->nr_stages > 1 ? plan->nr_stages : 1;
+}
+
+__API_SYMBOL__
+void pidcomm_plan_free(pidcomm_plan_t* plan){
+    for(uint32_t stage=0; stage<plan->nr_stages; stage++){
+        hypercube_manager* stage_manager = plan->stages[stage]->manager;
+
+        pidcomm_plan_free(plan->stages[stage]);
+        //the relocation program belongs to the manager of the whole set
+        free(stage_manager->axis_len);
+        free(stage_manager);
+    }
+    free(plan->stages);
+    pidcomm_return_buffer(plan->manager, plan->buffer_region);
+    free(plan->before.dpu_argument);
+    free(plan->after.dpu_argument);
+    free(plan->sync_buffer);
+    free(plan->axis_len);
+    free(plan->comm_axis);
+    free(plan->comm);
+    free(plan);
+}
+
+//Non-blocking collectives. Requests are executed in order by a progress thread, which drives the relocation
+//launches and hands the rotate-and-stream pass to the communication thread pool as the blocking calls do.
+typedef struct pidcomm_request {
+    pidcomm_plan_t* plan;
+    bool free_plan; //the plan was created by a pidcomm_i* call and is released once executed
+    bool done;
+    struct pidcomm_request* next;
+} pidcomm_request_t;
+
+static struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool started;
+    uint32_t nr_pending; //requests posted and not completed yet
+    pidcomm_request_t* head;
+    pidcomm_request_t* tail;
+} pidcomm_progress = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+static void* pidcomm_progress_thread(void* arg){
+    (void)arg;
+
+    while(true){
+        pthread_mutex_lock(&pidcomm_progress.mutex);
+        while(pidcomm_progress.head == NULL){
+            pthread_cond_wait(&pidcomm_progress.cond, &pidcomm_progress.mutex);
+        }
+        pidcomm_request_t* request = pidcomm_progress.head;
+        pidcomm_progress.head = request->next;
+        if(pidcomm_progress.head == NULL) pidcomm_progress.tail = NULL;
+        pthread_mutex_unlock(&pidcomm_progress.mutex);
+
+        pidcomm_run_plan(request->plan);
+        if(request->free_plan) pidcomm_plan_free(request->plan);
+
+        pthread_mutex_lock(&pidcomm_progress.mutex);
+        request->done = true;
+        pidcomm_progress.nr_pending--;
+        pthread_cond_broadcast(&pidcomm_progress.cond);
+        pthread_mutex_unlock(&pidcomm_progress.mutex);
+    }
+    return NULL;
+}
+
+static void pidcomm_wait_requests(void){
+    pthread_mutex_lock(&pidcomm_progress.mutex);
+    while(pidcomm_progress.nr_pending != 0){
+        pthread_cond_wait(&pidcomm_progress.cond, &pidcomm_progress.mutex);
+    }
+    pthread_mutex_unlock(&pidcomm_progress.mutex);
+}
+
+//Grouped collectives. Between pidcomm_group_start() and pidcomm_group_end() the blocking alltoall, reduce_scatter,
+//all_reduce and allgather are only recorded, and any other PID-Comm call first runs the ones recorded so far.
+typedef struct {
+    hypercube_manager* manager;
+    pidcomm_plan_type_t type;
+    char* comm;
+    uint32_t total_data_size;
+    uint32_t start_offset;
+    uint32_t target_offset;
+    uint32_t buffer_offset;
+    uint32_t size;
+    uint32_t reduce_type;
+} pidcomm_group_entry_t;
+
+static struct {
+    uint32_t depth; //nesting level of pidcomm_group_start()
+    uint32_t nr_entries;
+    uint32_t capacity;
+    pidcomm_group_entry_t* entries;
+} pidcomm_group;
+
+static bool pidcomm_group_add(hypercube_manager* manager, pidcomm_plan_type_t type, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type){
+    if(pidcomm_group.depth == 0) return false;
+
+    if(pidcomm_group.nr_entries == pidcomm_group.capacity){
+        pidcomm_group.capacity = pidcomm_group.capacity ? pidcomm_group.capacity * 2 : 16;
+        pidcomm_group.entries = realloc(pidcomm_group.entries, sizeof(pidcomm_group_entry_t) * pidcomm_group.capacity);
+    }
+    pidcomm_group_entry_t* entry = &pidcomm_group.entries[pidcomm_group.nr_entries++];
+    size_t comm_length = strlen(comm);
+
+    entry->manager = manager;
+    entry->type = type;
+    entry->comm = malloc(comm_length + 1);
+    memcpy(entry->comm, comm, comm_length + 1);
+    entry->total_data_size = total_data_size;
+    entry->start_offset = start_offset;
+    entry->target_offset = target_offset;
+    entry->buffer_offset = buffer_offset;
+    entry->size = size;
+    entry->reduce_type = reduce_type;
+    return true;
+}
+
+//Collectives of a group that can run as one: same manager, primitive, communicator, data type and operator
+static bool pidcomm_group_is_kind(pidcomm_group_entry_t* first, pidcomm_group_entry_t* entry){
+    return first->manager == entry->manager && first->type == entry->type && strcmp(first->comm, entry->comm) == 0
+        && first->size == entry->size && first->reduce_type == entry->reduce_type;
+}
+
+static int pidcomm_compare_start(const void* a, const void* b){
+    uint32_t x = ((const pidcomm_group_entry_t*)a)->start_offset;
+    uint32_t y = ((const pidcomm_group_entry_t*)b)->start_offset;
+    return (x > y) - (x < y);
+}
+
+//All-reduces of neighbouring slices with the same buffer offset are a single all-reduce of the concatenated slices,
+//whatever the order they were recorded in
+static uint32_t pidcomm_group_merge(pidcomm_group_entry_t* items, uint32_t nr_items){
+    uint32_t nr_merged = 1;
+
+    qsort(items, nr_items, sizeof(pidcomm_group_entry_t), pidcomm_compare_start);
+    for(uint32_t i=1; i<nr_items; i++){
+        pidcomm_group_entry_t* last = &items[nr_merged-1];
+
+        if(items[i].buffer_offset == last->buffer_offset && items[i].start_offset == last->start_offset + last->total_data_size
+            && items[i].target_offset == last->target_offset + last->total_data_size){
+            last->total_data_size += items[i].total_data_size;
+        }
+        else items[nr_merged++] = items[i];
+    }
+    return nr_merged;
+}
+
+static pidcomm_plan_t* pidcomm_group_plan(pidcomm_group_entry_t* entry, uint32_t total_data_size){
+    switch(entry->type){
+        case PIDCOMM_PLAN_ALLTOALL:
+            return pidcomm_plan_alltoall(entry->manager, entry->comm, total_data_size, entry->start_offset, entry->target_offset, entry->buffer_offset);
+        case PIDCOMM_PLAN_REDUCE_SCATTER:
+            return pidcomm_plan_reduce_scatter(entry->manager, entry->comm, total_data_size, entry->start_offset, entry->target_offset, entry->buffer_offset, entry->size, entry->reduce_type);
+        case PIDCOMM_PLAN_ALL_REDUCE:
+            return pidcomm_plan_all_reduce(entry->manager, entry->comm, total_data_size, entry->start_offset, entry->target_offset, entry->buffer_offset, entry->size, entry->reduce_type);
+        default:
+            return pidcomm_plan_allgather(entry->manager, entry->comm, total_data_size, entry->start_offset, entry->target_offset, entry->buffer_offset);
+    }
+}
+
+static void pidcomm_group_run(pidcomm_group_entry_t* entry){
+    pidcomm_plan_t* plan = pidcomm_group_plan(entry, entry->total_data_size);
+
+    pidcomm_run_plan(plan);
+    pidcomm_plan_free(plan);
+}
+
+//One launch of the relocation program copying the segments of the table at table_offset
+static void pidcomm_group_copy(pidcomm_plan_t* plan, uint32_t table_offset, uint32_t nr_segments){
+    pidcomm_relocation_t step;
+
+    pidcomm_set_relocation(plan, &step, RELOCATE_COPY_SEGMENTS, table_offset, table_offset, 0, 0, 0);
+    for(uint32_t i=0; i<plan->nr_dpus; i++){
+        step.dpu_argument[i].total_data_size = nr_segments;
+    }
+    pidcomm_run_relocation(plan, &step, DPU_SYNCHRONOUS);
+    pidcomm_sync(plan, 0);
+    free(step.dpu_argument);
+}
+
+//Collectives of one kind run as one collective on a staging area. Chunk r of every entry is packed next to chunk r
+//of the others, so the fused collective sends the chunks of all entries between two DPUs together, and its result
+//is cut back into the target of every entry. The staging area comes from the MRAM allocator, so the entries must
+//borrow their buffers from it too (PIDCOMM_AUTO_BUFFER); otherwise they run one after the other.
+static void pidcomm_group_fuse(pidcomm_group_entry_t* items, uint32_t nr_items){
+    hypercube_manager* manager = items[0].manager;
+    pidcomm_plan_type_t type = items[0].type;
+    uint32_t nr_dpus, used, peak, largest_free;
+    uint64_t staging_size = 0;
+    bool can_fuse = true;
+
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, items[0].comm, nr_dpus);
+    //reduce_scatter and alltoall send a chunk to every member, alltoall and allgather receive one from every member
+    uint32_t nr_send = (type == PIDCOMM_PLAN_REDUCE_SCATTER || type == PIDCOMM_PLAN_ALLTOALL) ? num_comm_dpu : 1;
+    uint32_t nr_recv = (type == PIDCOMM_PLAN_ALLTOALL || type == PIDCOMM_PLAN_ALLGATHER) ? num_comm_dpu : 1;
+    //an all_reduce moves its whole slice, the others one chunk per segment
+    uint32_t scale = type == PIDCOMM_PLAN_ALL_REDUCE ? num_comm_dpu : 1;
+    uint64_t nr_segments = (uint64_t)nr_items * (nr_send + nr_recv);
+
+    for(uint32_t i=0; i<nr_items; i++){
+        staging_size += items[i].total_data_size;
+        if(items[i].buffer_offset != PIDCOMM_AUTO_BUFFER || items[i].total_data_size % (8 * num_comm_dpu) != 0) can_fuse = false;
+    }
+    //the staging area, its communication buffer and the table, each aligned to the MRAM DMA size
+    pidcomm_mram_usage(manager, &used, &peak, &largest_free);
+    if(2 * staging_size + nr_segments * sizeof(copy_segment_t) + 3 * PIDCOMM_MRAM_DMA_SIZE > largest_free) can_fuse = false;
+
+    if(!can_fuse){
+        for(uint32_t i=0; i<nr_items; i++){
+            pidcomm_group_run(&items[i]);
+        }
+        return;
+    }
+
+    uint32_t chunk_size = staging_size / num_comm_dpu;
+    uint32_t staging = pidcomm_mram_alloc(manager, staging_size);
+    uint32_t table = pidcomm_mram_alloc(manager, nr_segments * sizeof(copy_segment_t));
+    copy_segment_t* pack = malloc(nr_segments * sizeof(copy_segment_t));
+    copy_segment_t* unpack = pack + nr_items * nr_send;
+
+    for(uint32_t i=0, position=0; i<nr_items; i++){
+        uint32_t chunk = items[i].total_data_size / num_comm_dpu;
+
+        for(uint32_t rank=0; rank<nr_send; rank++){
+            copy_segment_t segment = {items[i].start_offset + rank * chunk, staging + rank * chunk_size + scale * position, scale * chunk, 0};
+            pack[i * nr_send + rank] = segment;
+        }
+        for(uint32_t rank=0; rank<nr_recv; rank++){
+            copy_segment_t segment = {staging + rank * chunk_size + scale * position, items[i].target_offset + rank * chunk, scale * chunk, 0};
+            unpack[i * nr_recv + rank] = segment;
+        }
+        position += chunk;
+    }
+    DPU_ASSERT(dpu_broadcast_to(manager->dpu_set, DPU_MRAM_HEAP_POINTER_NAME, table, pack, nr_segments * sizeof(copy_segment_t), DPU_XFER_DEFAULT));
+
+    pidcomm_group_entry_t fused = items[0];
+    fused.start_offset = staging;
+    fused.target_offset = staging;
+    pidcomm_plan_t* plan = pidcomm_group_plan(&fused, staging_size);
+
+    if(manager->log_algorithm){
+        fprintf(stderr, "PID-Comm: %u grouped %s along %s fused into %u bytes\n", nr_items, pidcomm_plan_name[type], fused.comm, (uint32_t)staging_size);
+    }
+    pidcomm_group_copy(plan, table, nr_items * nr_send);
+    pidcomm_run_plan(plan);
+    pidcomm_group_copy(plan, table + nr_items * nr_send * sizeof(copy_segment_t), nr_items * nr_recv);
+
+    pidcomm_plan_free(plan);
+    pidcomm_mram_free(manager, table);
+    pidcomm_mram_free(manager, staging);
+    free(pack);
+}
+
+//Run the recorded collectives. The collectives of a group must not depend on each other: those of one kind run
+//together at the place of the first of them. The user program is saved and restored once per manager instead of
+//once per collective.
+static void pidcomm_group_flush(void){
+    hypercube_manager* manager = NULL;
+    struct dpu_program_t* user_program = NULL;
+    bool preserve_program = false;
+
+    if(pidcomm_group.nr_entries == 0) return;
+    pidcomm_wait_requests();
+
+    bool* done = calloc(pidcomm_group.nr_entries, sizeof(bool));
+    pidcomm_group_entry_t* items = malloc(sizeof(pidcomm_group_entry_t) * pidcomm_group.nr_entries);
+
+    for(uint32_t i=0; i<pidcomm_group.nr_entries; i++){
+        pidcomm_group_entry_t* entry = &pidcomm_group.entries[i];
+        uint32_t nr_items = 0;
+
+        if(done[i]) continue;
+        for(uint32_t next=i; next<pidcomm_group.nr_entries; next++){
+            if(done[next] || !pidcomm_group_is_kind(entry, &pidcomm_group.entries[next])) continue;
+            items[nr_items++] = pidcomm_group.entries[next];
+            done[next] = true;
+        }
+        if(entry->manager != manager){
+            if(manager != NULL){
+                manager->preserve_program = preserve_program;
+                pidcomm_restore_program(manager, user_program);
+            }
+            manager = entry->manager;
+            user_program = pidcomm_save_program(manager);
+            preserve_program = manager->preserve_program;
+            manager->preserve_program = false;
+        }
+
+        if(entry->type == PIDCOMM_PLAN_ALL_REDUCE) nr_items = pidcomm_group_merge(items, nr_items);
+        if(nr_items == 1) pidcomm_group_run(&items[0]);
+        else pidcomm_group_fuse(items, nr_items);
+    }
+    manager->preserve_program = preserve_program;
+    pidcomm_restore_program(manager, user_program);
+
+    for(uint32_t i=0; i<pidcomm_group.nr_entries; i++){
+        free(pidcomm_group.entries[i].comm);
+    }
+    free(items);
+    free(done);
+    pidcomm_group.nr_entries = 0;
+}
+
+__API_SYMBOL__
+void pidcomm_group_start(void){
+    pidcomm_group.depth++;
+}
+
+__API_SYMBOL__
+void pidcomm_group_end(void){
+    if(pidcomm_group.depth == 0) return;
+    if(--pidcomm_group.depth == 0) pidcomm_wait_pending();
+}
+
+static pidcomm_request_t* pidcomm_post(pidcomm_plan_t* plan, bool free_plan){
+    pidcomm_group_flush();
+
+    pidcomm_request_t* request = (pidcomm_request_t*) calloc(1, sizeof(pidcomm_request_t));
+    request->plan = plan;
+    request->free_plan = free_plan;
+
+    pthread_mutex_lock(&pidcomm_progress.mutex);
+    if(!pidcomm_progress.started){
+        pthread_t tid;
+        if(pthread_create(&tid, NULL, pidcomm_progress_thread, NULL)){
+            pthread_mutex_unlock(&pidcomm_progress.mutex);
+            DPU_ASSERT(DPU_ERR_SYSTEM);
+        }
+        pthread_detach(tid);
+        pidcomm_progress.started = true;
+    }
+    if(pidcomm_progress.tail != NULL) pidcomm_progress.tail->next = request;
+    else pidcomm_progress.head = request;
+    pidcomm_progress.tail = request;
+    pidcomm_progress.nr_pending++;
+    pthread_cond_broadcast(&pidcomm_progress.cond);
+    pthread_mutex_unlock(&pidcomm_progress.mutex);
+
+    return request;
+}
+
+//Blocking collectives wait for the posted and grouped ones, so that only one collective drives the DPUs at a time
+static void pidcomm_wait_pending(void){
+    pidcomm_wait_requests();
+    pidcomm_group_flush();
+}
+
+__API_SYMBOL__
+void pidcomm_execute(pidcomm_plan_t* plan){
+    pidcomm_wait_pending();
+    pidcomm_run_plan(plan);
+}
+
+__API_SYMBOL__
+pidcomm_request_t* pidcomm_start(pidcomm_plan_t* plan){
+    return pidcomm_post(plan, false);
+}
+
+__API_SYMBOL__
+bool pidcomm_test(pidcomm_request_t* request){
+    pthread_mutex_lock(&pidcomm_progress.mutex);
+    bool done = request->done;
+    pthread_mutex_unlock(&pidcomm_progress.mutex);
+
+    if(done) free(request);
+    return done;
+}
+
+__API_SYMBOL__
+void pidcomm_wait(pidcomm_request_t* request){
+    pthread_mutex_lock(&pidcomm_progress.mutex);
+    while(!request->done){
+        pthread_cond_wait(&pidcomm_progress.cond, &pidcomm_progress.mutex);
+    }
+    pthread_mutex_unlock(&pidcomm_progress.mutex);
+    free(request);
+}
+
+__API_SYMBOL__
+void pidcomm_waitall(uint32_t nr_requests, pidcomm_request_t** requests){
+    for(uint32_t i=0; i<nr_requests; i++){
+        pidcomm_wait(requests[i]);
+    }
+}
+
+__API_SYMBOL__
+void pidcomm_alltoall(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset){
+
+    if(pidcomm_group_add(manager, PIDCOMM_PLAN_ALLTOALL, comm, total_data_size, start_offset, target_offset, buffer_offset, 0, 0)) return;
+
+    pidcomm_plan_t* plan = pidcomm_plan_alltoall(manager, comm, total_data_size, start_offset, target_offset, buffer_offset);
+    pidcomm_execute(plan);
+    pidcomm_plan_free(plan);
+}
+
+__API_SYMBOL__
+void pidcomm_alltoall_inplace(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t offset){
+    pidcomm_plan_t* plan = pidcomm_plan_alltoall_inplace(manager, comm, total_data_size, offset);
+    pidcomm_execute(plan);
+    pidcomm_plan_free(plan);
+}
+
+__API_SYMBOL__
+void pidcomm_reduce_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type){
+
+    if(pidcomm_group_add(manager, PIDCOMM_PLAN_REDUCE_SCATTER, comm, total_data_size, start_offset, target_offset, buffer_offset, size, reduce_type)) return;
+
+    pidcomm_plan_t* plan = pidcomm_plan_reduce_scatter(manager, comm, total_data_size, start_offset, target_offset, buffer_offset, size, reduce_type);
+    pidcomm_execute(plan);
+    pidcomm_plan_free(plan);
+}
+
+__API_SYMBOL__
+void pidcomm_all_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, \
+                    uint32_t buffer_offset, uint32_t size, uint32_t reduce_type){
+
+    if(pidcomm_group_add(manager, PIDCOMM_PLAN_ALL_REDUCE, comm, total_data_size, start_offset, target_offset, buffer_offset, size, reduce_type)) return;
+
+    pidcomm_plan_t* plan = pidcomm_plan_all_reduce(manager, comm, total_data_size, start_offset, target_offset, buffer_offset, size, reduce_type);
+    pidcomm_execute(plan);
+    pidcomm_plan_free(plan);
+}
+
+__API_SYMBOL__
+void pidcomm_allgather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset){
+
+    if(pidcomm_group_add(manager, PIDCOMM_PLAN_ALLGATHER, comm, total_data_size, start_offset, target_offset, buffer_offset, 0, 0)) return;
+
+    pidcomm_plan_t* plan = pidcomm_plan_allgather(manager, comm, total_data_size, start_offset, target_offset, buffer_offset);
+    pidcomm_execute(plan);
+    pidcomm_plan_free(plan);
+}
+
+__API_SYMBOL__
+pidcomm_request_t* pidcomm_ialltoall(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset){
+
+    return pidcomm_post(pidcomm_plan_alltoall(manager, comm, total_data_size, start_offset, target_offset, buffer_offset), true);
+}
+
+__API_SYMBOL__
+pidcomm_request_t* pidcomm_ireduce_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type){
+
+    return pidcomm_post(pidcomm_plan_reduce_scatter(manager, comm, total_data_size, start_offset, target_offset, buffer_offset, size, reduce_type), true);
+}
+
+__API_SYMBOL__
+pidcomm_request_t* pidcomm_iall_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, \
+                    uint32_t buffer_offset, uint32_t size, uint32_t reduce_type){
+
+    return pidcomm_post(pidcomm_plan_all_reduce(manager, comm, total_data_size, start_offset, target_offset, buffer_offset, size, reduce_type), true);
+}
+
+__API_SYMBOL__
+pidcomm_request_t* pidcomm_iallgather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset){
+
+    return pidcomm_post(pidcomm_plan_allgather(manager, comm, total_data_size, start_offset, target_offset, buffer_offset), true);
+}
+
+__API_SYMBOL__
+void pidcomm_gather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                                                        uint32_t buffer_offset, void** host_buffer){
+
+    pidcomm_wait_pending();
+    pidcomm_plan_t* plan = pidcomm_plan_create(manager, PIDCOMM_PLAN_GATHER, comm, total_data_size, start_offset, start_offset, buffer_offset, 0, 0);
+    struct dpu_set_t dpu_set = manager->dpu_set;
+
+    if(plan->on_host){
+        pidcomm_run_host_rooted(manager, PIDCOMM_PLAN_GATHER, comm, total_data_size, start_offset, 0, 0, host_buffer);
+        pidcomm_plan_free(plan);
+        return;
+    }
+    gather(&dpu_set, start_offset, start_offset, total_data_size, plan->comm_type, plan->buffer_offset, plan->dimension, plan->axis_len, plan->comm_axis, host_buffer);
+
+    pidcomm_sync(plan, 0);
+    pidcomm_plan_free(plan);
+}
+
+__API_SYMBOL__
+void pidcomm_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, \
+                    uint32_t buffer_offset, uint32_t size, uint32_t reduce_type, void** host_buffer){
+
+    pidcomm_wait_pending();
+    pidcomm_plan_t* plan = pidcomm_plan_create(manager, PIDCOMM_PLAN_REDUCE, comm, total_data_size, start_offset, start_offset, buffer_offset, size, reduce_type);
+    struct dpu_set_t dpu_set = manager->dpu_set;
+
+    if(plan->on_host){
+        pidcomm_run_host_rooted(manager, PIDCOMM_PLAN_REDUCE, comm, total_data_size, start_offset, plan->size, reduce_type, host_buffer);
+        pidcomm_plan_free(plan);
+        return;
+    }
+    struct dpu_program_t* user_program = pidcomm_save_program(manager);
+
+    //relocate before kernel
+    if(!plan->comm_type){
+        pidcomm_set_relocation(plan, &plan->before, RELOCATE_CLOCKWISE, start_offset, start_offset, 0, plan->axis_len[0], plan->num_comm_rg);
+        pidcomm_run_relocation(plan, &plan->before, DPU_SYNCHRONOUS);
+    }
+    pidcomm_sync(plan, 0);
+
+    reduce(&dpu_set, start_offset, start_offset, plan->byte_length, total_data_size, plan->comm_type, plan->buffer_offset, plan->dimension, plan->axis_len, plan->comm_axis, plan->size, reduce_type, host_buffer);
+
+    pidcomm_sync(plan, 0);
+    pidcomm_restore_program(manager, user_program);
+    pidcomm_plan_free(plan);
+}
+
+//total data size is size of data each dpu will receive
+__API_SYMBOL__
+void pidcomm_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, \
+                    uint32_t buffer_offset, void** host_buffer){
+
+    pidcomm_wait_pending();
+    pidcomm_plan_t* plan = pidcomm_plan_create(manager, PIDCOMM_PLAN_SCATTER, comm, total_data_size, start_offset, start_offset, buffer_offset, 0, 0);
+    struct dpu_set_t dpu_set = manager->dpu_set;
+
+    if(plan->on_host){
+        pidcomm_run_host_rooted(manager, PIDCOMM_PLAN_SCATTER, comm, total_data_size, start_offset, 0, 0, host_buffer);
+        pidcomm_plan_free(plan);
+        return;
+    }
+    scatter(&dpu_set, start_offset, start_offset, total_data_size, plan->comm_type, plan->buffer_offset, plan->dimension, plan->axis_len, plan->comm_axis, host_buffer);
+
+    pidcomm_sync(plan, 0);
+    pidcomm_plan_free(plan);
+}
+
+//Members of a communicator are numbered with the first communicating axis varying fastest, as the chunks of alltoall()
+static uint32_t pidcomm_comm_rank(hypercube_manager* manager, const char* comm, uint32_t dpu){
+    size_t comm_length = strlen(comm);
+    uint32_t stride = 1;
+    uint32_t rank = 0;
+
+    for(uint32_t dim=0; dim<manager->dimension; dim++){
+        if(dim < comm_length && comm[dim] == '1'){
+            rank += (dpu % manager->axis_len[dim]) * stride;
+            stride *= manager->axis_len[dim];
+        }
+        dpu /= manager->axis_len[dim];
+    }
+    return rank;
+}
+
+//DPU holding the given rank in the communicator of dpu
+static uint32_t pidcomm_comm_member(hypercube_manager* manager, const char* comm, uint32_t dpu, uint32_t rank){
+    size_t comm_length = strlen(comm);
+    uint32_t stride = 1;
+    uint32_t member = 0;
+
+    for(uint32_t dim=0; dim<manager->dimension; dim++){
+        uint32_t coord = dpu % manager->axis_len[dim];
+        if(dim < comm_length && comm[dim] == '1'){
+            coord = rank % manager->axis_len[dim];
+            rank /= manager->axis_len[dim];
+        }
+        member += coord * stride;
+        stride *= manager->axis_len[dim];
+        dpu /= manager->axis_len[dim];
+    }
+    return member;
+}
+
+//Number of DPUs in each communicator
+static uint32_t pidcomm_comm_size(hypercube_manager* manager, const char* comm, uint32_t nr_dpus){
+    size_t comm_length = strlen(comm);
+    uint32_t hypercube_dpus = 1;
+    uint32_t num_comm_dpu = 1;
+
+    for(uint32_t dim=0; dim<manager->dimension; dim++){
+        hypercube_dpus *= manager->axis_len[dim];
+        if(dim < comm_length && comm[dim] == '1') num_comm_dpu *= manager->axis_len[dim];
+    }
+    if(hypercube_dpus != nr_dpus){
+        fprintf(stderr, "PID-Comm: the hypercube does not match the %u DPUs of the set\n", nr_dpus);
+        DPU_ASSERT(DPU_ERR_INVALID_DPU_SET);
+    }
+    return num_comm_dpu;
+}
+
+static void pidcomm_check_count(uint32_t count){
+    if(count % 8 != 0){
+        fprintf(stderr, "PID-Comm: the byte counts must be multiples of 8\n");
+        DPU_ASSERT(DPU_ERR_INVALID_MEMORY_TRANSFER);
+    }
+}
+
+//Packed areas of every DPU, length bytes apart in buffer. DPUs are indexed in entangled group order, as in the
+//hypercube and the rotate-and-stream kernels.
+static void pidcomm_copy_packed(struct dpu_set_t dpu_set, dpu_xfer_t xfer, uint8_t* buffer, uint32_t offset, uint32_t length){
+    struct dpu_set_t dpu;
+    uint32_t nr_dpus, i;
+
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
+    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
+        DPU_ASSERT(dpu_prepare_xfer(dpu, buffer + (size_t)i * length));
+    }
+    DPU_ASSERT(dpu_push_xfer(dpu_set, xfer, DPU_MRAM_HEAP_POINTER_NAME, offset, length, DPU_XFER_DEFAULT));
+}
+
+static int pidcomm_compare_length(const void* a, const void* b){
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+//Areas of length[i] bytes at buffer + base[i], moved so that every DPU transfers exactly its own bytes. The lengths
+//are sorted, and each layer between two consecutive lengths is one transfer of the DPUs whose area reaches past it,
+//so DPUs with equal lengths share every transfer.
+static void pidcomm_copy_ragged(struct dpu_set_t dpu_set, dpu_xfer_t xfer, uint8_t* buffer, size_t* base, uint32_t* length, uint32_t offset){
+    struct dpu_set_t dpu;
+    uint32_t nr_dpus, i;
+
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
+    uint32_t* layers = malloc(sizeof(uint32_t) * nr_dpus);
+    memcpy(layers, length, sizeof(uint32_t) * nr_dpus);
+    qsort(layers, nr_dpus, sizeof(uint32_t), pidcomm_compare_length);
+
+    for(uint32_t layer=0, done=0; layer<nr_dpus; layer++){
+        uint32_t end = layers[layer];
+        if(end == done) continue;
+        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
+            if(length[i] < end) continue;
+            DPU_ASSERT(dpu_prepare_xfer(dpu, buffer + base[i] + done));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, xfer, DPU_MRAM_HEAP_POINTER_NAME, offset + done, end - done, DPU_XFER_DEFAULT));
+        done = end;
+    }
+    free(layers);
+}
+
+//Only the bytes each DPU actually sends and receives are moved: the send areas are read and the receive areas are
+//written with pidcomm_copy_ragged(), and the chunks are routed on the host in between.
+static void pidcomm_alltoallv_host(hypercube_manager* manager, char* comm, uint32_t* send_counts, uint32_t start_offset, uint32_t target_offset){
+    struct dpu_set_t dpu_set = manager->dpu_set;
+    uint32_t nr_dpus;
+
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+
+    //send_displ[dpu * num_comm_dpu + rank]: offset of the chunk for rank in the send area of dpu
+    uint32_t* send_displ = malloc(sizeof(uint32_t) * nr_dpus * num_comm_dpu);
+    uint32_t* send_size = malloc(sizeof(uint32_t) * nr_dpus);
+    uint32_t* recv_size = malloc(sizeof(uint32_t) * nr_dpus);
+    size_t* send_base = malloc(sizeof(size_t) * nr_dpus);
+    size_t* recv_base = malloc(sizeof(size_t) * nr_dpus);
+    size_t total_send = 0;
+    size_t total_recv = 0;
+
+    for(uint32_t src=0; src<nr_dpus; src++){
+        uint32_t displ = 0;
+        for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+            pidcomm_check_count(send_counts[src * num_comm_dpu + rank]);
+            send_displ[src * num_comm_dpu + rank] = displ;
+            displ += send_counts[src * num_comm_dpu + rank];
+        }
+        send_size[src] = displ;
+        send_base[src] = total_send;
+        total_send += displ;
+    }
+    for(uint32_t dst=0; dst<nr_dpus; dst++){
+        uint32_t dst_rank = pidcomm_comm_rank(manager, comm, dst);
+        uint32_t recv = 0;
+        for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+            recv += send_counts[pidcomm_comm_member(manager, comm, dst, rank) * num_comm_dpu + dst_rank];
+        }
+        recv_size[dst] = recv;
+        recv_base[dst] = total_recv;
+        total_recv += recv;
+    }
+
+    if(total_send != 0){
+        uint8_t* send_buffer = malloc(total_send);
+        uint8_t* recv_buffer = malloc(total_recv);
+
+        pidcomm_copy_ragged(dpu_set, DPU_XFER_FROM_DPU, send_buffer, send_base, send_size, start_offset);
+
+        //chunks are received in the order of the source ranks
+        for(uint32_t dst=0; dst<nr_dpus; dst++){
+            uint32_t dst_rank = pidcomm_comm_rank(manager, comm, dst);
+            uint8_t* recv = recv_buffer + recv_base[dst];
+            for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+                uint32_t src = pidcomm_comm_member(manager, comm, dst, rank);
+                uint32_t count = send_counts[src * num_comm_dpu + dst_rank];
+                memcpy(recv, send_buffer + send_base[src] + send_displ[src * num_comm_dpu + dst_rank], count);
+                recv += count;
+            }
+        }
+
+        pidcomm_copy_ragged(dpu_set, DPU_XFER_TO_DPU, recv_buffer, recv_base, recv_size, target_offset);
+
+        free(send_buffer);
+        free(recv_buffer);
+    }
+    free(recv_base);
+    free(send_base);
+    free(recv_size);
+    free(send_size);
+    free(send_displ);
+}
+
+//Index of the pass of the chunks from src_dpu to dst_dpu: a pass moves one line range of a source rotate group into
+//a destination rotate group, every lane rotated by the same number of lanes
+static uint32_t pidcomm_alltoallv_pass(uint32_t nr_rg, uint32_t src_dpu, uint32_t dst_dpu){
+    return ((src_dpu / 8) * nr_rg + dst_dpu / 8) * 8 + (dst_dpu % 8 + 8 - src_dpu % 8) % 8;
+}
+
+//Rotate-and-stream over the populated lines only. A pass is as long as the largest of its 8 chunks, and passes whose
+//chunks are all empty move nothing. Every DPU receives its table of counts and slots, packs its chunks so that
+//those of a pass line up across the rotate group, and unpacks the received ones in the order of the source ranks.
+//Returns false when the set or the MRAM cannot hold the pass, leaving the exchange to the host.
+static bool pidcomm_alltoallv_rns(hypercube_manager* manager, char* comm, uint32_t* send_counts, uint32_t start_offset, uint32_t target_offset){
+    struct dpu_set_t dpu_set = manager->dpu_set;
+    struct dpu_set_t dpu;
+    uint32_t nr_dpus, i;
+    uint32_t used, peak, largest_free;
+
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
+    if(!pidcomm_has_full_ranks(dpu_set) || nr_dpus != dpu_set.list.nr_ranks * 64) return false;
+    if(dpu_set.list.ranks[0]->handler_context->handler->all_to_all_v_rns == NULL) return false;
+
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+    uint32_t nr_rg = nr_dpus / 8;
+    uint32_t nr_passes = nr_rg * nr_rg * 8;
+    uint32_t* pass_length = calloc(nr_passes, sizeof(uint32_t));
+    uint32_t* send_slot = malloc(sizeof(uint32_t) * nr_passes);
+    uint32_t* recv_slot = malloc(sizeof(uint32_t) * nr_passes);
+    uint64_t send_area_size = 0;
+    uint64_t recv_area_size = 0;
+    uint32_t num_passes = 0;
+
+    for(uint32_t src=0; src<nr_dpus; src++){
+        for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+            uint32_t count = send_counts[src * num_comm_dpu + rank];
+            uint32_t pass = pidcomm_alltoallv_pass(nr_rg, src, pidcomm_comm_member(manager, comm, src, rank));
+
+            pidcomm_check_count(count);
+            if(count > pass_length[pass]) pass_length[pass] = count;
+        }
+    }
+    //a source group sends its passes in the order of the destination groups, a destination group receives them in the
+    //order of the source groups
+    for(uint32_t src_rg=0; src_rg<nr_rg; src_rg++){
+        uint64_t slot = 0;
+        for(uint32_t pass=src_rg * nr_rg * 8; pass<(src_rg + 1) * nr_rg * 8; pass++){
+            send_slot[pass] = slot;
+            slot += pass_length[pass];
+            if(pass_length[pass] != 0) num_passes++;
+        }
+        if(slot > send_area_size) send_area_size = slot;
+    }
+    for(uint32_t dst_rg=0; dst_rg<nr_rg; dst_rg++){
+        uint64_t slot = 0;
+        for(uint32_t src_rg=0; src_rg<nr_rg; src_rg++){
+            for(uint32_t rot=0; rot<8; rot++){
+                uint32_t pass = (src_rg * nr_rg + dst_rg) * 8 + rot;
+                recv_slot[pass] = slot;
+                slot += pass_length[pass];
+            }
+        }
+        if(slot > recv_area_size) recv_area_size = slot;
+    }
+
+    uint32_t table_size = 2 * num_comm_dpu * sizeof(count_slot_t);
+    pidcomm_mram_usage(manager, &used, &peak, &largest_free);
+    if(num_passes != 0 && send_area_size + recv_area_size + table_size + 3 * PIDCOMM_MRAM_DMA_SIZE > largest_free){
+        free(recv_slot);
+        free(send_slot);
+        free(pass_length);
+        return false;
+    }
+
+    if(num_passes != 0){
+        //send entries in the order of the destination ranks, then receive entries in the order of the source ranks
+        count_slot_t* tables = malloc((size_t)nr_dpus * table_size);
+        uint32_t* passes = malloc(sizeof(uint32_t) * 6 * num_passes);
+        uint32_t table = pidcomm_mram_alloc(manager, table_size);
+        uint32_t send_area = pidcomm_mram_alloc(manager, send_area_size);
+        uint32_t recv_area = pidcomm_mram_alloc(manager, recv_area_size);
+
+        for(uint32_t dpu_id=0; dpu_id<nr_dpus; dpu_id++){
+            count_slot_t* entry = tables + (size_t)dpu_id * 2 * num_comm_dpu;
+            uint32_t dpu_rank = pidcomm_comm_rank(manager, comm, dpu_id);
+
+            for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+                uint32_t peer = pidcomm_comm_member(manager, comm, dpu_id, rank);
+                entry[rank].count = send_counts[dpu_id * num_comm_dpu + rank];
+                entry[rank].slot = send_slot[pidcomm_alltoallv_pass(nr_rg, dpu_id, peer)];
+                entry[num_comm_dpu + rank].count = send_counts[peer * num_comm_dpu + dpu_rank];
+                entry[num_comm_dpu + rank].slot = recv_slot[pidcomm_alltoallv_pass(nr_rg, peer, dpu_id)];
+            }
+        }
+        for(uint32_t pass=0, k=0; pass<nr_passes; pass++){
+            if(pass_length[pass] == 0) continue;
+            uint32_t* entry = passes + 6 * k++;
+            entry[0] = pass / 8 / nr_rg;
+            entry[1] = pass / 8 % nr_rg;
+            entry[2] = pass % 8;
+            entry[3] = send_slot[pass];
+            entry[4] = recv_slot[pass];
+            entry[5] = pass_length[pass];
+        }
+
+        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
+            DPU_ASSERT(dpu_prepare_xfer(dpu, tables + (size_t)i * 2 * num_comm_dpu));
+        }
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, table, table_size, DPU_XFER_DEFAULT));
+
+        pidcomm_plan_t plan = {.manager = manager, .nr_dpus = nr_dpus, .num_comm_dpu = num_comm_dpu};
+        pidcomm_relocation_t pack, unpack;
+        struct dpu_program_t* user_program = pidcomm_save_program(manager);
+
+        plan.sync_buffer = (uint64_t*) calloc(nr_dpus, sizeof(uint64_t));
+        pidcomm_set_relocation(&plan, &pack, RELOCATE_PACK_COUNTS, start_offset, send_area, 0, 0, 0);
+        pidcomm_set_relocation(&plan, &unpack, RELOCATE_UNPACK_COUNTS, recv_area, target_offset, 0, 0, 0);
+        for(uint32_t dpu_id=0; dpu_id<nr_dpus; dpu_id++){
+            pack.dpu_argument[dpu_id].table_offset = table;
+            unpack.dpu_argument[dpu_id].table_offset = table + num_comm_dpu * sizeof(count_slot_t);
+        }
+
+        pidcomm_run_relocation(&plan, &pack, DPU_SYNCHRONOUS);
+        pidcomm_sync(&plan, send_area);
+        all_to_all_v(&dpu_set, send_area, recv_area, num_passes, passes);
+        pidcomm_sync(&plan, 0);
+        pidcomm_run_relocation(&plan, &unpack, DPU_SYNCHRONOUS);
+
+        pidcomm_restore_program(manager, user_program);
+        free(unpack.dpu_argument);
+        free(pack.dpu_argument);
+        free(plan.sync_buffer);
+        pidcomm_mram_free(manager, recv_area);
+        pidcomm_mram_free(manager, send_area);
+        pidcomm_mram_free(manager, table);
+        free(passes);
+        free(tables);
+    }
+    free(recv_slot);
+    free(send_slot);
+    free(pass_length);
+    return true;
+}
+
+static void pidcomm_run_alltoallv(hypercube_manager* manager, char* comm, uint32_t* send_counts, uint32_t start_offset, uint32_t target_offset){
+    if(pidcomm_alltoallv_rns(manager, comm, send_counts, start_offset, target_offset)) return;
+
+    if(manager->log_algorithm){
+        fprintf(stderr, "PID-Comm: the alltoallv does not fit whole ranks of rotate groups or the MRAM, moved through the host\n");
+    }
+    pidcomm_alltoallv_host(manager, comm, send_counts, start_offset, target_offset);
+}
+
+__API_SYMBOL__
+void pidcomm_alltoallv(hypercube_manager* manager, char* comm, uint32_t* send_counts, uint32_t start_offset, uint32_t target_offset){
+    pidcomm_wait_pending();
+    pidcomm_run_alltoallv(manager, comm, send_counts, start_offset, target_offset);
+}
+
+static void pidcomm_run_allgatherv(hypercube_manager* manager, char* comm, uint32_t* counts, uint32_t start_offset, uint32_t target_offset){
+    struct dpu_set_t dpu_set = manager->dpu_set;
+    uint32_t nr_dpus;
+
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+
+    uint32_t* recv_size = malloc(sizeof(uint32_t) * nr_dpus);
+    size_t* send_base = malloc(sizeof(size_t) * nr_dpus);
+    size_t* recv_base = malloc(sizeof(size_t) * nr_dpus);
+    size_t total_send = 0;
+    size_t total_recv = 0;
+
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        uint32_t recv = 0;
+        pidcomm_check_count(counts[dpu]);
+        for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+            recv += counts[pidcomm_comm_member(manager, comm, dpu, rank)];
+        }
+        send_base[dpu] = total_send;
+        total_send += counts[dpu];
+        recv_size[dpu] = recv;
+        recv_base[dpu] = total_recv;
+        total_recv += recv;
+    }
+
+    if(total_send != 0){
+        uint8_t* send_buffer = malloc(total_send);
+        uint8_t* recv_buffer = malloc(total_recv);
+
+        pidcomm_copy_ragged(dpu_set, DPU_XFER_FROM_DPU, send_buffer, send_base, counts, start_offset);
+
+        for(uint32_t dst=0; dst<nr_dpus; dst++){
+            uint8_t* recv = recv_buffer + recv_base[dst];
+            for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+                uint32_t src = pidcomm_comm_member(manager, comm, dst, rank);
+                memcpy(recv, send_buffer + send_base[src], counts[src]);
+                recv += counts[src];
+            }
+        }
+
+        pidcomm_copy_ragged(dpu_set, DPU_XFER_TO_DPU, recv_buffer, recv_base, recv_size, target_offset);
+
+        free(send_buffer);
+        free(recv_buffer);
+    }
+    free(recv_base);
+    free(send_base);
+    free(recv_size);
+}
+
+__API_SYMBOL__
+void pidcomm_allgatherv(hypercube_manager* manager, char* comm, uint32_t* counts, uint32_t start_offset, uint32_t target_offset){
+    pidcomm_wait_pending();
+    pidcomm_run_allgatherv(manager, comm, counts, start_offset, target_offset);
+}
+
+static float pidcomm_half_to_float(uint16_t half){
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+    uint32_t bits;
+    float value;
+
+    if(exponent == 0){
+        //zero and subnormals, mantissa * 2^-24
+        value = (float)mantissa / 16777216.0f;
+        return sign ? -value : value;
+    }
+    if(exponent == 0x1f) bits = sign | 0x7f800000 | (mantissa << 13);
+    else bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+//Rounds to the nearest even, as _mm512_cvtps_ph does in the host collectives
+static uint16_t pidcomm_float_to_half(float value){
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint16_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = ((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+    uint32_t shift, half, remainder;
+
+    if(((bits >> 23) & 0xff) == 0xff) return sign | 0x7c00 | (mantissa ? 0x200 | (mantissa >> 13) : 0);
+    if(exponent >= 0x1f) return sign | 0x7c00;
+    if(exponent <= 0){
+        if(exponent < -10) return sign;
+        mantissa |= 0x800000;
+        shift = 14 - exponent;
+    }
+    else{
+        mantissa |= (uint32_t)exponent << 23;
+        shift = 13;
+    }
+    //a carry out of the mantissa increments the exponent, up to infinity
+    half = 1u << (shift - 1);
+    remainder = mantissa & ((1u << shift) - 1);
+    mantissa >>= shift;
+    if(remainder > half || (remainder == half && (mantissa & 1))) mantissa++;
+    return sign | mantissa;
+}
+
+static uint16_t pidcomm_float_to_bfloat(float value){
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    if((bits & 0x7fffffff) > 0x7f800000) return (bits >> 16) | 0x40;
+    return (bits + 0x7fff + ((bits >> 16) & 1)) >> 16;
+}
+
+//fp16 and bf16 are reduced in float and rounded once, after the last source
+static void pidcomm_load_floats(float* dst, const uint8_t* src, uint32_t nr_elements, uint32_t size){
+    uint16_t half;
+    uint32_t bits;
+
+    if(PIDCOMM_DTYPE_KIND(size) == PIDCOMM_DTYPE_KIND_BFLOAT16){
+        for(uint32_t e=0; e<nr_elements; e++){
+            memcpy(&half, src + 2 * e, sizeof(half));
+            bits = (uint32_t)half << 16;
+            memcpy(dst + e, &bits, sizeof(bits));
+        }
+    }
+    else{
+        for(uint32_t e=0; e<nr_elements; e++){
+            memcpy(&half, src + 2 * e, sizeof(half));
+            dst[e] = pidcomm_half_to_float(half);
+        }
+    }
+}
+
+static void pidcomm_store_floats(uint8_t* dst, const float* src, uint32_t nr_elements, uint32_t size){
+    uint16_t half;
+
+    for(uint32_t e=0; e<nr_elements; e++){
+        half = PIDCOMM_DTYPE_KIND(size) == PIDCOMM_DTYPE_KIND_BFLOAT16 ? pidcomm_float_to_bfloat(src[e]) : pidcomm_float_to_half(src[e]);
+        memcpy(dst + 2 * e, &half, sizeof(half));
+    }
+}
+
+/* The host reductions select the element type and the operator once per call, and run one typed loop per source,
+ * so the compiler vectorizes the element loop like the lane reducers of the rotate-and-stream path.
+ * Sums and products wrap in the unsigned type of the same width, as the vector adds do.
+ */
+#define PIDCOMM_HOST_REDUCE_LOOP(type, expr)                                            \
+    do                                                                                  \
+    {                                                                                   \
+        for(uint32_t i=1; i<nr_src; i++){                                               \
+            const uint8_t* in = src[i];                                                 \
+            for(uint32_t e=0; e<nr_elements; e++){                                      \
+                type a, b;                                                              \
+                memcpy(&a, dst + e * sizeof(type), sizeof(type));                      \
+                memcpy(&b, in + e * sizeof(type), sizeof(type));                        \
+                a = (expr);                                                             \
+                memcpy(dst + e * sizeof(type), &a, sizeof(type));                       \
+            }                                                                           \
+        }                                                                               \
+    } while (0)
+
+#define PIDCOMM_DEFINE_HOST_REDUCE_INT(name, type, utype, saturate)                                      \
+static void name(uint8_t* dst, uint8_t** src, uint32_t nr_src, uint32_t nr_elements, uint32_t reduce_type){ \
+    type r;                                                                                             \
+    switch(reduce_type){                                                                                \
+        case PIDCOMM_OP_MAX:                                                                            \
+            PIDCOMM_HOST_REDUCE_LOOP(type, a > b ? a : b);                                              \
+            break;                                                                                      \
+        case PIDCOMM_OP_MIN:                                                                            \
+            PIDCOMM_HOST_REDUCE_LOOP(type, a < b ? a : b);                                              \
+            break;                                                                                      \
+        case PIDCOMM_OP_SAT_SUM:                                                                        \
+            PIDCOMM_HOST_REDUCE_LOOP(type, __builtin_add_overflow(a, b, &r) ? (saturate) : r);          \
+            break;                                                                                      \
+        case PIDCOMM_OP_PROD:                                                                           \
+            PIDCOMM_HOST_REDUCE_LOOP(type, (type)((utype)a * (utype)b));                                \
+            break;                                                                                      \
+        case PIDCOMM_OP_BAND:                                                                           \
+            PIDCOMM_HOST_REDUCE_LOOP(type, a & b);                                                      \
+            break;                                                                                      \
+        case PIDCOMM_OP_BOR:                                                                            \
+            PIDCOMM_HOST_REDUCE_LOOP(type, a | b);                                                      \
+            break;                                                                                      \
+        case PIDCOMM_OP_BXOR:                                                                           \
+            PIDCOMM_HOST_REDUCE_LOOP(type, a ^ b);                                                      \
+            break;                                                                                      \
+        default:                                                                                        \
+            PIDCOMM_HOST_REDUCE_LOOP(type, (type)((utype)a + (utype)b));                                \
+            break;                                                                                      \
+    }                                                                                                   \
+}
+
+//Saturating sums clamp to the bound on the side of the overflow, which only the signed types can underflow
+PIDCOMM_DEFINE_HOST_REDUCE_INT(pidcomm_host_reduce_i8, int8_t, uint8_t, b < 0 ? INT8_MIN : INT8_MAX)
+PIDCOMM_DEFINE_HOST_REDUCE_INT(pidcomm_host_reduce_i16, int16_t, uint16_t, b < 0 ? INT16_MIN : INT16_MAX)
+PIDCOMM_DEFINE_HOST_REDUCE_INT(pidcomm_host_reduce_i32, int32_t, uint32_t, b < 0 ? INT32_MIN : INT32_MAX)
+PIDCOMM_DEFINE_HOST_REDUCE_INT(pidcomm_host_reduce_i64, int64_t, uint64_t, b < 0 ? INT64_MIN : INT64_MAX)
+PIDCOMM_DEFINE_HOST_REDUCE_INT(pidcomm_host_reduce_u8, uint8_t, uint8_t, UINT8_MAX)
+PIDCOMM_DEFINE_HOST_REDUCE_INT(pidcomm_host_reduce_u16, uint16_t, uint16_t, UINT16_MAX)
+PIDCOMM_DEFINE_HOST_REDUCE_INT(pidcomm_host_reduce_u32, uint32_t, uint32_t, UINT32_MAX)
+PIDCOMM_DEFINE_HOST_REDUCE_INT(pidcomm_host_reduce_u64, uint64_t, uint64_t, UINT64_MAX)
+
+//Floating-point sums saturate to infinity, so the saturating sum is the plain sum
+static void pidcomm_host_reduce_f32(uint8_t* dst, uint8_t** src, uint32_t nr_src, uint32_t nr_elements, uint32_t reduce_type){
+    switch(reduce_type){
+        case PIDCOMM_OP_MAX:
+            PIDCOMM_HOST_REDUCE_LOOP(float, a > b ? a : b);
+            break;
+        case PIDCOMM_OP_MIN:
+            PIDCOMM_HOST_REDUCE_LOOP(float, a < b ? a : b);
+            break;
+        case PIDCOMM_OP_PROD:
+            PIDCOMM_HOST_REDUCE_LOOP(float, a * b);
+            break;
+        default:
+            PIDCOMM_HOST_REDUCE_LOOP(float, a + b);
+            break;
+    }
+}
+
+typedef void (*pidcomm_host_reduce_fn)(uint8_t* dst, uint8_t** src, uint32_t nr_src, uint32_t nr_elements, uint32_t reduce_type);
+
+static pidcomm_host_reduce_fn pidcomm_host_reducer(uint32_t size){
+    static const pidcomm_host_reduce_fn signed_reducers[4] = {pidcomm_host_reduce_i8, pidcomm_host_reduce_i16, pidcomm_host_reduce_i32, pidcomm_host_reduce_i64};
+    static const pidcomm_host_reduce_fn unsigned_reducers[4] = {pidcomm_host_reduce_u8, pidcomm_host_reduce_u16, pidcomm_host_reduce_u32, pidcomm_host_reduce_u64};
+    uint32_t bytes = PIDCOMM_DTYPE_SIZE(size);
+    uint32_t log_bytes = bytes == 1 ? 0 : bytes == 2 ? 1 : bytes == 4 ? 2 : 3;
+
+    switch(PIDCOMM_DTYPE_KIND(size)){
+        case PIDCOMM_DTYPE_KIND_FLOAT32:
+        case PIDCOMM_DTYPE_KIND_BFLOAT16:
+        case PIDCOMM_DTYPE_KIND_FLOAT16:
+            return pidcomm_host_reduce_f32;
+        case PIDCOMM_DTYPE_KIND_UINT:
+            return unsigned_reducers[log_bytes];
+        default:
+            return signed_reducers[log_bytes];
+    }
+}
+
+//Element-wise reduction of nr_src chunks of length bytes into dst, in the order of the sources
+static void pidcomm_host_reduce(uint8_t* dst, uint8_t** src, uint32_t nr_src, uint32_t length, uint32_t size, uint32_t reduce_type){
+    uint32_t kind = PIDCOMM_DTYPE_KIND(size);
+    uint32_t bytes = PIDCOMM_DTYPE_SIZE(size);
+    uint32_t nr_elements = length / bytes;
+    pidcomm_host_reduce_fn reducer = pidcomm_host_reducer(size);
+
+    if(kind == PIDCOMM_DTYPE_KIND_BFLOAT16 || kind == PIDCOMM_DTYPE_KIND_FLOAT16){
+        float* acc = malloc((size_t)nr_elements * sizeof(float));
+        float* in = malloc((size_t)nr_elements * sizeof(float));
+        uint8_t* pair[2] = {(uint8_t*)acc, (uint8_t*)in};
+
+        pidcomm_load_floats(acc, src[0], nr_elements, size);
+        for(uint32_t i=1; i<nr_src; i++){
+            pidcomm_load_floats(in, src[i], nr_elements, size);
+            reducer((uint8_t*)acc, pair, 2, nr_elements, reduce_type);
+        }
+        pidcomm_store_floats(dst, acc, nr_elements, size);
+        free(in);
+        free(acc);
+        return;
+    }
+
+    if(dst != src[0]) memcpy(dst, src[0], (size_t)nr_elements * bytes);
+    reducer(dst, src, nr_src, nr_elements, reduce_type);
+}
+
+static void pidcomm_run_reduce_scatterv(hypercube_manager* manager, char* comm, uint32_t* counts, uint32_t start_offset, uint32_t target_offset,
+                    uint32_t size, uint32_t reduce_type){
+    struct dpu_set_t dpu_set = manager->dpu_set;
+    uint32_t nr_dpus;
+
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+
+    //the bitwise operators reduce the raw bits, so floating-point data is reduced as integers of the same size
+    if(reduce_type >= PIDCOMM_OP_BAND) size = PIDCOMM_DTYPE_SIZE(size);
+
+    //every DPU holds one chunk per member of its communicator, packed in rank order
+    uint32_t* send_size = malloc(sizeof(uint32_t) * nr_dpus);
+    size_t* send_base = malloc(sizeof(size_t) * nr_dpus);
+    size_t* recv_base = malloc(sizeof(size_t) * nr_dpus);
+    size_t total_send = 0;
+    size_t total_recv = 0;
+
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        uint32_t send = 0;
+        pidcomm_check_count(counts[dpu]);
+        for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+            send += counts[pidcomm_comm_member(manager, comm, dpu, rank)];
+        }
+        send_size[dpu] = send;
+        send_base[dpu] = total_send;
+        total_send += send;
+        recv_base[dpu] = total_recv;
+        total_recv += counts[dpu];
+    }
+
+    if(total_send != 0){
+        uint8_t* send_buffer = malloc(total_send);
+        uint8_t* recv_buffer = malloc(total_recv);
+        uint8_t** chunks = malloc(sizeof(uint8_t*) * num_comm_dpu);
+
+        pidcomm_copy_ragged(dpu_set, DPU_XFER_FROM_DPU, send_buffer, send_base, send_size, start_offset);
+
+        for(uint32_t dst=0; dst<nr_dpus; dst++){
+            uint32_t dst_rank = pidcomm_comm_rank(manager, comm, dst);
+            uint32_t displ = 0;
+
+            //the chunk of dst is at the same offset on every member
+            for(uint32_t rank=0; rank<dst_rank; rank++){
+                displ += counts[pidcomm_comm_member(manager, comm, dst, rank)];
+            }
+            for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+                chunks[rank] = send_buffer + send_base[pidcomm_comm_member(manager, comm, dst, rank)] + displ;
+            }
+            pidcomm_host_reduce(recv_buffer + recv_base[dst], chunks, num_comm_dpu, counts[dst], size, reduce_type);
+        }
+
+        pidcomm_copy_ragged(dpu_set, DPU_XFER_TO_DPU, recv_buffer, recv_base, counts, target_offset);
+
+        free(chunks);
+        free(send_buffer);
+        free(recv_buffer);
+    }
+    free(recv_base);
+    free(send_base);
+    free(send_size);
+}
+
+__API_SYMBOL__
+void pidcomm_reduce_scatterv(hypercube_manager* manager, char* comm, uint32_t* counts, uint32_t start_offset, uint32_t target_offset,
+                    uint32_t size, uint32_t reduce_type){
+    pidcomm_wait_pending();
+    pidcomm_run_reduce_scatterv(manager, comm, counts, start_offset, target_offset, size, reduce_type);
+}
+
+//Every DPU is written with the block read from source[dpu], straight from the buffer of the source without a host copy.
+//DPUs whose source is PIDCOMM_NO_SOURCE keep their data.
+#define PIDCOMM_NO_SOURCE UINT32_MAX
+
+static void pidcomm_write_permuted(struct dpu_set_t dpu_set, uint8_t* buffer, uint32_t* source, uint32_t total_data_size, uint32_t dst_offset){
+    struct dpu_set_t dpu;
+    uint32_t nr_dpus, i;
+
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
+    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
+        if(source[i] == PIDCOMM_NO_SOURCE) continue;
+        DPU_ASSERT(dpu_prepare_xfer(dpu, buffer + (size_t)source[i] * total_data_size));
+    }
+    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, dst_offset, total_data_size, DPU_XFER_DEFAULT));
+}
+
+//The rotate-and-stream pass writes whole destination lines while other threads read their sources, so the two areas
+//must not overlap, unless they are the same area and every DPU read from keeps its own bytes.
+static bool pidcomm_can_permute_rns(hypercube_manager* manager, uint32_t* source, uint32_t nr_dpus, uint32_t total_data_size,
+                    uint32_t src_offset, uint32_t dst_offset){
+    struct dpu_set_t dpu_set = manager->dpu_set;
+
+    if(!pidcomm_has_full_ranks(dpu_set) || nr_dpus != dpu_set.list.nr_ranks * 64) return false;
+    if(dpu_set.list.ranks[0]->handler_context->handler->permute_rns == NULL) return false;
+    if(src_offset + total_data_size <= dst_offset || dst_offset + total_data_size <= src_offset) return true;
+    if(src_offset != dst_offset) return false;
+
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        uint32_t src = source[dpu];
+        if(src != PIDCOMM_NO_SOURCE && source[src] != PIDCOMM_NO_SOURCE && source[src] != src) return false;
+    }
+    return true;
+}
+
+//Rotate-and-stream between the rotate groups when the set allows it, through a host buffer otherwise
+static void pidcomm_permute(hypercube_manager* manager, uint32_t* source, uint32_t nr_dpus, uint32_t total_data_size,
+                    uint32_t src_offset, uint32_t dst_offset){
+    pidcomm_check_count(total_data_size);
+    if(total_data_size == 0) return;
+
+    if(pidcomm_can_permute_rns(manager, source, nr_dpus, total_data_size, src_offset, dst_offset)){
+        DPU_ASSERT(permute(&manager->dpu_set, src_offset, dst_offset, total_data_size, source));
+        return;
+    }
+    if(manager->log_algorithm){
+        fprintf(stderr, "PID-Comm: the point-to-point transfer does not fit whole ranks of rotate groups, moved through the host\n");
     }
 
-    else if(axis_len[0] < 8 && ((num_comm_rg < 8) && (num_comm_rg > 1) )){
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_SHORT_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE_SHORT_INT32, NULL));
+    uint8_t* buffer = malloc((size_t)nr_dpus * total_data_size);
 
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset+buffer_offset;
-            dpu_argument[i].target_offset = target_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = num_comm_rg;
-        }
-            
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+    pidcomm_copy_packed(manager->dpu_set, DPU_XFER_FROM_DPU, buffer, src_offset, total_data_size);
+    pidcomm_write_permuted(manager->dpu_set, buffer, source, total_data_size, dst_offset);
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+    free(buffer);
+}
 
-    }
-    else if(!comm_type){
+//Every member receives the block of the root of its communicator. The rotate-and-stream pass replicates the root lanes
+//into each destination line in one read and one write, and the roots keep their bytes, so the block stays in place.
+//Without it, only the roots are read to the host and their blocks are written to the other members.
+__API_SYMBOL__
+void pidcomm_bcast(hypercube_manager* manager, char* comm, uint32_t root, uint32_t total_data_size, uint32_t offset){
+    struct dpu_set_t dpu_set = manager->dpu_set;
+    struct dpu_set_t dpu;
+    uint32_t nr_dpus, i;
 
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_COUNTERCLOCKWISE_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_COUNTERCLOCKWISE_INT32, NULL));
+    pidcomm_wait_pending();
+    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
 
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset + buffer_offset;
-            dpu_argument[i].target_offset = target_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = num_comm_rg;
-        }
-            
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+    pidcomm_check_count(total_data_size);
+    if(root >= num_comm_dpu){
+        fprintf(stderr, "PID-Comm: the root %u is not in communicators of %u DPUs\n", root, num_comm_dpu);
+        DPU_ASSERT(DPU_ERR_INVALID_DPU_SET);
+    }
+    if(total_data_size == 0 || num_comm_dpu == 1) return;
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+    uint32_t* source = malloc(sizeof(uint32_t) * nr_dpus);
+    for(uint32_t each_dpu=0; each_dpu<nr_dpus; each_dpu++){
+        uint32_t root_dpu = pidcomm_comm_member(manager, comm, each_dpu, root);
+        source[each_dpu] = (root_dpu == each_dpu) ? PIDCOMM_NO_SOURCE : root_dpu;
+    }
+    if(pidcomm_can_permute_rns(manager, source, nr_dpus, total_data_size, offset, offset)){
+        DPU_ASSERT(permute(&manager->dpu_set, offset, offset, total_data_size, source));
+        free(source);
+        return;
     }
-    else{
-        // if(size==1) DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_AR_2_Y_INT8"), NULL));
-        // else DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_AR_2_Y_INT32"), NULL));
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_INCREMENTAL_COUNTERCLOCKWISE_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_INCREMENTAL_COUNTERCLOCKWISE_INT32, NULL));
-
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset + buffer_offset;
-            dpu_argument[i].target_offset = target_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = num_comm_rg;
-        }
 
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-        }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+    //slot[dpu]: buffer of the communicator whose root is dpu
+    uint32_t* slot = malloc(sizeof(uint32_t) * nr_dpus);
+    uint8_t* buffer = malloc((size_t)(nr_dpus / num_comm_dpu) * total_data_size);
+    uint32_t nr_roots = 0;
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
+        if(source[i] != PIDCOMM_NO_SOURCE) continue;
+        slot[i] = nr_roots++;
+        DPU_ASSERT(dpu_prepare_xfer(dpu, buffer + (size_t)slot[i] * total_data_size));
     }
-    i=0;
+    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, offset, total_data_size, DPU_XFER_DEFAULT));
+
     DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
+        if(source[i] == PIDCOMM_NO_SOURCE) continue;
+        DPU_ASSERT(dpu_prepare_xfer(dpu, buffer + (size_t)slot[source[i]] * total_data_size));
     }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
+    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, offset, total_data_size, DPU_XFER_DEFAULT));
+
+    free(slot);
+    free(buffer);
+    free(source);
 }
 
 __API_SYMBOL__
-void pidcomm_allgather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
-                        uint32_t target_offset, uint32_t buffer_offset){
+void pidcomm_shift(hypercube_manager* manager, uint32_t axis, int32_t k, uint32_t total_data_size, uint32_t src_offset, uint32_t dst_offset){
+    uint32_t nr_dpus;
+    uint32_t stride = 1;
+
+    pidcomm_wait_pending();
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &nr_dpus));
+    //checks that the hypercube matches the DPUs of the set
+    pidcomm_comm_size(manager, "", nr_dpus);
+    if(axis >= manager->dimension){
+        fprintf(stderr, "PID-Comm: the hypercube has no axis %u\n", axis);
+        DPU_ASSERT(DPU_ERR_INVALID_DPU_SET);
+    }
 
-    struct dpu_set_t dpu_set = manager->dpu_set;
-    uint32_t dimension = manager->dimension;
-    uint32_t* axis_len = manager->axis_len;
+    for(uint32_t dim=0; dim<axis; dim++){
+        stride *= manager->axis_len[dim];
+    }
+    uint32_t axis_len = manager->axis_len[axis];
+    //the DPU at coordinate c receives from the DPU at c - k
+    uint32_t back = (uint32_t)(((int64_t)axis_len - (int64_t)k % (int64_t)axis_len) % axis_len);
+    uint32_t* source = malloc(sizeof(uint32_t) * nr_dpus);
+
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        uint32_t coord = (dpu / stride) % axis_len;
+        source[dpu] = dpu - coord * stride + ((coord + back) % axis_len) * stride;
+    }
+    pidcomm_permute(manager, source, nr_dpus, total_data_size, src_offset, dst_offset);
 
-    uint32_t* comm_axis = malloc(sizeof(uint32_t) * dimension);
+    free(source);
+}
 
-    for(uint32_t dim=0; dim<dimension; dim++){
-        comm_axis[dim] = (int)(*(comm+dim))-48;
+__API_SYMBOL__
+void pidcomm_sendrecv(hypercube_manager* manager, uint32_t* destination, uint32_t total_data_size, uint32_t src_offset, uint32_t dst_offset){
+    uint32_t nr_dpus;
+
+    pidcomm_wait_pending();
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &nr_dpus));
+
+    uint32_t* source = malloc(sizeof(uint32_t) * nr_dpus);
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        source[dpu] = PIDCOMM_NO_SOURCE;
     }
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        if(destination[dpu] == PIDCOMM_NO_SOURCE) continue;
+        if(destination[dpu] >= nr_dpus || source[destination[dpu]] != PIDCOMM_NO_SOURCE){
+            fprintf(stderr, "PID-Comm: sendrecv destinations must be distinct DPUs of the set\n");
+            DPU_ASSERT(DPU_ERR_INVALID_DPU_SET);
+        }
+        source[destination[dpu]] = dpu;
+    }
+    pidcomm_permute(manager, source, nr_dpus, total_data_size, src_offset, dst_offset);
 
+    free(source);
+}
 
-    struct dpu_set_t dpu;
+//The transpose runs on the rotate groups when the first transposed axis either keeps the lanes, so that every group
+//is copied whole to one group, or runs along the lanes and fills whole groups, so that 8 x 8 tiles of groups are
+//transposed lane by lane. In place, the two tiles of each pair trade places and a block cannot be transposed itself.
+static bool pidcomm_can_transpose_rns(hypercube_manager* manager, uint32_t nr_dpus, uint32_t axis_len, uint32_t stride, uint32_t total_data_size,
+                    uint32_t src_offset, uint32_t dst_offset, bool transpose_block, uint32_t size){
+    struct dpu_set_t dpu_set = manager->dpu_set;
+
+    if(!pidcomm_has_full_ranks(dpu_set) || nr_dpus != dpu_set.list.nr_ranks * 64) return false;
+    if(dpu_set.list.ranks[0]->handler_context->handler->transpose_rns == NULL) return false;
+    if(stride % 8 != 0 && !(stride == 1 && axis_len % 8 == 0)) return false;
+    //the elements of a block are moved in units of 8 bytes or of whole elements within the 8-byte word of every DPU
+    if(transpose_block && size % 8 != 0 && 8 % size != 0) return false;
+    if(src_offset + total_data_size <= dst_offset || dst_offset + total_data_size <= src_offset) return true;
+    return src_offset == dst_offset && !transpose_block;
+}
+
+//Block (i, j) of the grid formed by the two communicating axes moves to (j, i), optionally transposed itself
+__API_SYMBOL__
+void pidcomm_transpose(hypercube_manager* manager, char* comm, uint32_t rows, uint32_t cols, uint32_t size,
+                    uint32_t src_offset, uint32_t dst_offset, bool transpose_block){
     uint32_t nr_dpus;
-    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
-    dpu_arguments_comm_t* dpu_argument = (dpu_arguments_comm_t*) malloc(sizeof(dpu_arguments_comm_t) * nr_dpus);
-    uint32_t num_comm_dpu = 1;
-    uint32_t comm_type;
+    uint32_t axis[2];
+    uint32_t stride[2];
+    uint32_t nr_axes = 0;
+    size_t comm_length = strlen(comm);
+    uint32_t total_data_size = rows * cols * size;
+
+    pidcomm_wait_pending();
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &nr_dpus));
+    pidcomm_comm_size(manager, comm, nr_dpus);
+
+    for(uint32_t dim=0, len=1; dim<manager->dimension; len*=manager->axis_len[dim], dim++){
+        if(dim >= comm_length || comm[dim] != '1') continue;
+        if(nr_axes < 2){
+            axis[nr_axes] = dim;
+            stride[nr_axes] = len;
+        }
+        nr_axes++;
+    }
+    if(nr_axes != 2 || manager->axis_len[axis[0]] != manager->axis_len[axis[1]]){
+        fprintf(stderr, "PID-Comm: transpose needs two communicating axes of the same length\n");
+        DPU_ASSERT(DPU_ERR_INVALID_DPU_SET);
+    }
+    pidcomm_check_count(total_data_size);
+    if(total_data_size == 0) return;
+
+    uint32_t axis_len = manager->axis_len[axis[0]];
+    uint32_t* source = malloc(sizeof(uint32_t) * nr_dpus);
 
-    if(comm_axis[0] == 1){
-        comm_type = 0;
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        uint32_t i = (dpu / stride[0]) % axis_len;
+        uint32_t j = (dpu / stride[1]) % axis_len;
+        source[dpu] = dpu - i * stride[0] - j * stride[1] + j * stride[0] + i * stride[1];
     }
-    else comm_type = 1;
 
-    
+    if(pidcomm_can_transpose_rns(manager, nr_dpus, axis_len, stride[0], total_data_size, src_offset, dst_offset, transpose_block, size)){
+        bool in_place = src_offset == dst_offset;
+        uint32_t num_rg = stride[0] == 1 ? 8 : 1;
+        uint32_t num_tiles = 0;
+        uint32_t* tile_src_rg = malloc(sizeof(uint32_t) * (nr_dpus / 8));
+        uint32_t* tile_dst_rg = malloc(sizeof(uint32_t) * (nr_dpus / 8));
+
+        for(uint32_t dpu=0; dpu<nr_dpus; dpu+=8){
+            uint32_t i = (dpu / stride[0]) % axis_len;
+            uint32_t j = (dpu / stride[1]) % axis_len;
+
+            if(num_rg == 1){
+                //in place, the pair of groups is swapped once and the diagonal stays
+                if(in_place && source[dpu] <= dpu) continue;
+                tile_src_rg[num_tiles] = dpu / 8;
+                tile_dst_rg[num_tiles] = source[dpu] / 8;
+                num_tiles++;
+                continue;
+            }
+            //the tile of groups holding rows i..i+7 of columns j..j+7
+            if(j % 8 != 0 || (in_place && i > j)) continue;
+            for(uint32_t k=0; k<8; k++){
+                tile_src_rg[num_tiles * 8 + k] = (dpu + k * stride[1]) / 8;
+                tile_dst_rg[num_tiles * 8 + k] = (source[dpu] + k * stride[1]) / 8;
+            }
+            num_tiles++;
+        }
+        DPU_ASSERT(transpose(&manager->dpu_set, src_offset, dst_offset, total_data_size, num_tiles, num_rg, tile_src_rg, tile_dst_rg, in_place,
+            transpose_block ? rows : 0, cols, size));
 
-    for(uint32_t dim=0; dim<dimension; dim++){
-        if(comm_axis[dim]==1){
-            num_comm_dpu *= axis_len[dim];
+        free(tile_src_rg);
+        free(tile_dst_rg);
+        free(source);
+        return;
+    }
+    if(manager->log_algorithm){
+        fprintf(stderr, "PID-Comm: the transpose does not fit whole ranks of rotate groups, moved through the host\n");
+    }
+
+    uint8_t* buffer = malloc((size_t)nr_dpus * total_data_size);
+
+    pidcomm_copy_packed(manager->dpu_set, DPU_XFER_FROM_DPU, buffer, src_offset, total_data_size);
+
+    if(transpose_block){
+        uint8_t* transposed = malloc((size_t)nr_dpus * total_data_size);
+
+        //row-major rows x cols blocks become row-major cols x rows blocks
+        for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+            uint8_t* block = buffer + (size_t)dpu * total_data_size;
+            uint8_t* block_t = transposed + (size_t)dpu * total_data_size;
+            for(uint32_t row=0; row<rows; row++){
+                for(uint32_t col=0; col<cols; col++){
+                    memcpy(block_t + ((size_t)col * rows + row) * size, block + ((size_t)row * cols + col) * size, size);
+                }
+            }
         }
+        free(buffer);
+        buffer = transposed;
     }
+    pidcomm_write_permuted(manager->dpu_set, buffer, source, total_data_size, dst_offset);
+
+    free(buffer);
+    free(source);
+}
+
+//Host path of the collectives with equal chunks: the data is read once, combined on the host and written back once
+static void pidcomm_run_host_all_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset,
+                    uint32_t size, uint32_t reduce_type){
+    uint32_t nr_dpus;
+
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+
+    pidcomm_check_count(total_data_size);
+    if(total_data_size == 0) return;
+    if(reduce_type >= PIDCOMM_OP_BAND) size = PIDCOMM_DTYPE_SIZE(size);
+
+    uint8_t* buffer = malloc((size_t)nr_dpus * total_data_size);
+    uint8_t* result = malloc((size_t)nr_dpus * total_data_size);
+    uint8_t** chunks = malloc(sizeof(uint8_t*) * num_comm_dpu);
+    uint32_t* source = malloc(sizeof(uint32_t) * nr_dpus);
 
-    T** result = (T**) calloc(nr_dpus, sizeof(T*));
-    for(int i=0; i<nr_dpus; i++)
-        result[i] = (T*) calloc(8/sizeof(T), sizeof(T));
-    int i;
+    pidcomm_copy_packed(manager->dpu_set, DPU_XFER_FROM_DPU, buffer, start_offset, total_data_size);
 
-    uint32_t num_comm_rg = 1;
-    for(uint32_t dim=0, len = 1; dim<dimension, len<8; len*=axis_len[dim], dim++){
-        if(comm_axis[dim] == 1){
-            if (axis_len[dim] <= (8/len)) num_comm_rg *= axis_len[dim];
-            else num_comm_rg *= (8/len);
+    //the result of each communicator is kept in the slot of its first member and written to every member
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        source[dpu] = pidcomm_comm_member(manager, comm, dpu, 0);
+        if(source[dpu] != dpu) continue;
+        for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+            chunks[rank] = buffer + (size_t)pidcomm_comm_member(manager, comm, dpu, rank) * total_data_size;
         }
-        if(num_comm_rg >= 8) num_comm_rg = 8;
+        pidcomm_host_reduce(result + (size_t)dpu * total_data_size, chunks, num_comm_dpu, total_data_size, size, reduce_type);
     }
-    //relocate before kernel
+    pidcomm_write_permuted(manager->dpu_set, result, source, total_data_size, target_offset);
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
+    free(source);
+    free(chunks);
+    free(result);
+    free(buffer);
+}
+
+__API_SYMBOL__
+void pidcomm_host_all_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset,
+                    uint32_t size, uint32_t reduce_type){
+    pidcomm_wait_pending();
+    pidcomm_run_host_all_reduce(manager, comm, total_data_size, start_offset, target_offset, size, reduce_type);
+}
+
+static void pidcomm_run_host(hypercube_manager* manager, pidcomm_plan_type_t type, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t size, uint32_t reduce_type){
+    uint32_t nr_dpus;
+
+    if(type == PIDCOMM_PLAN_ALL_REDUCE){
+        pidcomm_run_host_all_reduce(manager, comm, total_data_size, start_offset, target_offset, size, reduce_type);
+        return;
     }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
 
-    all_gather(&dpu_set, start_offset, start_offset, total_data_size/num_comm_dpu, comm_type, buffer_offset, dimension, axis_len, comm_axis);
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+    uint32_t nr_counts = type == PIDCOMM_PLAN_ALLTOALL ? nr_dpus * num_comm_dpu : nr_dpus;
+    uint32_t* counts = malloc(sizeof(uint32_t) * nr_counts);
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
+    //every chunk of the collectives with equal chunks is total_data_size / num_comm_dpu bytes
+    for(uint32_t i=0; i<nr_counts; i++){
+        counts[i] = total_data_size / num_comm_dpu;
+    }
+    switch(type){
+        case PIDCOMM_PLAN_ALLTOALL:
+            pidcomm_run_alltoallv(manager, comm, counts, start_offset, target_offset);
+            break;
+        case PIDCOMM_PLAN_REDUCE_SCATTER:
+            pidcomm_run_reduce_scatterv(manager, comm, counts, start_offset, target_offset, size, reduce_type);
+            break;
+        default:
+            pidcomm_run_allgatherv(manager, comm, counts, start_offset, target_offset);
+            break;
     }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
+    free(counts);
+}
 
-    //relocate after kernel
-    if(axis_len[0]==2 && axis_len[1]==2 && ((comm_axis[0]==1 && comm_axis[1]==0 && comm_axis[2]==1) || (comm_axis[0]==0 && comm_axis[1]==1 && comm_axis[2]==0))){
-        // DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_ALLTOALL_22"), NULL));
-        DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_MODIFIED_CLOCKWISE, NULL));
-
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset + buffer_offset;
-            dpu_argument[i].target_offset = target_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = 2;
-        }
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
-                
+//gather, scatter and reduce on the host keep the host buffer layout of the rotate-and-stream path: host_buffer[g]
+//holds the group of 8 DPUs 8g to 8g+7 in 64-byte lines of one 8-byte word per DPU. reduce fills the lane of each
+//communicator instead, numbered in the order of their first member. A partial last group leaves its lanes untouched.
+static void pidcomm_run_host_rooted(hypercube_manager* manager, pidcomm_plan_type_t type, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t size, uint32_t reduce_type, void** host_buffer){
+    uint32_t nr_dpus;
+
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+    uint32_t nr_words = total_data_size / 8;
+
+    pidcomm_check_count(total_data_size);
+    if(total_data_size == 0) return;
+
+    uint8_t* buffer = malloc((size_t)nr_dpus * total_data_size);
+
+    if(type == PIDCOMM_PLAN_SCATTER){
+        for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+            for(uint32_t word=0; word<nr_words; word++){
+                memcpy(buffer + (size_t)dpu * total_data_size + 8 * word, (uint8_t*)host_buffer[dpu / 8] + 64 * word + 8 * (dpu % 8), 8);
+            }
         }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+        pidcomm_copy_packed(manager->dpu_set, DPU_XFER_TO_DPU, buffer, start_offset, total_data_size);
+        free(buffer);
+        return;
+    }
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+    pidcomm_copy_packed(manager->dpu_set, DPU_XFER_FROM_DPU, buffer, start_offset, total_data_size);
+    if(type == PIDCOMM_PLAN_GATHER){
+        for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+            for(uint32_t word=0; word<nr_words; word++){
+                memcpy((uint8_t*)host_buffer[dpu / 8] + 64 * word + 8 * (dpu % 8), buffer + (size_t)dpu * total_data_size + 8 * word, 8);
+            }
+        }
+        free(buffer);
+        return;
     }
-    else if(!comm_type  || (axis_len[0]<8 && comm_axis[1]==1) || (axis_len[0]*axis_len[1]==4 && (comm_axis[1] == 1 || comm_axis[2] == 1))){
-        // DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_ALLTOALL_X_2"), NULL));
-        DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_REVERSE_CLOCKWISE, NULL));
 
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset + buffer_offset;
-            dpu_argument[i].target_offset = target_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-            dpu_argument[i].num_comm_rg = num_comm_rg;
+    uint8_t* result = malloc(total_data_size);
+    uint8_t** chunks = malloc(sizeof(uint8_t*) * num_comm_dpu);
+    uint32_t nr_comms = 0;
+
+    if(reduce_type >= PIDCOMM_OP_BAND) size = PIDCOMM_DTYPE_SIZE(size);
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        if(pidcomm_comm_member(manager, comm, dpu, 0) != dpu) continue;
+        for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+            chunks[rank] = buffer + (size_t)pidcomm_comm_member(manager, comm, dpu, rank) * total_data_size;
         }
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
+        pidcomm_host_reduce(result, chunks, num_comm_dpu, total_data_size, size, reduce_type);
+        for(uint32_t word=0; word<nr_words; word++){
+            memcpy((uint8_t*)host_buffer[nr_comms / 8] + 64 * word + 8 * (nr_comms % 8), result + 8 * word, 8);
         }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+        nr_comms++;
+    }
+
+    free(chunks);
+    free(result);
+    free(buffer);
+}
+
+//Measured cost of a collective on one communicator and data type, for each path, at sizes doubling from 8 bytes
+//per communicating DPU. Messages between two measured sizes are interpolated, larger ones extrapolated.
+#define PIDCOMM_NR_PATHS 3
+#define PIDCOMM_COST_SAMPLES 32
+
+typedef struct pidcomm_cost_model {
+    pidcomm_plan_type_t type;
+    char* comm;
+    uint32_t size; //data type of reduce_scatter and all_reduce, 0 for alltoall and allgather
+    uint32_t nr_samples;
+    uint32_t bytes[PIDCOMM_COST_SAMPLES];
+    double time_us[PIDCOMM_COST_SAMPLES][PIDCOMM_NR_PATHS];
+    struct pidcomm_cost_model* next;
+} pidcomm_cost_model_t;
+
+static const char* pidcomm_algorithm_name[] = {"rns", "host", "hybrid"};
+
+//alltoall and allgather move the bytes without looking at them, so one model covers every data type
+static uint32_t pidcomm_cost_size(pidcomm_plan_type_t type, uint32_t size){
+    return type == PIDCOMM_PLAN_REDUCE_SCATTER || type == PIDCOMM_PLAN_ALL_REDUCE ? size : 0;
+}
+
+//the hybrid path splits an all_reduce, the other collectives have the rotate-and-stream and the host paths
+static uint32_t pidcomm_nr_paths(pidcomm_plan_type_t type){
+    return type == PIDCOMM_PLAN_ALL_REDUCE ? PIDCOMM_NR_PATHS : PIDCOMM_ALGO_HYBRID;
+}
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+static pidcomm_cost_model_t* pidcomm_find_cost_model(hypercube_manager* manager, pidcomm_plan_type_t type, const char* comm, uint32_t size){
+    for(pidcomm_cost_model_t* model = manager->cost_models; model != NULL; model = model->next){
+        if(model->type == type && model->size == size && strcmp(model->comm, comm) == 0) return model;
     }
-    else{
-        // DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_RELOCATE_2"), NULL));
-        DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE, NULL));
+    return NULL;
+}
 
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset + buffer_offset;
-            dpu_argument[i].target_offset = target_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 1;
-            dpu_argument[i].comm_type = comm_type;
-            dpu_argument[i].a_length = axis_len[0];
-        }
+static double pidcomm_estimate_us(pidcomm_cost_model_t* model, uint32_t path, uint32_t total_data_size){
+    uint32_t sample = 1;
 
-        DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
+    if(model->nr_samples == 1 || total_data_size <= model->bytes[0]) return model->time_us[0][path];
+    while(sample + 1 < model->nr_samples && model->bytes[sample] < total_data_size) sample++;
+
+    double slope = (model->time_us[sample][path] - model->time_us[sample-1][path]) / (model->bytes[sample] - model->bytes[sample-1]);
+    return model->time_us[sample-1][path] + slope * ((double)total_data_size - model->bytes[sample-1]);
+}
+
+static uint32_t pidcomm_select_algorithm(pidcomm_plan_t* plan){
+    hypercube_manager* manager = plan->manager;
+    uint32_t algorithm = manager->algorithm;
+    pidcomm_cost_model_t* model = NULL;
+    double cost[PIDCOMM_NR_PATHS] = {0.0, 0.0, 0.0};
+
+    //reduce, gather and scatter carry a host buffer and are executed by their pidcomm_* call
+    if(plan->type > PIDCOMM_PLAN_ALLGATHER) return PIDCOMM_ALGO_RNS;
+
+    if(plan->on_host){
+        algorithm = PIDCOMM_ALGO_HOST;
+    }
+    else if(algorithm == PIDCOMM_ALGO_AUTO){
+        model = pidcomm_find_cost_model(manager, plan->type, plan->comm, pidcomm_cost_size(plan->type, plan->size));
+
+        //collectives that were not calibrated keep the rotate-and-stream path
+        algorithm = PIDCOMM_ALGO_RNS;
+        if(model != NULL){
+            for(uint32_t path=0; path<pidcomm_nr_paths(plan->type); path++){
+                cost[path] = pidcomm_estimate_us(model, path, plan->total_data_size);
+                if(cost[path] < cost[algorithm]) algorithm = path;
+            }
         }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+    }
+    else if(algorithm >= pidcomm_nr_paths(plan->type)){
+        algorithm = PIDCOMM_ALGO_RNS;
+    }
 
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
+    if(manager->log_algorithm){
+        fprintf(stderr, "PID-Comm: %s %s %u bytes of type %#x -> %s", pidcomm_plan_name[plan->type], plan->comm, plan->total_data_size,
+            plan->size, pidcomm_algorithm_name[algorithm]);
+        if(model != NULL){
+            fprintf(stderr, " (model: rns %.1f us, host %.1f us", cost[PIDCOMM_ALGO_RNS], cost[PIDCOMM_ALGO_HOST]);
+            if(plan->type == PIDCOMM_PLAN_ALL_REDUCE) fprintf(stderr, ", hybrid %.1f us", cost[PIDCOMM_ALGO_HYBRID]);
+            fprintf(stderr, ")");
+        }
+        else if(plan->on_host) fprintf(stderr, " (rotate groups do not fit)");
+        else if(manager->algorithm == PIDCOMM_ALGO_AUTO) fprintf(stderr, " (not calibrated)");
+        fprintf(stderr, "\n");
     }
+    return algorithm;
+}
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
+__API_SYMBOL__
+void pidcomm_set_algorithm(hypercube_manager* manager, uint32_t algorithm, bool log_algorithm){
+    manager->algorithm = algorithm;
+    manager->log_algorithm = log_algorithm;
+}
+
+//Time of one path, through pidcomm_run_plan() as the collectives are run
+static double pidcomm_time_us(hypercube_manager* manager, pidcomm_plan_type_t type, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t path){
+    pidcomm_group_entry_t entry = {manager, type, comm, total_data_size, start_offset, target_offset, buffer_offset, size, PIDCOMM_OP_SUM};
+    pidcomm_plan_t* plan = pidcomm_group_plan(&entry, total_data_size);
+    struct timeval start, stop;
+    double best = 0.0;
+
+    manager->algorithm = path;
+    //the first run is a warm-up, then the fastest of 3 runs is kept
+    for(uint32_t iter=0; iter<4; iter++){
+        gettimeofday(&start, NULL);
+        pidcomm_run_plan(plan);
+        gettimeofday(&stop, NULL);
+
+        double time = (stop.tv_sec - start.tv_sec) * 1000000.0 + (stop.tv_usec - start.tv_usec);
+        if(iter == 1 || (iter > 1 && time < best)) best = time;
     }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
+    pidcomm_plan_free(plan);
+    return best;
 }
 
+//Measure every path of every collective on comm at sizes doubling from 8 bytes per communicating DPU up to
+//max_data_size, reducing size words with PIDCOMM_SUM. The MRAM from the offsets on, up to max_data_size bytes
+//and the communication buffer, is overwritten.
 __API_SYMBOL__
-void pidcomm_gather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, 
-                                                        uint32_t buffer_offset, void** host_buffer){
+void pidcomm_calibrate(hypercube_manager* manager, char* comm, uint32_t start_offset, uint32_t target_offset, uint32_t buffer_offset,
+                    uint32_t max_data_size, uint32_t size){
+    uint32_t nr_dpus;
 
-    struct dpu_set_t dpu_set = manager->dpu_set;
-    uint32_t dimension = manager->dimension;
-    uint32_t* axis_len = manager->axis_len;
+    pidcomm_wait_pending();
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+    uint32_t small = 8 * num_comm_dpu;
+    uint32_t large = max_data_size - max_data_size % small;
 
-    uint32_t* comm_axis = malloc(sizeof(uint32_t) * dimension);
+    if(large == 0){
+        fprintf(stderr, "PID-Comm: calibrating %s needs at least %u bytes\n", comm, small);
+        DPU_ASSERT(DPU_ERR_INVALID_MEMORY_TRANSFER);
+    }
 
-    for(uint32_t dim=0; dim<dimension; dim++){
-        comm_axis[dim] = (int)(*(comm+dim))-48;
+    struct dpu_program_t* user_program = pidcomm_save_program(manager);
+    bool preserve_program = manager->preserve_program;
+    uint32_t algorithm = manager->algorithm;
+    bool log_algorithm = manager->log_algorithm;
+
+    manager->preserve_program = false;
+    manager->log_algorithm = false;
+    for(uint32_t type=PIDCOMM_PLAN_ALLTOALL; type<=PIDCOMM_PLAN_ALLGATHER; type++){
+        uint32_t cost_size = pidcomm_cost_size(type, size);
+        pidcomm_cost_model_t* model = pidcomm_find_cost_model(manager, type, comm, cost_size);
+
+        if(model == NULL){
+            size_t comm_length = strlen(comm);
+            model = calloc(1, sizeof(pidcomm_cost_model_t));
+            model->type = type;
+            model->comm = malloc(comm_length + 1);
+            memcpy(model->comm, comm, comm_length + 1);
+            model->size = cost_size;
+            model->next = manager->cost_models;
+            manager->cost_models = model;
+        }
+        //the sizes double up to the largest one, which is measured last even when it is not a power of two of the smallest
+        model->nr_samples = 0;
+        for(uint64_t bytes=small; model->nr_samples<PIDCOMM_COST_SAMPLES; bytes*=2){
+            model->bytes[model->nr_samples++] = bytes < large ? bytes : large;
+            if(bytes >= large) break;
+        }
+        for(uint32_t sample=0; sample<model->nr_samples; sample++){
+            for(uint32_t path=0; path<pidcomm_nr_paths(type); path++){
+                model->time_us[sample][path] = pidcomm_time_us(manager, type, comm, model->bytes[sample], start_offset, target_offset,
+                    buffer_offset, cost_size, path);
+            }
+            if(log_algorithm){
+                fprintf(stderr, "PID-Comm: calibrated %s %s %u bytes of type %#x: rns %.1f us, host %.1f us", pidcomm_plan_name[type], comm,
+                    model->bytes[sample], cost_size, model->time_us[sample][PIDCOMM_ALGO_RNS], model->time_us[sample][PIDCOMM_ALGO_HOST]);
+                if(type == PIDCOMM_PLAN_ALL_REDUCE) fprintf(stderr, ", hybrid %.1f us", model->time_us[sample][PIDCOMM_ALGO_HYBRID]);
+                fprintf(stderr, "\n");
+            }
+        }
     }
+    manager->algorithm = algorithm;
+    manager->log_algorithm = log_algorithm;
+    manager->preserve_program = preserve_program;
+    pidcomm_restore_program(manager, user_program);
+}
 
-    struct dpu_set_t dpu;
-    uint32_t nr_dpus;
-    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
+//Largest number of words sharing a quantization scale, mirrored from QUANT_MAX_BLOCK in common.h
+#define PIDCOMM_QUANT_MAX_BLOCK 512
 
-    T** result = (T**) calloc(nr_dpus, sizeof(T*));
-    for(int i=0; i<nr_dpus; i++)
-        result[i] = (T*) calloc(8/sizeof(T), sizeof(T));
-    int i;
+//Mirrored from quant_shift() in data_relocate.c: the smallest shift for which the rounded magnitude fits in a word
+static uint32_t pidcomm_quant_shift(int64_t magnitude, uint32_t quant_size){
+    int64_t quant_max = quant_size == sizeof(int8_t) ? INT8_MAX : INT16_MAX;
+    uint32_t shift = 0;
 
-    gather(&dpu_set, start_offset, start_offset, total_data_size, 0, buffer_offset, dimension, axis_len, comm_axis, host_buffer);
+    while(shift < 31 && ((magnitude + ((1LL << shift) >> 1)) >> shift) > quant_max) shift++;
+    return shift;
+}
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
+//One launch of a quantization mode on nr_chunks chunks of chunk_words int32 words
+static void pidcomm_run_quant_kernel(pidcomm_plan_t* plan, relocate_mode_t mode, uint32_t start_offset, uint32_t target_offset, uint32_t table_offset,
+                        uint32_t nr_chunks, uint32_t chunk_words, uint32_t quant_size, uint32_t quant_block){
+    pidcomm_relocation_t step;
+
+    pidcomm_set_relocation(plan, &step, mode, start_offset, target_offset, 0, 0, 0);
+    for(uint32_t i=0; i<plan->nr_dpus; i++){
+        step.dpu_argument[i].total_data_size = nr_chunks * chunk_words * sizeof(int32_t);
+        step.dpu_argument[i].num_comm_dpu = nr_chunks;
+        step.dpu_argument[i].quant_size = quant_size;
+        step.dpu_argument[i].quant_block = quant_block;
+        step.dpu_argument[i].table_offset = table_offset;
     }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));   
-
+    pidcomm_run_relocation(plan, &step, DPU_SYNCHRONOUS);
+    pidcomm_sync(plan, 0);
+    free(step.dpu_argument);
 }
 
-__API_SYMBOL__
-void pidcomm_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, \
-                    uint32_t buffer_offset, uint32_t size, void** host_buffer){
+//Largest absolute error of a result word. Every member rounds its words by at most half the step it chose for the
+//block, and an all_reduce rounds the reduced chunk once more, with a step no coarser than that of the summed magnitudes.
+static uint64_t pidcomm_quant_error(hypercube_manager* manager, char* comm, bool requantize, uint32_t nr_dpus, uint32_t num_comm_dpu,
+                        int64_t* magnitude, uint32_t nr_blocks, uint32_t quant_size){
+    uint64_t error = 0;
 
-    struct dpu_set_t dpu_set = manager->dpu_set;
-    uint32_t dimension = manager->dimension;
-    uint32_t* axis_len = manager->axis_len;
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        uint32_t dpu_rank = pidcomm_comm_rank(manager, comm, dpu);
 
-    uint32_t* comm_axis = malloc(sizeof(uint32_t) * dimension);
+        for(uint32_t block=0; block<nr_blocks; block++){
+            uint64_t block_error = 0;
+            int64_t sum = 0;
 
-    for(uint32_t dim=0; dim<dimension; dim++){
-        comm_axis[dim] = (int)(*(comm+dim))-48;
+            for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+                uint32_t member = pidcomm_comm_member(manager, comm, dpu, rank);
+                int64_t value = magnitude[((size_t)member * num_comm_dpu + dpu_rank) * nr_blocks + block];
+
+                block_error += (1ULL << pidcomm_quant_shift(value, quant_size)) >> 1;
+                sum += value;
+            }
+            if(requantize) block_error += (1ULL << pidcomm_quant_shift(sum + block_error, quant_size)) >> 1;
+            if(block_error > error) error = block_error;
+        }
     }
+    return error;
+}
 
+//int32 collective exchanged as quant_type words. Every DPU quantizes the chunk for each member with its own
+//power-of-two scale per block of quant_block words, into a slot that carries the shifts after the words. A source
+//group keeps one slot per destination group and rotation, so the host streams a line of each slot, rotates it into the
+//destination lanes, decodes every word with the shift of the DPU it comes from and sums the words in 64 bits, writing
+//the int32 chunk of each member. An all_reduce quantizes the reduced chunks again and allgathers their slots. The
+//scales, slots and chunks live in regions of the MRAM allocator, so start_offset is left intact. When the error of
+//the quantized result would exceed max_error, or the set has partial ranks, the int32 words are exchanged as they are.
+static void pidcomm_run_quantized(hypercube_manager* manager, pidcomm_plan_type_t type, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset, uint32_t quant_type, uint32_t quant_block, uint64_t max_error,
+                        uint64_t* error_bound){
+    struct dpu_set_t dpu_set = manager->dpu_set;
     struct dpu_set_t dpu;
-    uint32_t nr_dpus;
+    uint32_t nr_dpus, i;
+
+    pidcomm_wait_pending();
+    //integer data types are their size in bytes
+    if(quant_type != sizeof(int8_t) && quant_type != sizeof(int16_t)){
+        fprintf(stderr, "PID-Comm: quantized collectives exchange PIDCOMM_INT8 or PIDCOMM_INT16 words\n");
+        DPU_ASSERT(DPU_ERR_INVALID_MEMORY_TRANSFER);
+    }
+    //the int8 words of a block must start on the 8-byte boundary of an MRAM transfer
+    if(quant_block == 0 || quant_block % 8 != 0 || quant_block > PIDCOMM_QUANT_MAX_BLOCK){
+        fprintf(stderr, "PID-Comm: %u words per quantization scale is not a multiple of 8 up to %u\n", quant_block, PIDCOMM_QUANT_MAX_BLOCK);
+        DPU_ASSERT(DPU_ERR_INVALID_MEMORY_TRANSFER);
+    }
+
     DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
-    dpu_arguments_comm_t* dpu_argument = (dpu_arguments_comm_t*) malloc(sizeof(dpu_arguments_comm_t) * nr_dpus);
-    uint32_t num_comm_dpu = 1;
-    uint32_t comm_type;
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+    uint32_t nr_words = total_data_size / sizeof(int32_t);
+    uint32_t quant_data_size = nr_words * quant_type;
 
-    if(comm_axis[0] == 1){
-        comm_type = 0;
+    if(total_data_size % sizeof(int32_t) != 0 || quant_data_size % (8 * num_comm_dpu) != 0){
+        fprintf(stderr, "PID-Comm: the quantized data must split into chunks of multiples of 8 bytes among the %u DPUs of a communicator\n", num_comm_dpu);
+        DPU_ASSERT(DPU_ERR_INVALID_MEMORY_TRANSFER);
     }
-    else comm_type = 1;
 
-    for(uint32_t dim=0; dim<dimension; dim++){
-        if(comm_axis[dim]==1){
-            num_comm_dpu *= axis_len[dim];
-        }
+    struct dpu_program_t* user_program = pidcomm_save_program(manager);
+    bool preserve_program = manager->preserve_program;
+    bool requantize = type == PIDCOMM_PLAN_ALL_REDUCE;
+    uint32_t chunk_words = nr_words / num_comm_dpu;
+    uint32_t nr_blocks = (chunk_words + quant_block - 1) / quant_block;
+    //the quantized words, then one shift byte per block padded to 8 bytes
+    uint32_t slot_size = chunk_words * quant_type + (nr_blocks + 7) / 8 * 8;
+    pidcomm_plan_t plan = {.manager = manager, .nr_dpus = nr_dpus, .num_comm_dpu = num_comm_dpu, .total_data_size = total_data_size};
+    uint64_t error = 0;
+    bool quantize = pidcomm_has_full_ranks(dpu_set) && nr_dpus == dpu_set.list.nr_ranks * 64
+        && dpu_set.list.ranks[0]->handler_context->handler->reduce_quantized_rns != NULL;
+
+    manager->preserve_program = false;
+    plan.sync_buffer = (uint64_t*) calloc(nr_dpus, sizeof(uint64_t));
+
+    if(quantize){
+        uint32_t scale_size = num_comm_dpu * nr_blocks * sizeof(int64_t);
+        uint32_t scale_offset = pidcomm_mram_alloc(manager, scale_size);
+        int64_t* magnitude = malloc((size_t)nr_dpus * scale_size);
+
+        pidcomm_run_quant_kernel(&plan, RELOCATE_QUANT_BLOCK_MAX, start_offset, scale_offset, 0, num_comm_dpu, chunk_words, quant_type, quant_block);
+        pidcomm_copy_packed(dpu_set, DPU_XFER_FROM_DPU, (uint8_t*)magnitude, scale_offset, scale_size);
+        pidcomm_mram_free(manager, scale_offset);
+
+        error = pidcomm_quant_error(manager, comm, requantize, nr_dpus, num_comm_dpu, magnitude, nr_blocks, quant_type);
+        free(magnitude);
+        if(error > max_error) quantize = false;
+    }
+    else if(manager->log_algorithm){
+        fprintf(stderr, "PID-Comm: the quantized collective along %s does not fit whole ranks of rotate groups, exchanged exactly\n", comm);
     }
 
-    T** result = (T**) calloc(nr_dpus, sizeof(T*));
-    for(int i=0; i<nr_dpus; i++)
-        result[i] = (T*) calloc(8/sizeof(T), sizeof(T));
-    int i;
+    if(!quantize){
+        pidcomm_plan_t* exchange_plan;
 
-    uint32_t num_comm_rg = 1;
-    for(uint32_t dim=0, len = 1; dim<dimension, len<8; len*=axis_len[dim], dim++){
-        if(comm_axis[dim] == 1){
-            if (axis_len[dim] <= (8/len)) num_comm_rg *= axis_len[dim];
-            else num_comm_rg *= (8/len);
+        error = 0;
+        if(type == PIDCOMM_PLAN_REDUCE_SCATTER){
+            exchange_plan = pidcomm_plan_reduce_scatter(manager, comm, total_data_size, start_offset, target_offset, buffer_offset, sizeof(int32_t), PIDCOMM_OP_SUM);
         }
-        if(num_comm_rg >= 8) num_comm_rg = 8;
+        else{
+            exchange_plan = pidcomm_plan_all_reduce(manager, comm, total_data_size, start_offset, target_offset, buffer_offset, sizeof(int32_t), PIDCOMM_OP_SUM);
+        }
+        pidcomm_run_plan(exchange_plan);
+        pidcomm_plan_free(exchange_plan);
     }
+    else{
+        uint32_t nr_rg = nr_dpus / 8;
+        //slot_index[(src_rg * nr_rg + dst_rg) * 8 + rotation]: slot of the source group for the destination group
+        uint32_t* slot_index = malloc(sizeof(uint32_t) * nr_rg * nr_rg * 8);
+        uint32_t* nr_slots = calloc(nr_rg, sizeof(uint32_t));
+        uint32_t max_slots = 0;
+
+        memset(slot_index, 0xff, sizeof(uint32_t) * nr_rg * nr_rg * 8);
+        for(uint32_t src=0; src<nr_dpus; src++){
+            for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+                uint32_t dst = pidcomm_comm_member(manager, comm, src, rank);
+                uint32_t pass = ((src / 8) * nr_rg + dst / 8) * 8 + (dst % 8 + 8 - src % 8) % 8;
+
+                if(slot_index[pass] == UINT32_MAX) slot_index[pass] = nr_slots[src / 8]++;
+                if(nr_slots[src / 8] > max_slots) max_slots = nr_slots[src / 8];
+            }
+        }
 
-    //relocate before kernel
-    if(!comm_type){
-
-        // if(size==1) DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_RELOCATE_2_INT8"), NULL));
-        // else DPU_ASSERT(dpu_load(dpu_set, getenv("DPU_BINARY_RELOCATE_2_INT32"), NULL));
-        if(size==1) DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_INT8, NULL));
-        else DPU_ASSERT(dpu_load(dpu_set, DPU_BINARY_RELOCATE_CLOCKWISE_INT32, NULL));
-
-        for(int i=0; i<nr_dpus; i++){
-            dpu_argument[i].each_dpu = i;
-            dpu_argument[i].start_offset = start_offset;
-            dpu_argument[i].target_offset = start_offset;
-            dpu_argument[i].total_data_size = total_data_size;
-            dpu_argument[i].num_comm_dpu = num_comm_dpu;
-            dpu_argument[i].no_rotate = 0;
-            dpu_argument[i].a_length = axis_len[0];
+        //the slot of every chunk, then for an all_reduce the slot of the reduced chunk and those of the gathered ones
+        uint32_t table_size = (2 * num_comm_dpu + 1) * sizeof(count_slot_t);
+        count_slot_t* tables = malloc((size_t)nr_dpus * table_size);
+        for(uint32_t src=0; src<nr_dpus; src++){
+            count_slot_t* entry = tables + (size_t)src * (2 * num_comm_dpu + 1);
+
+            for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+                uint32_t dst = pidcomm_comm_member(manager, comm, src, rank);
+                uint32_t pass = ((src / 8) * nr_rg + dst / 8) * 8 + (dst % 8 + 8 - src % 8) % 8;
+
+                entry[rank].count = slot_size;
+                entry[rank].slot = slot_index[pass] * slot_size;
+                entry[num_comm_dpu + 1 + rank].count = slot_size;
+                entry[num_comm_dpu + 1 + rank].slot = rank * slot_size;
+            }
+            entry[num_comm_dpu].count = slot_size;
+            entry[num_comm_dpu].slot = 0;
         }
-            
+
+        //sources[4*k...]: source group, rotation, lane mask and slot, grouped by destination group
+        uint32_t* source_start = malloc(sizeof(uint32_t) * (nr_rg + 1));
+        uint32_t* source_of = malloc(sizeof(uint32_t) * nr_rg * 8);
+        uint32_t* sources = malloc(sizeof(uint32_t) * 4 * (size_t)nr_rg * (num_comm_dpu * 8 < nr_rg * 8 ? num_comm_dpu * 8 : nr_rg * 8));
+        uint32_t num_sources = 0;
+
+        for(uint32_t dst_rg=0; dst_rg<nr_rg; dst_rg++){
+            source_start[dst_rg] = num_sources;
+            memset(source_of, 0xff, sizeof(uint32_t) * nr_rg * 8);
+            for(uint32_t lane=0; lane<8; lane++){
+                for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+                    uint32_t src = pidcomm_comm_member(manager, comm, dst_rg * 8 + lane, rank);
+                    uint32_t rotation = (lane + 8 - src % 8) % 8;
+                    uint32_t* entry;
+
+                    if(source_of[(src / 8) * 8 + rotation] == UINT32_MAX){
+                        source_of[(src / 8) * 8 + rotation] = num_sources;
+                        entry = sources + 4 * num_sources++;
+                        entry[0] = src / 8;
+                        entry[1] = rotation;
+                        entry[2] = 0;
+                        entry[3] = slot_index[((src / 8) * nr_rg + dst_rg) * 8 + rotation] * slot_size;
+                    }
+                    sources[4 * source_of[(src / 8) * 8 + rotation] + 2] |= 1u << lane;
+                }
+            }
+        }
+        source_start[nr_rg] = num_sources;
+
+        uint32_t table = pidcomm_mram_alloc(manager, table_size);
+        uint32_t slot_offset = pidcomm_mram_alloc(manager, max_slots * slot_size);
+        uint32_t result_offset = requantize ? pidcomm_mram_alloc(manager, chunk_words * sizeof(int32_t)) : target_offset;
+
         DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-            DPU_ASSERT(dpu_prepare_xfer(dpu, dpu_argument+i));
+            DPU_ASSERT(dpu_prepare_xfer(dpu, tables + (size_t)i * (2 * num_comm_dpu + 1)));
         }
-        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, "DPU_INPUT_ARGUMENTS_RS1", 0, sizeof(dpu_arguments_comm_t), DPU_XFER_DEFAULT));
+        DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_TO_DPU, DPU_MRAM_HEAP_POINTER_NAME, table, table_size, DPU_XFER_DEFAULT));
 
-        // Run kernel on DPUs
-        DPU_ASSERT(dpu_launch(dpu_set, DPU_SYNCHRONOUS));
-    }
+        pidcomm_run_quant_kernel(&plan, RELOCATE_QUANTIZE, start_offset, slot_offset, table, num_comm_dpu, chunk_words, quant_type, quant_block);
+        reduce_quantized(&dpu_set, slot_offset, result_offset, chunk_words, quant_type, quant_block, source_start, sources);
+        pidcomm_sync(&plan, 0);
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
+        if(requantize){
+            uint32_t gather_offset = pidcomm_mram_alloc(manager, num_comm_dpu * slot_size);
+
+            pidcomm_run_quant_kernel(&plan, RELOCATE_QUANTIZE, result_offset, slot_offset, table + num_comm_dpu * sizeof(count_slot_t), 1, chunk_words, quant_type, quant_block);
+            pidcomm_plan_t* gather_plan = pidcomm_plan_allgather(manager, comm, num_comm_dpu * slot_size, slot_offset, gather_offset, PIDCOMM_AUTO_BUFFER);
+            pidcomm_run_plan(gather_plan);
+            pidcomm_plan_free(gather_plan);
+            pidcomm_run_quant_kernel(&plan, RELOCATE_DEQUANTIZE, gather_offset, target_offset, table + (num_comm_dpu + 1) * sizeof(count_slot_t), num_comm_dpu,
+                chunk_words, quant_type, quant_block);
+
+            pidcomm_mram_free(manager, gather_offset);
+            pidcomm_mram_free(manager, result_offset);
+        }
+        pidcomm_mram_free(manager, slot_offset);
+        pidcomm_mram_free(manager, table);
+        free(sources);
+        free(source_of);
+        free(source_start);
+        free(tables);
+        free(nr_slots);
+        free(slot_index);
     }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
+    if(error_bound != NULL) *error_bound = error;
 
+    free(plan.sync_buffer);
+    manager->preserve_program = preserve_program;
+    pidcomm_restore_program(manager, user_program);
+}
 
-    //kernel function of All-Reduce
-    reduce(&dpu_set, start_offset, start_offset, total_data_size/num_comm_dpu, total_data_size, comm_type, buffer_offset, dimension, axis_len, comm_axis, size, host_buffer);
-    
+__API_SYMBOL__
+void pidcomm_all_reduce_quantized(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, \
+                    uint32_t buffer_offset, uint32_t quant_type, uint32_t quant_block, uint64_t max_error, uint64_t* error_bound){
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
+    pidcomm_run_quantized(manager, PIDCOMM_PLAN_ALL_REDUCE, comm, total_data_size, start_offset, target_offset, buffer_offset, quant_type, quant_block,
+        max_error, error_bound);
+}
+
+__API_SYMBOL__
+void pidcomm_reduce_scatter_quantized(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset, uint32_t quant_type, uint32_t quant_block, uint64_t max_error,
+                        uint64_t* error_bound){
+
+    pidcomm_run_quantized(manager, PIDCOMM_PLAN_REDUCE_SCATTER, comm, total_data_size, start_offset, target_offset, buffer_offset, quant_type, quant_block,
+        max_error, error_bound);
+}
+
+//Bytes of a block of the sparse collectives, mirrored from SPARSE_BLOCK in common.h
+#define PIDCOMM_SPARSE_BLOCK 64
+
+//Data of every DPU compacted by RELOCATE_SPARSE_COMPACT: the headers (nonzero count and bitmap of the nonzero blocks)
+//and the nonzero blocks, read exactly for each DPU
+typedef struct {
+    uint32_t nr_blocks;
+    uint32_t nr_words;
+    uint32_t header_size;
+    uint8_t* headers;
+    uint8_t* blocks;
+    size_t* base; //offset of the nonzero blocks of each DPU in blocks
+    uint32_t* length; //bytes of the nonzero blocks of each DPU
+    uint32_t* prefix; //nonzero blocks of the DPU before each bitmap word
+} pidcomm_sparse_t;
+
+static const uint8_t pidcomm_zero_block[PIDCOMM_SPARSE_BLOCK];
+
+static uint32_t pidcomm_sparse_header_size(uint32_t nr_blocks){
+    return sizeof(uint64_t) * (1 + (nr_blocks + 63) / 64);
+}
+
+static void pidcomm_check_sparse_size(uint32_t total_data_size){
+    if(total_data_size % PIDCOMM_SPARSE_BLOCK != 0){
+        fprintf(stderr, "PID-Comm: the sparse chunks must be multiples of %u bytes\n", PIDCOMM_SPARSE_BLOCK);
+        DPU_ASSERT(DPU_ERR_INVALID_MEMORY_TRANSFER);
+    }
+}
+
+//Compact the data of every DPU into sparse_offset, then read the headers and only the nonzero blocks of each DPU
+static void pidcomm_sparse_read(hypercube_manager* manager, uint32_t nr_dpus, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t sparse_offset, pidcomm_sparse_t* sparse){
+    pidcomm_plan_t plan = {.manager = manager, .nr_dpus = nr_dpus, .total_data_size = total_data_size};
+    pidcomm_relocation_t step;
+    struct dpu_program_t* user_program = pidcomm_save_program(manager);
+
+    pidcomm_set_relocation(&plan, &step, RELOCATE_SPARSE_COMPACT, start_offset, sparse_offset, 0, 0, 0);
+    pidcomm_run_relocation(&plan, &step, DPU_SYNCHRONOUS);
+    free(step.dpu_argument);
+
+    sparse->nr_blocks = total_data_size / PIDCOMM_SPARSE_BLOCK;
+    sparse->nr_words = (sparse->nr_blocks + 63) / 64;
+    sparse->header_size = pidcomm_sparse_header_size(sparse->nr_blocks);
+    sparse->headers = malloc((size_t)nr_dpus * sparse->header_size);
+    sparse->prefix = malloc(sizeof(uint32_t) * nr_dpus * sparse->nr_words);
+    sparse->base = malloc(sizeof(size_t) * nr_dpus);
+    sparse->length = malloc(sizeof(uint32_t) * nr_dpus);
+    size_t total_length = 0;
+
+    pidcomm_copy_packed(manager->dpu_set, DPU_XFER_FROM_DPU, sparse->headers, sparse_offset, sparse->header_size);
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        uint64_t* bitmap = (uint64_t*)(sparse->headers + (size_t)dpu * sparse->header_size) + 1;
+        uint32_t count = 0;
+
+        for(uint32_t word=0; word<sparse->nr_words; word++){
+            sparse->prefix[(size_t)dpu * sparse->nr_words + word] = count;
+            count += __builtin_popcountll(bitmap[word]);
+        }
+        sparse->base[dpu] = total_length;
+        sparse->length[dpu] = count * PIDCOMM_SPARSE_BLOCK;
+        total_length += sparse->length[dpu];
     }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
 
+    sparse->blocks = malloc(total_length);
+    pidcomm_copy_ragged(manager->dpu_set, DPU_XFER_FROM_DPU, sparse->blocks, sparse->base, sparse->length, sparse_offset + sparse->header_size);
+    pidcomm_restore_program(manager, user_program);
 }
 
-//total data size is size of data each dpu will receive
-__API_SYMBOL__
-void pidcomm_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, \
-                    uint32_t buffer_offset, void** host_buffer){
+static void pidcomm_sparse_free(pidcomm_sparse_t* sparse){
+    free(sparse->headers);
+    free(sparse->blocks);
+    free(sparse->base);
+    free(sparse->length);
+    free(sparse->prefix);
+}
 
-    struct dpu_set_t dpu_set = manager->dpu_set;
-    uint32_t dimension = manager->dimension;
-    uint32_t* axis_len = manager->axis_len;
+static uint64_t pidcomm_sparse_bitmap(pidcomm_sparse_t* sparse, uint32_t dpu, uint32_t word){
+    return ((uint64_t*)(sparse->headers + (size_t)dpu * sparse->header_size))[1 + word];
+}
 
-    uint32_t* comm_axis = malloc(sizeof(uint32_t) * dimension);
+//Nonzero block of the DPU, NULL for a zero block
+static uint8_t* pidcomm_sparse_block(pidcomm_sparse_t* sparse, uint32_t dpu, uint32_t block){
+    uint64_t bitmap = pidcomm_sparse_bitmap(sparse, dpu, block / 64);
+    uint64_t below = bitmap & ((1ULL << (block % 64)) - 1);
 
-    for(uint32_t dim=0; dim<dimension; dim++){
-        comm_axis[dim] = (int)(*(comm+dim))-48;
+    if(!((bitmap >> (block % 64)) & 1)) return NULL;
+    return sparse->blocks + sparse->base[dpu] + (size_t)(sparse->prefix[(size_t)dpu * sparse->nr_words + block / 64] + __builtin_popcountll(below)) * PIDCOMM_SPARSE_BLOCK;
+}
+
+//Reduce the blocks [first, end) of the members into dst, visiting only the blocks nonzero on at least one member.
+//A zero block of a member enters the reduction as zeros, and blocks zero on every member stay zero in dst.
+static void pidcomm_sparse_reduce(pidcomm_sparse_t* sparse, uint32_t* members, uint32_t nr_members, uint32_t first, uint32_t end,
+                        uint8_t* dst, uint8_t** chunks, uint32_t size, uint32_t reduce_type){
+
+    for(uint32_t word = first / 64; word * 64 < end; word++){
+        uint64_t bits = 0;
+        for(uint32_t rank=0; rank<nr_members; rank++){
+            bits |= pidcomm_sparse_bitmap(sparse, members[rank], word);
+        }
+        while(bits != 0){
+            uint32_t block = word * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if(block < first || block >= end) continue;
+
+            for(uint32_t rank=0; rank<nr_members; rank++){
+                uint8_t* chunk = pidcomm_sparse_block(sparse, members[rank], block);
+                chunks[rank] = chunk != NULL ? chunk : (uint8_t*)pidcomm_zero_block;
+            }
+            pidcomm_host_reduce(dst + (size_t)(block - first) * PIDCOMM_SPARSE_BLOCK, chunks, nr_members, PIDCOMM_SPARSE_BLOCK, size, reduce_type);
+        }
     }
+}
 
-    struct dpu_set_t dpu;
-    uint32_t nr_dpus;
-    DPU_ASSERT(dpu_get_nr_dpus(dpu_set, &nr_dpus));
-    dpu_arguments_comm_t* dpu_argument = (dpu_arguments_comm_t*) malloc(sizeof(dpu_arguments_comm_t) * nr_dpus);
-    uint32_t num_comm_dpu = 1;
-    uint32_t comm_type;
+//Write the result slot source[dpu] of out_size bytes to every DPU, dense or in the format of RELOCATE_SPARSE_COMPACT.
+//A sparse image covers exactly the header and the nonzero blocks of its slot, so nothing is written past it.
+static void pidcomm_sparse_write(hypercube_manager* manager, uint8_t* result, uint32_t* source, uint32_t nr_dpus, uint32_t out_size,
+                        uint32_t target_offset, bool sparse_output){
+    if(!sparse_output){
+        pidcomm_write_permuted(manager->dpu_set, result, source, out_size, target_offset);
+        return;
+    }
 
-    if(comm_axis[0] == 1){
-        comm_type = 0;
+    uint32_t nr_blocks = out_size / PIDCOMM_SPARSE_BLOCK;
+    uint32_t header_size = pidcomm_sparse_header_size(nr_blocks);
+    size_t* base = malloc(sizeof(size_t) * nr_dpus);
+    uint32_t* length = malloc(sizeof(uint32_t) * nr_dpus);
+    size_t total_length = 0;
+
+    //the slots written are the ones that are their own source
+    for(uint32_t slot=0; slot<nr_dpus; slot++){
+        uint32_t count = 0;
+        if(source[slot] != slot) continue;
+        for(uint32_t block=0; block<nr_blocks; block++){
+            if(memcmp(result + (size_t)slot * out_size + (size_t)block * PIDCOMM_SPARSE_BLOCK, pidcomm_zero_block, PIDCOMM_SPARSE_BLOCK) != 0) count++;
+        }
+        base[slot] = total_length;
+        length[slot] = header_size + count * PIDCOMM_SPARSE_BLOCK;
+        total_length += length[slot];
     }
-    else comm_type = 1;
 
-    for(uint32_t dim=0; dim<dimension; dim++){
-        if(comm_axis[dim]==1){
-            num_comm_dpu *= axis_len[dim];
+    uint8_t* images = calloc(1, total_length);
+
+    for(uint32_t slot=0; slot<nr_dpus; slot++){
+        if(source[slot] != slot) continue;
+
+        uint64_t* header = (uint64_t*)(images + base[slot]);
+        uint8_t* blocks = images + base[slot] + header_size;
+
+        for(uint32_t block=0; block<nr_blocks; block++){
+            uint8_t* data = result + (size_t)slot * out_size + (size_t)block * PIDCOMM_SPARSE_BLOCK;
+            if(memcmp(data, pidcomm_zero_block, PIDCOMM_SPARSE_BLOCK) == 0) continue;
+            header[1 + block / 64] |= 1ULL << (block % 64);
+            memcpy(blocks + header[0] * PIDCOMM_SPARSE_BLOCK, data, PIDCOMM_SPARSE_BLOCK);
+            header[0]++;
         }
     }
+    //every DPU receives the image of its source slot
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        base[dpu] = base[source[dpu]];
+        length[dpu] = length[source[dpu]];
+    }
+    pidcomm_copy_ragged(manager->dpu_set, DPU_XFER_TO_DPU, images, base, length, target_offset);
+    free(length);
+    free(base);
+    free(images);
+}
 
-    T** result = (T**) calloc(nr_dpus, sizeof(T*));
-    for(int i=0; i<nr_dpus; i++)
-        result[i] = (T*) calloc(8/sizeof(T), sizeof(T));
-    int i;
+__API_SYMBOL__
+void pidcomm_sparse_all_reduce(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset, uint32_t target_offset, \
+                    uint32_t buffer_offset, uint32_t size, uint32_t reduce_type, bool sparse_output){
+    pidcomm_sparse_t sparse;
+    uint32_t nr_dpus;
 
-    uint32_t num_comm_rg = 1;
-    for(uint32_t dim=0, len = 1; dim<dimension, len<8; len*=axis_len[dim], dim++){
-        if(comm_axis[dim] == 1){
-            if (axis_len[dim] <= (8/len)) num_comm_rg *= axis_len[dim];
-            else num_comm_rg *= (8/len);
+    pidcomm_wait_pending();
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+
+    pidcomm_check_sparse_size(total_data_size);
+    if(total_data_size == 0) return;
+    if(reduce_type >= PIDCOMM_OP_BAND) size = PIDCOMM_DTYPE_SIZE(size);
+
+    uint32_t buffer_region = pidcomm_borrow_buffer(manager, pidcomm_sparse_header_size(total_data_size / PIDCOMM_SPARSE_BLOCK) + total_data_size, start_offset, &buffer_offset);
+    pidcomm_sparse_read(manager, nr_dpus, total_data_size, start_offset, start_offset + buffer_offset, &sparse);
+    pidcomm_return_buffer(manager, buffer_region);
+
+    uint8_t* result = calloc(nr_dpus, total_data_size);
+    uint8_t** chunks = malloc(sizeof(uint8_t*) * num_comm_dpu);
+    uint32_t* members = malloc(sizeof(uint32_t) * num_comm_dpu);
+    uint32_t* source = malloc(sizeof(uint32_t) * nr_dpus);
+
+    //the result of each communicator is kept in the slot of its first member and written to every member
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        source[dpu] = pidcomm_comm_member(manager, comm, dpu, 0);
+        if(source[dpu] != dpu) continue;
+        for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+            members[rank] = pidcomm_comm_member(manager, comm, dpu, rank);
         }
-        if(num_comm_rg >= 8) num_comm_rg = 8;
+        pidcomm_sparse_reduce(&sparse, members, num_comm_dpu, 0, sparse.nr_blocks, result + (size_t)dpu * total_data_size, chunks, size, reduce_type);
     }
+    pidcomm_sparse_write(manager, result, source, nr_dpus, total_data_size, target_offset, sparse_output);
 
-    //kernel function of All-Reduce
-    scatter(&dpu_set, start_offset, start_offset, total_data_size, comm_type, buffer_offset, dimension, axis_len, comm_axis, host_buffer);
+    free(source);
+    free(members);
+    free(chunks);
+    free(result);
+    pidcomm_sparse_free(&sparse);
+}
 
-    i=0;
-    DPU_FOREACH_ENTANGLED_GROUP(dpu_set, dpu, i, nr_dpus){
-        DPU_ASSERT(dpu_prepare_xfer(dpu, result[i]));
+__API_SYMBOL__
+void pidcomm_sparse_reduce_scatter(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset, uint32_t size, uint32_t reduce_type, bool sparse_output){
+    pidcomm_sparse_t sparse;
+    uint32_t nr_dpus;
+
+    pidcomm_wait_pending();
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+    uint32_t chunk_size = total_data_size / num_comm_dpu;
+
+    pidcomm_check_sparse_size(chunk_size);
+    if(chunk_size == 0) return;
+    if(reduce_type >= PIDCOMM_OP_BAND) size = PIDCOMM_DTYPE_SIZE(size);
+
+    uint32_t buffer_region = pidcomm_borrow_buffer(manager, pidcomm_sparse_header_size(total_data_size / PIDCOMM_SPARSE_BLOCK) + total_data_size, start_offset, &buffer_offset);
+    pidcomm_sparse_read(manager, nr_dpus, total_data_size, start_offset, start_offset + buffer_offset, &sparse);
+    pidcomm_return_buffer(manager, buffer_region);
+
+    uint32_t chunk_blocks = chunk_size / PIDCOMM_SPARSE_BLOCK;
+    uint8_t* result = calloc(nr_dpus, chunk_size);
+    uint8_t** chunks = malloc(sizeof(uint8_t*) * num_comm_dpu);
+    uint32_t* members = malloc(sizeof(uint32_t) * num_comm_dpu);
+    uint32_t* source = malloc(sizeof(uint32_t) * nr_dpus);
+
+    //every DPU receives the reduction of the chunk of its rank
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        uint32_t first = pidcomm_comm_rank(manager, comm, dpu) * chunk_blocks;
+
+        source[dpu] = dpu;
+        for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+            members[rank] = pidcomm_comm_member(manager, comm, dpu, rank);
+        }
+        pidcomm_sparse_reduce(&sparse, members, num_comm_dpu, first, first + chunk_blocks, result + (size_t)dpu * chunk_size, chunks, size, reduce_type);
+    }
+    pidcomm_sparse_write(manager, result, source, nr_dpus, chunk_size, target_offset, sparse_output);
+
+    free(source);
+    free(members);
+    free(chunks);
+    free(result);
+    pidcomm_sparse_free(&sparse);
+}
+
+__API_SYMBOL__
+void pidcomm_sparse_allgather(hypercube_manager* manager, char* comm, uint32_t total_data_size, uint32_t start_offset,
+                        uint32_t target_offset, uint32_t buffer_offset, bool sparse_output){
+    pidcomm_sparse_t sparse;
+    uint32_t nr_dpus;
+
+    pidcomm_wait_pending();
+    DPU_ASSERT(dpu_get_nr_dpus(manager->dpu_set, &nr_dpus));
+    uint32_t num_comm_dpu = pidcomm_comm_size(manager, comm, nr_dpus);
+    //total_data_size is the gathered size, as in pidcomm_allgather(), and every DPU contributes one chunk of it
+    uint32_t chunk_size = total_data_size / num_comm_dpu;
+
+    pidcomm_check_sparse_size(chunk_size);
+    if(chunk_size == 0) return;
+
+    uint32_t buffer_region = pidcomm_borrow_buffer(manager, pidcomm_sparse_header_size(chunk_size / PIDCOMM_SPARSE_BLOCK) + chunk_size, start_offset, &buffer_offset);
+    pidcomm_sparse_read(manager, nr_dpus, chunk_size, start_offset, start_offset + buffer_offset, &sparse);
+    pidcomm_return_buffer(manager, buffer_region);
+
+    uint8_t* result = calloc(nr_dpus, total_data_size);
+    uint32_t* source = malloc(sizeof(uint32_t) * nr_dpus);
+
+    //the chunks are gathered in the slot of the first member in rank order, copying only the nonzero blocks
+    for(uint32_t dpu=0; dpu<nr_dpus; dpu++){
+        source[dpu] = pidcomm_comm_member(manager, comm, dpu, 0);
+        if(source[dpu] != dpu) continue;
+        for(uint32_t rank=0; rank<num_comm_dpu; rank++){
+            uint32_t member = pidcomm_comm_member(manager, comm, dpu, rank);
+            uint8_t* dst = result + (size_t)dpu * total_data_size + (size_t)rank * chunk_size;
+
+            for(uint32_t word=0; word<sparse.nr_words; word++){
+                uint64_t bits = pidcomm_sparse_bitmap(&sparse, member, word);
+                while(bits != 0){
+                    uint32_t block = word * 64 + __builtin_ctzll(bits);
+                    bits &= bits - 1;
+                    memcpy(dst + (size_t)block * PIDCOMM_SPARSE_BLOCK, pidcomm_sparse_block(&sparse, member, block), PIDCOMM_SPARSE_BLOCK);
+                }
+            }
+        }
     }
-    DPU_ASSERT(dpu_push_xfer(dpu_set, DPU_XFER_FROM_DPU, DPU_MRAM_HEAP_POINTER_NAME, 0, 8, DPU_XFER_DEFAULT));
-}
\ No newline at end of file
+    pidcomm_sparse_write(manager, result, source, nr_dpus, total_data_size, target_offset, sparse_output);
+
+    free(source);
+    free(result);
+    pidcomm_sparse_free(&sparse);
+}
@@ -211,6 +211,9 @@ dpu_thread_compute_job(struct dpu_rank_t *rank, struct dpu_thread_job *job, bool
         case DPU_THREAD_JOB_LOAD: {
             status = dpu_load_rank(rank, job->load_info.runtime, job->load_info.elf_info);
         } break;
+        case DPU_THREAD_JOB_RESTORE: {
+            status = dpu_restore_rank(rank, job->load_info.runtime);
+        } break;
         case DPU_THREAD_JOB_CALLBACK: {
             struct dpu_thread_job *master = job->callback.master_job;
             bool master_job;
@@ -13,4 +13,7 @@
 dpu_error_t
 dpu_load_rank(struct dpu_rank_t *rank, struct dpu_program_t *program, dpu_elf_file_t elf_info);
 
+dpu_error_t
+dpu_restore_rank(struct dpu_rank_t *rank, struct dpu_program_t *program);
+
 #endif
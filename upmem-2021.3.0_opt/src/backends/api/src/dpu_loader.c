@@ -69,6 +69,8 @@ patch_rank_iram(dpu_loader_env_t env, void *content, dpu_mem_max_addr_t address,
 static dpu_error_t
 patch_rank_wram(dpu_loader_env_t env, void *content, dpu_mem_max_addr_t address, dpu_mem_max_size_t size, bool init);
 static dpu_error_t
+patch_wram_with_dpu_frequency(dpuword_t *content, wram_addr_t addr, wram_size_t sz, struct dpu_rank_t *rank);
+static dpu_error_t
 patch_dpu_wram(dpu_loader_env_t env, void *content, dpu_mem_max_addr_t address, dpu_mem_max_size_t size, bool init);
 
 static dpu_error_t
@@ -210,6 +212,93 @@ end:
     return status;
 }
 
+__API_SYMBOL__ dpu_error_t
+dpu_elf_cache_image(dpu_elf_file_t file, struct dpu_rank_t *rank, struct dpu_program_t *program)
+{
+    dpu_error_t status = DPU_OK;
+    elf_fd info = (elf_fd)file;
+    size_t phdrnum = info->phnum;
+    struct dpu_load_memory_functions_t load_functions = { NULL, NULL, NULL, NULL };
+    struct _dpu_loader_context_t context;
+    struct dpu_program_segment_t *segments;
+    uint32_t nr_segments = 0;
+
+    /* The profiling patch depends on the state of the rank profiling context, it cannot be replayed */
+    if (dpu_get_profiling_context(rank)->enable_profiling == DPU_PROFILING_STATS) {
+        goto end;
+    }
+
+    dpu_loader_fill_rank_context(&context, rank);
+
+    if ((segments = calloc(phdrnum, sizeof(*segments))) == NULL) {
+        status = DPU_ERR_SYSTEM;
+        goto end;
+    }
+
+    for (unsigned int each_phdr = 0; each_phdr < phdrnum; ++each_phdr) {
+        GElf_Phdr phdr;
+        uint32_t addr;
+        uint32_t size;
+        uint32_t *size_accumulator;
+        mem_load_function_t do_load;
+        mem_patch_function_t do_patch;
+        uint8_t *content;
+
+        if (gelf_getphdr(info->elf, each_phdr, &phdr) != &phdr) {
+            status = DPU_ERR_ELF_INVALID_FILE;
+            goto free_segments;
+        }
+
+        if (phdr.p_type != PT_LOAD) {
+            continue;
+        }
+
+        if ((status = extract_and_convert_memory_information(
+                 &phdr, &context, &load_functions, &addr, &size, &size_accumulator, &do_load, &do_patch))
+            != DPU_OK) {
+            goto free_segments;
+        }
+
+        /* A core dump carries register values that cannot be restored from an image */
+        if (size_accumulator == &context.dummy) {
+            goto free_segments;
+        }
+        /* MRAM content belongs to the application once the program is loaded */
+        if (size_accumulator == &context.nr_of_mram_bytes) {
+            continue;
+        }
+
+        if ((status = fetch_content(info, &phdr, &content)) != DPU_OK) {
+            goto free_segments;
+        }
+
+        if ((size_accumulator == &context.nr_of_wram_words)
+            && ((status = patch_wram_with_dpu_frequency((dpuword_t *)content, addr, size, rank)) != DPU_OK)) {
+            free(content);
+            goto free_segments;
+        }
+
+        segments[nr_segments].is_iram = (size_accumulator == &context.nr_of_instructions);
+        segments[nr_segments].address = addr;
+        segments[nr_segments].size = size;
+        segments[nr_segments].content = content;
+        nr_segments++;
+        *size_accumulator += size;
+    }
+
+    program->nr_segments = nr_segments;
+    program->segments = segments;
+    goto end;
+
+free_segments:
+    while (nr_segments-- > 0) {
+        free(segments[nr_segments].content);
+    }
+    free(segments);
+end:
+    return status;
+}
+
 static dpu_error_t
 load_segment(elf_fd info, dpu_loader_context_t context, struct dpu_load_memory_functions_t *load_functions, GElf_Phdr *phdr)
 {
@@ -68,6 +68,10 @@ dpu_free_program(struct dpu_program_t *program)
                 free_symbols(program->profiling_symbols);
             }
             free(program->program_path);
+            for (uint32_t each_segment = 0; each_segment < program->nr_segments; ++each_segment) {
+                free(program->segments[each_segment].content);
+            }
+            free(program->segments);
             free(program);
         }
     }
@@ -56,6 +56,9 @@
 #define DPU_PROFILE_PROPERTY_POOL_THRESHOLD_1_THREAD "poolThreshold1Thread"
 #define DPU_PROFILE_PROPERTY_POOL_THRESHOLD_2_THREADS "poolThreshold2Threads"
 #define DPU_PROFILE_PROPERTY_POOL_THRESHOLD_4_THREADS "poolThreshold4Threads"
+#define DPU_PROFILE_PROPERTY_NR_THREAD_PER_COMM_POOL "nrThreadPerCommPool"
+#define DPU_PROFILE_PROPERTY_NR_TASK_PER_COMM_THREAD "nrTaskPerCommThread"
+#define DPU_PROFILE_PROPERTY_COMM_WORK_STEALING "commWorkStealing"
 #define DPU_PROFILE_PROPERTY_USB_SERIAL "usbSerial"
 #define DPU_PROFILE_PROPERTY_CHIP_SELECT "chipSelect"
 
@@ -111,6 +111,7 @@ enum dpu_thread_job_type {
     DPU_THREAD_JOB_COPY_MRAM_TO_RANK,
     DPU_THREAD_JOB_CALLBACK,
     DPU_THREAD_JOB_LOAD,
+    DPU_THREAD_JOB_RESTORE,
     DPU_THREAD_JOB_COPY_MRAM_TO_MRAM_CUSTOM,
 };
 
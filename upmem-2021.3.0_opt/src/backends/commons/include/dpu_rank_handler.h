@@ -46,7 +46,7 @@ typedef struct dpu_rank_handler {
     dpu_rank_status_e (*gather_z_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t target_dpu_index, void ** host_buffer);
     dpu_rank_status_e (*gather_xz_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t target_dpu_index, void ** host_buffer);
 
-    dpu_rank_status_e (*reduce_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t total_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t data_type, void ** host_buffer);
+    dpu_rank_status_e (*reduce_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t total_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t data_type, uint32_t reduce_type, void ** host_buffer);
     dpu_rank_status_e (*reduce_x_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t data_type, void ** host_buffer);
     dpu_rank_status_e (*reduce_y_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t data_type, void ** host_buffer);
 
@@ -54,9 +54,9 @@ typedef struct dpu_rank_handler {
     dpu_rank_status_e (*scatter_x_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void ** host_buffer);
     dpu_rank_status_e (*scatter_y_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void ** host_buffer);
 
-    dpu_rank_status_e (*reduce_scatter_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size);
-    dpu_rank_status_e (*reduce_scatter_cpu_x_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size);
-    dpu_rank_status_e (*reduce_scatter_cpu_y_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size);
+    dpu_rank_status_e (*reduce_scatter_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size, uint32_t reduce_type);
+    dpu_rank_status_e (*reduce_scatter_cpu_x_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type);
+    dpu_rank_status_e (*reduce_scatter_cpu_y_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type);
 
     dpu_rank_status_e (*all_reduce_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size, uint32_t reduce_type);
     dpu_rank_status_e (*all_reduce_x_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type);
@@ -74,6 +74,12 @@ typedef struct dpu_rank_handler {
     dpu_rank_status_e (*all_to_all_y_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset);
     dpu_rank_status_e (*all_to_all_z_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset);
 
+    dpu_rank_status_e (*all_to_all_inplace_rns)(struct dpu_set_t *comm_dpu_set, uint32_t start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis);
+    dpu_rank_status_e (*permute_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t* source);
+    dpu_rank_status_e (*transpose_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t num_tiles, uint32_t num_rg, uint32_t* tile_src_rg, uint32_t* tile_dst_rg, uint32_t swap, uint32_t rows, uint32_t cols, uint32_t size);
+    dpu_rank_status_e (*all_to_all_v_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t num_passes, uint32_t* passes);
+    dpu_rank_status_e (*reduce_quantized_rns)(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t chunk_words, uint32_t quant_size, uint32_t quant_block, uint32_t* source_start, uint32_t* sources);
+
     struct {
 #define FEATURE(feature, ...) dpu_error_t (*feature)(__VA_ARGS__);
 #include <rank_features.def>
@@ -74,6 +74,9 @@ PROPERTIES = [
     Property('poolThreshold1Thread'    , 'int' ),
     Property('poolThreshold2Threads'   , 'int' ),
     Property('poolThreshold4Threads'   , 'int' ),
+    Property('nrThreadPerCommPool'     , 'int' ),
+    Property('nrTaskPerCommThread'     , 'int' ),
+    Property('commWorkStealing'        , 'bool'),
 
     # Backup SPI
     Property('usbSerial'               , 'str' ),
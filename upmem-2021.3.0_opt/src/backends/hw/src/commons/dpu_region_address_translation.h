@@ -228,6 +228,60 @@ struct dpu_region_address_translation {
         uint32_t communication_buffer_offset
     );
 
+    void (*trans_all_to_all_inplace_rg)(
+        void *base_region_addr_a,
+        void *base_region_addr_b,
+        uint32_t rg_id_a,
+        uint32_t rg_id_b,
+        uint32_t offset_a,
+        uint32_t offset_b,
+        uint32_t length,
+        uint32_t alltoall_comm_type
+    );
+
+    void (*trans_permute_rg)(
+        void **base_region_addr_src,
+        void *base_region_addr_dst,
+        uint32_t *src_rg_id,
+        uint32_t *rotate,
+        uint8_t *lane_mask,
+        uint32_t num_src,
+        uint32_t dst_rg_id,
+        uint32_t src_offset,
+        uint32_t dst_offset,
+        uint32_t length
+    );
+
+    void (*trans_transpose_rg)(
+        void **base_region_addr_a,
+        void **base_region_addr_b,
+        uint32_t *rg_id_a,
+        uint32_t *rg_id_b,
+        uint32_t num_rg,
+        uint32_t swap,
+        uint32_t offset_a,
+        uint32_t offset_b,
+        uint32_t length,
+        uint32_t rows,
+        uint32_t cols,
+        uint32_t size
+    );
+
+    void (*trans_reduce_quantized_rg)(
+        void **base_region_addr_src,
+        void *base_region_addr_dst,
+        uint32_t *src_rg_id,
+        uint32_t *rotate,
+        uint8_t *lane_mask,
+        uint32_t *src_start_offset,
+        uint32_t num_src,
+        uint32_t dst_rg_id,
+        uint32_t dst_start_offset,
+        uint32_t chunk_words,
+        uint32_t quant_size,
+        uint32_t quant_block
+    );
+
     void (*trans_all_gather_rg)(
         void *base_region_addr_src,
         void **base_region_addr_dst,
@@ -301,7 +355,8 @@ struct dpu_region_address_translation {
         uint32_t communication_buffer_offset,
         void **host_buffer,
         uint32_t host_buffer_first_index,
-        uint32_t data_size
+        uint32_t data_size,
+        uint32_t reduce_type
     );
 
     void (*trans_scatter_rg)(
@@ -331,6 +386,7 @@ struct dpu_region_address_translation {
         uint32_t alltoall_comm_type,
         uint32_t communication_buffer_offset,
         uint32_t size,
+        uint32_t reduce_type,
         uint32_t num_thread,
         uint32_t thread_id
     );
@@ -347,7 +403,8 @@ struct dpu_region_address_translation {
         uint32_t communication_buffer_offset,
         uint32_t num_iter_dst,
         uint32_t a_length,
-        uint32_t size
+        uint32_t size,
+        uint32_t reduce_type
     );
 
     void (*trans_reduce_scatter_cpu_rg_22)(
@@ -363,7 +420,8 @@ struct dpu_region_address_translation {
         uint32_t comm_axis_z,
         uint32_t communication_buffer_offset,
         uint32_t num_iter_dst,
-        uint32_t size
+        uint32_t size,
+        uint32_t reduce_type
     );
 
     void (*trans_reduce_scatter_cpu_y_rg)(
@@ -377,7 +435,8 @@ struct dpu_region_address_translation {
         uint32_t num_iter_src,
         uint32_t alltoall_comm_type,
         uint32_t communication_buffer_offset,
-        uint32_t size
+        uint32_t size,
+        uint32_t reduce_type
     );
 
     void (*trans_all_reduce_rg)(
@@ -411,7 +470,8 @@ struct dpu_region_address_translation {
         uint32_t communication_buffer_offset,
         uint32_t num_iter_dst,
         uint32_t a_length,
-        uint32_t size
+        uint32_t size,
+        uint32_t reduce_type
     );
 
     void (*trans_all_reduce_rg_22)(
@@ -428,7 +488,8 @@ struct dpu_region_address_translation {
         uint32_t comm_axis_z,
         uint32_t communication_buffer_offset,
         uint32_t num_iter_dst,
-        uint32_t size
+        uint32_t size,
+        uint32_t reduce_type
     );
 
     void (*trans_all_reduce_y_rg)(
@@ -457,21 +518,26 @@ void xeon_sp_trans_all_to_all_rg(void *base_region_addr_src, void *base_region_a
 void xeon_sp_trans_all_to_all_rg_24(void *base_region_addr_src, void *base_region_addr_dst, uint32_t src_rg_id, uint32_t dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t a_length);
 void xeon_sp_trans_all_to_all_rg_22(void *base_region_addr_src, void *base_region_addr_dst, uint32_t src_rg_id, uint32_t dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t alltoall_comm_type_x, uint32_t alltoall_comm_type_y, uint32_t alltoall_comm_type_z, uint32_t communication_buffer_offset);
 
+void xeon_sp_trans_all_to_all_inplace_rg(void *base_region_addr_a, void *base_region_addr_b, uint32_t rg_id_a, uint32_t rg_id_b, uint32_t offset_a, uint32_t offset_b, uint32_t length, uint32_t alltoall_comm_type);
+void xeon_sp_trans_permute_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t* rotate, uint8_t* lane_mask, uint32_t num_src, uint32_t dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length);
+void xeon_sp_trans_transpose_rg(void **base_region_addr_a, void **base_region_addr_b, uint32_t* rg_id_a, uint32_t* rg_id_b, uint32_t num_rg, uint32_t swap, uint32_t offset_a, uint32_t offset_b, uint32_t length, uint32_t rows, uint32_t cols, uint32_t size);
+void xeon_sp_trans_reduce_quantized_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t* rotate, uint8_t* lane_mask, uint32_t* src_start_offset, uint32_t num_src, uint32_t dst_rg_id, uint32_t dst_start_offset, uint32_t chunk_words, uint32_t quant_size, uint32_t quant_block);
+
 void xeon_sp_trans_all_gather_rg(void *base_region_addr_src, void **base_region_addr_dst, uint32_t src_rg_id, uint32_t* dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t num_thread, uint32_t thread_id);
 void xeon_sp_trans_all_gather_rg_24(void *base_region_addr_src, void **base_region_addr_dst, uint32_t src_rg_id, uint32_t* dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t a_length);
 void xeon_sp_trans_all_gather_rg_22(void *base_region_addr_src, void **base_region_addr_dst, uint32_t src_rg_id, uint32_t* dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t comm_axis_x, uint32_t comm_axis_y, uint32_t comm_axis_z, uint32_t communication_buffer_offset, uint32_t num_iter_dst);
 
 void xeon_sp_trans_gather_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void **host_buffer, uint32_t host_buffer_first_index);
-void xeon_sp_trans_reduce_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t total_length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void **host_buffer, uint32_t host_buffer_first_index, uint32_t data_size);
+void xeon_sp_trans_reduce_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t total_length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void **host_buffer, uint32_t host_buffer_first_index, uint32_t data_size, uint32_t reduce_type);
 void xeon_sp_trans_scatter_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void **host_buffer, uint32_t host_buffer_first_index);
 
-void xeon_sp_trans_reduce_scatter_cpu_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t num_thread, uint32_t thread_id);
-void xeon_sp_trans_reduce_scatter_cpu_rg_24(void *base_region_addr_src, void **base_region_addr_dst, uint32_t src_rg_id, uint32_t* dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t a_length, uint32_t size);
-void xeon_sp_trans_reduce_scatter_cpu_rg_22(void *base_region_addr_src, void **base_region_addr_dst, uint32_t src_rg_id, uint32_t* dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t comm_axis_x, uint32_t comm_axis_y, uint32_t comm_axis_z, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t size);
-void xeon_sp_trans_reduce_scatter_cpu_y_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size);
+void xeon_sp_trans_reduce_scatter_cpu_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type, uint32_t num_thread, uint32_t thread_id);
+void xeon_sp_trans_reduce_scatter_cpu_rg_24(void *base_region_addr_src, void **base_region_addr_dst, uint32_t src_rg_id, uint32_t* dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t a_length, uint32_t size, uint32_t reduce_type);
+void xeon_sp_trans_reduce_scatter_cpu_rg_22(void *base_region_addr_src, void **base_region_addr_dst, uint32_t src_rg_id, uint32_t* dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t comm_axis_x, uint32_t comm_axis_y, uint32_t comm_axis_z, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t size, uint32_t reduce_type);
+void xeon_sp_trans_reduce_scatter_cpu_y_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type);
 
 void xeon_sp_trans_all_reduce_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t iter_dst_a, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type, uint32_t num_thread, uint32_t thread_id);
-void xeon_sp_trans_all_reduce_rg_24(void *base_region_addr_src, void **base_region_addr_dst, uint32_t src_rg_id, uint32_t* dst_rg_id, uint32_t iter_dst_a, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t a_length, uint32_t size);
-void xeon_sp_trans_all_reduce_rg_22(void *base_region_addr_src, void **base_region_addr_dst, uint32_t src_rg_id, uint32_t* dst_rg_id, uint32_t iter_dst_a, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t comm_axis_x, uint32_t comm_axis_y, uint32_t comm_axis_z, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t size);
+void xeon_sp_trans_all_reduce_rg_24(void *base_region_addr_src, void **base_region_addr_dst, uint32_t src_rg_id, uint32_t* dst_rg_id, uint32_t iter_dst_a, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t a_length, uint32_t size, uint32_t reduce_type);
+void xeon_sp_trans_all_reduce_rg_22(void *base_region_addr_src, void **base_region_addr_dst, uint32_t src_rg_id, uint32_t* dst_rg_id, uint32_t iter_dst_a, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t comm_axis_x, uint32_t comm_axis_y, uint32_t comm_axis_z, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t size, uint32_t reduce_type);
 void xeon_sp_trans_all_reduce_y_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t iter_dst_a, uint32_t src_offset, uint32_t dst_offset, uint32_t length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type);
 #endif /* DPU_REGION_ADDRESS_TRANSLATION_INCLUDE_H */
@@ -60,6 +60,36 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
     return unchanged_bits | (bits_21_to_15 << 14) | (bit_14 << 21);
 }
 
+/* The translation above only moves bits 14 to 21, and the chunk mapping below only splits bit 17 of the
+ * region offset (= bit 13 of the MRAM offset), so the region offset is linear within each 8KB block of MRAM:
+ *
+ * region_offset(o) = region_offset(o & ~0x1fff) + (o & 0x1fff) * 16
+ *
+ * The rotate-and-stream kernels look up the base of the block instead of translating every 64bit word.
+ */
+#define MRAM_LINEAR_BLOCK_SHIFT_a2a 13
+#define MRAM_LINEAR_BLOCK_MASK_a2a ((1 << MRAM_LINEAR_BLOCK_SHIFT_a2a) - 1)
+#define MRAM_NR_LINEAR_BLOCK_a2a (MRAM_SIZE_a2a >> MRAM_LINEAR_BLOCK_SHIFT_a2a)
+
+static uint64_t mram_block_region_offset_a2a[MRAM_NR_LINEAR_BLOCK_a2a];
+
+__attribute__((constructor)) static void
+setup_mram_block_region_offset_a2a(void)
+{
+    for (uint32_t block = 0; block < MRAM_NR_LINEAR_BLOCK_a2a; block++) {
+        uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(block << MRAM_LINEAR_BLOCK_SHIFT_a2a);
+        uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a((uint64_t)mram_64_bit_word_offset);
+        mram_block_region_offset_a2a[block] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+    }
+}
+
+static inline uint64_t
+mram_offset_to_region_offset_a2a(uint32_t byte_offset)
+{
+    return mram_block_region_offset_a2a[(byte_offset >> MRAM_LINEAR_BLOCK_SHIFT_a2a) & (MRAM_NR_LINEAR_BLOCK_a2a - 1)]
+        + BANK_OFFSET_NEXT_DATA_a2a((uint64_t)(byte_offset & MRAM_LINEAR_BLOCK_MASK_a2a));
+}
+
 /////////////////////////////////////////////////////////
 
 #define RNS_FLUSH_DST(iter, dst_rank_bgwise_addr)                                  \
@@ -90,6 +120,28 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         }                                                                              \
     } while (0)
 
+/* The reduction kernels read the sources of COMM_FLUSH_BLOCK iterations before invalidating them with a single
+ * fence, instead of one fence per 64-byte iteration. The destinations are written with non-temporal stores,
+ * which bypass the CPU cache, so they are never flushed (cf. threads_write_to_rank in xeon_sp_translation.c).
+ */
+#ifndef COMM_FLUSH_BLOCK
+#define COMM_FLUSH_BLOCK 32
+#endif
+
+#define RNS_FLUSH_BLOCK(FLUSH, iter, rank_bgwise_addr_block, nr_block, nr_addr)          \
+    do                                                                                   \
+    {                                                                                    \
+        _mm_mfence();                                                                    \
+                                                                                         \
+        for (uint32_t blk = 0; blk < (nr_block); blk++)                                  \
+        {                                                                                \
+            for (uint32_t addr = 0; addr < (nr_addr); addr++)                            \
+            {                                                                            \
+                FLUSH(iter, rank_bgwise_addr_block[blk][addr]);                          \
+            }                                                                            \
+        }                                                                                \
+    } while (0)
+
 #define RNS_SRC_BG_a2a 4
 #define RNS_TAR_BG_a2a 8
 #define chip_rank_a2a 64
@@ -551,22 +603,382 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         } \
     } while (0)
 
-#define REDUCE_S_SUM_RS(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size)   \
+/* Data types of the reductions, mirrored from PIDCOMM_DTYPE in pidcomm.h.
+ * The low byte is the element size in bytes and the high byte the kind of lanes, signed integers being kind 0
+ * so that sizeof(T) can be passed. The relocation only depends on the element size and is shared by all kinds.
+ */
+#define PIDCOMM_DTYPE_SIZE(dtype) ((dtype) & 0xff)
+#define PIDCOMM_DTYPE_KIND(dtype) ((dtype) >> 8)
+
+#define PIDCOMM_DTYPE_KIND_INT 0
+#define PIDCOMM_DTYPE_KIND_FLOAT32 1
+#define PIDCOMM_DTYPE_KIND_BFLOAT16 2
+#define PIDCOMM_DTYPE_KIND_FLOAT16 3
+#define PIDCOMM_DTYPE_KIND_UINT 4
+
+#define PIDCOMM_DTYPE_FLOAT32 0x104
+#define PIDCOMM_DTYPE_BFLOAT16 0x202
+#define PIDCOMM_DTYPE_FLOAT16 0x302
+
+/* Reduction operators, mirrored from PIDCOMM_OPERATOR in pidcomm.h */
+#define PIDCOMM_OP_SUM 0
+#define PIDCOMM_OP_MAX 1
+#define PIDCOMM_OP_SAT_SUM 2
+#define PIDCOMM_OP_MIN 3
+#define PIDCOMM_OP_PROD 4
+#define PIDCOMM_OP_BAND 5
+#define PIDCOMM_OP_BOR 6
+#define PIDCOMM_OP_BXOR 7
+
+/* Multiplies 8-bit lanes: the even bytes are the low bytes of a 16-bit multiply, the odd bytes are multiplied in the high bytes */
+static inline __m512i mullo_epi8(__m512i a, __m512i b)
+{
+    __m512i even = _mm512_mullo_epi16(a, b);
+    __m512i odd = _mm512_mullo_epi16(_mm512_srli_epi16(a, 8), _mm512_srli_epi16(b, 8));
+
+    return _mm512_mask_blend_epi8(0xAAAAAAAAAAAAAAAAULL, even, _mm512_slli_epi16(odd, 8));
+}
+
+/* vpmullq needs AVX512DQ, so the low 64 bits of the product are built from 32-bit multiplies */
+static inline __m512i mullo_epi64(__m512i a, __m512i b)
+{
+    __m512i cross = _mm512_add_epi64(_mm512_mul_epu32(_mm512_srli_epi64(a, 32), b), _mm512_mul_epu32(a, _mm512_srli_epi64(b, 32)));
+
+    return _mm512_add_epi64(_mm512_mul_epu32(a, b), _mm512_slli_epi64(cross, 32));
+}
+
+/* Saturating adds for the widths without a native instruction: a lane overflows when both operands have the sign
+ * the result does not have, and then saturates towards the sign of the operands.
+ */
+static inline __m512i adds_epi32(__m512i a, __m512i b)
+{
+    __m512i res = _mm512_add_epi32(a, b);
+    __mmask16 overflow = _mm512_cmplt_epi32_mask(_mm512_and_si512(_mm512_xor_si512(a, res), _mm512_xor_si512(b, res)), _mm512_setzero_si512());
+
+    return _mm512_mask_mov_epi32(res, overflow, _mm512_xor_si512(_mm512_srai_epi32(a, 31), _mm512_set1_epi32(INT32_MAX)));
+}
+
+static inline __m512i adds_epi64(__m512i a, __m512i b)
+{
+    __m512i res = _mm512_add_epi64(a, b);
+    __mmask8 overflow = _mm512_cmplt_epi64_mask(_mm512_and_si512(_mm512_xor_si512(a, res), _mm512_xor_si512(b, res)), _mm512_setzero_si512());
+
+    return _mm512_mask_mov_epi64(res, overflow, _mm512_xor_si512(_mm512_srai_epi64(a, 63), _mm512_set1_epi64(INT64_MAX)));
+}
+
+/* An unsigned lane overflows when the sum wraps below an operand */
+static inline __m512i adds_epu32(__m512i a, __m512i b)
+{
+    __m512i res = _mm512_add_epi32(a, b);
+
+    return _mm512_mask_mov_epi32(res, _mm512_cmplt_epu32_mask(res, a), _mm512_set1_epi32(-1));
+}
+
+static inline __m512i adds_epu64(__m512i a, __m512i b)
+{
+    __m512i res = _mm512_add_epi64(a, b);
+
+    return _mm512_mask_mov_epi64(res, _mm512_cmplt_epu64_mask(res, a), _mm512_set1_epi64(-1));
+}
+
+static inline __m512 reduce_ps(__m512 acc, __m512 val, uint32_t reduce_type)
+{
+    switch (reduce_type) {
+        case PIDCOMM_OP_MAX:
+            return _mm512_max_ps(acc, val);
+        case PIDCOMM_OP_MIN:
+            return _mm512_min_ps(acc, val);
+        case PIDCOMM_OP_PROD:
+            return _mm512_mul_ps(acc, val);
+        default: //floating-point sums saturate to infinity
+            return _mm512_add_ps(acc, val);
+    }
+}
+
+static inline __m512i reduce_epi8(__m512i acc, __m512i val, uint32_t reduce_type)
+{
+    switch (reduce_type) {
+        case PIDCOMM_OP_MAX:
+            return _mm512_max_epi8(acc, val);
+        case PIDCOMM_OP_SAT_SUM:
+            return _mm512_adds_epi8(acc, val);
+        case PIDCOMM_OP_MIN:
+            return _mm512_min_epi8(acc, val);
+        case PIDCOMM_OP_PROD:
+            return mullo_epi8(acc, val);
+        case PIDCOMM_OP_BAND:
+            return _mm512_and_si512(acc, val);
+        case PIDCOMM_OP_BOR:
+            return _mm512_or_si512(acc, val);
+        case PIDCOMM_OP_BXOR:
+            return _mm512_xor_si512(acc, val);
+        default:
+            return _mm512_add_epi8(acc, val);
+    }
+}
+
+static inline __m512i reduce_epi16(__m512i acc, __m512i val, uint32_t reduce_type)
+{
+    switch (reduce_type) {
+        case PIDCOMM_OP_MAX:
+            return _mm512_max_epi16(acc, val);
+        case PIDCOMM_OP_SAT_SUM:
+            return _mm512_adds_epi16(acc, val);
+        case PIDCOMM_OP_MIN:
+            return _mm512_min_epi16(acc, val);
+        case PIDCOMM_OP_PROD:
+            return _mm512_mullo_epi16(acc, val);
+        case PIDCOMM_OP_BAND:
+            return _mm512_and_si512(acc, val);
+        case PIDCOMM_OP_BOR:
+            return _mm512_or_si512(acc, val);
+        case PIDCOMM_OP_BXOR:
+            return _mm512_xor_si512(acc, val);
+        default:
+            return _mm512_add_epi16(acc, val);
+    }
+}
+
+static inline __m512i reduce_epi32(__m512i acc, __m512i val, uint32_t reduce_type)
+{
+    switch (reduce_type) {
+        case PIDCOMM_OP_MAX:
+            return _mm512_max_epi32(acc, val);
+        case PIDCOMM_OP_SAT_SUM:
+            return adds_epi32(acc, val);
+        case PIDCOMM_OP_MIN:
+            return _mm512_min_epi32(acc, val);
+        case PIDCOMM_OP_PROD:
+            return _mm512_mullo_epi32(acc, val);
+        case PIDCOMM_OP_BAND:
+            return _mm512_and_si512(acc, val);
+        case PIDCOMM_OP_BOR:
+            return _mm512_or_si512(acc, val);
+        case PIDCOMM_OP_BXOR:
+            return _mm512_xor_si512(acc, val);
+        default:
+            return _mm512_add_epi32(acc, val);
+    }
+}
+
+static inline __m512i reduce_epi64(__m512i acc, __m512i val, uint32_t reduce_type)
+{
+    switch (reduce_type) {
+        case PIDCOMM_OP_MAX:
+            return _mm512_max_epi64(acc, val);
+        case PIDCOMM_OP_SAT_SUM:
+            return adds_epi64(acc, val);
+        case PIDCOMM_OP_MIN:
+            return _mm512_min_epi64(acc, val);
+        case PIDCOMM_OP_PROD:
+            return mullo_epi64(acc, val);
+        case PIDCOMM_OP_BAND:
+            return _mm512_and_si512(acc, val);
+        case PIDCOMM_OP_BOR:
+            return _mm512_or_si512(acc, val);
+        case PIDCOMM_OP_BXOR:
+            return _mm512_xor_si512(acc, val);
+        default:
+            return _mm512_add_epi64(acc, val);
+    }
+}
+
+static inline __m512i reduce_epu8(__m512i acc, __m512i val, uint32_t reduce_type)
+{
+    switch (reduce_type) {
+        case PIDCOMM_OP_MAX:
+            return _mm512_max_epu8(acc, val);
+        case PIDCOMM_OP_SAT_SUM:
+            return _mm512_adds_epu8(acc, val);
+        case PIDCOMM_OP_MIN:
+            return _mm512_min_epu8(acc, val);
+        default: //sums, products and bitwise operators do not depend on the signedness
+            return reduce_epi8(acc, val, reduce_type);
+    }
+}
+
+static inline __m512i reduce_epu16(__m512i acc, __m512i val, uint32_t reduce_type)
+{
+    switch (reduce_type) {
+        case PIDCOMM_OP_MAX:
+            return _mm512_max_epu16(acc, val);
+        case PIDCOMM_OP_SAT_SUM:
+            return _mm512_adds_epu16(acc, val);
+        case PIDCOMM_OP_MIN:
+            return _mm512_min_epu16(acc, val);
+        default: //sums, products and bitwise operators do not depend on the signedness
+            return reduce_epi16(acc, val, reduce_type);
+    }
+}
+
+static inline __m512i reduce_epu32(__m512i acc, __m512i val, uint32_t reduce_type)
+{
+    switch (reduce_type) {
+        case PIDCOMM_OP_MAX:
+            return _mm512_max_epu32(acc, val);
+        case PIDCOMM_OP_SAT_SUM:
+            return adds_epu32(acc, val);
+        case PIDCOMM_OP_MIN:
+            return _mm512_min_epu32(acc, val);
+        default: //sums, products and bitwise operators do not depend on the signedness
+            return reduce_epi32(acc, val, reduce_type);
+    }
+}
+
+static inline __m512i reduce_epu64(__m512i acc, __m512i val, uint32_t reduce_type)
+{
+    switch (reduce_type) {
+        case PIDCOMM_OP_MAX:
+            return _mm512_max_epu64(acc, val);
+        case PIDCOMM_OP_SAT_SUM:
+            return adds_epu64(acc, val);
+        case PIDCOMM_OP_MIN:
+            return _mm512_min_epu64(acc, val);
+        default: //sums, products and bitwise operators do not depend on the signedness
+            return reduce_epi64(acc, val, reduce_type);
+    }
+}
+
+/* Per-lane patterns of the integer identities, indexed by log2 of the element size */
+static const uint64_t lane_one[4] = {0x0101010101010101ULL, 0x0001000100010001ULL, 0x0000000100000001ULL, 0x0000000000000001ULL};
+static const uint64_t lane_sign[4] = {0x8080808080808080ULL, 0x8000800080008000ULL, 0x8000000080000000ULL, 0x8000000000000000ULL};
+
+/* Identity of the operator, in the layout of the accumulator (fp32 for the floating-point types) */
+static inline __m512i reduce_lanes_identity(uint32_t size, uint32_t reduce_type)
+{
+    uint32_t kind = PIDCOMM_DTYPE_KIND(size);
+    uint32_t width = __builtin_ctz(PIDCOMM_DTYPE_SIZE(size) | 0x10);
+
+    if (kind == PIDCOMM_DTYPE_KIND_FLOAT32 || kind == PIDCOMM_DTYPE_KIND_BFLOAT16 || kind == PIDCOMM_DTYPE_KIND_FLOAT16) {
+        switch (reduce_type) {
+            case PIDCOMM_OP_MAX:
+                return _mm512_castps_si512(_mm512_set1_ps(-__builtin_inff()));
+            case PIDCOMM_OP_MIN:
+                return _mm512_castps_si512(_mm512_set1_ps(__builtin_inff()));
+            case PIDCOMM_OP_PROD:
+                return _mm512_castps_si512(_mm512_set1_ps(1.0f));
+            default:
+                return _mm512_setzero_si512();
+        }
+    }
+    if (width > 3) {
+        return _mm512_setzero_si512();
+    }
+    switch (reduce_type) {
+        case PIDCOMM_OP_MAX:
+            return kind == PIDCOMM_DTYPE_KIND_UINT ? _mm512_setzero_si512() : _mm512_set1_epi64(lane_sign[width]);
+        case PIDCOMM_OP_MIN:
+            return kind == PIDCOMM_DTYPE_KIND_UINT ? _mm512_set1_epi64(-1) : _mm512_set1_epi64(~lane_sign[width]);
+        case PIDCOMM_OP_PROD:
+            return _mm512_set1_epi64(lane_one[width]);
+        case PIDCOMM_OP_BAND:
+            return _mm512_set1_epi64(-1);
+        default:
+            return _mm512_setzero_si512();
+    }
+}
+
+/* Reduces one register of 8-bit to 64-bit lanes into the accumulator.
+ * Floating-point lanes are accumulated in fp32: bf16 lanes keep the even elements in sum and the odd ones in sum_hi,
+ * fp16 lanes keep the low 256 bits in sum and the high 256 bits in sum_hi. reduce_lanes_finish() converts them back.
+ * Integer lanes are dispatched on the kind and size of the data type, so every width has its own instructions.
+ * The bitwise operators never see a floating-point type, the plan reduces those as integers of the same size.
+ */
+static inline void reduce_lanes(__m512i *sum, __m512i *sum_hi, __m512i reg, uint32_t size, uint32_t reduce_type)
+{
+    switch (PIDCOMM_DTYPE_KIND(size)) {
+        case PIDCOMM_DTYPE_KIND_FLOAT32:
+            *sum = _mm512_castps_si512(reduce_ps(_mm512_castsi512_ps(*sum), _mm512_castsi512_ps(reg), reduce_type));
+            return;
+        case PIDCOMM_DTYPE_KIND_BFLOAT16: {
+#ifdef __AVX512BF16__
+            if (reduce_type == PIDCOMM_OP_SUM || reduce_type == PIDCOMM_OP_SAT_SUM) {
+                /* vdpbf16ps with 1.0 in one element of each pair adds the other element of the pair in fp32 */
+                __m512bh ones_even = (__m512bh)_mm512_set1_epi32(0x00003f80);
+                __m512bh ones_odd = (__m512bh)_mm512_set1_epi32(0x3f800000);
+                *sum = _mm512_castps_si512(_mm512_dpbf16_ps(_mm512_castsi512_ps(*sum), (__m512bh)reg, ones_even));
+                *sum_hi = _mm512_castps_si512(_mm512_dpbf16_ps(_mm512_castsi512_ps(*sum_hi), (__m512bh)reg, ones_odd));
+                return;
+            }
+#endif
+            __m512 even = _mm512_castsi512_ps(_mm512_slli_epi32(reg, 16));
+            __m512 odd = _mm512_castsi512_ps(_mm512_and_si512(reg, _mm512_set1_epi32(0xffff0000)));
+            *sum = _mm512_castps_si512(reduce_ps(_mm512_castsi512_ps(*sum), even, reduce_type));
+            *sum_hi = _mm512_castps_si512(reduce_ps(_mm512_castsi512_ps(*sum_hi), odd, reduce_type));
+            return;
+        }
+        case PIDCOMM_DTYPE_KIND_FLOAT16: {
+            __m512 lo = _mm512_cvtph_ps(_mm512_castsi512_si256(reg));
+            __m512 hi = _mm512_cvtph_ps(_mm512_extracti64x4_epi64(reg, 1));
+            *sum = _mm512_castps_si512(reduce_ps(_mm512_castsi512_ps(*sum), lo, reduce_type));
+            *sum_hi = _mm512_castps_si512(reduce_ps(_mm512_castsi512_ps(*sum_hi), hi, reduce_type));
+            return;
+        }
+        case PIDCOMM_DTYPE_KIND_UINT:
+            switch (PIDCOMM_DTYPE_SIZE(size)) {
+                case 1:
+                    *sum = reduce_epu8(*sum, reg, reduce_type);
+                    return;
+                case 2:
+                    *sum = reduce_epu16(*sum, reg, reduce_type);
+                    return;
+                case 4:
+                    *sum = reduce_epu32(*sum, reg, reduce_type);
+                    return;
+                default:
+                    *sum = reduce_epu64(*sum, reg, reduce_type);
+                    return;
+            }
+        default:
+            switch (PIDCOMM_DTYPE_SIZE(size)) {
+                case 1:
+                    *sum = reduce_epi8(*sum, reg, reduce_type);
+                    return;
+                case 2:
+                    *sum = reduce_epi16(*sum, reg, reduce_type);
+                    return;
+                case 4:
+                    *sum = reduce_epi32(*sum, reg, reduce_type);
+                    return;
+                default:
+                    *sum = reduce_epi64(*sum, reg, reduce_type);
+                    return;
+            }
+    }
+}
+
+/* Rounds fp32 lanes to bf16 (nearest even), the result is in the upper 16 bits of each lane */
+static inline __m512i fp32_to_bf16_high(__m512i bits)
+{
+    __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+    __m512i rounded = _mm512_add_epi32(bits, _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7fff)));
+    __mmask16 nan = _mm512_cmp_ps_mask(_mm512_castsi512_ps(bits), _mm512_castsi512_ps(bits), _CMP_UNORD_Q);
+
+    rounded = _mm512_mask_or_epi32(rounded, nan, bits, _mm512_set1_epi32(0x00400000));
+    return _mm512_and_si512(rounded, _mm512_set1_epi32(0xffff0000));
+}
+
+static inline __m512i reduce_lanes_finish(__m512i sum, __m512i sum_hi, uint32_t size)
+{
+    if (size == PIDCOMM_DTYPE_BFLOAT16) {
+        return _mm512_or_si512(_mm512_srli_epi32(fp32_to_bf16_high(sum), 16), fp32_to_bf16_high(sum_hi));
+    } else if (size == PIDCOMM_DTYPE_FLOAT16) {
+        __m256i lo = _mm512_cvtps_ph(_mm512_castsi512_ps(sum), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256i hi = _mm512_cvtps_ph(_mm512_castsi512_ps(sum_hi), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+    }
+    return sum;
+}
+
+#define REDUCE_S_SUM_RS(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type) \
     do                                                                                          \
     {                                                                                           \
         __m512i reg1;                                                                           \
                                                                                                 \
         void *dst_rank_clwise_addr9 = dst_rank_bgwise_addr;                                     \
                                                                                                 \
-        __m512i sum = _mm512_set_epi64(                                                         \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL);                                 \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                 \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                              \
                                                                                                 \
         __m512i mask = _mm512_set_epi64(                                                        \
                                         0x0f0b07030e0a0602ULL,                                  \
@@ -581,7 +993,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                                                 1, 3, 5, 7, 9, 11, 13, 15);                     \
         __m512i perm = _mm512_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15); \
                                                                                                 \
-        if(size == 1){                                                                          \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                      \
             for (int cl = 0; cl < iter; cl++)                                                   \
             {                                                                                   \
                                                                                                 \
@@ -589,7 +1001,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     void *src_rank_clwise_addr1 = src_rank_bgwise_addr[i];                      \
                                                                                                 \
                     reg1 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr1));           \
-                    sum = _mm512_add_epi8(sum, reg1);                                           \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                       \
                 }                                                                               \
                                                                                                 \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                    \
@@ -611,17 +1023,16 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg1 = _mm512_shuffle_epi8(reg1, mask);                                     \
                     reg1 = _mm512_permutexvar_epi32(perm, reg1);                                \
                                                                                                 \
-                    if(size == 2) sum = _mm512_add_epi16(sum, reg1);                            \
-                    else if(size == 4) sum = _mm512_add_epi32(sum, reg1);                       \
-                    else sum = _mm512_add_epi64(sum, reg1);                                     \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                       \
                 }                                                                               \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                   \
                 __mmask8 mask_all = 0xFF;                                                       \
                 _mm512_mask_storeu_epi64((__m512i*)dst_rank_clwise_addr9, mask_all, sum);       \
             }                                                                                   \
         }                                                                                       \
     } while (0)
 
-#define REDUCE_RNS_SUM_RS(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size)     \
+#define REDUCE_RNS_SUM_RS(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type) \
     do                                                                                              \
     {                                                                                               \
                                                                                                     \
@@ -638,15 +1049,8 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         void *dst_rank_clwise_addr9 = dst_rank_bgwise_addr;                                         \
                                                                                                     \
                                                                                                     \
-        __m512i sum = _mm512_set_epi64(                                                             \
-                                        0x0000000000000000ULL,                                      \
-                                        0x0000000000000000ULL,                                      \
-                                        0x0000000000000000ULL,                                      \
-                                        0x0000000000000000ULL,                                      \
-                                        0x0000000000000000ULL,                                      \
-                                        0x0000000000000000ULL,                                      \
-                                        0x0000000000000000ULL,                                      \
-                                        0x0000000000000000ULL);                                     \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                     \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                                  \
                                                                                                     \
         __m512i mask = _mm512_set_epi64(                                                            \
                                         0x0f0b07030e0a0602ULL,                                      \
@@ -661,7 +1065,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                                                 1, 3, 5, 7, 9, 11, 13, 15);                         \
         __m512i perm = _mm512_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15);     \
                                                                                                     \
-        if(size == 1){                                                                              \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                          \
             for (int cl = 0; cl < iter; cl++)                                                       \
             {                                                                                       \
                                                                                                     \
@@ -699,14 +1103,14 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg8 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr8));               \
                     reg8 = _mm512_rol_epi64(reg8, 56);                                              \
                                                                                                     \
-                    sum = _mm512_add_epi8(sum, reg1);                                               \
-                    sum = _mm512_add_epi8(sum, reg2);                                               \
-                    sum = _mm512_add_epi8(sum, reg3);                                               \
-                    sum = _mm512_add_epi8(sum, reg4);                                               \
-                    sum = _mm512_add_epi8(sum, reg5);                                               \
-                    sum = _mm512_add_epi8(sum, reg6);                                               \
-                    sum = _mm512_add_epi8(sum, reg7);                                               \
-                    sum = _mm512_add_epi8(sum, reg8);                                               \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg5, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg6, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg7, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg8, size, reduce_type);                           \
                                                                                                     \
                 }                                                                                   \
                                                                                                     \
@@ -779,38 +1183,17 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg8 = _mm512_shuffle_epi8(reg8, mask);                                         \
                     reg8 = _mm512_permutexvar_epi32(perm, reg8);                                    \
                                                                                                     \
-                    if(size == 2){                                                                  \
-                        sum = _mm512_add_epi16(sum, reg1);                                          \
-                        sum = _mm512_add_epi16(sum, reg2);                                          \
-                        sum = _mm512_add_epi16(sum, reg3);                                          \
-                        sum = _mm512_add_epi16(sum, reg4);                                          \
-                        sum = _mm512_add_epi16(sum, reg5);                                          \
-                        sum = _mm512_add_epi16(sum, reg6);                                          \
-                        sum = _mm512_add_epi16(sum, reg7);                                          \
-                        sum = _mm512_add_epi16(sum, reg8);                                          \
-                    }                                                                               \
-                    else if(size == 4){                                                             \
-                        sum = _mm512_add_epi32(sum, reg1);                                          \
-                        sum = _mm512_add_epi32(sum, reg2);                                          \
-                        sum = _mm512_add_epi32(sum, reg3);                                          \
-                        sum = _mm512_add_epi32(sum, reg4);                                          \
-                        sum = _mm512_add_epi32(sum, reg5);                                          \
-                        sum = _mm512_add_epi32(sum, reg6);                                          \
-                        sum = _mm512_add_epi32(sum, reg7);                                          \
-                        sum = _mm512_add_epi32(sum, reg8);                                          \
-                    }                                                                               \
-                    else{                                                                           \
-                        sum = _mm512_add_epi64(sum, reg1);                                          \
-                        sum = _mm512_add_epi64(sum, reg2);                                          \
-                        sum = _mm512_add_epi64(sum, reg3);                                          \
-                        sum = _mm512_add_epi64(sum, reg4);                                          \
-                        sum = _mm512_add_epi64(sum, reg5);                                          \
-                        sum = _mm512_add_epi64(sum, reg6);                                          \
-                        sum = _mm512_add_epi64(sum, reg7);                                          \
-                        sum = _mm512_add_epi64(sum, reg8);                                          \
-                    }                                                                               \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg5, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg6, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg7, size, reduce_type);                           \
+                    reduce_lanes(&sum, &sum_hi, reg8, size, reduce_type);                           \
                                                                                                     \
                 }                                                                                   \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                       \
                                                                                                     \
                 __mmask8 mask_all = 0xFF;                                                           \
                 _mm512_mask_storeu_epi64((__m512i*)dst_rank_clwise_addr9, mask_all, sum);           \
@@ -820,31 +1203,24 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
 
 
 
-#define S_SUM_RS(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size)          \
+#define S_SUM_RS(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type) \
     do                                                                                          \
     {                                                                                           \
         __m512i reg1;                                                                           \
                                                                                                 \
         void *dst_rank_clwise_addr9 = dst_rank_bgwise_addr;                                     \
                                                                                                 \
-        __m512i sum = _mm512_set_epi64(                                                         \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL);                                 \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                 \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                              \
                                                                                                 \
-        if(size == 1){                                                                          \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                      \
             for (int cl = 0; cl < iter; cl++)                                                   \
             {                                                                                   \
                 for(uint32_t i=0; i<num_iter_src; i++){                                         \
                     void *src_rank_clwise_addr1 = src_rank_bgwise_addr[i];                      \
                                                                                                 \
                     reg1 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr1));           \
-                    sum = _mm512_add_epi8(sum, reg1);                                           \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                       \
                 }                                                                               \
                 _mm512_stream_si512((void *)(dst_rank_clwise_addr9), sum);                      \
             }                                                                                   \
@@ -873,10 +1249,9 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg1 = _mm512_shuffle_epi8(reg1, mask);                                     \
                     reg1 = _mm512_permutexvar_epi32(perm, reg1);                                \
                                                                                                 \
-                    if(size == 2) sum = _mm512_add_epi16(sum, reg1);                            \
-                    else if(size == 4) sum = _mm512_add_epi32(sum, reg1);                       \
-                    else sum = _mm512_add_epi64(sum, reg1);                                     \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                       \
                 }                                                                               \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                   \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                    \
                 sum = _mm512_shuffle_epi8(sum, mask);                                           \
                 sum = _mm512_permutexvar_epi32(perm, sum);                                      \
@@ -886,7 +1261,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         }                                                                                       \
     } while (0)
 
-#define REDUCE_SCATTER_CPU_Y_24(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, a_length) \
+#define REDUCE_SCATTER_CPU_Y_24(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type, a_length) \
     do                                                                                                          \
     {                                                                                                           \
         a_length+=0;                                                                                            \
@@ -897,17 +1272,10 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                                                                                                                 \
                                                                                                                 \
                                                                                                                 \
-        __m512i sum = _mm512_set_epi64(                                                                         \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL);                                                 \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                                 \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                                              \
                                                                                                                 \
-        if(size == 1){                                                                                          \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                                      \
             for (int cl = 0; cl < iter; cl++)                                                                   \
             {                                                                                                   \
                 for(uint32_t i=0; i<num_iter_src; i++){                                                         \
@@ -924,18 +1292,18 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                         reg3 = _mm512_rol_epi64(reg3, 32);                                                      \
                         reg4 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr4));                       \
                         reg4 = _mm512_rol_epi64(reg4, 48);                                                      \
-                        sum = _mm512_add_epi8(sum, reg1);                                                       \
-                        sum = _mm512_add_epi8(sum, reg2);                                                       \
-                        sum = _mm512_add_epi8(sum, reg3);                                                       \
-                        sum = _mm512_add_epi8(sum, reg4);                                                       \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                                   \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                                   \
+                        reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                                   \
+                        reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                                   \
                     }                                                                                           \
                     else if(a_length==4){                                                                       \
                         reg1 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr1));                       \
                         reg1 = _mm512_rol_epi64(reg1, 0);                                                       \
                         reg2 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr2));                       \
                         reg2 = _mm512_rol_epi64(reg2, 32);                                                      \
-                        sum = _mm512_add_epi8(sum, reg1);                                                       \
-                        sum = _mm512_add_epi8(sum, reg2);                                                       \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                                   \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                                   \
                     }                                                                                           \
                 }                                                                                               \
                 for(uint32_t i=0; i<1; i++){                                                                    \
@@ -990,24 +1358,10 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                         reg4 = _mm512_shuffle_epi8(reg4, mask);                                                 \
                         reg4 = _mm512_permutexvar_epi32(perm, reg4);                                            \
                                                                                                                 \
-                        if(size==2){                                                                            \
-                            sum = _mm512_add_epi16(sum, reg1);                                                  \
-                            sum = _mm512_add_epi16(sum, reg2);                                                  \
-                            sum = _mm512_add_epi16(sum, reg3);                                                  \
-                            sum = _mm512_add_epi16(sum, reg4);                                                  \
-                        }                                                                                       \
-                        else if(size==4){                                                                       \
-                            sum = _mm512_add_epi32(sum, reg1);                                                  \
-                            sum = _mm512_add_epi32(sum, reg2);                                                  \
-                            sum = _mm512_add_epi32(sum, reg3);                                                  \
-                            sum = _mm512_add_epi32(sum, reg4);                                                  \
-                        }                                                                                       \
-                        else if(size==8){                                                                       \
-                            sum = _mm512_add_epi64(sum, reg1);                                                  \
-                            sum = _mm512_add_epi64(sum, reg2);                                                  \
-                            sum = _mm512_add_epi64(sum, reg3);                                                  \
-                            sum = _mm512_add_epi64(sum, reg4);                                                  \
-                        }                                                                                       \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                                   \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                                   \
+                        reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                                   \
+                        reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                                   \
                     }                                                                                           \
                     else if(a_length==4){                                                                       \
                         reg1 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr1));                       \
@@ -1022,20 +1376,11 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                         reg2 = _mm512_shuffle_epi8(reg2, mask);                                                 \
                         reg2 = _mm512_permutexvar_epi32(perm, reg2);                                            \
                                                                                                                 \
-                        if(size==2){                                                                            \
-                            sum = _mm512_add_epi16(sum, reg1);                                                  \
-                            sum = _mm512_add_epi16(sum, reg2);                                                  \
-                        }                                                                                       \
-                        else if(size==4){                                                                       \
-                            sum = _mm512_add_epi32(sum, reg1);                                                  \
-                            sum = _mm512_add_epi32(sum, reg2);                                                  \
-                        }                                                                                       \
-                        else if(size==8){                                                                       \
-                            sum = _mm512_add_epi64(sum, reg1);                                                  \
-                            sum = _mm512_add_epi64(sum, reg2);                                                  \
-                        }                                                                                       \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                                   \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                                   \
                     }                                                                                           \
                 }                                                                                               \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                                   \
                                                                                                                 \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                                    \
                 sum = _mm512_shuffle_epi8(sum, mask);                                                           \
@@ -1049,23 +1394,16 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         }                                                                                                       \
     } while (0)
 
-#define REDUCE_SCATTER_CPU_Y_22(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, a_length) \
+#define REDUCE_SCATTER_CPU_Y_22(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type, a_length) \
     do                                                                                                          \
     {                                                                                                           \
         __m512i reg1;                                                                                           \
         __m512i reg2;                                                                                           \
                                                                                                                 \
-        __m512i sum = _mm512_set_epi64(                                                                         \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL,                                                  \
-                                        0x0000000000000000ULL);                                                 \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                                 \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                                              \
                                                                                                                 \
-        if(size == 1){                                                                                          \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                                      \
             for (int cl = 0; cl < iter; cl++)                                                                   \
             {                                                                                                   \
                 for(uint32_t i=0; i<num_iter_src; i++){                                                         \
@@ -1076,8 +1414,8 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg1 = _mm512_rol_epi32(reg1, 0);                                                           \
                     reg2 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr2));                           \
                     reg2 = _mm512_rol_epi32(reg2, 16);                                                          \
-                    sum = _mm512_add_epi8(sum, reg1);                                                           \
-                    sum = _mm512_add_epi8(sum, reg2);                                                           \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                                       \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                                       \
                 }                                                                                               \
                 for(uint32_t i=0; i<1; i++){                                                                    \
                     void *dst_rank_clwise_addr9 = dst_rank_bgwise_addr[(8/a_length)*i];                         \
@@ -1117,19 +1455,10 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg2 = _mm512_shuffle_epi8(reg2, mask);                                                     \
                     reg2 = _mm512_permutexvar_epi32(perm, reg2);                                                \
                                                                                                                 \
-                    if(size==2){                                                                                \
-                        sum = _mm512_add_epi16(sum, reg1);                                                      \
-                        sum = _mm512_add_epi16(sum, reg2);                                                      \
-                    }                                                                                           \
-                    else if(size==4){                                                                           \
-                        sum = _mm512_add_epi32(sum, reg1);                                                      \
-                        sum = _mm512_add_epi32(sum, reg2);                                                      \
-                    }                                                                                           \
-                    else if(size==8){                                                                           \
-                        sum = _mm512_add_epi64(sum, reg1);                                                      \
-                        sum = _mm512_add_epi64(sum, reg2);                                                      \
-                    }                                                                                           \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                                       \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                                       \
                 }                                                                                               \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                                   \
                                                                                                                 \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                                    \
                 sum = _mm512_shuffle_epi8(sum, mask);                                                           \
@@ -1143,7 +1472,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         }                                                                                                       \
     } while (0)
 
-#define RNS_SUM_RS(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size)        \
+#define RNS_SUM_RS(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type) \
     do                                                                                          \
     {                                                                                           \
         __m512i reg1;                                                                           \
@@ -1157,17 +1486,10 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                                                                                                 \
         void *dst_rank_clwise_addr9 = dst_rank_bgwise_addr;                                     \
                                                                                                 \
-        __m512i sum = _mm512_set_epi64(                                                         \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL,                                  \
-                                        0x0000000000000000ULL);                                 \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                 \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                              \
                                                                                                 \
-        if(size == 1){                                                                          \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                      \
             for (int cl = 0; cl < iter; cl++)                                                   \
             {                                                                                   \
                 for(uint32_t i=0; i<num_iter_src; i++){                                         \
@@ -1204,14 +1526,14 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg8 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr8));           \
                     reg8 = _mm512_rol_epi64(reg8, 56);                                          \
                                                                                                 \
-                    sum = _mm512_add_epi8(sum, reg1);                                           \
-                    sum = _mm512_add_epi8(sum, reg2);                                           \
-                    sum = _mm512_add_epi8(sum, reg3);                                           \
-                    sum = _mm512_add_epi8(sum, reg4);                                           \
-                    sum = _mm512_add_epi8(sum, reg5);                                           \
-                    sum = _mm512_add_epi8(sum, reg6);                                           \
-                    sum = _mm512_add_epi8(sum, reg7);                                           \
-                    sum = _mm512_add_epi8(sum, reg8);                                           \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg5, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg6, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg7, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg8, size, reduce_type);                       \
                                                                                                 \
                 }                                                                               \
                 _mm512_stream_si512((void *)(dst_rank_clwise_addr9), sum);                      \
@@ -1291,47 +1613,16 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg8 = _mm512_shuffle_epi8(reg8, mask);                                     \
                     reg8 = _mm512_permutexvar_epi32(perm, reg8);                                \
                                                                                                 \
-                    if(size == 1){                                                              \
-                        sum = _mm512_add_epi8(sum, reg1);                                       \
-                        sum = _mm512_add_epi8(sum, reg2);                                       \
-                        sum = _mm512_add_epi8(sum, reg3);                                       \
-                        sum = _mm512_add_epi8(sum, reg4);                                       \
-                        sum = _mm512_add_epi8(sum, reg5);                                       \
-                        sum = _mm512_add_epi8(sum, reg6);                                       \
-                        sum = _mm512_add_epi8(sum, reg7);                                       \
-                        sum = _mm512_add_epi8(sum, reg8);                                       \
-                    }                                                                           \
-                    else if(size == 2){                                                         \
-                        sum = _mm512_add_epi16(sum, reg1);                                      \
-                        sum = _mm512_add_epi16(sum, reg2);                                      \
-                        sum = _mm512_add_epi16(sum, reg3);                                      \
-                        sum = _mm512_add_epi16(sum, reg4);                                      \
-                        sum = _mm512_add_epi16(sum, reg5);                                      \
-                        sum = _mm512_add_epi16(sum, reg6);                                      \
-                        sum = _mm512_add_epi16(sum, reg7);                                      \
-                        sum = _mm512_add_epi16(sum, reg8);                                      \
-                    }                                                                           \
-                    else if(size == 4){                                                         \
-                        sum = _mm512_add_epi32(sum, reg1);                                      \
-                        sum = _mm512_add_epi32(sum, reg2);                                      \
-                        sum = _mm512_add_epi32(sum, reg3);                                      \
-                        sum = _mm512_add_epi32(sum, reg4);                                      \
-                        sum = _mm512_add_epi32(sum, reg5);                                      \
-                        sum = _mm512_add_epi32(sum, reg6);                                      \
-                        sum = _mm512_add_epi32(sum, reg7);                                      \
-                        sum = _mm512_add_epi32(sum, reg8);                                      \
-                    }                                                                           \
-                    else{                                                                       \
-                        sum = _mm512_add_epi64(sum, reg1);                                      \
-                        sum = _mm512_add_epi64(sum, reg2);                                      \
-                        sum = _mm512_add_epi64(sum, reg3);                                      \
-                        sum = _mm512_add_epi64(sum, reg4);                                      \
-                        sum = _mm512_add_epi64(sum, reg5);                                      \
-                        sum = _mm512_add_epi64(sum, reg6);                                      \
-                        sum = _mm512_add_epi64(sum, reg7);                                      \
-                        sum = _mm512_add_epi64(sum, reg8);                                      \
-                    }                                                                           \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg5, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg6, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg7, size, reduce_type);                       \
+                    reduce_lanes(&sum, &sum_hi, reg8, size, reduce_type);                       \
                 }                                                                               \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                   \
                                                                                                 \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                    \
                 sum = _mm512_shuffle_epi8(sum, mask);                                           \
@@ -1342,7 +1633,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         }                                                                                       \
     } while (0)
 
-#define REDUCE_SCATTER_CPU_X_24(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, a_length)     \
+#define REDUCE_SCATTER_CPU_X_24(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type, a_length) \
     do                                                                                                              \
     {                                                                                                               \
         __m512i reg1;                                                                                               \
@@ -1350,15 +1641,8 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         __m512i reg3;                                                                                               \
         __m512i reg4;                                                                                               \
                                                                                                                     \
-        __m512i sum = _mm512_set_epi64(                                                                             \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL);                                                     \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                                     \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                                                  \
         __m512i mask_ar = _mm512_set_epi64(                                                                         \
                                         0x0e0f0c0d0a0b0809ULL,                                                      \
                                         0x0607040502030001ULL,                                                      \
@@ -1368,7 +1652,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                                         0x0607040502030001ULL,                                                      \
                                         0x0e0f0c0d0a0b0809ULL,                                                      \
                                         0x0607040502030001ULL);                                                     \
-        if(size == 1){                                                                                              \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                                          \
             for (int cl = 0; cl < iter; cl++)                                                                       \
             {                                                                                                       \
                 for(uint32_t i=0; i<num_iter_src; i++){                                                             \
@@ -1387,18 +1671,18 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                         reg3 = _mm512_rol_epi32(reg3, 16);                                                          \
                         reg4 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr4));                           \
                         reg4 = _mm512_rol_epi32(reg4, 24);                                                          \
-                        sum = _mm512_add_epi8(sum, reg1);                                                           \
-                        sum = _mm512_add_epi8(sum, reg2);                                                           \
-                        sum = _mm512_add_epi8(sum, reg3);                                                           \
-                        sum = _mm512_add_epi8(sum, reg4);                                                           \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                                       \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                                       \
+                        reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                                       \
+                        reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                                       \
                     }                                                                                               \
                     else if(a_length==2){                                                                           \
                         reg1 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr1));                           \
                         reg1 = _mm512_rol_epi64(reg1, 0);                                                           \
                         reg2 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr2));                           \
                         reg2 = _mm512_shuffle_epi8(reg2, mask_ar);                                                  \
-                        sum = _mm512_add_epi8(sum, reg1);                                                           \
-                        sum = _mm512_add_epi8(sum, reg2);                                                           \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                                       \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                                       \
                     }                                                                                               \
                                                                                                                     \
                 }                                                                                                   \
@@ -1467,31 +1751,14 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                         reg2 = _mm512_permutexvar_epi32(perm, reg2);                                                \
                     }                                                                                               \
                                                                                                                     \
-                    if(size == 2){                                                                                  \
-                        sum = _mm512_add_epi16(sum, reg1);                                                          \
-                        sum = _mm512_add_epi16(sum, reg2);                                                          \
-                        if(a_length==4){                                                                            \
-                            sum = _mm512_add_epi16(sum, reg3);                                                      \
-                            sum = _mm512_add_epi16(sum, reg4);                                                      \
-                        }                                                                                           \
-                    }                                                                                               \
-                    else if(size == 4){                                                                             \
-                        sum = _mm512_add_epi32(sum, reg1);                                                          \
-                        sum = _mm512_add_epi32(sum, reg2);                                                          \
-                        if(a_length==4){                                                                            \
-                            sum = _mm512_add_epi32(sum, reg3);                                                      \
-                            sum = _mm512_add_epi32(sum, reg4);                                                      \
-                        }                                                                                           \
-                    }                                                                                               \
-                    else{                                                                                           \
-                        sum = _mm512_add_epi64(sum, reg1);                                                          \
-                        sum = _mm512_add_epi64(sum, reg2);                                                          \
-                        if(a_length==4){                                                                            \
-                            sum = _mm512_add_epi64(sum, reg3);                                                      \
-                            sum = _mm512_add_epi64(sum, reg4);                                                      \
-                        }                                                                                           \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                                           \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                                           \
+                    if(a_length==4){                                                                                \
+                        reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                                       \
+                        reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                                       \
                     }                                                                                               \
                 }                                                                                                   \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                                       \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                                        \
                 sum = _mm512_shuffle_epi8(sum, mask);                                                               \
                 sum = _mm512_permutexvar_epi32(perm, sum);                                                          \
@@ -1503,7 +1770,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         }                                                                                                           \
     } while (0)
 
-#define REDUCE_SCATTER_CPU_X_22(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, a_length)     \
+#define REDUCE_SCATTER_CPU_X_22(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type, a_length) \
     do                                                                                                              \
     {                                                                                                               \
         __m512i reg1;                                                                                               \
@@ -1511,15 +1778,8 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         __m512i reg3;                                                                                               \
         __m512i reg4;                                                                                               \
                                                                                                                     \
-        __m512i sum = _mm512_set_epi64(                                                                             \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL,                                                      \
-                                        0x0000000000000000ULL);                                                     \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                                     \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                                                  \
         __m512i mask_ar = _mm512_set_epi64(                                                                         \
                                         0x0e0f0c0d0a0b0809ULL,                                                      \
                                         0x0607040502030001ULL,                                                      \
@@ -1529,7 +1789,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                                         0x0607040502030001ULL,                                                      \
                                         0x0e0f0c0d0a0b0809ULL,                                                      \
                                         0x0607040502030001ULL);                                                     \
-        if(size == 1){                                                                                              \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                                          \
             for (int cl = 0; cl < iter; cl++)                                                                       \
             {                                                                                                       \
                 for(uint32_t i=0; i<num_iter_src; i++){                                                             \
@@ -1546,10 +1806,10 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg4 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr4));                               \
                     reg4 = _mm512_rol_epi64(reg4, 32);                                                              \
                     reg4 = _mm512_shuffle_epi8(reg4, mask_ar);                                                      \
-                    sum = _mm512_add_epi8(sum, reg1);                                                               \
-                    sum = _mm512_add_epi8(sum, reg2);                                                               \
-                    sum = _mm512_add_epi8(sum, reg3);                                                               \
-                    sum = _mm512_add_epi8(sum, reg4);                                                               \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                                           \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                                           \
+                    reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                                           \
+                    reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                                           \
                 }                                                                                                   \
                 void *dst_rank_clwise_addr9 = dst_rank_bgwise_addr;                                                 \
                 _mm512_stream_si512((void *)(dst_rank_clwise_addr9), sum);                                          \
@@ -1601,25 +1861,12 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg4 = _mm512_shuffle_epi8(reg4, mask);                                                         \
                     reg4 = _mm512_permutexvar_epi32(perm, reg4);                                                    \
                                                                                                                     \
-                    if(size == 2){                                                                                  \
-                        sum = _mm512_add_epi16(sum, reg1);                                                          \
-                        sum = _mm512_add_epi16(sum, reg2);                                                          \
-                        sum = _mm512_add_epi16(sum, reg3);                                                          \
-                        sum = _mm512_add_epi16(sum, reg4);                                                          \
-                    }                                                                                               \
-                    else if(size == 4){                                                                             \
-                        sum = _mm512_add_epi32(sum, reg1);                                                          \
-                        sum = _mm512_add_epi32(sum, reg2);                                                          \
-                        sum = _mm512_add_epi32(sum, reg3);                                                          \
-                        sum = _mm512_add_epi32(sum, reg4);                                                          \
-                    }                                                                                               \
-                    else{                                                                                           \
-                        sum = _mm512_add_epi64(sum, reg1);                                                          \
-                        sum = _mm512_add_epi64(sum, reg2);                                                          \
-                        sum = _mm512_add_epi64(sum, reg3);                                                          \
-                        sum = _mm512_add_epi64(sum, reg4);                                                          \
-                    }                                                                                               \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                                           \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                                           \
+                    reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                                           \
+                    reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                                           \
                 }                                                                                                   \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                                       \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                                        \
                 sum = _mm512_shuffle_epi8(sum, mask);                                                               \
                 sum = _mm512_permutexvar_epi32(perm, sum);                                                          \
@@ -1635,24 +1882,16 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
     do                                                                                                  \
     {                                                                                                   \
         __m512i reg1;                                                                                   \
-        __m512i sum = _mm512_set_epi64(                                                                 \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL);                                         \
-                                                                                                        \
-        if(size == 1){                                                                                  \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                         \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                                      \
+                                                                                                        \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                              \
             for (int cl = 0; cl < iter; cl++)                                                           \
             {                                                                                           \
                 for(uint32_t i=0; i<num_iter_src; i++){                                                 \
                     void *src_rank_clwise_addr1 = src_rank_bgwise_addr[i];                              \
                     reg1 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr1));                   \
-                    if(reduce_type == 0) sum = _mm512_add_epi8(sum, reg1);                              \
-                    else if (reduce_type == 1) sum = _mm512_max_epi8(sum, reg1);                        \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                               \
                 }                                                                                       \
                 for(uint32_t i=0; i<num_iter_src; i++){                                                 \
                                                                                                         \
@@ -1687,17 +1926,9 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg1 = _mm512_shuffle_epi8(reg1, mask);                                             \
                     reg1 = _mm512_permutexvar_epi32(perm, reg1);                                        \
                                                                                                         \
-                    if(reduce_type == 0){                                                               \
-                        if(size == 2) sum = _mm512_add_epi16(sum, reg1);                                \
-                        else if(size == 4) sum = _mm512_add_epi32(sum, reg1);                           \
-                        else sum = _mm512_add_epi64(sum, reg1);                                         \
-                    }                                                                                   \
-                    else if(reduce_type == 1){                                                          \
-                        if(size == 2) sum = _mm512_max_epi16(sum, reg1);                                \
-                        else if(size == 4) sum = _mm512_max_epi32(sum, reg1);                           \
-                        else sum = _mm512_max_epi64(sum, reg1);                                         \
-                    }                                                                                   \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                               \
                 }                                                                                       \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                           \
                                                                                                         \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                            \
                 sum = _mm512_shuffle_epi8(sum, mask);                                                   \
@@ -1714,7 +1945,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         }                                                                                               \
     } while (0)
 
-#define S_SUM_AR_24(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, a_length)     \
+#define S_SUM_AR_24(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type, a_length) \
     do                                                                                                  \
     {                                                                                                   \
                                                                                                         \
@@ -1724,17 +1955,10 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         __m512i reg3;                                                                                   \
         __m512i reg4;                                                                                   \
                                                                                                         \
-        __m512i sum = _mm512_set_epi64(                                                                 \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL);                                         \
-                                                                                                        \
-        if(size == 1){                                                                                  \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                         \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                                      \
+                                                                                                        \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                              \
             for (int cl = 0; cl < iter; cl++)                                                           \
             {                                                                                           \
                                                                                                         \
@@ -1752,18 +1976,18 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                         reg3 = _mm512_rol_epi64(reg3, 32);                                              \
                         reg4 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr4));               \
                         reg4 = _mm512_rol_epi64(reg4, 48);                                              \
-                        sum = _mm512_add_epi8(sum, reg1);                                               \
-                        sum = _mm512_add_epi8(sum, reg2);                                               \
-                        sum = _mm512_add_epi8(sum, reg3);                                               \
-                        sum = _mm512_add_epi8(sum, reg4);                                               \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                           \
                     }                                                                                   \
                     else if(a_length==4){                                                               \
                         reg1 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr1));               \
                         reg1 = _mm512_rol_epi64(reg1, 0);                                               \
                         reg2 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr2));               \
                         reg2 = _mm512_rol_epi64(reg2, 32);                                              \
-                        sum = _mm512_add_epi8(sum, reg1);                                               \
-                        sum = _mm512_add_epi8(sum, reg2);                                               \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                           \
                     }                                                                                   \
                 }                                                                                       \
                 if(a_length==2){sum = _mm512_rol_epi64(sum, 48);}                                       \
@@ -1838,24 +2062,10 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                         reg4 = _mm512_shuffle_epi8(reg4, mask);                                         \
                         reg4 = _mm512_permutexvar_epi32(perm, reg4);                                    \
                                                                                                         \
-                        if(size==2){                                                                    \
-                            sum = _mm512_add_epi16(sum, reg1);                                          \
-                            sum = _mm512_add_epi16(sum, reg2);                                          \
-                            sum = _mm512_add_epi16(sum, reg3);                                          \
-                            sum = _mm512_add_epi16(sum, reg4);                                          \
-                        }                                                                               \
-                        if(size==4){                                                                    \
-                            sum = _mm512_add_epi32(sum, reg1);                                          \
-                            sum = _mm512_add_epi32(sum, reg2);                                          \
-                            sum = _mm512_add_epi32(sum, reg3);                                          \
-                            sum = _mm512_add_epi32(sum, reg4);                                          \
-                        }                                                                               \
-                        else if(size==8){                                                               \
-                            sum = _mm512_add_epi64(sum, reg1);                                          \
-                            sum = _mm512_add_epi64(sum, reg2);                                          \
-                            sum = _mm512_add_epi64(sum, reg3);                                          \
-                            sum = _mm512_add_epi64(sum, reg4);                                          \
-                        }                                                                               \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                           \
                     }                                                                                   \
                     else if(a_length==4){                                                               \
                         reg1 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr1));               \
@@ -1870,20 +2080,11 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                         reg2 = _mm512_shuffle_epi8(reg2, mask);                                         \
                         reg2 = _mm512_permutexvar_epi32(perm, reg2);                                    \
                                                                                                         \
-                        if(size==2){                                                                    \
-                            sum = _mm512_add_epi16(sum, reg1);                                          \
-                            sum = _mm512_add_epi16(sum, reg2);                                          \
-                        }                                                                               \
-                        else if(size==4){                                                               \
-                            sum = _mm512_add_epi32(sum, reg1);                                          \
-                            sum = _mm512_add_epi32(sum, reg2);                                          \
-                        }                                                                               \
-                        else if(size==8){                                                               \
-                            sum = _mm512_add_epi64(sum, reg1);                                          \
-                            sum = _mm512_add_epi64(sum, reg2);                                          \
-                        }                                                                               \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                           \
                     }                                                                                   \
                 }                                                                                       \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                           \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                            \
                 sum = _mm512_shuffle_epi8(sum, mask);                                                   \
                 sum = _mm512_permutexvar_epi32(perm, sum);                                              \
@@ -1917,23 +2118,16 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         }                                                                                               \
     } while (0)
 
-#define S_SUM_AR_22(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, a_length)     \
+#define S_SUM_AR_22(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type, a_length) \
     do                                                                                                  \
     {                                                                                                   \
         __m512i reg1;                                                                                   \
         __m512i reg2;                                                                                   \
                                                                                                         \
-        __m512i sum = _mm512_set_epi64(                                                                 \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL);                                         \
-                                                                                                        \
-        if(size == 1){                                                                                  \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                         \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                                      \
+                                                                                                        \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                              \
             for (int cl = 0; cl < iter; cl++)                                                           \
             {                                                                                           \
                                                                                                         \
@@ -1943,8 +2137,8 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg1 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr1));                   \
                     reg2 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr2));                   \
                     reg2 = _mm512_rol_epi32(reg2, 16);                                                  \
-                    sum = _mm512_add_epi8(sum, reg1);                                                   \
-                    sum = _mm512_add_epi8(sum, reg2);                                                   \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                               \
                 }                                                                                       \
                 for(uint32_t i=0; i<num_iter_src; i++){                                                 \
                     void *dst_rank_clwise_addr9 = dst_rank_bgwise_addr[(8/a_length)*i];                 \
@@ -1986,19 +2180,10 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg2 = _mm512_shuffle_epi8(reg2, mask);                                             \
                     reg2 = _mm512_permutexvar_epi32(perm, reg2);                                        \
                                                                                                         \
-                    if(size==2){                                                                        \
-                        sum = _mm512_add_epi16(sum, reg1);                                              \
-                        sum = _mm512_add_epi16(sum, reg2);                                              \
-                    }                                                                                   \
-                    else if(size==4){                                                                   \
-                        sum = _mm512_add_epi32(sum, reg1);                                              \
-                        sum = _mm512_add_epi32(sum, reg2);                                              \
-                    }                                                                                   \
-                    else if(size==8){                                                                   \
-                        sum = _mm512_add_epi64(sum, reg1);                                              \
-                        sum = _mm512_add_epi64(sum, reg2);                                              \
-                    }                                                                                   \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                               \
                 }                                                                                       \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                           \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                            \
                 sum = _mm512_shuffle_epi8(sum, mask);                                                   \
                 sum = _mm512_permutexvar_epi32(perm, sum);                                              \
@@ -2029,15 +2214,8 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         __m512i reg7;                                                                                   \
         __m512i reg8;                                                                                   \
                                                                                                         \
-        __m512i sum = _mm512_set_epi64(                                                                 \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL);                                         \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                         \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                                      \
         if(size == 0){                                                                                  \
             for (int cl = 0; cl < iter; cl++){                                                          \
                 for(uint32_t i=0; i<num_iter_src; i++){                                                 \
@@ -2126,7 +2304,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                 }                                                                                       \
             }                                                                                           \
         }                                                                                               \
-        else if(size == 1){                                                                             \
+        else if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                         \
             for (int cl = 0; cl < iter; cl++)                                                           \
             {                                                                                           \
                                                                                                         \
@@ -2164,26 +2342,14 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg8 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr8));                   \
                     reg8 = _mm512_rol_epi64(reg8, 56);                                                  \
                                                                                                         \
-                    if(reduce_type == 0){                                                               \
-                        sum = _mm512_add_epi8(sum, reg1);                                               \
-                        sum = _mm512_add_epi8(sum, reg2);                                               \
-                        sum = _mm512_add_epi8(sum, reg3);                                               \
-                        sum = _mm512_add_epi8(sum, reg4);                                               \
-                        sum = _mm512_add_epi8(sum, reg5);                                               \
-                        sum = _mm512_add_epi8(sum, reg6);                                               \
-                        sum = _mm512_add_epi8(sum, reg7);                                               \
-                        sum = _mm512_add_epi8(sum, reg8);                                               \
-                    }                                                                                   \
-                    else if(reduce_type == 1){                                                          \
-                        sum = _mm512_max_epi8(sum, reg1);                                               \
-                        sum = _mm512_max_epi8(sum, reg2);                                               \
-                        sum = _mm512_max_epi8(sum, reg3);                                               \
-                        sum = _mm512_max_epi8(sum, reg4);                                               \
-                        sum = _mm512_max_epi8(sum, reg5);                                               \
-                        sum = _mm512_max_epi8(sum, reg6);                                               \
-                        sum = _mm512_max_epi8(sum, reg7);                                               \
-                        sum = _mm512_max_epi8(sum, reg8);                                               \
-                    }                                                                                   \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg5, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg6, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg7, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg8, size, reduce_type);                               \
                 }                                                                                       \
                                                                                                         \
                 sum = _mm512_rol_epi64(sum, 8);                                                         \
@@ -2301,71 +2467,16 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg8 = _mm512_shuffle_epi8(reg8, mask);                                             \
                     reg8 = _mm512_permutexvar_epi32(perm, reg8);                                        \
                                                                                                         \
-                    if(reduce_type == 0){                                                               \
-                        if(size == 2){                                                                  \
-                            sum = _mm512_add_epi16(sum, reg1);                                          \
-                            sum = _mm512_add_epi16(sum, reg2);                                          \
-                            sum = _mm512_add_epi16(sum, reg3);                                          \
-                            sum = _mm512_add_epi16(sum, reg4);                                          \
-                            sum = _mm512_add_epi16(sum, reg5);                                          \
-                            sum = _mm512_add_epi16(sum, reg6);                                          \
-                            sum = _mm512_add_epi16(sum, reg7);                                          \
-                            sum = _mm512_add_epi16(sum, reg8);                                          \
-                        }                                                                               \
-                        else if(size == 4){                                                             \
-                            sum = _mm512_add_epi32(sum, reg1);                                          \
-                            sum = _mm512_add_epi32(sum, reg2);                                          \
-                            sum = _mm512_add_epi32(sum, reg3);                                          \
-                            sum = _mm512_add_epi32(sum, reg4);                                          \
-                            sum = _mm512_add_epi32(sum, reg5);                                          \
-                            sum = _mm512_add_epi32(sum, reg6);                                          \
-                            sum = _mm512_add_epi32(sum, reg7);                                          \
-                            sum = _mm512_add_epi32(sum, reg8);                                          \
-                        }                                                                               \
-                        else{                                                                           \
-                            sum = _mm512_add_epi64(sum, reg1);                                          \
-                            sum = _mm512_add_epi64(sum, reg2);                                          \
-                            sum = _mm512_add_epi64(sum, reg3);                                          \
-                            sum = _mm512_add_epi64(sum, reg4);                                          \
-                            sum = _mm512_add_epi64(sum, reg5);                                          \
-                            sum = _mm512_add_epi64(sum, reg6);                                          \
-                            sum = _mm512_add_epi64(sum, reg7);                                          \
-                            sum = _mm512_add_epi64(sum, reg8);                                          \
-                        }                                                                               \
-                    }                                                                                   \
-                    else if(reduce_type == 1){                                                          \
-                        if(size == 2){                                                                  \
-                            sum = _mm512_max_epi16(sum, reg1);                                          \
-                            sum = _mm512_max_epi16(sum, reg2);                                          \
-                            sum = _mm512_max_epi16(sum, reg3);                                          \
-                            sum = _mm512_max_epi16(sum, reg4);                                          \
-                            sum = _mm512_max_epi16(sum, reg5);                                          \
-                            sum = _mm512_max_epi16(sum, reg6);                                          \
-                            sum = _mm512_max_epi16(sum, reg7);                                          \
-                            sum = _mm512_max_epi16(sum, reg8);                                          \
-                        }                                                                               \
-                        else if(size == 4){                                                             \
-                            sum = _mm512_max_epi32(sum, reg1);                                          \
-                            sum = _mm512_max_epi32(sum, reg2);                                          \
-                            sum = _mm512_max_epi32(sum, reg3);                                          \
-                            sum = _mm512_max_epi32(sum, reg4);                                          \
-                            sum = _mm512_max_epi32(sum, reg5);                                          \
-                            sum = _mm512_max_epi32(sum, reg6);                                          \
-                            sum = _mm512_max_epi32(sum, reg7);                                          \
-                            sum = _mm512_max_epi32(sum, reg8);                                          \
-                        }                                                                               \
-                        else{                                                                           \
-                            sum = _mm512_max_epi64(sum, reg1);                                          \
-                            sum = _mm512_max_epi64(sum, reg2);                                          \
-                            sum = _mm512_max_epi64(sum, reg3);                                          \
-                            sum = _mm512_max_epi64(sum, reg4);                                          \
-                            sum = _mm512_max_epi64(sum, reg5);                                          \
-                            sum = _mm512_max_epi64(sum, reg6);                                          \
-                            sum = _mm512_max_epi64(sum, reg7);                                          \
-                            sum = _mm512_max_epi64(sum, reg8);                                          \
-                        }                                                                               \
-                    }                                                                                   \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg5, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg6, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg7, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg8, size, reduce_type);                               \
                 }                                                                                       \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                           \
                                                                                                         \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                            \
                 sum = _mm512_shuffle_epi8(sum, mask);                                                   \
@@ -2411,7 +2522,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         }                                                                                               \
     } while (0)
 
-#define RNS_SUM_AR_24(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, a_length)   \
+#define RNS_SUM_AR_24(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type, a_length) \
     do                                                                                                  \
     {                                                                                                   \
         __m512i reg1;                                                                                   \
@@ -2419,15 +2530,8 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         __m512i reg3;                                                                                   \
         __m512i reg4;                                                                                   \
                                                                                                         \
-        __m512i sum = _mm512_set_epi64(                                                                 \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL);                                         \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                         \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                                      \
         __m512i mask_ar = _mm512_set_epi64(                                                             \
                                                         0x0e0f0c0d0a0b0809ULL,                          \
                                                         0x0607040502030001ULL,                          \
@@ -2438,7 +2542,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                                                         0x0e0f0c0d0a0b0809ULL,                          \
                                                         0x0607040502030001ULL);                         \
                                                                                                         \
-        if(size == 1){                                                                                  \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                              \
             for (int cl = 0; cl < iter; cl++)                                                           \
             {                                                                                           \
                 for(uint32_t i=0; i<num_iter_src; i++){                                                 \
@@ -2457,18 +2561,18 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                         reg3 = _mm512_rol_epi32(reg3, 16);                                              \
                         reg4 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr4));               \
                         reg4 = _mm512_rol_epi32(reg4, 24);                                              \
-                        sum = _mm512_add_epi8(sum, reg1);                                               \
-                        sum = _mm512_add_epi8(sum, reg2);                                               \
-                        sum = _mm512_add_epi8(sum, reg3);                                               \
-                        sum = _mm512_add_epi8(sum, reg4);                                               \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                           \
                     }                                                                                   \
                     else if(a_length==2){                                                               \
                         reg1 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr1));               \
                         reg1 = _mm512_rol_epi64(reg1, 0);                                               \
                         reg2 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr2));               \
                         reg2 = _mm512_shuffle_epi8(reg2, mask_ar);                                      \
-                        sum = _mm512_add_epi8(sum, reg1);                                               \
-                        sum = _mm512_add_epi8(sum, reg2);                                               \
+                        reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                           \
                     }                                                                                   \
                 }                                                                                       \
                                                                                                         \
@@ -2561,31 +2665,14 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                         reg2 = _mm512_permutexvar_epi32(perm, reg2);                                    \
                     }                                                                                   \
                                                                                                         \
-                    if(size == 2){                                                                      \
-                        sum = _mm512_add_epi16(sum, reg1);                                              \
-                        sum = _mm512_add_epi16(sum, reg2);                                              \
-                        if(a_length==4){                                                                \
-                            sum = _mm512_add_epi16(sum, reg3);                                          \
-                            sum = _mm512_add_epi16(sum, reg4);                                          \
-                        }                                                                               \
-                    }                                                                                   \
-                    else if(size == 4){                                                                 \
-                        sum = _mm512_add_epi32(sum, reg1);                                              \
-                        sum = _mm512_add_epi32(sum, reg2);                                              \
-                        if(a_length==4){                                                                \
-                            sum = _mm512_add_epi32(sum, reg3);                                          \
-                            sum = _mm512_add_epi32(sum, reg4);                                          \
-                        }                                                                               \
-                    }                                                                                   \
-                    else{                                                                               \
-                        sum = _mm512_add_epi64(sum, reg1);                                              \
-                        sum = _mm512_add_epi64(sum, reg2);                                              \
-                        if(a_length==4){                                                                \
-                            sum = _mm512_add_epi64(sum, reg3);                                          \
-                            sum = _mm512_add_epi64(sum, reg4);                                          \
-                        }                                                                               \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                               \
+                    if(a_length==4){                                                                    \
+                        reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                           \
+                        reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                           \
                     }                                                                                   \
                 }                                                                                       \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                           \
                                                                                                         \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                            \
                 sum = _mm512_shuffle_epi8(sum, mask);                                                   \
@@ -2621,7 +2708,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         }                                                                                               \
     } while (0)
 
-#define RNS_SUM_AR_22(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, a_length)   \
+#define RNS_SUM_AR_22(iter, src_rank_bgwise_addr, dst_rank_bgwise_addr, num_iter_src, size, reduce_type, a_length) \
     do                                                                                                  \
     {                                                                                                   \
         __m512i reg1;                                                                                   \
@@ -2629,15 +2716,8 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
         __m512i reg3;                                                                                   \
         __m512i reg4;                                                                                   \
                                                                                                         \
-        __m512i sum = _mm512_set_epi64(                                                                 \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL,                                          \
-                                        0x0000000000000000ULL);                                         \
+        __m512i sum = reduce_lanes_identity(size, reduce_type);                                         \
+        __m512i sum_hi = reduce_lanes_identity(size, reduce_type);                                      \
         __m512i mask_ar = _mm512_set_epi64(                                                             \
                                                         0x0e0f0c0d0a0b0809ULL,                          \
                                                         0x0607040502030001ULL,                          \
@@ -2648,7 +2728,7 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                                                         0x0e0f0c0d0a0b0809ULL,                          \
                                                         0x0607040502030001ULL);                         \
                                                                                                         \
-        if(size == 1){                                                                                  \
+        if(PIDCOMM_DTYPE_SIZE(size) == 1){                                                              \
             for (int cl = 0; cl < iter; cl++)                                                           \
             {                                                                                           \
                 for(uint32_t i=0; i<num_iter_src; i++){                                                 \
@@ -2666,10 +2746,10 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg4 = _mm512_stream_load_si512((void *)(src_rank_clwise_addr4));                   \
                     reg4 = _mm512_rol_epi64(reg4, 32);                                                  \
                     reg4 = _mm512_shuffle_epi8(reg4, mask_ar);                                          \
-                    sum = _mm512_add_epi8(sum, reg1);                                                   \
-                    sum = _mm512_add_epi8(sum, reg2);                                                   \
-                    sum = _mm512_add_epi8(sum, reg3);                                                   \
-                    sum = _mm512_add_epi8(sum, reg4);                                                   \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                               \
                 }                                                                                       \
                                                                                                         \
                 sum = _mm512_rol_epi64(sum, 32);                                                        \
@@ -2740,25 +2820,12 @@ static uint32_t apply_address_translation_on_mram_offset_a2a(uint32_t byte_offse
                     reg4 = _mm512_shuffle_epi8(reg4, mask);                                             \
                     reg4 = _mm512_permutexvar_epi32(perm, reg4);                                        \
                                                                                                         \
-                    if(size == 2){                                                                      \
-                        sum = _mm512_add_epi16(sum, reg1);                                              \
-                        sum = _mm512_add_epi16(sum, reg2);                                              \
-                        sum = _mm512_add_epi16(sum, reg3);                                              \
-                        sum = _mm512_add_epi16(sum, reg4);                                              \
-                    }                                                                                   \
-                    else if(size == 4){                                                                 \
-                        sum = _mm512_add_epi32(sum, reg1);                                              \
-                        sum = _mm512_add_epi32(sum, reg2);                                              \
-                        sum = _mm512_add_epi32(sum, reg3);                                              \
-                        sum = _mm512_add_epi32(sum, reg4);                                              \
-                    }                                                                                   \
-                    else{                                                                               \
-                        sum = _mm512_add_epi64(sum, reg1);                                              \
-                        sum = _mm512_add_epi64(sum, reg2);                                              \
-                        sum = _mm512_add_epi64(sum, reg3);                                              \
-                        sum = _mm512_add_epi64(sum, reg4);                                              \
-                    }                                                                                   \
+                    reduce_lanes(&sum, &sum_hi, reg1, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg2, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg3, size, reduce_type);                               \
+                    reduce_lanes(&sum, &sum_hi, reg4, size, reduce_type);                               \
                 }                                                                                       \
+                sum = reduce_lanes_finish(sum, sum_hi, size);                                           \
                                                                                                         \
                 sum = _mm512_permutexvar_epi32(vindex, sum);                                            \
                 sum = _mm512_shuffle_epi8(sum, mask);                                                   \
@@ -2795,8 +2862,8 @@ void xeon_sp_trans_all_reduce_rg(void **base_region_addr_src, void *base_region_
     int packet_size = 8;
     int iteration = packet_size / 8;
     alltoall_comm_type+=0;
-    int64_t mram_src_offset_1mb_wise=0;
-    int64_t mram_dst_offset_1mb_wise=0;
+    int64_t mram_src_offset_1mb_wise_k[8];
+    int64_t mram_dst_offset_1mb_wise_k[8];
     uint32_t src_mram_offset=0;
     uint32_t dst_mram_offset=0;
     src_mram_offset = size*reduce_type;
@@ -2814,10 +2881,9 @@ void xeon_sp_trans_all_reduce_rg(void **base_region_addr_src, void *base_region_
     uint32_t dst_rotate_group_offset_256_64= (dst_rg_id%4) * (256*1024) + (dst_rg_id/4) * 64;
     uint32_t src_rotate_group_offset_256_64;
 
-    void *src_rank_addr_iter[num_iter_src * 8];
-    uint32_t mram_64_bit_word_offset;
-    uint64_t next_data;
+    void *src_rank_addr_iter[COMM_FLUSH_BLOCK][num_iter_src * 8];
     void *src_rank_addr;
+    uint32_t nr_pending_flush = 0;
 
     void *dst_rank_addr;
     void *dst_rank_addr_iter[num_iter_src * 8];
@@ -2831,46 +2897,47 @@ void xeon_sp_trans_all_reduce_rg(void **base_region_addr_src, void *base_region_
     //for(uint32_t i=0; i<iter_length; i++){
     for(uint32_t i=(iter_length/num_thread)*thread_id; i<(iter_length/num_thread)*(thread_id+1); i++){
 
+        //the translation does not depend on the source rank
+        for(uint32_t k=0; k<8; k++){
+            mram_dst_offset_1mb_wise_k[k] = mram_offset_to_region_offset_a2a(dst_mram_offset + byte_length*k);
+        }
+
         for(uint32_t j=0; j<num_iter_src; j++){
             dst_rank_base_addr = base_region_addr_src[j];
             dst_rotate_group_offset_256_64= (src_rg_id[j]%4) * (256*1024) + (src_rg_id[j]/4) * 64;
 
             for(uint32_t k=0; k<8; k++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset + byte_length*k);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
+                dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise_k[k];
                 dst_rank_addr_iter[j*8 + k] = dst_rank_addr + dst_rotate_group_offset_256_64;
             }
         }
 
+        //the translation does not depend on the source rank
+        for(uint32_t k=0; k<8; k++){
+            mram_src_offset_1mb_wise_k[k] = mram_offset_to_region_offset_a2a(src_mram_offset + byte_length*k);
+        }
+
         for(uint32_t j=0; j<num_iter_src; j++){
             src_rank_base_addr = base_region_addr_src[j];
             src_rotate_group_offset_256_64= (src_rg_id[j]%4) * (256*1024) + (src_rg_id[j]/4) * 64;
 
             for(uint32_t k=0; k<8; k++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset + byte_length*k);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
-                src_rank_addr_iter[j*8 + k] = src_rank_addr + src_rotate_group_offset_256_64;
+                src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise_k[k];
+                src_rank_addr_iter[nr_pending_flush][j*8 + k] = src_rank_addr + src_rotate_group_offset_256_64;
             }
         }
             
-        RNS_SUM_AR(iteration, src_rank_addr_iter, dst_rank_addr_iter, num_iter_src, size, reduce_type);
-
-        _mm_mfence();
+        RNS_SUM_AR(iteration, src_rank_addr_iter[nr_pending_flush], dst_rank_addr_iter, num_iter_src, size, reduce_type);
 
-        for(uint32_t j=0; j<num_iter_src*8; j++){
-            RNS_FLUSH_DST(iteration, src_rank_addr_iter[j]);
-        }
-        for(uint32_t j=0; j<num_iter_src*8; j++){
-            RNS_FLUSH_DST(iteration, dst_rank_addr_iter[j]);
+        if(++nr_pending_flush == COMM_FLUSH_BLOCK){
+            RNS_FLUSH_BLOCK(RNS_FLUSH_DST, iteration, src_rank_addr_iter, nr_pending_flush, num_iter_src*8);
+            nr_pending_flush = 0;
         }
 
         src_mram_offset+=8;
         dst_mram_offset+=8;
     }
+    RNS_FLUSH_BLOCK(RNS_FLUSH_DST, iteration, src_rank_addr_iter, nr_pending_flush, num_iter_src*8);
     _mm_mfence();
     return;
 }
@@ -2902,10 +2969,9 @@ void xeon_sp_trans_all_reduce_y_rg(void **base_region_addr_src, void *base_regio
     uint32_t dst_rotate_group_offset_256_64= (dst_rg_id%4) * (256*1024) + (dst_rg_id/4) * 64;
     uint32_t src_rotate_group_offset_256_64;
 
-    void *src_rank_addr_iter[num_iter_src];
-    uint32_t mram_64_bit_word_offset;
-    uint64_t next_data;
+    void *src_rank_addr_iter[COMM_FLUSH_BLOCK][num_iter_src];
     void *src_rank_addr;
+    uint32_t nr_pending_flush = 0;
 
     void *dst_rank_addr;
     void *dst_rank_addr_iter[num_iter_src];
@@ -2914,52 +2980,46 @@ void xeon_sp_trans_all_reduce_y_rg(void **base_region_addr_src, void *base_regio
 
     for(uint32_t i=0; i<iter_length; i++){
 
+        mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
+
         for(uint32_t j=0; j<num_iter_src; j++){
             dst_rank_base_addr = base_region_addr_src[j];
             dst_rotate_group_offset_256_64= (src_rg_id[j]%4) * (256*1024) + (src_rg_id[j]/4) * 64;
 
             for(uint32_t k=0; k<1; k++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset + byte_length*k);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
                 dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
                 dst_rank_addr_iter[j + k] = dst_rank_addr + dst_rotate_group_offset_256_64;
             }
         }
 
+        mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+
         for(uint32_t j=0; j<num_iter_src; j++){
             src_rank_base_addr = base_region_addr_src[j];
             src_rotate_group_offset_256_64= (src_rg_id[j]%4) * (256*1024) + (src_rg_id[j]/4) * 64;
 
             for(uint32_t k=0; k<1; k++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset + byte_length*k);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
                 src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
-                src_rank_addr_iter[j + k] = src_rank_addr + src_rotate_group_offset_256_64;
+                src_rank_addr_iter[nr_pending_flush][j + k] = src_rank_addr + src_rotate_group_offset_256_64;
             }
         }
 
-        S_SUM_AR(iteration, src_rank_addr_iter, dst_rank_addr_iter, num_iter_src, size, reduce_type);
-
-        _mm_mfence();
+        S_SUM_AR(iteration, src_rank_addr_iter[nr_pending_flush], dst_rank_addr_iter, num_iter_src, size, reduce_type);
 
-        for(uint32_t j=0; j<num_iter_src; j++){
-            RNS_FLUSH_DST(iteration, src_rank_addr_iter[j]);
-        }
-        for(uint32_t j=0; j<num_iter_src; j++){
-            RNS_FLUSH_SRC(iteration, dst_rank_addr_iter[j]);
+        if(++nr_pending_flush == COMM_FLUSH_BLOCK){
+            RNS_FLUSH_BLOCK(RNS_FLUSH_DST, iteration, src_rank_addr_iter, nr_pending_flush, num_iter_src);
+            nr_pending_flush = 0;
         }
 
-
         src_mram_offset+=8;
         dst_mram_offset+=8;
     }
+    RNS_FLUSH_BLOCK(RNS_FLUSH_DST, iteration, src_rank_addr_iter, nr_pending_flush, num_iter_src);
     _mm_mfence();
     return;
 }
 
-void xeon_sp_trans_all_reduce_rg_24(void *base_region_addr_dst, void **base_region_addr_src, uint32_t dst_rg_id, uint32_t* src_rg_id, uint32_t iter_dst_a, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t a_length, uint32_t size){
+void xeon_sp_trans_all_reduce_rg_24(void *base_region_addr_dst, void **base_region_addr_src, uint32_t dst_rg_id, uint32_t* src_rg_id, uint32_t iter_dst_a, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t a_length, uint32_t size, uint32_t reduce_type){
 
     void *dst_rank_base_addr = base_region_addr_dst;
     void *src_rank_base_addr_arr[num_iter_dst];
@@ -2991,14 +3051,10 @@ void xeon_sp_trans_all_reduce_rg_24(void *base_region_addr_dst, void **base_regi
                 void *dst_rank_addr_array[num_iter_dst * a_length];
                 dst_rank_addr_array[0] = dst_rank_base_addr + dst_rotate_group_offset_256_64;
                 void *src_rank_addr_array[num_iter_dst * a_length];
-                uint32_t mram_64_bit_word_offset;
-                uint64_t next_data;
 
                 for(uint32_t j=0; j<num_iter_dst; j++){
                     for(uint32_t k=0; k<a_length; k++){
-                        mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset+byte_length*k);
-                        next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                        mram_src_offset_1mb_wise[k] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                        mram_src_offset_1mb_wise[k] = mram_offset_to_region_offset_a2a(src_mram_offset+byte_length*k);
                         void *src_rank_addr = src_rank_base_addr_arr[j] + mram_src_offset_1mb_wise[k];
                         src_rank_addr_array[j*a_length + k]=(src_rank_addr+src_rotate_group_offset_256_64[j]);
                     }
@@ -3006,15 +3062,13 @@ void xeon_sp_trans_all_reduce_rg_24(void *base_region_addr_dst, void **base_regi
 
                 for(uint32_t j=0; j<num_iter_dst; j++){
                     for(uint32_t k=0; k<a_length; k++){
-                        mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset+byte_length*k);
-                        next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                        mram_dst_offset_1mb_wise[k] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                        mram_dst_offset_1mb_wise[k] = mram_offset_to_region_offset_a2a(dst_mram_offset+byte_length*k);
                         void *dst_rank_addr = src_rank_base_addr_arr[j] + mram_dst_offset_1mb_wise[k];
                         dst_rank_addr_array[j*a_length + k]=(dst_rank_addr+src_rotate_group_offset_256_64[j]);
                     }
                 }
                 
-                RNS_SUM_AR_24(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, a_length);
+                RNS_SUM_AR_24(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, reduce_type, a_length);
                 src_mram_offset+=8;
                 dst_mram_offset+=8;
             }
@@ -3026,13 +3080,9 @@ void xeon_sp_trans_all_reduce_rg_24(void *base_region_addr_dst, void **base_regi
             void *dst_rank_addr_array[(8/a_length)*num_iter_dst];
             void *src_rank_addr_array[(8/a_length)*num_iter_dst];
             uint32_t rg_offset = 0;
-            uint32_t mram_64_bit_word_offset;
-            uint64_t next_data;
 
             for(rg_offset=0; rg_offset<(8/a_length); rg_offset++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset+(rg_offset)*byte_length);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise[rg_offset] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise[rg_offset] = mram_offset_to_region_offset_a2a(src_mram_offset+(rg_offset)*byte_length);
             }
             for(rg_offset=0; rg_offset<(8/a_length) * num_iter_dst; rg_offset++){    
                 void *src_rank_addr = src_rank_base_addr_arr[rg_offset/(8/a_length)] + mram_src_offset_1mb_wise[rg_offset%(8/a_length)];
@@ -3040,16 +3090,14 @@ void xeon_sp_trans_all_reduce_rg_24(void *base_region_addr_dst, void **base_regi
             }
 
             for(rg_offset=0; rg_offset<(8/a_length); rg_offset++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise[rg_offset] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_dst_offset_1mb_wise[rg_offset] = mram_offset_to_region_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
             }
             for(rg_offset=0; rg_offset<(8/a_length) * num_iter_dst; rg_offset++){    
                 void *dst_rank_addr = src_rank_base_addr_arr[rg_offset/(8/a_length)] + mram_dst_offset_1mb_wise[rg_offset%(8/a_length)];
                 dst_rank_addr_array[rg_offset]=(dst_rank_addr + src_rotate_group_offset_256_64[rg_offset/(8/a_length)]);
             }
 
-            S_SUM_AR_24(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, a_length);
+            S_SUM_AR_24(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, reduce_type, a_length);
 
             src_mram_offset+=8;
             dst_mram_offset+=8;
@@ -3059,7 +3107,7 @@ void xeon_sp_trans_all_reduce_rg_24(void *base_region_addr_dst, void **base_regi
     return;
 }
 
-void xeon_sp_trans_all_reduce_rg_22(void *base_region_addr_dst, void **base_region_addr_src, uint32_t dst_rg_id, uint32_t* src_rg_id, uint32_t iter_dst_a, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_axis_x, uint32_t comm_axis_y, uint32_t comm_axis_z, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t size){
+void xeon_sp_trans_all_reduce_rg_22(void *base_region_addr_dst, void **base_region_addr_src, uint32_t dst_rg_id, uint32_t* src_rg_id, uint32_t iter_dst_a, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_axis_x, uint32_t comm_axis_y, uint32_t comm_axis_z, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t size, uint32_t reduce_type){
 
     void *dst_rank_base_addr = base_region_addr_dst;
     void *src_rank_base_addr_arr[num_iter_dst];
@@ -3091,14 +3139,10 @@ void xeon_sp_trans_all_reduce_rg_22(void *base_region_addr_dst, void **base_regi
                 void *dst_rank_addr_array[num_iter_dst * 4];
                 dst_rank_addr_array[0] = dst_rank_base_addr + dst_rotate_group_offset_256_64;
                 void *src_rank_addr_array[num_iter_dst * 4];
-                uint32_t mram_64_bit_word_offset;
-                uint64_t next_data;
 
                 for(uint32_t j=0; j<num_iter_dst; j++){
                     for(uint32_t k=0; k<4; k++){
-                        mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset+byte_length*k);
-                        next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                        mram_src_offset_1mb_wise[k] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                        mram_src_offset_1mb_wise[k] = mram_offset_to_region_offset_a2a(src_mram_offset+byte_length*k);
                         void *src_rank_addr = src_rank_base_addr_arr[j] + mram_src_offset_1mb_wise[k];
                         src_rank_addr_array[j*4 + k]=(src_rank_addr+src_rotate_group_offset_256_64[j]);
                     }
@@ -3106,15 +3150,13 @@ void xeon_sp_trans_all_reduce_rg_22(void *base_region_addr_dst, void **base_regi
 
                 for(uint32_t j=0; j<num_iter_dst; j++){
                     for(uint32_t k=0; k<4; k++){
-                        mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset+byte_length*k);
-                        next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                        mram_dst_offset_1mb_wise[k] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                        mram_dst_offset_1mb_wise[k] = mram_offset_to_region_offset_a2a(dst_mram_offset+byte_length*k);
                         void *dst_rank_addr = src_rank_base_addr_arr[j] + mram_dst_offset_1mb_wise[k];
                         dst_rank_addr_array[j*4 + k]=(dst_rank_addr+src_rotate_group_offset_256_64[j]);
                     }
                 }
                 
-                RNS_SUM_AR_22(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, 4);
+                RNS_SUM_AR_22(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, reduce_type, 4);
                 src_mram_offset+=8;
                 dst_mram_offset+=8;
             }
@@ -3126,13 +3168,9 @@ void xeon_sp_trans_all_reduce_rg_22(void *base_region_addr_dst, void **base_regi
             void *dst_rank_addr_array[2*num_iter_dst];
             void *src_rank_addr_array[2*num_iter_dst];
             uint32_t rg_offset = 0;
-            uint32_t mram_64_bit_word_offset;
-            uint64_t next_data;
 
             for(rg_offset=0; rg_offset<2; rg_offset++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset+(rg_offset)*byte_length);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise[rg_offset] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise[rg_offset] = mram_offset_to_region_offset_a2a(src_mram_offset+(rg_offset)*byte_length);
             }
             for(rg_offset=0; rg_offset<2 * num_iter_dst; rg_offset++){    
                 void *src_rank_addr = src_rank_base_addr_arr[rg_offset/2] + mram_src_offset_1mb_wise[rg_offset%2];
@@ -3140,16 +3178,14 @@ void xeon_sp_trans_all_reduce_rg_22(void *base_region_addr_dst, void **base_regi
             }
 
             for(rg_offset=0; rg_offset<2; rg_offset++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise[rg_offset] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_dst_offset_1mb_wise[rg_offset] = mram_offset_to_region_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
             }
             for(rg_offset=0; rg_offset<2 * num_iter_dst; rg_offset++){    
                 void *dst_rank_addr = src_rank_base_addr_arr[rg_offset/2] + mram_dst_offset_1mb_wise[rg_offset%2];
                 dst_rank_addr_array[rg_offset]=(dst_rank_addr + src_rotate_group_offset_256_64[rg_offset/2]);
             }
 
-            S_SUM_AR_22(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, 4);
+            S_SUM_AR_22(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, reduce_type, 4);
 
             src_mram_offset+=8;
             dst_mram_offset+=8;
@@ -3160,7 +3196,7 @@ void xeon_sp_trans_all_reduce_rg_22(void *base_region_addr_dst, void **base_regi
 }
 
 void xeon_sp_trans_reduce_scatter_cpu_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length,\
-                                             uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t num_thread, uint32_t thread_id){
+                                             uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type, uint32_t num_thread, uint32_t thread_id){
 
     void *src_rank_base_addr;
     void *dst_rank_base_addr = base_region_addr_dst;
@@ -3168,7 +3204,7 @@ void xeon_sp_trans_reduce_scatter_cpu_rg(void **base_region_addr_src, void *base
     int iteration = packet_size / 8;
 
     alltoall_comm_type+=0;
-    int64_t mram_src_offset_1mb_wise=0;
+    int64_t mram_src_offset_1mb_wise_k[8];
     int64_t mram_dst_offset_1mb_wise=0;
 
     uint32_t src_mram_offset=size*0;
@@ -3187,10 +3223,9 @@ void xeon_sp_trans_reduce_scatter_cpu_rg(void **base_region_addr_src, void *base
     uint32_t dst_rotate_group_offset_256_64= (dst_rg_id%4) * (256*1024) + (dst_rg_id/4) * 64;
     uint32_t src_rotate_group_offset_256_64;
 
-    void *src_rank_addr_iter[num_iter_src * 8];
-    uint32_t mram_64_bit_word_offset;
-    uint64_t next_data;
+    void *src_rank_addr_iter[COMM_FLUSH_BLOCK][num_iter_src * 8];
     void *src_rank_addr;
+    uint32_t nr_pending_flush = 0;
 
     //threaded
     src_mram_offset = src_start_offset + 1024*1024 + communication_buffer_offset + 8*(iter_length/num_thread)*thread_id;
@@ -3199,44 +3234,41 @@ void xeon_sp_trans_reduce_scatter_cpu_rg(void **base_region_addr_src, void *base
     //for(uint32_t i=0; i<iter_length; i++){
     for(uint32_t i=(iter_length/num_thread)*thread_id; i<(iter_length/num_thread)*(thread_id+1); i++){
             
-        mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-        next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-        mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+        mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
         void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
         void *dst_rank_addr_iter = dst_rank_addr + dst_rotate_group_offset_256_64;
 
+        //the translation does not depend on the source rank
+        for(uint32_t k=0; k<8; k++){
+            mram_src_offset_1mb_wise_k[k] = mram_offset_to_region_offset_a2a(src_mram_offset + byte_length*k);
+        }
+
         for(uint32_t j=0; j<num_iter_src; j++){
             src_rank_base_addr = base_region_addr_src[j];
             src_rotate_group_offset_256_64= (src_rg_id[j]%4) * (256*1024) + (src_rg_id[j]/4) * 64;
 
             for(uint32_t k=0; k<8; k++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset + byte_length*k);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
-                src_rank_addr_iter[j*8 + k] = src_rank_addr + src_rotate_group_offset_256_64;
+                src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise_k[k];
+                src_rank_addr_iter[nr_pending_flush][j*8 + k] = src_rank_addr + src_rotate_group_offset_256_64;
             }
         }
 
-        RNS_SUM_RS(iteration, src_rank_addr_iter, dst_rank_addr_iter, num_iter_src, size);
+        RNS_SUM_RS(iteration, src_rank_addr_iter[nr_pending_flush], dst_rank_addr_iter, num_iter_src, size, reduce_type);
 
-        _mm_mfence();
-
-        for(uint32_t j=0; j<num_iter_src*8; j++){
-            RNS_FLUSH_SRC(iteration, src_rank_addr_iter[j]);
+        if(++nr_pending_flush == COMM_FLUSH_BLOCK){
+            RNS_FLUSH_BLOCK(RNS_FLUSH_SRC, iteration, src_rank_addr_iter, nr_pending_flush, num_iter_src*8);
+            nr_pending_flush = 0;
         }
 
-        RNS_FLUSH_DST(iteration, dst_rank_addr_iter);
-
-
         src_mram_offset+=8;
         dst_mram_offset+=8;
     }
+    RNS_FLUSH_BLOCK(RNS_FLUSH_SRC, iteration, src_rank_addr_iter, nr_pending_flush, num_iter_src*8);
     _mm_mfence();
     return;
 }
 
-void xeon_sp_trans_reduce_scatter_cpu_y_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size){
+void xeon_sp_trans_reduce_scatter_cpu_y_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type){
 
     void *src_rank_base_addr;
     void *dst_rank_base_addr = base_region_addr_dst;
@@ -3262,56 +3294,51 @@ void xeon_sp_trans_reduce_scatter_cpu_y_rg(void **base_region_addr_src, void *ba
     uint32_t dst_rotate_group_offset_256_64= (dst_rg_id%4) * (256*1024) + (dst_rg_id/4) * 64;
     uint32_t src_rotate_group_offset_256_64;
 
-    void *src_rank_addr_iter[num_iter_src * 8];
-    uint32_t mram_64_bit_word_offset;
-    uint64_t next_data;
+    void *src_rank_addr_iter[COMM_FLUSH_BLOCK][num_iter_src];
     void *src_rank_addr;
+    void *dst_rank_addr_iter[COMM_FLUSH_BLOCK];
 
-    for(uint32_t i=0; i<iter_length; i++){
-            
-        mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-        next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-        mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-        void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
-        void *dst_rank_addr_iter = dst_rank_addr + dst_rotate_group_offset_256_64;
+    for(uint32_t i_block=0; i_block<iter_length; i_block+=COMM_FLUSH_BLOCK){
+        uint32_t block_length = (iter_length - i_block < COMM_FLUSH_BLOCK) ? (iter_length - i_block) : COMM_FLUSH_BLOCK;
 
-        for(uint32_t j=0; j<num_iter_src; j++){
-            src_rank_base_addr = base_region_addr_src[j];
-            src_rotate_group_offset_256_64= (src_rg_id[j]%4) * (256*1024) + (src_rg_id[j]/4) * 64;
+        for(uint32_t i=0; i<block_length; i++){
+            mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
+            void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
+            dst_rank_addr_iter[i] = dst_rank_addr + dst_rotate_group_offset_256_64;
+
+            mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+
+            for(uint32_t j=0; j<num_iter_src; j++){
+                src_rank_base_addr = base_region_addr_src[j];
+                src_rotate_group_offset_256_64= (src_rg_id[j]%4) * (256*1024) + (src_rg_id[j]/4) * 64;
 
-            for(uint32_t k=0; k<1; k++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset + byte_length*k);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
                 src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
-                src_rank_addr_iter[j + k] = src_rank_addr + src_rotate_group_offset_256_64;
+                src_rank_addr_iter[i][j] = src_rank_addr + src_rotate_group_offset_256_64;
             }
-        }
 
-        for(uint32_t j=0; j<num_iter_src; j++){
-            RNS_FLUSH_SRC(iteration, src_rank_addr_iter[j]);
+            src_mram_offset+=8;
+            dst_mram_offset+=8;
         }
-        
-        RNS_FLUSH_DST(iteration, dst_rank_addr_iter);
-        _mm_mfence();
-
-        S_SUM_RS(iteration, src_rank_addr_iter, dst_rank_addr_iter, num_iter_src, size);
 
+        //invalidate stale copies of the whole block before reading it
+        for(uint32_t i=0; i<block_length; i++){
+            for(uint32_t j=0; j<num_iter_src; j++){
+                RNS_FLUSH_SRC(iteration, src_rank_addr_iter[i][j]);
+            }
+        }
         _mm_mfence();
 
-        for(uint32_t j=0; j<num_iter_src; j++){
-            RNS_FLUSH_SRC(iteration, src_rank_addr_iter[j]);
-        }        
-        RNS_FLUSH_DST(iteration, dst_rank_addr_iter);
+        for(uint32_t i=0; i<block_length; i++){
+            S_SUM_RS(iteration, src_rank_addr_iter[i], dst_rank_addr_iter[i], num_iter_src, size, reduce_type);
+        }
 
-        src_mram_offset+=8;
-        dst_mram_offset+=8;
+        RNS_FLUSH_BLOCK(RNS_FLUSH_SRC, iteration, src_rank_addr_iter, block_length, num_iter_src);
     }
     _mm_mfence();
     return;
 }
 
-void xeon_sp_trans_reduce_scatter_cpu_rg_24(void *base_region_addr_dst, void **base_region_addr_src, uint32_t dst_rg_id, uint32_t* src_rg_id, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t allgather_comm_type, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t a_length, uint32_t size){
+void xeon_sp_trans_reduce_scatter_cpu_rg_24(void *base_region_addr_dst, void **base_region_addr_src, uint32_t dst_rg_id, uint32_t* src_rg_id, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t allgather_comm_type, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t a_length, uint32_t size, uint32_t reduce_type){
 
     void *dst_rank_base_addr = base_region_addr_dst;
     void *src_rank_base_addr_arr[num_iter_dst]; 
@@ -3341,20 +3368,14 @@ void xeon_sp_trans_reduce_scatter_cpu_rg_24(void *base_region_addr_dst, void **b
         for(uint32_t i=0; i<remain_length; i++){
             void *src_rank_addr_array[num_iter_dst*a_length];
             void *dst_rank_addr_array;
-            uint32_t mram_64_bit_word_offset;
-            uint64_t next_data;
 
-            mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-            next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_dst_offset_1mb_wise[0] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+            mram_dst_offset_1mb_wise[0] = mram_offset_to_region_offset_a2a(dst_mram_offset);
             void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise[0];
             dst_rank_addr_array=(dst_rank_addr + dst_rotate_group_offset_256_64);
 
             for(uint32_t j=0; j<num_iter_dst; j++){
                 for(uint32_t k=0; k<a_length; k++){
-                    mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset+byte_length*k);
-                    next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                    mram_src_offset_1mb_wise[k] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                    mram_src_offset_1mb_wise[k] = mram_offset_to_region_offset_a2a(src_mram_offset+byte_length*k);
                     void *src_rank_addr = src_rank_base_addr_arr[j] + mram_src_offset_1mb_wise[k];
                     src_rank_addr_array[j*a_length + k]=(src_rank_addr+src_rotate_group_offset_256_64[j]);
                 }
@@ -3366,7 +3387,7 @@ void xeon_sp_trans_reduce_scatter_cpu_rg_24(void *base_region_addr_dst, void **b
             _mm_mfence();
 
             //RnS
-            REDUCE_SCATTER_CPU_X_24(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, a_length);
+            REDUCE_SCATTER_CPU_X_24(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, reduce_type, a_length);
             _mm_mfence();
 
             for(uint32_t j=0; j<num_iter_dst*a_length; j++){
@@ -3387,22 +3408,16 @@ void xeon_sp_trans_reduce_scatter_cpu_rg_24(void *base_region_addr_dst, void **b
             //void *dst_rank_addr_array[num_iter_dst];
             void *dst_rank_addr_array[1];
             uint32_t rg_offset=0;
-            uint32_t mram_64_bit_word_offset;
-            uint64_t next_data;
 
             for(rg_offset=0; rg_offset<(8/a_length); rg_offset++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset+(rg_offset)*byte_length);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise[rg_offset] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise[rg_offset] = mram_offset_to_region_offset_a2a(src_mram_offset+(rg_offset)*byte_length);
             }
             for(rg_offset=0; rg_offset<(8/a_length) * num_iter_dst; rg_offset++){    
                 void *src_rank_addr = src_rank_base_addr_arr[rg_offset/(8/a_length)] + mram_src_offset_1mb_wise[rg_offset%(8/a_length)];
                 src_rank_addr_array[rg_offset]=(src_rank_addr + src_rotate_group_offset_256_64[rg_offset/(8/a_length)]);
             }
 
-            mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-            next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_dst_offset_1mb_wise[0] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+            mram_dst_offset_1mb_wise[0] = mram_offset_to_region_offset_a2a(dst_mram_offset);
             void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise[0];
             dst_rank_addr_array[0]=(dst_rank_addr + dst_rotate_group_offset_256_64);
 
@@ -3414,7 +3429,7 @@ void xeon_sp_trans_reduce_scatter_cpu_rg_24(void *base_region_addr_dst, void **b
             _mm_mfence();
 
             //RnS
-            REDUCE_SCATTER_CPU_Y_24(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, a_length);
+            REDUCE_SCATTER_CPU_Y_24(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, reduce_type, a_length);
             
             _mm_mfence();
 
@@ -3432,7 +3447,7 @@ void xeon_sp_trans_reduce_scatter_cpu_rg_24(void *base_region_addr_dst, void **b
     return;
 }
 
-void xeon_sp_trans_reduce_scatter_cpu_rg_22(void *base_region_addr_dst, void **base_region_addr_src, uint32_t dst_rg_id, uint32_t* src_rg_id, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_axis_x, uint32_t comm_axis_y, uint32_t comm_axis_z, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t size){
+void xeon_sp_trans_reduce_scatter_cpu_rg_22(void *base_region_addr_dst, void **base_region_addr_src, uint32_t dst_rg_id, uint32_t* src_rg_id, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_axis_x, uint32_t comm_axis_y, uint32_t comm_axis_z, uint32_t communication_buffer_offset, uint32_t num_iter_dst, uint32_t size, uint32_t reduce_type){
 
     void *dst_rank_base_addr = base_region_addr_dst;
     void *src_rank_base_addr_arr[num_iter_dst]; 
@@ -3463,20 +3478,14 @@ void xeon_sp_trans_reduce_scatter_cpu_rg_22(void *base_region_addr_dst, void **b
         for(uint32_t i=0; i<remain_length; i++){
             void *src_rank_addr_array[num_iter_dst*4];
             void *dst_rank_addr_array;
-            uint32_t mram_64_bit_word_offset;
-            uint64_t next_data;
 
-            mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-            next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_dst_offset_1mb_wise[0] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+            mram_dst_offset_1mb_wise[0] = mram_offset_to_region_offset_a2a(dst_mram_offset);
             void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise[0];
             dst_rank_addr_array=(dst_rank_addr + dst_rotate_group_offset_256_64);
 
             for(uint32_t j=0; j<num_iter_dst; j++){
                 for(uint32_t k=0; k<4; k++){
-                    mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset+byte_length*k);
-                    next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                    mram_src_offset_1mb_wise[k] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                    mram_src_offset_1mb_wise[k] = mram_offset_to_region_offset_a2a(src_mram_offset+byte_length*k);
                     void *src_rank_addr = src_rank_base_addr_arr[j] + mram_src_offset_1mb_wise[k];
                     src_rank_addr_array[j*4 + k]=(src_rank_addr+src_rotate_group_offset_256_64[j]);
                 }
@@ -3488,7 +3497,7 @@ void xeon_sp_trans_reduce_scatter_cpu_rg_22(void *base_region_addr_dst, void **b
             _mm_mfence();
 
             //RnS
-            REDUCE_SCATTER_CPU_X_22(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, 4);
+            REDUCE_SCATTER_CPU_X_22(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, reduce_type, 4);
             _mm_mfence();
 
             for(uint32_t j=0; j<4*num_iter_dst; j++){
@@ -3508,22 +3517,16 @@ void xeon_sp_trans_reduce_scatter_cpu_rg_22(void *base_region_addr_dst, void **b
             //void *dst_rank_addr_array[num_iter_dst];
             void *dst_rank_addr_array[1];
             uint32_t rg_offset=0;
-            uint32_t mram_64_bit_word_offset;
-            uint64_t next_data;
 
             for(rg_offset=0; rg_offset<2; rg_offset++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset+(rg_offset)*byte_length);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise[rg_offset] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise[rg_offset] = mram_offset_to_region_offset_a2a(src_mram_offset+(rg_offset)*byte_length);
             }
             for(rg_offset=0; rg_offset<2 * num_iter_dst; rg_offset++){    
                 void *src_rank_addr = src_rank_base_addr_arr[rg_offset/2] + mram_src_offset_1mb_wise[rg_offset%2];
                 src_rank_addr_array[rg_offset]=(src_rank_addr + src_rotate_group_offset_256_64[rg_offset/2]);
             }
 
-            mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-            next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_dst_offset_1mb_wise[0] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+            mram_dst_offset_1mb_wise[0] = mram_offset_to_region_offset_a2a(dst_mram_offset);
             void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise[0];
             dst_rank_addr_array[0]=(dst_rank_addr + dst_rotate_group_offset_256_64);
 
@@ -3536,7 +3539,7 @@ void xeon_sp_trans_reduce_scatter_cpu_rg_22(void *base_region_addr_dst, void **b
             _mm_mfence();
 
             //RnS
-            REDUCE_SCATTER_CPU_Y_22(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, 4);
+            REDUCE_SCATTER_CPU_Y_22(iteration, src_rank_addr_array, dst_rank_addr_array, num_iter_dst, size, reduce_type, 4);
             
             _mm_mfence();
 
@@ -3603,12 +3606,8 @@ void xeon_sp_trans_all_to_all_rg(void *base_region_addr_src, void *base_region_a
         for(uint32_t rns_chip_id=0; rns_chip_id<8; rns_chip_id++){
         //for(uint32_t rns_chip_id=(8/num_thread)*thread_id; rns_chip_id<(8/num_thread)*(thread_id+1); rns_chip_id++){
             for(uint32_t i=0; i<iter_length; i++){
-                uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-                uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+                mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
 
                 void *src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
                 void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
@@ -3700,12 +3699,8 @@ void xeon_sp_trans_all_to_all_rg(void *base_region_addr_src, void *base_region_a
 
             for(uint32_t i=0; i<remain_length; i++){
 
-                uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-                uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+                mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
 
                 void *src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
                 void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
@@ -3761,12 +3756,8 @@ void xeon_sp_trans_all_to_all_rg(void *base_region_addr_src, void *base_region_a
     else{ //perpendicular to the entangled group
 
         for(uint32_t i=0; i<iter_length; i++){
-            uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-            uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-            mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-            next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+            mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+            mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
 
             void *src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
             void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
@@ -3803,12 +3794,8 @@ void xeon_sp_trans_all_to_all_rg(void *base_region_addr_src, void *base_region_a
             dst_mram_offset+=64;
         }
         for(uint32_t i=0; i<remain_length; i++){
-            uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-            uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-            mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-            next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+            mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+            mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
 
             void *src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
             void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
@@ -3846,6 +3833,335 @@ void xeon_sp_trans_all_to_all_rg(void *base_region_addr_src, void *base_region_a
     return;
 }
 
+/* In-place alltoall between rotate groups a and b. Line (a, offset_a + r*L + x) goes to (b, offset_b + r*L + x) rotated
+ * by r lanes, and line (b, offset_b + r*L + x) goes the other way with the same rotation, so both lines are read before
+ * either is written and the pair is swapped without a communication buffer. When a == b the two are the same line.
+ * Perpendicular to the entangled group (alltoall_comm_type 1) the lines are swapped without rotation over L bytes.
+ */
+void xeon_sp_trans_all_to_all_inplace_rg(void *base_region_addr_a, void *base_region_addr_b, uint32_t rg_id_a, uint32_t rg_id_b, uint32_t offset_a, uint32_t offset_b,\
+                                     uint32_t byte_length, uint32_t alltoall_comm_type){
+    void *rank_addr_a = base_region_addr_a + (rg_id_a%4) * (256*1024) + (rg_id_a/4) * 64;
+    void *rank_addr_b = base_region_addr_b + (rg_id_b%4) * (256*1024) + (rg_id_b/4) * 64;
+    uint32_t nr_rotations = alltoall_comm_type == 0 ? 8 : 1;
+    uint32_t iter_length = byte_length/8;
+
+    for(uint32_t rns_chip_id=0; rns_chip_id<nr_rotations; rns_chip_id++){
+        __m512i rotate_bit = _mm512_set1_epi64(8 * rns_chip_id);
+        uint32_t mram_offset_a = offset_a + 1024*1024 + rns_chip_id * byte_length;
+        uint32_t mram_offset_b = offset_b + 1024*1024 + rns_chip_id * byte_length;
+
+        for(uint32_t i=0; i<iter_length; i+=8){
+            uint32_t nr_words = (iter_length - i < 8) ? iter_length - i : 8;
+
+            _mm_mfence();
+            for(uint32_t w=0; w<nr_words; w++){
+                COMM_FLUSH_a2a(1, rank_addr_a + mram_offset_to_region_offset_a2a(mram_offset_a + 8*w));
+                COMM_FLUSH_a2a(1, rank_addr_b + mram_offset_to_region_offset_a2a(mram_offset_b + 8*w));
+            }
+            _mm_mfence();
+
+            for(uint32_t w=0; w<nr_words; w++){
+                void *line_a = rank_addr_a + mram_offset_to_region_offset_a2a(mram_offset_a + 8*w);
+                void *line_b = rank_addr_b + mram_offset_to_region_offset_a2a(mram_offset_b + 8*w);
+                __m512i reg_a = _mm512_stream_load_si512(line_a);
+                __m512i reg_b = _mm512_stream_load_si512(line_b);
+
+                _mm512_stream_si512(line_b, _mm512_rolv_epi64(reg_a, rotate_bit));
+                _mm512_stream_si512(line_a, _mm512_rolv_epi64(reg_b, rotate_bit));
+            }
+            _mm_mfence();
+
+            for(uint32_t w=0; w<nr_words; w++){
+                COMM_FLUSH_a2a(1, rank_addr_a + mram_offset_to_region_offset_a2a(mram_offset_a + 8*w));
+                COMM_FLUSH_a2a(1, rank_addr_b + mram_offset_to_region_offset_a2a(mram_offset_b + 8*w));
+            }
+
+            mram_offset_a += 64;
+            mram_offset_b += 64;
+        }
+    }
+    _mm_mfence();
+    return;
+}
+
+/* Point-to-point exchange into one rotate group. Every 64bit word of the destination line gathers one byte per lane,
+ * so the sources are grouped by rotate group and rotation: source k is rotated by rotate[k] lanes and blended into the
+ * lanes set in lane_mask[k]. Lanes no source covers keep their data, in which case the destination line is read first.
+ * The words are moved in groups of 8 so that one pair of fences covers a whole 64-byte stride of every DPU.
+ */
+void xeon_sp_trans_permute_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t* rotate, uint8_t* lane_mask, uint32_t num_src,\
+                                     uint32_t dst_rg_id, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length){
+    void *src_rank_addr[8];
+    __mmask64 blend_mask[8];
+    __m512i rotate_bit[8];
+    uint8_t covered_lanes = 0;
+
+    for(uint32_t k=0; k<num_src; k++){
+        src_rank_addr[k] = base_region_addr_src[k] + (src_rg_id[k]%4) * (256*1024) + (src_rg_id[k]/4) * 64;
+        blend_mask[k] = (__mmask64)lane_mask[k] * 0x0101010101010101ULL;
+        rotate_bit[k] = _mm512_set1_epi64(8 * rotate[k]);
+        covered_lanes |= lane_mask[k];
+    }
+    void *dst_rank_addr = base_region_addr_dst + (dst_rg_id%4) * (256*1024) + (dst_rg_id/4) * 64;
+    bool keep_dst = covered_lanes != 0xff;
+
+    uint32_t src_mram_offset = src_start_offset + 1024*1024;
+    uint32_t dst_mram_offset = dst_start_offset + 1024*1024;
+    uint32_t iter_length = byte_length/8;
+
+    for(uint32_t i=0; i<iter_length; i+=8){
+        uint32_t nr_words = (iter_length - i < 8) ? iter_length - i : 8;
+
+        _mm_mfence();
+        for(uint32_t w=0; w<nr_words; w++){
+            uint64_t mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset + 8*w);
+            for(uint32_t k=0; k<num_src; k++){
+                COMM_FLUSH_a2a(1, src_rank_addr[k] + mram_src_offset_1mb_wise);
+            }
+            if(keep_dst) COMM_FLUSH_a2a(1, dst_rank_addr + mram_offset_to_region_offset_a2a(dst_mram_offset + 8*w));
+        }
+        _mm_mfence();
+
+        for(uint32_t w=0; w<nr_words; w++){
+            uint64_t mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset + 8*w);
+            void *dst_rank_addr_iter = dst_rank_addr + mram_offset_to_region_offset_a2a(dst_mram_offset + 8*w);
+            __m512i reg1 = keep_dst ? _mm512_stream_load_si512(dst_rank_addr_iter) : _mm512_setzero_si512();
+
+            for(uint32_t k=0; k<num_src; k++){
+                __m512i reg2 = _mm512_stream_load_si512(src_rank_addr[k] + mram_src_offset_1mb_wise);
+                reg1 = _mm512_mask_blend_epi8(blend_mask[k], reg1, _mm512_rolv_epi64(reg2, rotate_bit[k]));
+            }
+            _mm512_stream_si512(dst_rank_addr_iter, reg1);
+        }
+        _mm_mfence();
+
+        for(uint32_t w=0; w<nr_words; w++){
+            uint64_t mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset + 8*w);
+            for(uint32_t k=0; k<num_src; k++){
+                COMM_FLUSH_a2a(1, src_rank_addr[k] + mram_src_offset_1mb_wise);
+            }
+            COMM_FLUSH_a2a(1, dst_rank_addr + mram_offset_to_region_offset_a2a(dst_mram_offset + 8*w));
+        }
+
+        src_mram_offset += 64;
+        dst_mram_offset += 64;
+    }
+    _mm_mfence();
+    return;
+}
+
+/* Transpose of a grid of DPU blocks. With num_rg 8, the 8 rotate groups of b take the 8 groups of a transposed lane by
+ * lane: lane s of group d is lane d of group s, so every source line is rotated by s - d lanes and blended into the
+ * destination lines, as the alltoall pass does for whole lines. With num_rg 1 the line is copied as is. With swap, a
+ * takes the transpose of b in the same pass, so the two tiles of an in-place transpose trade places.
+ * When rows is not 0, every block of rows x cols elements of size bytes is transposed too: each unit of min(size, 8)
+ * bytes of a destination word is gathered from the word that holds it in the source block.
+ */
+void xeon_sp_trans_transpose_rg(void **base_region_addr_a, void **base_region_addr_b, uint32_t* rg_id_a, uint32_t* rg_id_b, uint32_t num_rg,\
+                                     uint32_t swap, uint32_t offset_a, uint32_t offset_b, uint32_t byte_length, uint32_t rows, uint32_t cols, uint32_t size){
+    void *rank_addr_a[8];
+    void *rank_addr_b[8];
+    __m512i rotate_bit[8];
+    __m512i reg_a[8];
+    __m512i reg_b[8];
+    uint8_t gathered[64] __attribute__((aligned(64)));
+    uint8_t line[64] __attribute__((aligned(64)));
+    uint32_t src_unit[64];
+
+    for(uint32_t k=0; k<num_rg; k++){
+        rank_addr_a[k] = base_region_addr_a[k] + (rg_id_a[k]%4) * (256*1024) + (rg_id_a[k]/4) * 64;
+        rank_addr_b[k] = base_region_addr_b[k] + (rg_id_b[k]%4) * (256*1024) + (rg_id_b[k]/4) * 64;
+    }
+    for(uint32_t r=0; r<8; r++){
+        rotate_bit[r] = _mm512_set1_epi64(8 * r);
+    }
+    uint32_t unit = (rows == 0 || size >= 8) ? 8 : size;
+    uint32_t units_per_word = 8 / unit;
+    uint32_t units_per_element = (size >= 8) ? size / 8 : 1;
+    uint32_t mram_offset_a = offset_a + 1024*1024;
+    uint32_t mram_offset_b = offset_b + 1024*1024;
+    uint32_t iter_length = byte_length/8;
+
+    for(uint32_t i=0; i<iter_length; i+=8){
+        uint32_t nr_words = (iter_length - i < 8) ? iter_length - i : 8;
+
+        for(uint32_t u=0; u<nr_words*units_per_word; u++){
+            uint32_t dst_unit = i*units_per_word + u;
+            if(rows == 0){
+                src_unit[u] = dst_unit;
+                continue;
+            }
+            //the destination block is cols x rows
+            uint32_t element = dst_unit / units_per_element;
+            uint32_t col = element / rows;
+            uint32_t row = element % rows;
+            src_unit[u] = (row*cols + col) * units_per_element + dst_unit % units_per_element;
+        }
+
+        _mm_mfence();
+        for(uint32_t u=0; u<nr_words*units_per_word; u++){
+            uint64_t src_offset_1mb_wise = mram_offset_to_region_offset_a2a(mram_offset_a + 8*(src_unit[u]/units_per_word));
+            for(uint32_t k=0; k<num_rg; k++){
+                COMM_FLUSH_a2a(1, rank_addr_a[k] + src_offset_1mb_wise);
+            }
+        }
+        if(swap){
+            for(uint32_t w=0; w<nr_words; w++){
+                uint64_t dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(mram_offset_b + 8*(i+w));
+                for(uint32_t k=0; k<num_rg; k++){
+                    COMM_FLUSH_a2a(1, rank_addr_b[k] + dst_offset_1mb_wise);
+                }
+            }
+        }
+        _mm_mfence();
+
+        for(uint32_t w=0; w<nr_words; w++){
+            uint64_t dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(mram_offset_b + 8*(i+w));
+            uint64_t src_offset_1mb_wise = mram_offset_to_region_offset_a2a(mram_offset_a + 8*(i+w));
+
+            for(uint32_t k=0; k<num_rg; k++){
+                if(units_per_word == 1){
+                    reg_a[k] = _mm512_stream_load_si512(rank_addr_a[k] + mram_offset_to_region_offset_a2a(mram_offset_a + 8*src_unit[w]));
+                    continue;
+                }
+                //unit e of the word of every lane takes bytes [e*unit*8, (e+1)*unit*8) of the line
+                for(uint32_t e=0; e<units_per_word; e++){
+                    uint32_t src = src_unit[w*units_per_word + e];
+                    _mm512_store_si512(line, _mm512_stream_load_si512(rank_addr_a[k] + mram_offset_to_region_offset_a2a(mram_offset_a + 8*(src/units_per_word))));
+                    memcpy(gathered + e*unit*8, line + (src%units_per_word)*unit*8, unit*8);
+                }
+                reg_a[k] = _mm512_load_si512(gathered);
+            }
+            if(swap){
+                for(uint32_t k=0; k<num_rg; k++){
+                    reg_b[k] = _mm512_stream_load_si512(rank_addr_b[k] + dst_offset_1mb_wise);
+                }
+            }
+
+            for(uint32_t d=0; d<num_rg; d++){
+                __m512i reg1 = reg_a[0];
+                __m512i reg2 = swap ? reg_b[0] : _mm512_setzero_si512();
+
+                if(num_rg > 1){
+                    for(uint32_t s=0; s<8; s++){
+                        reg1 = _mm512_mask_blend_epi8(0x0101010101010101ULL << s, reg1, _mm512_rolv_epi64(reg_a[s], rotate_bit[(s + 8 - d) % 8]));
+                        if(swap) reg2 = _mm512_mask_blend_epi8(0x0101010101010101ULL << s, reg2, _mm512_rolv_epi64(reg_b[s], rotate_bit[(s + 8 - d) % 8]));
+                    }
+                }
+                _mm512_stream_si512(rank_addr_b[d] + dst_offset_1mb_wise, reg1);
+                if(swap) _mm512_stream_si512(rank_addr_a[d] + src_offset_1mb_wise, reg2);
+            }
+        }
+        _mm_mfence();
+
+        for(uint32_t u=0; u<nr_words*units_per_word; u++){
+            uint64_t src_offset_1mb_wise = mram_offset_to_region_offset_a2a(mram_offset_a + 8*(src_unit[u]/units_per_word));
+            for(uint32_t k=0; k<num_rg; k++){
+                COMM_FLUSH_a2a(1, rank_addr_a[k] + src_offset_1mb_wise);
+            }
+        }
+        for(uint32_t w=0; w<nr_words; w++){
+            uint64_t dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(mram_offset_b + 8*(i+w));
+            for(uint32_t k=0; k<num_rg; k++){
+                COMM_FLUSH_a2a(1, rank_addr_b[k] + dst_offset_1mb_wise);
+            }
+        }
+    }
+    _mm_mfence();
+    return;
+}
+
+/* Swaps the 8x8 bytes of a line: the line holds byte q of the word of lane l at q*8 + l, and the result holds the
+ * whole word of lane l in the 64bit lane l. The swap is its own inverse.
+ */
+static inline __m512i transpose_lane_words(__m512i reg)
+{
+    __m512i mask = _mm512_set_epi64(0x0f0b07030e0a0602ULL, 0x0d0905010c080400ULL, 0x0f0b07030e0a0602ULL, 0x0d0905010c080400ULL,
+                                    0x0f0b07030e0a0602ULL, 0x0d0905010c080400ULL, 0x0f0b07030e0a0602ULL, 0x0d0905010c080400ULL);
+    __m512i vindex = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    __m512i perm = _mm512_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15);
+
+    reg = _mm512_permutexvar_epi32(vindex, reg);
+    reg = _mm512_shuffle_epi8(reg, mask);
+    return _mm512_permutexvar_epi32(perm, reg);
+}
+
+/* Quantized reduce_scatter into one rotate group. Source k is a slot of the members in rotate group src_rg_id[k] at
+ * src_start_offset[k], rotated by rotate[k] lanes into the lanes set in lane_mask[k]. A slot holds the chunk_words
+ * quantized words of a chunk followed by the shift of each of its blocks of quant_block words, one byte per block, so
+ * every word is decoded with the scale its own DPU chose. The words are summed in 64 bits and written as int32 words
+ * from dst_start_offset.
+ */
+void xeon_sp_trans_reduce_quantized_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t* rotate, uint8_t* lane_mask,\
+                                     uint32_t* src_start_offset, uint32_t num_src, uint32_t dst_rg_id, uint32_t dst_start_offset, uint32_t chunk_words, uint32_t quant_size, uint32_t quant_block){
+    void *src_rank_addr[num_src];
+    __m512i rotate_bit[num_src];
+    __m512i shift_word[num_src];
+    __m512i sum[8];
+    uint32_t words_per_line = 8 / quant_size;
+    __m512i sign_bits = _mm512_set1_epi64(64 - 8 * quant_size);
+    __m512i byte_mask = _mm512_set1_epi64(0xff);
+    __m512i low_mask = _mm512_set1_epi64(0xffffffff);
+    uint32_t quant_length = chunk_words * quant_size;
+    uint32_t group = UINT32_MAX;
+
+    for(uint32_t k=0; k<num_src; k++){
+        src_rank_addr[k] = base_region_addr_src[k] + (src_rg_id[k]%4) * (256*1024) + (src_rg_id[k]/4) * 64;
+        rotate_bit[k] = _mm512_set1_epi64(8 * rotate[k]);
+    }
+    void *dst_rank_addr = base_region_addr_dst + (dst_rg_id%4) * (256*1024) + (dst_rg_id/4) * 64;
+
+    for(uint32_t offset=0; offset<quant_length; offset+=8){
+        uint32_t block = offset / quant_size / quant_block;
+
+        //the shifts of 8 blocks share a line
+        if(block / 8 != group){
+            group = block / 8;
+            _mm_mfence();
+            for(uint32_t k=0; k<num_src; k++){
+                COMM_FLUSH_a2a(1, src_rank_addr[k] + mram_offset_to_region_offset_a2a(src_start_offset[k] + 1024*1024 + quant_length + 8*group));
+            }
+            _mm_mfence();
+            for(uint32_t k=0; k<num_src; k++){
+                __m512i reg = _mm512_stream_load_si512(src_rank_addr[k] + mram_offset_to_region_offset_a2a(src_start_offset[k] + 1024*1024 + quant_length + 8*group));
+                shift_word[k] = transpose_lane_words(_mm512_rolv_epi64(reg, rotate_bit[k]));
+            }
+        }
+        __m512i shift_bit = _mm512_set1_epi64(8 * (block % 8));
+
+        _mm_mfence();
+        for(uint32_t k=0; k<num_src; k++){
+            COMM_FLUSH_a2a(1, src_rank_addr[k] + mram_offset_to_region_offset_a2a(src_start_offset[k] + 1024*1024 + offset));
+        }
+        _mm_mfence();
+
+        for(uint32_t e=0; e<words_per_line; e++){
+            sum[e] = _mm512_setzero_si512();
+        }
+        for(uint32_t k=0; k<num_src; k++){
+            __m512i reg = _mm512_stream_load_si512(src_rank_addr[k] + mram_offset_to_region_offset_a2a(src_start_offset[k] + 1024*1024 + offset));
+            __m512i shift = _mm512_and_si512(_mm512_srlv_epi64(shift_word[k], shift_bit), byte_mask);
+
+            reg = transpose_lane_words(_mm512_rolv_epi64(reg, rotate_bit[k]));
+            for(uint32_t e=0; e<words_per_line; e++){
+                //sign-extend word e of every lane, then scale it back
+                __m512i word = _mm512_sllv_epi64(reg, _mm512_set1_epi64(64 - 8 * quant_size * (e + 1)));
+                word = _mm512_srav_epi64(word, sign_bits);
+                sum[e] = _mm512_mask_add_epi64(sum[e], lane_mask[k], sum[e], _mm512_sllv_epi64(word, shift));
+            }
+        }
+
+        //two int32 words fill the 64bit word of a lane
+        for(uint32_t e=0; e<words_per_line; e+=2){
+            __m512i reg = _mm512_or_si512(_mm512_and_si512(sum[e], low_mask), _mm512_slli_epi64(sum[e+1], 32));
+            uint32_t dst_offset = dst_start_offset + 1024*1024 + (offset / quant_size + e) * sizeof(int32_t);
+            _mm512_stream_si512(dst_rank_addr + mram_offset_to_region_offset_a2a(dst_offset), transpose_lane_words(reg));
+        }
+    }
+    _mm_mfence();
+    return;
+}
+
 void xeon_sp_trans_all_to_all_rg_24(void *base_region_addr_src, void *base_region_addr_dst, uint32_t src_rg_id, uint32_t dst_rg_id, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t a_length){
     void *src_rank_base_addr = base_region_addr_src;
     void *dst_rank_base_addr = base_region_addr_dst;
@@ -3884,12 +4200,8 @@ void xeon_sp_trans_all_to_all_rg_24(void *base_region_addr_src, void *base_regio
     if(alltoall_comm_type==0){
         for(uint32_t rns_chip_id=0; rns_chip_id<a_length; rns_chip_id++){
             for(uint32_t i=0; i<iter_length; i++){
-                uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-                uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+                mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
 
                 void *src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
                 void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
@@ -3949,12 +4261,8 @@ void xeon_sp_trans_all_to_all_rg_24(void *base_region_addr_src, void *base_regio
                 dst_mram_offset+=64;
             }
             for(uint32_t i=0; i<remain_length; i++){
-                uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-                uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+                mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
 
                 void *src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
                 void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
@@ -3995,12 +4303,8 @@ void xeon_sp_trans_all_to_all_rg_24(void *base_region_addr_src, void *base_regio
     else{ //alltoall_comm_type==1
         for(uint32_t rns_chip_id=0; rns_chip_id<(8/a_length); rns_chip_id++){
             for(uint32_t i=0; i<iter_length; i++){
-                uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-                uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+                mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
 
                 void *src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
                 void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
@@ -4072,12 +4376,8 @@ void xeon_sp_trans_all_to_all_rg_24(void *base_region_addr_src, void *base_regio
                 dst_mram_offset+=64;
             }
             for(uint32_t i=0; i<remain_length; i++){
-                uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-                uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+                mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
 
                 void *src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
                 void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
@@ -4156,12 +4456,8 @@ void xeon_sp_trans_all_to_all_rg_22(void *base_region_addr_src, void *base_regio
     if(comm_axis_x && !comm_axis_y && comm_axis_z){
         for(uint32_t rns_chip_id=0; rns_chip_id<4; rns_chip_id++){
             for(uint32_t i=0; i<iter_length; i++){
-                uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-                uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+                mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
 
                 void *src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
                 void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
@@ -4209,12 +4505,8 @@ void xeon_sp_trans_all_to_all_rg_22(void *base_region_addr_src, void *base_regio
     else if(!comm_axis_x && comm_axis_y && !comm_axis_z){
         for(uint32_t rns_chip_id=0; rns_chip_id<2; rns_chip_id++){
             for(uint32_t i=0; i<iter_length; i++){
-                uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-                uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+                mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
 
                 void *src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
                 void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
@@ -4278,25 +4570,19 @@ void xeon_sp_trans_gather_rg(void **base_region_addr_src, void *base_region_addr
     uint32_t iter_length = byte_length/8;
     uint32_t dst_rotate_group_offset_256_64= (dst_rg_id%4) * (256*1024) + (dst_rg_id/4) * 64;
 
-    uint32_t mram_64_bit_word_offset;
-    uint64_t next_data;
 
-    if(alltoall_comm_type==0){
-        for(uint32_t i=0; i<iter_length; i++){
-            
-            mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-            next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-            void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
-            void *dst_rank_addr_iter = dst_rank_addr + dst_rotate_group_offset_256_64;
-            
-            void *dst_host_buffer = (*(host_buffer+host_buffer_first_index)+ (64)*i);
+    for(uint32_t i=0; i<iter_length; i++){
+        
+        mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
+        void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
+        void *dst_rank_addr_iter = dst_rank_addr + dst_rotate_group_offset_256_64;
+        
+        void *dst_host_buffer = (*(host_buffer+host_buffer_first_index)+ (64)*i);
 
-            for(int iter_8=0; iter_8<1; iter_8++){
-                GATHER_COPY(iteration, dst_rank_addr_iter, dst_host_buffer);
-            }
-            dst_mram_offset+=8;
+        for(int iter_8=0; iter_8<1; iter_8++){
+            GATHER_COPY(iteration, dst_rank_addr_iter, dst_host_buffer);
         }
+        dst_mram_offset+=8;
     }
     
     _mm_mfence();
@@ -4325,15 +4611,11 @@ void xeon_sp_trans_scatter_rg(void **base_region_addr_src, void *base_region_add
     
     uint32_t dst_rotate_group_offset_256_64= (dst_rg_id%4) * (256*1024) + (dst_rg_id/4) * 64;
 
-    uint32_t mram_64_bit_word_offset;
-    uint64_t next_data;
 
     //uint32_t flag=1;
     for(uint32_t i=0; i<iter_length; i++){
         
-        mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-        next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-        mram_dst_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+        mram_dst_offset_1mb_wise = mram_offset_to_region_offset_a2a(dst_mram_offset);
         void *dst_rank_addr = dst_rank_base_addr + mram_dst_offset_1mb_wise;
         void *dst_rank_addr_iter = dst_rank_addr + dst_rotate_group_offset_256_64;
         
@@ -4351,7 +4633,7 @@ void xeon_sp_trans_scatter_rg(void **base_region_addr_src, void *base_region_add
     return;
 }
 
-void xeon_sp_trans_reduce_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t total_length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void **host_buffer, uint32_t host_buffer_first_index, uint32_t data_type){
+void xeon_sp_trans_reduce_rg(void **base_region_addr_src, void *base_region_addr_dst, uint32_t* src_rg_id, uint32_t dst_rg_id, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t total_length, uint32_t num_iter_src, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void **host_buffer, uint32_t host_buffer_first_index, uint32_t data_type, uint32_t reduce_type){
     base_region_addr_dst+=0;
     dst_rg_id+=0;
     communication_buffer_offset+=0;
@@ -4360,6 +4642,7 @@ void xeon_sp_trans_reduce_rg(void **base_region_addr_src, void *base_region_addr
     int iteration = packet_size / 8;
     alltoall_comm_type+=0;
     int64_t mram_src_offset_1mb_wise=0;
+    int64_t mram_src_offset_1mb_wise_k[8];
 
     uint32_t src_mram_offset=0;
     uint32_t dst_mram_offset=0;
@@ -4373,30 +4656,30 @@ void xeon_sp_trans_reduce_rg(void **base_region_addr_src, void *base_region_addr
     uint32_t src_rotate_group_offset_256_64;
 
     void *src_rank_addr_iter[num_iter_src * 8];
-    uint32_t mram_64_bit_word_offset;
-    uint64_t next_data;
     void *src_rank_addr;
 
     if(alltoall_comm_type==0){ //parallel to the entangled group
         for(uint32_t i=0; i<iter_length; i++){
             
 
+            //the translation does not depend on the source rank
+            for(uint32_t k=0; k<8; k++){
+                mram_src_offset_1mb_wise_k[k] = mram_offset_to_region_offset_a2a(src_mram_offset + byte_length*k);
+            }
+
             for(uint32_t j=0; j<num_iter_src; j++){
                 src_rank_base_addr = base_region_addr_src[j];
                 src_rotate_group_offset_256_64= (src_rg_id[j]%4) * (256*1024) + (src_rg_id[j]/4) * 64;
 
                 for(uint32_t k=0; k<8; k++){
-                    mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset + byte_length*k);
-                    next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                    mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
-                    src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
+                    src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise_k[k];
                     src_rank_addr_iter[j*8 + k] = src_rank_addr + src_rotate_group_offset_256_64;
                 }
             }
             void *dst_host_buffer = (*(host_buffer+(host_buffer_first_index/num_iter_src))+ (64)*i + 64*(host_buffer_first_index % num_iter_src));
             (dst_host_buffer)+=0;
             for(int iter_8=0; iter_8<1; iter_8++){
-                REDUCE_RNS_SUM_RS(iteration, src_rank_addr_iter, dst_host_buffer, num_iter_src, data_type);
+                REDUCE_RNS_SUM_RS(iteration, src_rank_addr_iter, dst_host_buffer, num_iter_src, data_type, reduce_type);
             }
 
             src_mram_offset+=8;
@@ -4406,14 +4689,13 @@ void xeon_sp_trans_reduce_rg(void **base_region_addr_src, void *base_region_addr
     else{ //perpendicular to the entangled group
         for(uint32_t i=0; i<iter_length; i++){
 
+            mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
+
             for(uint32_t j=0; j<num_iter_src; j++){
                 src_rank_base_addr = base_region_addr_src[j];
                 src_rotate_group_offset_256_64= (src_rg_id[j]%4) * (256*1024) + (src_rg_id[j]/4) * 64;
 
                 for(uint32_t k=0; k<1; k++){
-                    mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-                    next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                    mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
                     src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
                     src_rank_addr_iter[j + k] = src_rank_addr + src_rotate_group_offset_256_64;
                 }
@@ -4421,7 +4703,7 @@ void xeon_sp_trans_reduce_rg(void **base_region_addr_src, void *base_region_addr
 
             void *dst_host_buffer = (*(host_buffer+(host_buffer_first_index/num_iter_src))+ (64)*i) + 64*iter_length*(host_buffer_first_index % num_iter_src);
             for(int iter_8=0; iter_8<1; iter_8++){
-                REDUCE_S_SUM_RS(iteration, src_rank_addr_iter, dst_host_buffer, num_iter_src, data_type);
+                REDUCE_S_SUM_RS(iteration, src_rank_addr_iter, dst_host_buffer, num_iter_src, data_type, reduce_type);
             }
 
             src_mram_offset+=8;
@@ -4474,15 +4756,11 @@ void xeon_sp_trans_all_gather_rg(void *base_region_addr_src, void **base_region_
             void *dst_rank_addr_array[8*num_iter_dst];
             void *src_rank_addr;
             uint32_t rg_offset=0;
-            uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-            uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            int64_t mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+            int64_t mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
             src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
 
             for(rg_offset=0; rg_offset<8; rg_offset++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise[rg_offset] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_dst_offset_1mb_wise[rg_offset] = mram_offset_to_region_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
             }
             for(rg_offset=0; rg_offset<8*num_iter_dst; rg_offset++){    
                 void *dst_rank_addr = dst_rank_base_addr_arr[rg_offset/8] + mram_dst_offset_1mb_wise[rg_offset%8];
@@ -4520,14 +4798,10 @@ void xeon_sp_trans_all_gather_rg(void *base_region_addr_src, void **base_region_
             void *dst_rank_addr_array[num_iter_dst];
             void *src_rank_addr;
             uint32_t rg_offset=0;
-            uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-            uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+            mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
             src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
 
-            mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset);
-            next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_dst_offset_1mb_wise[0] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a; //x-axis아니라서 통신하는 애들은 rg내의 번호가 모두 같음
+            mram_dst_offset_1mb_wise[0] = mram_offset_to_region_offset_a2a(dst_mram_offset); //x-axis아니라서 통신하는 애들은 rg내의 번호가 모두 같음
             for(rg_offset=0; rg_offset<num_iter_dst; rg_offset++){    
                 void *dst_rank_addr = dst_rank_base_addr_arr[rg_offset] + mram_dst_offset_1mb_wise[0];
                 dst_rank_addr_array[rg_offset]=(dst_rank_addr+dst_rotate_group_offset_256_64[rg_offset]);
@@ -4583,15 +4857,11 @@ void xeon_sp_trans_all_gather_rg_24(void *base_region_addr_src, void **base_regi
                 void *dst_rank_addr_array[a_length*num_iter_dst];
                 void *src_rank_addr;
                 uint32_t rg_offset=0;
-                uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-                uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
                 src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
 
                 for(rg_offset=0; rg_offset<a_length; rg_offset++){
-                    mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
-                    next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                    mram_dst_offset_1mb_wise[rg_offset] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                    mram_dst_offset_1mb_wise[rg_offset] = mram_offset_to_region_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
                 }
                 for(rg_offset=0; rg_offset<a_length*num_iter_dst; rg_offset++){    
                     void *dst_rank_addr = dst_rank_base_addr_arr[rg_offset/a_length] + mram_dst_offset_1mb_wise[rg_offset%a_length];
@@ -4613,15 +4883,11 @@ void xeon_sp_trans_all_gather_rg_24(void *base_region_addr_src, void **base_regi
             void *dst_rank_addr_array[(8/a_length) * num_iter_dst];
             void *src_rank_addr;
             uint32_t rg_offset=0;
-            uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-            uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+            mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
             src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
 
             for(rg_offset=0; rg_offset<(8/a_length); rg_offset++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise[rg_offset] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_dst_offset_1mb_wise[rg_offset] = mram_offset_to_region_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
             }
             for(rg_offset=0; rg_offset<(8/a_length) * num_iter_dst; rg_offset++){
                 void *dst_rank_addr = dst_rank_base_addr_arr[rg_offset/(8/a_length)] + mram_dst_offset_1mb_wise[rg_offset%(8/a_length)]; //!
@@ -4681,15 +4947,11 @@ void xeon_sp_trans_all_gather_rg_22(void *base_region_addr_src, void **base_regi
             void *dst_rank_addr_array[4*num_iter_dst];
             void *src_rank_addr;
             uint32_t rg_offset=0;
-            uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-            uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+            mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
             src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
 
             for(rg_offset=0; rg_offset<4; rg_offset++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise[rg_offset] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_dst_offset_1mb_wise[rg_offset] = mram_offset_to_region_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
             }
             for(rg_offset=0; rg_offset<4*num_iter_dst; rg_offset++){    
                 void *dst_rank_addr = dst_rank_base_addr_arr[rg_offset/4] + mram_dst_offset_1mb_wise[rg_offset%4];
@@ -4709,15 +4971,11 @@ void xeon_sp_trans_all_gather_rg_22(void *base_region_addr_src, void **base_regi
             void *dst_rank_addr_array[2 * num_iter_dst];
             void *src_rank_addr;
             uint32_t rg_offset=0;
-            uint32_t mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(src_mram_offset);
-            uint64_t next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-            mram_src_offset_1mb_wise = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+            mram_src_offset_1mb_wise = mram_offset_to_region_offset_a2a(src_mram_offset);
             src_rank_addr = src_rank_base_addr + mram_src_offset_1mb_wise;
 
             for(rg_offset=0; rg_offset<2; rg_offset++){
-                mram_64_bit_word_offset = apply_address_translation_on_mram_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
-                next_data = BANK_OFFSET_NEXT_DATA_a2a(mram_64_bit_word_offset);
-                mram_dst_offset_1mb_wise[rg_offset] = (next_data % BANK_CHUNK_SIZE_a2a) + (next_data / BANK_CHUNK_SIZE_a2a) * BANK_NEXT_CHUNK_OFFSET_a2a;
+                mram_dst_offset_1mb_wise[rg_offset] = mram_offset_to_region_offset_a2a(dst_mram_offset+(rg_offset)*byte_length);
             }
             for(rg_offset=0; rg_offset<2 * num_iter_dst; rg_offset++){
                 void *dst_rank_addr = dst_rank_base_addr_arr[rg_offset/2] + mram_dst_offset_1mb_wise[rg_offset%2]; //!
@@ -1099,6 +1099,10 @@ struct dpu_region_address_translation xeon_sp_translate = {
     .trans_all_to_all_rg = xeon_sp_trans_all_to_all_rg,
     .trans_all_to_all_rg_24 = xeon_sp_trans_all_to_all_rg_24,
     .trans_all_to_all_rg_22 = xeon_sp_trans_all_to_all_rg_22,
+    .trans_all_to_all_inplace_rg = xeon_sp_trans_all_to_all_inplace_rg,
+    .trans_permute_rg = xeon_sp_trans_permute_rg,
+    .trans_transpose_rg = xeon_sp_trans_transpose_rg,
+    .trans_reduce_quantized_rg = xeon_sp_trans_reduce_quantized_rg,
     .trans_all_gather_rg = xeon_sp_trans_all_gather_rg,
     .trans_all_gather_rg_24 = xeon_sp_trans_all_gather_rg_24,
     .trans_all_gather_rg_22 = xeon_sp_trans_all_gather_rg_22,
@@ -41,6 +41,9 @@
 
 #include "static_verbose.h"
 #include <pthread.h>
+#include <errno.h>
+#include <numa.h>
+#include <numaif.h>
 
 const char *
 get_rank_path(dpu_description_t description);
@@ -111,11 +114,11 @@ static dpu_rank_status_e
 hw_all_gather_xz_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset);
 
 static dpu_rank_status_e
-hw_reduce_scatter_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size);
+hw_reduce_scatter_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size, uint32_t reduce_type);
 static dpu_rank_status_e
-hw_reduce_scatter_cpu_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size);
+hw_reduce_scatter_cpu_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type);
 static dpu_rank_status_e
-hw_reduce_scatter_cpu_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size);
+hw_reduce_scatter_cpu_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type);
 
 static dpu_rank_status_e
 hw_all_reduce_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size, uint32_t reduce_type);
@@ -124,8 +127,8 @@ hw_all_reduce_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, u
 static dpu_rank_status_e
 hw_all_reduce_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type);
 
-//static dpu_rank_status_e
-//hw_gather_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, void ** host_buffer);
+static dpu_rank_status_e
+hw_gather_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, void ** host_buffer);
 static dpu_rank_status_e
 hw_gather_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void ** host_buffer);
 static dpu_rank_status_e
@@ -136,7 +139,7 @@ static dpu_rank_status_e
 hw_gather_xz_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t target_dpu_index, void ** host_buffer);
 
 static dpu_rank_status_e
-hw_reduce_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t total_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size, void **host_buffer);
+hw_reduce_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t total_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size, uint32_t reduce_type, void **host_buffer);
 //static dpu_rank_status_e
 //hw_reduce_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t data_type, void **host_buffer);
 //static dpu_rank_status_e
@@ -149,6 +152,17 @@ hw_scatter_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint
 static dpu_rank_status_e
 hw_scatter_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void **host_buffer);
 
+static dpu_rank_status_e
+hw_all_to_all_inplace_rns(struct dpu_set_t *comm_dpu_set, uint32_t start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis);
+static dpu_rank_status_e
+hw_permute_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t* source);
+static dpu_rank_status_e
+hw_transpose_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t byte_length, uint32_t num_tiles, uint32_t num_rg, uint32_t* tile_src_rg, uint32_t* tile_dst_rg, uint32_t swap, uint32_t rows, uint32_t cols, uint32_t size);
+static dpu_rank_status_e
+hw_all_to_all_v_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t num_passes, uint32_t* passes);
+static dpu_rank_status_e
+hw_reduce_quantized_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t chunk_words, uint32_t quant_size, uint32_t quant_block, uint32_t* source_start, uint32_t* sources);
+
 
 static dpu_rank_status_e
 hw_fill_description_from_profile(dpu_properties_t properties, dpu_description_t description);
@@ -184,7 +198,7 @@ __API_SYMBOL__ struct dpu_rank_handler hw_dpu_rank_handler = {
     .all_reduce_rns = hw_all_reduce_rns,
     .all_reduce_x_rns = hw_all_reduce_x_rns,
     .all_reduce_y_rns = hw_all_reduce_y_rns,
-    //.gather_rns = hw_gather_rns,
+    .gather_rns = hw_gather_rns,
     .gather_x_rns = hw_gather_x_rns,
     .gather_y_rns = hw_gather_y_rns,
     .gather_z_rns = hw_gather_z_rns,
@@ -195,6 +209,11 @@ __API_SYMBOL__ struct dpu_rank_handler hw_dpu_rank_handler = {
     .scatter_rns = hw_scatter_rns,
     .scatter_x_rns = hw_scatter_x_rns,
     .scatter_y_rns = hw_scatter_y_rns,
+    .all_to_all_inplace_rns = hw_all_to_all_inplace_rns,
+    .permute_rns = hw_permute_rns,
+    .transpose_rns = hw_transpose_rns,
+    .all_to_all_v_rns = hw_all_to_all_v_rns,
+    .reduce_quantized_rns = hw_reduce_quantized_rns,
     .fill_description_from_profile = hw_fill_description_from_profile,
     .custom_operation = hw_custom_operation,
     .get_nr_dpu_ranks = hw_get_nr_dpu_ranks,
@@ -226,7 +245,12 @@ typedef struct _hw_dpu_rank_allocation_parameters_t {
     uint8_t mode, dpu_chip_id, backend_id;
     uint8_t channel_id;
     uint8_t *ptr_region;
+    int numa_node;
     bool bypass_module_compatibility;
+    /* Thread pool running the collectives */
+    uint32_t comm_pool_nb_threads;
+    uint32_t comm_pool_nb_tasks_per_thread;
+    bool comm_pool_work_stealing;
     /* Backends specific */
     fpga_allocation_parameters_t fpga;
 } * hw_dpu_rank_allocation_parameters_t;
@@ -503,6 +527,361 @@ get_byte_order(struct dpu_rank_t *rank, hw_dpu_rank_allocation_parameters_t para
     return DPU_RANK_SUCCESS;
 }
 
+/* Persistent pool running the rank-level collective (RNS) engines.
+ * Threads are grouped by the NUMA node of the rank regions of the communicator and pinned to it. Each collective is split
+ * into tasks, every task being a contiguous slice of the rank group pairs of the engine. A task is queued on a thread of
+ * the group local to the region it starts streaming from. With work stealing, a thread that has emptied its own queue
+ * steals from the tail of the other queues, looking first at the threads working on the same channel, then at the threads
+ * of the same NUMA node.
+ */
+#define DEFAULT_NB_THREAD_PER_COMM_POOL (32)
+#define MAX_NB_THREAD_PER_COMM_POOL (128)
+#define DEFAULT_NB_TASK_PER_COMM_THREAD (8)
+#define MAX_NB_COMM_TASK (1024)
+#define MAX_NB_COMM_GROUP (8)
+/* thread_all_gather_x_rns works on sets of 4 jobs */
+#define COMM_POOL_JOB_GRANULARITY (4)
+#define COMM_POOL_NO_TASK (UINT32_MAX)
+
+typedef void *(*comm_pool_job_t)(void *);
+
+struct comm_pool_group {
+    int numa_node;
+    uint32_t first_thread;
+    uint32_t nb_threads;
+    uint32_t nb_tasks;
+};
+
+struct comm_pool_thread_args {
+    struct comm_pool_group *group;
+    pthread_t tid;
+    bool stop_thread;
+    /* Channel of the first task queued for the current collective */
+    uint8_t channel_id;
+    /* Queue of the current collective, as indexes in comm_pool.tasks: head in the upper 32 bits, tail in the lower ones */
+    uint64_t queue;
+};
+
+enum comm_pool_start_state {
+    COMM_POOL_STARTING,
+    COMM_POOL_STARTED,
+    COMM_POOL_ABORTED,
+};
+
+struct comm_pool {
+    pthread_mutex_t mutex;
+    pthread_barrier_t barrier_threads;
+    /* The threads wait on start_cond until every thread is created and the barrier is sized */
+    pthread_mutex_t start_mutex;
+    pthread_cond_t start_cond;
+    enum comm_pool_start_state start_state;
+    uint32_t nb_ranks;
+    uint32_t nb_threads;
+    uint32_t nb_tasks;
+    uint32_t nb_groups;
+    bool work_stealing;
+    bool is_running;
+    bool start_failed;
+
+    comm_pool_job_t job;
+    uint8_t *job_args;
+    size_t job_args_size;
+
+    struct comm_pool_group groups[MAX_NB_COMM_GROUP];
+    struct comm_pool_thread_args threads_args[MAX_NB_THREAD_PER_COMM_POOL];
+    uint32_t tasks[MAX_NB_COMM_TASK];
+    uint8_t tasks_channel[MAX_NB_COMM_TASK];
+    struct comm_pool_group *tasks_group[MAX_NB_COMM_TASK];
+};
+static struct comm_pool comm_pool = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .start_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .start_cond = PTHREAD_COND_INITIALIZER,
+};
+
+static struct comm_pool_group *
+comm_pool_find_group(int numa_node)
+{
+    for (uint32_t each_group = 0; each_group < comm_pool.nb_groups; each_group++) {
+        if (comm_pool.groups[each_group].numa_node == numa_node) {
+            return &comm_pool.groups[each_group];
+        }
+    }
+    return NULL;
+}
+
+static uint32_t
+comm_pool_pop_task(struct comm_pool_thread_args *args, bool from_tail)
+{
+    uint64_t queue = __atomic_load_n(&args->queue, __ATOMIC_ACQUIRE);
+    while (true) {
+        uint32_t head = queue >> 32;
+        uint32_t tail = queue & 0xffffffff;
+        uint64_t next_queue;
+        uint32_t task_idx;
+
+        if (head >= tail) {
+            return COMM_POOL_NO_TASK;
+        }
+        if (from_tail) {
+            task_idx = tail - 1;
+            next_queue = ((uint64_t)head << 32) | (tail - 1);
+        } else {
+            task_idx = head;
+            next_queue = ((uint64_t)(head + 1) << 32) | tail;
+        }
+        if (__atomic_compare_exchange_n(&args->queue, &queue, next_queue, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return comm_pool.tasks[task_idx];
+        }
+    }
+}
+
+static uint32_t
+comm_pool_steal_task(struct comm_pool_thread_args *args)
+{
+    uint32_t thread_id = args - comm_pool.threads_args;
+
+    // 0: same channel, 1: same NUMA node, 2: any thread
+    for (uint32_t pass = 0; pass < 3; pass++) {
+        for (uint32_t each_victim = 1; each_victim < comm_pool.nb_threads; each_victim++) {
+            struct comm_pool_thread_args *victim = &comm_pool.threads_args[(thread_id + each_victim) % comm_pool.nb_threads];
+            if ((pass == 0 && victim->channel_id != args->channel_id) || (pass == 1 && victim->group != args->group)) {
+                continue;
+            }
+            uint32_t task = comm_pool_pop_task(victim, true);
+            if (task != COMM_POOL_NO_TASK) {
+                return task;
+            }
+        }
+    }
+    return COMM_POOL_NO_TASK;
+}
+
+static void *
+thread_comm_pool(void *arg)
+{
+    struct comm_pool_thread_args *args = (struct comm_pool_thread_args *)arg;
+    struct comm_pool_group *group = args->group;
+    bool numa_affinity_is_set = false;
+
+    pthread_mutex_lock(&comm_pool.start_mutex);
+    while (comm_pool.start_state == COMM_POOL_STARTING) {
+        pthread_cond_wait(&comm_pool.start_cond, &comm_pool.start_mutex);
+    }
+    bool aborted = comm_pool.start_state == COMM_POOL_ABORTED;
+    pthread_mutex_unlock(&comm_pool.start_mutex);
+    if (aborted) {
+        return NULL;
+    }
+
+    while (true) {
+        // Wait for a collective to perform
+        pthread_barrier_wait(&comm_pool.barrier_threads);
+
+        if (args->stop_thread) {
+            break;
+        }
+
+        if (!numa_affinity_is_set && group->numa_node >= 0) {
+            if (numa_run_on_node(group->numa_node) < 0) {
+                LOG_FN(DEBUG, "Failed to set thread NUMA node affinity (%s)", strerror(errno));
+            }
+            numa_affinity_is_set = true;
+        }
+
+        uint32_t task;
+        while ((task = comm_pool_pop_task(args, false)) != COMM_POOL_NO_TASK) {
+            comm_pool.job(comm_pool.job_args + task * comm_pool.job_args_size);
+        }
+        if (comm_pool.work_stealing) {
+            while ((task = comm_pool_steal_task(args)) != COMM_POOL_NO_TASK) {
+                comm_pool.job(comm_pool.job_args + task * comm_pool.job_args_size);
+            }
+        }
+
+        // Wait for every thread to complete their tasks
+        pthread_barrier_wait(&comm_pool.barrier_threads);
+    }
+    return NULL;
+}
+
+static void
+comm_pool_stop(void)
+{
+    if (!comm_pool.is_running) {
+        return;
+    }
+    for (uint32_t each_thread = 0; each_thread < comm_pool.nb_threads; each_thread++) {
+        comm_pool.threads_args[each_thread].stop_thread = true;
+    }
+    pthread_barrier_wait(&comm_pool.barrier_threads);
+    for (uint32_t each_thread = 0; each_thread < comm_pool.nb_threads; each_thread++) {
+        pthread_join(comm_pool.threads_args[each_thread].tid, NULL);
+    }
+    pthread_barrier_destroy(&comm_pool.barrier_threads);
+    comm_pool.is_running = false;
+}
+
+/* Releases the threads created so far before they reach the barrier, and falls back to the calling thread for good */
+static void
+comm_pool_abort_start(void)
+{
+    LOG_FN(WARNING, "Failed to create the collective thread pool, collectives will run on the calling thread");
+
+    pthread_mutex_lock(&comm_pool.start_mutex);
+    comm_pool.start_state = COMM_POOL_ABORTED;
+    pthread_cond_broadcast(&comm_pool.start_cond);
+    pthread_mutex_unlock(&comm_pool.start_mutex);
+
+    for (uint32_t each_thread = 0; each_thread < comm_pool.nb_threads; each_thread++) {
+        pthread_join(comm_pool.threads_args[each_thread].tid, NULL);
+    }
+    comm_pool.nb_threads = 0;
+    comm_pool.start_failed = true;
+}
+
+static void
+comm_pool_start(struct dpu_set_t *comm_dpu_set)
+{
+    hw_dpu_rank_allocation_parameters_t params = _this_params(comm_dpu_set->list.ranks[0]->description);
+    uint32_t nb_threads = params->comm_pool_nb_threads;
+    uint32_t nb_tasks_per_thread = params->comm_pool_work_stealing ? params->comm_pool_nb_tasks_per_thread : 1;
+    char thread_name[16];
+
+    // One group per NUMA node hosting the ranks of the communicator
+    comm_pool.nb_groups = 0;
+    for (uint32_t each_rank = 0; each_rank < comm_dpu_set->list.nr_ranks; each_rank++) {
+        int numa_node = _this_params(comm_dpu_set->list.ranks[each_rank]->description)->numa_node;
+        if (comm_pool_find_group(numa_node) == NULL && comm_pool.nb_groups < MAX_NB_COMM_GROUP) {
+            comm_pool.groups[comm_pool.nb_groups++].numa_node = numa_node;
+        }
+    }
+    if (nb_threads < comm_pool.nb_groups) {
+        nb_threads = comm_pool.nb_groups;
+    }
+    nb_threads = (nb_threads + COMM_POOL_JOB_GRANULARITY - 1) / COMM_POOL_JOB_GRANULARITY * COMM_POOL_JOB_GRANULARITY;
+    if (nb_threads > MAX_NB_THREAD_PER_COMM_POOL) {
+        nb_threads = MAX_NB_THREAD_PER_COMM_POOL;
+    }
+    if (nb_tasks_per_thread == 0) {
+        nb_tasks_per_thread = 1;
+    } else if (nb_tasks_per_thread > MAX_NB_COMM_TASK / nb_threads) {
+        nb_tasks_per_thread = MAX_NB_COMM_TASK / nb_threads;
+    }
+    comm_pool.nb_tasks = nb_threads * nb_tasks_per_thread;
+    comm_pool.work_stealing = params->comm_pool_work_stealing;
+    comm_pool.start_state = COMM_POOL_STARTING;
+
+    comm_pool.nb_threads = 0;
+    for (uint32_t each_group = 0; each_group < comm_pool.nb_groups; each_group++) {
+        struct comm_pool_group *group = &comm_pool.groups[each_group];
+        group->first_thread = comm_pool.nb_threads;
+        group->nb_threads = nb_threads / comm_pool.nb_groups + (each_group < nb_threads % comm_pool.nb_groups);
+        for (uint32_t each_thread = 0; each_thread < group->nb_threads; each_thread++) {
+            struct comm_pool_thread_args *threads_args = &comm_pool.threads_args[comm_pool.nb_threads];
+            threads_args->group = group;
+            threads_args->stop_thread = false;
+            threads_args->queue = 0;
+            if (pthread_create(&threads_args->tid, NULL, thread_comm_pool, (void *)threads_args)) {
+                comm_pool_abort_start();
+                return;
+            }
+            snprintf(thread_name, 16, "DPU_COMM_%04x", ((each_group & 0xff) << 8) | (each_thread & 0xff));
+            pthread_setname_np(threads_args->tid, thread_name);
+            comm_pool.nb_threads++;
+        }
+    }
+
+    if (pthread_barrier_init(&comm_pool.barrier_threads, NULL, comm_pool.nb_threads + 1)) {
+        comm_pool_abort_start();
+        return;
+    }
+    pthread_mutex_lock(&comm_pool.start_mutex);
+    comm_pool.start_state = COMM_POOL_STARTED;
+    pthread_cond_broadcast(&comm_pool.start_cond);
+    pthread_mutex_unlock(&comm_pool.start_mutex);
+    comm_pool.is_running = true;
+}
+
+/* Returns the number of jobs a collective must be split into. Must be followed by comm_pool_release(). */
+static uint32_t
+comm_pool_acquire(struct dpu_set_t *comm_dpu_set)
+{
+    pthread_mutex_lock(&comm_pool.mutex);
+    if (!comm_pool.is_running && !comm_pool.start_failed) {
+        comm_pool_start(comm_dpu_set);
+    }
+    return comm_pool.is_running ? comm_pool.nb_tasks : DEFAULT_NB_THREAD_PER_COMM_POOL;
+}
+
+static void
+comm_pool_release(void)
+{
+    pthread_mutex_unlock(&comm_pool.mutex);
+}
+
+/* Runs job on each of the nb_jobs elements of the job_args array, job i being considered local to the rank it starts
+ * streaming from, as the engines split their iterations in rank order.
+ */
+static void
+comm_pool_do_jobs(struct dpu_set_t *comm_dpu_set, comm_pool_job_t job, void *job_args, size_t job_args_size, uint32_t nb_jobs)
+{
+    if (job == NULL) {
+        return;
+    }
+
+    if (!comm_pool.is_running) {
+        for (uint32_t each_job = 0; each_job < nb_jobs; each_job++) {
+            job((uint8_t *)job_args + each_job * job_args_size);
+        }
+        return;
+    }
+
+    comm_pool.job = job;
+    comm_pool.job_args = job_args;
+    comm_pool.job_args_size = job_args_size;
+
+    // Sort the tasks by group, keeping the rank order inside each group
+    uint32_t nr_ranks = comm_dpu_set->list.nr_ranks;
+    for (uint32_t each_group = 0; each_group < comm_pool.nb_groups; each_group++) {
+        comm_pool.groups[each_group].nb_tasks = 0;
+    }
+    for (uint32_t each_job = 0; each_job < nb_jobs; each_job++) {
+        hw_dpu_rank_allocation_parameters_t params
+            = _this_params(comm_dpu_set->list.ranks[(uint64_t)each_job * nr_ranks / nb_jobs]->description);
+        struct comm_pool_group *group = comm_pool_find_group(params->numa_node);
+        if (group == NULL) {
+            group = &comm_pool.groups[each_job % comm_pool.nb_groups];
+        }
+        comm_pool.tasks_group[each_job] = group;
+        comm_pool.tasks_channel[each_job] = params->channel_id;
+        group->nb_tasks++;
+    }
+    uint32_t first_task = 0;
+    for (uint32_t each_group = 0; each_group < comm_pool.nb_groups; each_group++) {
+        struct comm_pool_group *group = &comm_pool.groups[each_group];
+        uint32_t task_idx = first_task;
+        for (uint32_t each_job = 0; each_job < nb_jobs; each_job++) {
+            if (comm_pool.tasks_group[each_job] == group) {
+                comm_pool.tasks[task_idx++] = each_job;
+            }
+        }
+
+        // Each thread of the group gets a contiguous slice of the tasks of the group
+        for (uint32_t each_thread = 0; each_thread < group->nb_threads; each_thread++) {
+            struct comm_pool_thread_args *args = &comm_pool.threads_args[group->first_thread + each_thread];
+            uint32_t head = first_task + (uint64_t)each_thread * group->nb_tasks / group->nb_threads;
+            uint32_t tail = first_task + (uint64_t)(each_thread + 1) * group->nb_tasks / group->nb_threads;
+            args->channel_id = (head < tail) ? comm_pool.tasks_channel[comm_pool.tasks[head]] : 0xff;
+            args->queue = ((uint64_t)head << 32) | tail;
+        }
+        first_task += group->nb_tasks;
+    }
+
+    pthread_barrier_wait(&comm_pool.barrier_threads);
+    pthread_barrier_wait(&comm_pool.barrier_threads);
+}
+
 static dpu_rank_status_e
 hw_allocate(struct dpu_rank_t *rank, dpu_description_t description)
 {
@@ -512,6 +891,8 @@ hw_allocate(struct dpu_rank_t *rank, dpu_description_t description)
     int ret;
     uint8_t nr_cis;
 
+    params->numa_node = -1;
+
     /* 1/ Make sure SDK is compatible with the kernel module */
     static bool compatibility_checked = false;
     if ((params->bypass_module_compatibility == false) && (compatibility_checked == false)) 
@@ -637,6 +1018,12 @@ hw_allocate(struct dpu_rank_t *rank, dpu_description_t description)
             }
 
             rank_context->control_interfaces = (uint64_t *)params->ptr_region;
+
+            if (numa_available() != -1
+                && get_mempolicy(&params->numa_node, NULL, 0, params->ptr_region, MPOL_F_NODE | MPOL_F_ADDR) < 0) {
+                LOG_RANK(DEBUG, rank, "Failed to evaluate NUMA node ID (%s)", strerror(errno));
+                params->numa_node = -1;
+            }
         }
     }
 
@@ -667,6 +1054,10 @@ hw_allocate(struct dpu_rank_t *rank, dpu_description_t description)
 
     log_rank_path(rank, params->rank_fs.rank_path);
 
+    pthread_mutex_lock(&comm_pool.mutex);
+    comm_pool.nb_ranks++;
+    pthread_mutex_unlock(&comm_pool.mutex);
+
     return DPU_RANK_SUCCESS;
 
 free_ptr_region:
@@ -697,6 +1088,12 @@ hw_free(struct dpu_rank_t *rank)
     hw_dpu_rank_context_t rank_context = _this(rank);
     hw_dpu_rank_allocation_parameters_t params = _this_params(rank->description);
 
+    pthread_mutex_lock(&comm_pool.mutex);
+    if (--comm_pool.nb_ranks == 0) {
+        comm_pool_stop();
+    }
+    pthread_mutex_unlock(&comm_pool.mutex);
+
     if (params->mode == DPU_REGION_MODE_PERF) {
         munmap(params->ptr_region, params->region_size);
         if (params->translate.destroy_rank)
@@ -1241,10 +1638,9 @@ void *thread_all_to_all_x_rns_24(void *thread_parameter){
 static dpu_rank_status_e
 hw_all_to_all_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset){
 
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -1257,16 +1653,15 @@ hw_all_to_all_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, u
         thread_params[iter_thread].p_alltoall_comm_type=alltoall_comm_type;
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_num_thread=thread_num;
-        if(a>4){
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_to_all_x_rns, (void *) &thread_params[iter_thread]);
-        }
-        else{
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_to_all_x_rns_24, (void *) &thread_params[iter_thread]);
-        }
     }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+    if(a>4){
+        thread_fn=thread_all_to_all_x_rns;
     }
+    else{
+        thread_fn=thread_all_to_all_x_rns_24;
+    }
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
 
     return DPU_RANK_SUCCESS;
 }
@@ -1274,10 +1669,8 @@ hw_all_to_all_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, u
 static dpu_rank_status_e
 hw_all_to_all_xz_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset){
     
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num]; //={0, rank, start_offset, dpu_byte_length, a, b, c}
-    int status;
-    pthread_t array_thread[thread_num];
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -1290,11 +1683,9 @@ hw_all_to_all_xz_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset,
         thread_params[iter_thread].p_alltoall_comm_type=alltoall_comm_type;
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_num_thread=thread_num;
-        pthread_create(&array_thread[iter_thread], NULL, thread_all_to_all_xz_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_all_to_all_xz_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     
     return DPU_RANK_SUCCESS;
 }
@@ -1302,10 +1693,9 @@ hw_all_to_all_xz_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset,
 static dpu_rank_status_e
 hw_all_to_all_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset){
     
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num]; //={0, rank, start_offset, dpu_byte_length, a, b, c}
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
 
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
@@ -1319,26 +1709,24 @@ hw_all_to_all_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, u
         thread_params[iter_thread].p_alltoall_comm_type=alltoall_comm_type;
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_num_thread=thread_num;
-        if(a>4){
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_to_all_y_rns, (void *) &thread_params[iter_thread]);
-        }
-        else{
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_to_all_y_rns_24, (void *) &thread_params[iter_thread]);
-        }
     }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+    if(a>4){
+        thread_fn=thread_all_to_all_y_rns;
     }
+    else{
+        thread_fn=thread_all_to_all_y_rns_24;
+    }
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     return DPU_RANK_SUCCESS;
 }
 
 static dpu_rank_status_e
 hw_all_to_all_z_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset){
     
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num]; //={0, rank, start_offset, dpu_byte_length, a, b, c}
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -1351,16 +1739,15 @@ hw_all_to_all_z_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, u
         thread_params[iter_thread].p_alltoall_comm_type=alltoall_comm_type;
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_num_thread=thread_num;
-        if(a>4){
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_to_all_z_rns, (void *) &thread_params[iter_thread]);
-        }
-        else{
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_to_all_z_rns_24, (void *) &thread_params[iter_thread]);
-        }
     }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+    if(a>4){
+        thread_fn=thread_all_to_all_z_rns;
     }
+    else{
+        thread_fn=thread_all_to_all_z_rns_24;
+    }
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     return DPU_RANK_SUCCESS;
 }
 
@@ -1385,6 +1772,24 @@ typedef struct {
     uint32_t* axis_len;
     uint32_t* comm_axis;
 
+    uint32_t* source;
+
+    uint32_t num_tiles;
+    uint32_t num_rg;
+    uint32_t* tile_src_rg;
+    uint32_t* tile_dst_rg;
+    uint32_t swap;
+    uint32_t rows;
+    uint32_t cols;
+
+    uint32_t num_passes;
+    uint32_t* passes;
+
+    uint32_t chunk_words;
+    uint32_t quant_block;
+    uint32_t* source_start;
+    uint32_t* sources;
+
 }st_thread_parameter;
 
 void *thread_all_to_all_rns(void *thread_parameter){
@@ -1487,12 +1892,12 @@ void *thread_all_to_all_rns(void *thread_parameter){
         for(uint32_t dim=0; dim < dimension; dim++){
             if(dim == 1) temp_total_product *= (axis_len[0]/8);
             else if(dim>1) temp_total_product *= axis_len[dim-1];
-            src_rank_id += iter_src[dim]*temp_total_product/8;
-            dst_rank_id += iter_dst[dim]*temp_total_product/8;
             src_rg_id += iter_src[dim]*temp_total_product;
             dst_rg_id += iter_dst[dim]*temp_total_product;
         }
+        src_rank_id = src_rg_id / 8;
         src_rg_id = src_rg_id % 8;
+        dst_rank_id = dst_rg_id / 8;
         dst_rg_id = dst_rg_id % 8;
 
         hw_dpu_rank_allocation_parameters_t params_src = _this_params(comm_dpu_set->list.ranks[src_rank_id] ->description);
@@ -1506,6 +1911,129 @@ void *thread_all_to_all_rns(void *thread_parameter){
     return 0;
 }
 
+//In-place alltoall: the iterations of thread_all_to_all_rns(), but the pair of rotate groups of the iterations (src, dst)
+//and (dst, src) is swapped by the one with src <= dst, so nothing is written to a communication buffer.
+void *thread_all_to_all_inplace_rns(void *thread_parameter){
+    st_thread_parameter *each_thread_comm_parameter = (st_thread_parameter *)thread_parameter;
+    uint32_t thread_id = each_thread_comm_parameter->p_thread_id;
+    struct dpu_set_t *comm_dpu_set=each_thread_comm_parameter->p_comm_dpu_set;
+    uint32_t src_start_offset=each_thread_comm_parameter->p_src_start_offset;
+    uint32_t dst_start_offset=each_thread_comm_parameter->p_dst_start_offset;
+    uint32_t dpu_byte_length=each_thread_comm_parameter->p_dpu_byte_length;
+    uint32_t comm_type=each_thread_comm_parameter->p_comm_type;
+    uint32_t num_thread=each_thread_comm_parameter->p_num_thread;
+
+    uint32_t dimension = each_thread_comm_parameter->dimension;
+    uint32_t* axis_len = each_thread_comm_parameter->axis_len;
+    uint32_t* comm_axis = each_thread_comm_parameter->comm_axis;
+
+    uint32_t num_inter_thread = 1;
+
+    uint32_t total_iter_num=1;
+    uint32_t total_axis_product=1;
+
+    for(uint32_t i=0; i<dimension; i++){
+        total_iter_num *= axis_len[i];
+        if(comm_axis[i] == 1) {
+            total_axis_product *= axis_len[i];
+        }
+    }
+    if(comm_type == 0) total_axis_product /= 8;
+
+    total_iter_num /=8;
+    total_iter_num *= total_axis_product;
+
+    uint32_t share=total_iter_num/(num_thread/num_inter_thread);
+    uint32_t remainder=total_iter_num%(num_thread/num_inter_thread);
+    uint32_t remain_iter=0;
+    uint32_t start_point = share*(thread_id/num_inter_thread);
+    uint32_t src_start_offset_iter, dst_start_offset_iter;
+
+    if((thread_id/num_inter_thread)<remainder){
+        remain_iter=1;
+        start_point+=(thread_id/num_inter_thread);
+    }
+    else{
+        start_point+=remainder;
+    }
+
+    uint32_t* iter_src = calloc(dimension, sizeof(uint32_t));
+    uint32_t* iter_dst = calloc(dimension, sizeof(uint32_t));
+    uint32_t cur_iter_num, cur_remain, cur_iter_src, cur_iter_dst;
+
+    for(uint32_t i=start_point; i<(start_point+(share+remain_iter)); i++){
+
+        cur_iter_num = total_iter_num;
+        cur_remain = i;
+        for(int dim = (int)dimension-1; dim>=0; dim--){
+            if(comm_axis[dim] == 0){
+                if(dim == 0) cur_iter_num /= (axis_len[0]/8);
+                else cur_iter_num/=axis_len[dim];
+                iter_src[dim] = cur_remain / cur_iter_num;
+                iter_dst[dim] = cur_remain / cur_iter_num;
+                cur_remain -= iter_src[dim] * cur_iter_num;
+            }
+        }
+
+        cur_iter_src = cur_remain / total_axis_product;
+        cur_iter_dst = cur_remain % total_axis_product;
+        //the pair (src, dst) is swapped together with (dst, src)
+        if(cur_iter_src > cur_iter_dst) continue;
+
+        if(!comm_type){
+            src_start_offset_iter = src_start_offset + cur_iter_dst * 8 * dpu_byte_length;
+            dst_start_offset_iter = dst_start_offset + cur_iter_src * 8 * dpu_byte_length;
+        }
+        else{
+            src_start_offset_iter = src_start_offset + cur_iter_dst * 1 * dpu_byte_length;
+            dst_start_offset_iter = dst_start_offset + cur_iter_src * 1 * dpu_byte_length;
+        }
+
+        for(uint32_t dim = 0; dim<dimension; dim++){
+            if(comm_axis[dim] == 1){
+                if(dim==0){
+                    iter_src[dim] = cur_iter_src % (axis_len[dim]/8);
+                    iter_dst[dim] = cur_iter_dst % (axis_len[dim]/8);
+                    cur_iter_src = cur_iter_src / (axis_len[dim]/8);
+                    cur_iter_dst = cur_iter_dst / (axis_len[dim]/8);
+                }
+                else{
+                    iter_src[dim] = cur_iter_src % axis_len[dim];
+                    iter_dst[dim] = cur_iter_dst % axis_len[dim];
+                    cur_iter_src = cur_iter_src / axis_len[dim];
+                    cur_iter_dst = cur_iter_dst / axis_len[dim];
+                }
+            }
+        }
+
+        uint32_t src_rank_id=0; 
+        uint32_t dst_rank_id=0; 
+        uint32_t src_rg_id=0;
+        uint32_t dst_rg_id=0;
+        uint32_t temp_total_product=1;
+        for(uint32_t dim=0; dim < dimension; dim++){
+            if(dim == 1) temp_total_product *= (axis_len[0]/8);
+            else if(dim>1) temp_total_product *= axis_len[dim-1];
+            src_rg_id += iter_src[dim]*temp_total_product;
+            dst_rg_id += iter_dst[dim]*temp_total_product;
+        }
+        src_rank_id = src_rg_id / 8;
+        src_rg_id = src_rg_id % 8;
+        dst_rank_id = dst_rg_id / 8;
+        dst_rg_id = dst_rg_id % 8;
+
+        hw_dpu_rank_allocation_parameters_t params_src = _this_params(comm_dpu_set->list.ranks[src_rank_id] ->description);
+        uint8_t *rank_base_address_src=params_src->ptr_region;
+        hw_dpu_rank_allocation_parameters_t params_dst = _this_params(comm_dpu_set->list.ranks[dst_rank_id] ->description);
+        uint8_t *rank_base_address_dst=params_dst->ptr_region;
+
+        params_src->translate.trans_all_to_all_inplace_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type);
+    }
+    free(iter_src);
+    free(iter_dst);
+    return 0;
+}
+
 //for when the product of the length of the first 2 dimensions is a muliutple of 8
 void *thread_all_to_all_24_rns(void *thread_parameter){
     st_thread_parameter *each_thread_comm_parameter = (st_thread_parameter *)thread_parameter;
@@ -1623,12 +2151,12 @@ void *thread_all_to_all_24_rns(void *thread_parameter){
         for(uint32_t dim=1; dim < dimension; dim++){
             if(dim == 2) temp_total_product *= (axis_len[0]*axis_len[1]/8);
             else if(dim>2) temp_total_product *= axis_len[dim-1];
-            src_rank_id += iter_src[dim]*temp_total_product/8;
-            dst_rank_id += iter_dst[dim]*temp_total_product/8;
             src_rg_id += iter_src[dim]*temp_total_product;
             dst_rg_id += iter_dst[dim]*temp_total_product;
         }
+        src_rank_id = src_rg_id / 8;
         src_rg_id = src_rg_id % 8;
+        dst_rank_id = dst_rg_id / 8;
         dst_rg_id = dst_rg_id % 8;
 
         hw_dpu_rank_allocation_parameters_t params_src = _this_params(comm_dpu_set->list.ranks[src_rank_id] ->description);
@@ -1784,12 +2312,12 @@ void *thread_all_to_all_22_rns(void *thread_parameter){
         for(uint32_t dim=2; dim < dimension; dim++){
             if(dim == 3) temp_total_product *= (4*axis_len[2]/8);
             else if(dim>3) temp_total_product *= axis_len[dim-1];
-            src_rank_id += iter_src[dim]*temp_total_product/8;
-            dst_rank_id += iter_dst[dim]*temp_total_product/8;
             src_rg_id += iter_src[dim]*temp_total_product;
             dst_rg_id += iter_dst[dim]*temp_total_product;
         }
+        src_rank_id = src_rg_id / 8;
         src_rg_id = src_rg_id % 8;
+        dst_rank_id = dst_rg_id / 8;
         dst_rg_id = dst_rg_id % 8;
 
         hw_dpu_rank_allocation_parameters_t params_src = _this_params(comm_dpu_set->list.ranks[src_rank_id] ->description);
@@ -1826,10 +2354,9 @@ void *thread_all_to_all_22_rns(void *thread_parameter){
 static dpu_rank_status_e
 hw_all_to_all_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis){
     
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -1842,17 +2369,291 @@ hw_all_to_all_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uin
         thread_params[iter_thread].dimension=dimension;
         thread_params[iter_thread].axis_len=axis_len;
         thread_params[iter_thread].comm_axis=comm_axis;
-        
-        if(axis_len[0] >=8) pthread_create(&array_thread[iter_thread], NULL, thread_all_to_all_rns, (void *) &thread_params[iter_thread]);
-        else if(axis_len[0]*axis_len[1] >= 8) pthread_create(&array_thread[iter_thread], NULL, thread_all_to_all_24_rns, (void *) &thread_params[iter_thread]);
-        else pthread_create(&array_thread[iter_thread], NULL, thread_all_to_all_22_rns, (void *) &thread_params[iter_thread]);
     }
+    if(axis_len[0] >=8) thread_fn=thread_all_to_all_rns;
+    else if(axis_len[0]*axis_len[1] >= 8) thread_fn=thread_all_to_all_24_rns;
+    else thread_fn=thread_all_to_all_22_rns;
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
+    return DPU_RANK_SUCCESS;
+}
+
+
+static dpu_rank_status_e
+hw_all_to_all_inplace_rns(struct dpu_set_t *comm_dpu_set, uint32_t start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis){
+
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
+    st_thread_parameter thread_params[thread_num];
+    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
+        thread_params[iter_thread].p_thread_id=iter_thread;
+        thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
+        thread_params[iter_thread].p_src_start_offset=start_offset;
+        thread_params[iter_thread].p_dst_start_offset=start_offset;
+        thread_params[iter_thread].p_dpu_byte_length=dpu_byte_length;
+        thread_params[iter_thread].p_comm_type = comm_type;
+        thread_params[iter_thread].p_num_thread=thread_num;
+        thread_params[iter_thread].dimension=dimension;
+        thread_params[iter_thread].axis_len=axis_len;
+        thread_params[iter_thread].comm_axis=comm_axis;
+    }
+    comm_pool_do_jobs(comm_dpu_set, thread_all_to_all_inplace_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
+    return DPU_RANK_SUCCESS;
+}
+
+//source[dpu]: the DPU whose bytes dpu receives, UINT32_MAX to keep its own. The DPUs are numbered by rotate group,
+//64 per rank, and every thread fills whole destination rotate groups.
+void *thread_permute_rns(void *thread_parameter){
+    st_thread_parameter *each_thread_comm_parameter = (st_thread_parameter *)thread_parameter;
+    uint32_t thread_id = each_thread_comm_parameter->p_thread_id;
+    struct dpu_set_t *comm_dpu_set=each_thread_comm_parameter->p_comm_dpu_set;
+    uint32_t src_start_offset=each_thread_comm_parameter->p_src_start_offset;
+    uint32_t dst_start_offset=each_thread_comm_parameter->p_dst_start_offset;
+    uint32_t dpu_byte_length=each_thread_comm_parameter->p_dpu_byte_length;
+    uint32_t num_thread=each_thread_comm_parameter->p_num_thread;
+    uint32_t* source = each_thread_comm_parameter->source;
+
+    uint32_t total_iter_num = comm_dpu_set->list.nr_ranks * 8;
+    uint32_t share=total_iter_num/num_thread;
+    uint32_t remainder=total_iter_num%num_thread;
+    uint32_t start_point = share*thread_id + (thread_id<remainder ? thread_id : remainder);
+    uint32_t end_point = start_point + share + (thread_id<remainder ? 1 : 0);
+
+    void* rank_base_address_src[8];
+    uint32_t src_rg_id[8];
+    uint32_t rotate[8];
+    uint8_t lane_mask[8];
+
+    for(uint32_t dst_rg=start_point; dst_rg<end_point; dst_rg++){
+        uint32_t num_src = 0;
+
+        for(uint32_t lane=0; lane<8; lane++){
+            uint32_t src_dpu = source[dst_rg*8 + lane];
+            if(src_dpu == UINT32_MAX) continue;
+
+            uint32_t rot = (lane + 8 - src_dpu%8) % 8;
+            uint32_t k = 0;
+            while(k < num_src && !(src_rg_id[k] == src_dpu/8 && rotate[k] == rot)) k++;
+            if(k == num_src){
+                src_rg_id[k] = src_dpu/8;
+                rotate[k] = rot;
+                lane_mask[k] = 0;
+                num_src++;
+            }
+            lane_mask[k] |= (uint8_t)(1 << lane);
+        }
+        if(num_src == 0) continue;
+
+        for(uint32_t k=0; k<num_src; k++){
+            hw_dpu_rank_allocation_parameters_t params_src = _this_params(comm_dpu_set->list.ranks[src_rg_id[k]/8]->description);
+            rank_base_address_src[k] = params_src->ptr_region;
+            src_rg_id[k] %= 8;
+        }
+        hw_dpu_rank_allocation_parameters_t params_dst = _this_params(comm_dpu_set->list.ranks[dst_rg/8]->description);
+        uint8_t *rank_base_address_dst=params_dst->ptr_region;
+
+        params_dst->translate.trans_permute_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, rotate, lane_mask, num_src, dst_rg%8, src_start_offset, dst_start_offset, dpu_byte_length);
+    }
+    return 0;
+}
+
+static dpu_rank_status_e
+hw_permute_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t* source){
+
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
+    st_thread_parameter thread_params[thread_num];
+    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
+        thread_params[iter_thread].p_thread_id=iter_thread;
+        thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
+        thread_params[iter_thread].p_src_start_offset=src_start_offset;
+        thread_params[iter_thread].p_dst_start_offset=dst_start_offset;
+        thread_params[iter_thread].p_dpu_byte_length=dpu_byte_length;
+        thread_params[iter_thread].p_num_thread=thread_num;
+        thread_params[iter_thread].source=source;
+    }
+    comm_pool_do_jobs(comm_dpu_set, thread_permute_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
+    return DPU_RANK_SUCCESS;
+}
+
+void *thread_transpose_rns(void *thread_parameter){
+    st_thread_parameter *each_thread_comm_parameter = (st_thread_parameter *)thread_parameter;
+    uint32_t thread_id = each_thread_comm_parameter->p_thread_id;
+    struct dpu_set_t *comm_dpu_set=each_thread_comm_parameter->p_comm_dpu_set;
+    uint32_t src_start_offset=each_thread_comm_parameter->p_src_start_offset;
+    uint32_t dst_start_offset=each_thread_comm_parameter->p_dst_start_offset;
+    uint32_t dpu_byte_length=each_thread_comm_parameter->p_dpu_byte_length;
+    uint32_t num_thread=each_thread_comm_parameter->p_num_thread;
+    uint32_t num_rg=each_thread_comm_parameter->num_rg;
+
+    uint32_t total_iter_num = each_thread_comm_parameter->num_tiles;
+    uint32_t share=total_iter_num/num_thread;
+    uint32_t remainder=total_iter_num%num_thread;
+    uint32_t start_point = share*thread_id + (thread_id<remainder ? thread_id : remainder);
+    uint32_t end_point = start_point + share + (thread_id<remainder ? 1 : 0);
+
+    void* rank_base_address_src[8];
+    void* rank_base_address_dst[8];
+    uint32_t src_rg_id[8];
+    uint32_t dst_rg_id[8];
+
+    for(uint32_t tile=start_point; tile<end_point; tile++){
+        uint32_t* tile_src_rg = each_thread_comm_parameter->tile_src_rg + tile*num_rg;
+        uint32_t* tile_dst_rg = each_thread_comm_parameter->tile_dst_rg + tile*num_rg;
+        //a tile on the diagonal is its own mirror
+        uint32_t swap = each_thread_comm_parameter->swap && memcmp(tile_src_rg, tile_dst_rg, sizeof(uint32_t) * num_rg) != 0;
+
+        for(uint32_t k=0; k<num_rg; k++){
+            hw_dpu_rank_allocation_parameters_t params_src = _this_params(comm_dpu_set->list.ranks[tile_src_rg[k]/8]->description);
+            hw_dpu_rank_allocation_parameters_t params_dst = _this_params(comm_dpu_set->list.ranks[tile_dst_rg[k]/8]->description);
+            rank_base_address_src[k] = params_src->ptr_region;
+            rank_base_address_dst[k] = params_dst->ptr_region;
+            src_rg_id[k] = tile_src_rg[k] % 8;
+            dst_rg_id[k] = tile_dst_rg[k] % 8;
+        }
+        hw_dpu_rank_allocation_parameters_t params = _this_params(comm_dpu_set->list.ranks[tile_dst_rg[0]/8]->description);
+
+        params->translate.trans_transpose_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, num_rg, swap, src_start_offset, dst_start_offset,
+            dpu_byte_length, each_thread_comm_parameter->rows, each_thread_comm_parameter->cols, each_thread_comm_parameter->size);
+    }
+    return 0;
+}
+
+static dpu_rank_status_e
+hw_transpose_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t num_tiles, uint32_t num_rg,
+                    uint32_t* tile_src_rg, uint32_t* tile_dst_rg, uint32_t swap, uint32_t rows, uint32_t cols, uint32_t size){
+
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
+    st_thread_parameter thread_params[thread_num];
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+        thread_params[iter_thread].p_thread_id=iter_thread;
+        thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
+        thread_params[iter_thread].p_src_start_offset=src_start_offset;
+        thread_params[iter_thread].p_dst_start_offset=dst_start_offset;
+        thread_params[iter_thread].p_dpu_byte_length=dpu_byte_length;
+        thread_params[iter_thread].p_num_thread=thread_num;
+        thread_params[iter_thread].num_tiles=num_tiles;
+        thread_params[iter_thread].num_rg=num_rg;
+        thread_params[iter_thread].tile_src_rg=tile_src_rg;
+        thread_params[iter_thread].tile_dst_rg=tile_dst_rg;
+        thread_params[iter_thread].swap=swap;
+        thread_params[iter_thread].rows=rows;
+        thread_params[iter_thread].cols=cols;
+        thread_params[iter_thread].size=size;
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_transpose_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     return DPU_RANK_SUCCESS;
 }
 
+//passes[6*pass...]: source rotate group, destination rotate group, rotation, source slot, destination slot and length
+//in bytes per DPU. The passes write disjoint slots, so they are dealt to the threads in turn whatever their groups.
+void *thread_all_to_all_v_rns(void *thread_parameter){
+    st_thread_parameter *each_thread_comm_parameter = (st_thread_parameter *)thread_parameter;
+    uint32_t thread_id = each_thread_comm_parameter->p_thread_id;
+    struct dpu_set_t *comm_dpu_set=each_thread_comm_parameter->p_comm_dpu_set;
+    uint32_t src_start_offset=each_thread_comm_parameter->p_src_start_offset;
+    uint32_t dst_start_offset=each_thread_comm_parameter->p_dst_start_offset;
+    uint32_t num_thread=each_thread_comm_parameter->p_num_thread;
+    uint8_t lane_mask = 0xff;
+
+    for(uint32_t pass=thread_id; pass<each_thread_comm_parameter->num_passes; pass+=num_thread){
+        uint32_t* entry = each_thread_comm_parameter->passes + 6*pass;
+        hw_dpu_rank_allocation_parameters_t params_src = _this_params(comm_dpu_set->list.ranks[entry[0]/8]->description);
+        hw_dpu_rank_allocation_parameters_t params_dst = _this_params(comm_dpu_set->list.ranks[entry[1]/8]->description);
+        void* rank_base_address_src = params_src->ptr_region;
+        uint32_t src_rg_id = entry[0]%8;
+        uint32_t rotate = entry[2];
+
+        params_dst->translate.trans_permute_rg(&rank_base_address_src, params_dst->ptr_region, &src_rg_id, &rotate, &lane_mask, 1, entry[1]%8,
+            src_start_offset + entry[3], dst_start_offset + entry[4], entry[5]);
+    }
+    return 0;
+}
+
+static dpu_rank_status_e
+hw_all_to_all_v_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t num_passes, uint32_t* passes){
+
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
+    st_thread_parameter thread_params[thread_num];
+    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
+        thread_params[iter_thread].p_thread_id=iter_thread;
+        thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
+        thread_params[iter_thread].p_src_start_offset=src_start_offset;
+        thread_params[iter_thread].p_dst_start_offset=dst_start_offset;
+        thread_params[iter_thread].p_num_thread=thread_num;
+        thread_params[iter_thread].num_passes=num_passes;
+        thread_params[iter_thread].passes=passes;
+    }
+    comm_pool_do_jobs(comm_dpu_set, thread_all_to_all_v_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
+    return DPU_RANK_SUCCESS;
+}
+
+//sources[4*k...]: rotate group, rotation, lane mask and slot of the sources of every destination rotate group, those
+//of group dst_rg from source_start[dst_rg] to source_start[dst_rg+1]. Every thread fills whole destination groups.
+void *thread_reduce_quantized_rns(void *thread_parameter){
+    st_thread_parameter *each_thread_comm_parameter = (st_thread_parameter *)thread_parameter;
+    uint32_t thread_id = each_thread_comm_parameter->p_thread_id;
+    struct dpu_set_t *comm_dpu_set=each_thread_comm_parameter->p_comm_dpu_set;
+    uint32_t src_start_offset=each_thread_comm_parameter->p_src_start_offset;
+    uint32_t dst_start_offset=each_thread_comm_parameter->p_dst_start_offset;
+    uint32_t num_thread=each_thread_comm_parameter->p_num_thread;
+    uint32_t* source_start = each_thread_comm_parameter->source_start;
+
+    uint32_t total_iter_num = comm_dpu_set->list.nr_ranks * 8;
+    uint32_t share=total_iter_num/num_thread;
+    uint32_t remainder=total_iter_num%num_thread;
+    uint32_t start_point = share*thread_id + (thread_id<remainder ? thread_id : remainder);
+    uint32_t end_point = start_point + share + (thread_id<remainder ? 1 : 0);
+
+    for(uint32_t dst_rg=start_point; dst_rg<end_point; dst_rg++){
+        uint32_t num_src = source_start[dst_rg+1] - source_start[dst_rg];
+        uint32_t* entry = each_thread_comm_parameter->sources + 4*source_start[dst_rg];
+        void* rank_base_address_src[num_src];
+        uint32_t src_rg_id[num_src];
+        uint32_t rotate[num_src];
+        uint8_t lane_mask[num_src];
+        uint32_t src_offset[num_src];
+
+        for(uint32_t k=0; k<num_src; k++, entry+=4){
+            hw_dpu_rank_allocation_parameters_t params_src = _this_params(comm_dpu_set->list.ranks[entry[0]/8]->description);
+            rank_base_address_src[k] = params_src->ptr_region;
+            src_rg_id[k] = entry[0]%8;
+            rotate[k] = entry[1];
+            lane_mask[k] = (uint8_t)entry[2];
+            src_offset[k] = src_start_offset + entry[3];
+        }
+        hw_dpu_rank_allocation_parameters_t params_dst = _this_params(comm_dpu_set->list.ranks[dst_rg/8]->description);
+
+        params_dst->translate.trans_reduce_quantized_rg(rank_base_address_src, params_dst->ptr_region, src_rg_id, rotate, lane_mask, src_offset, num_src, dst_rg%8,
+            dst_start_offset, each_thread_comm_parameter->chunk_words, each_thread_comm_parameter->size, each_thread_comm_parameter->quant_block);
+    }
+    return 0;
+}
+
+static dpu_rank_status_e
+hw_reduce_quantized_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t chunk_words, uint32_t quant_size, uint32_t quant_block,
+                    uint32_t* source_start, uint32_t* sources){
+
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
+    st_thread_parameter thread_params[thread_num];
+    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
+        thread_params[iter_thread].p_thread_id=iter_thread;
+        thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
+        thread_params[iter_thread].p_src_start_offset=src_start_offset;
+        thread_params[iter_thread].p_dst_start_offset=dst_start_offset;
+        thread_params[iter_thread].p_num_thread=thread_num;
+        thread_params[iter_thread].size=quant_size;
+        thread_params[iter_thread].chunk_words=chunk_words;
+        thread_params[iter_thread].quant_block=quant_block;
+        thread_params[iter_thread].source_start=source_start;
+        thread_params[iter_thread].sources=sources;
+    }
+    comm_pool_do_jobs(comm_dpu_set, thread_reduce_quantized_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
+    return DPU_RANK_SUCCESS;
+}
 
 void *thread_reduce_scatter_cpu_x_rns(void *thread_parameter){
     st_thread_all_to_all_x_parameter *each_thread_all_to_all_x_parameter = (st_thread_all_to_all_x_parameter *)thread_parameter;
@@ -1867,6 +2668,7 @@ void *thread_reduce_scatter_cpu_x_rns(void *thread_parameter){
     uint32_t alltoall_comm_type=each_thread_all_to_all_x_parameter->p_alltoall_comm_type;
     uint32_t communication_buffer_offset=each_thread_all_to_all_x_parameter->p_communication_buffer_offset;
     uint32_t size = each_thread_all_to_all_x_parameter->size;
+    uint32_t reduce_type = each_thread_all_to_all_x_parameter->reduce_type;
     uint32_t thread_num = each_thread_all_to_all_x_parameter->thread_num;
 
     /* uint32_t total_iter_num=c*b*(a/8);
@@ -1928,7 +2730,7 @@ void *thread_reduce_scatter_cpu_x_rns(void *thread_parameter){
         src_start_offset_iter = src_start_offset + iter_dst_a * 8 * dpu_byte_length;
         dst_start_offset_iter = dst_start_offset + iter_src_a * 8 * dpu_byte_length;
 
-        params_src->translate.trans_reduce_scatter_cpu_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, num_iter_src, alltoall_comm_type, communication_buffer_offset, size, num_inter_thread, thread_id%num_inter_thread); //rank_base_addr, offset, length
+        params_src->translate.trans_reduce_scatter_cpu_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, num_iter_src, alltoall_comm_type, communication_buffer_offset, size, reduce_type, num_inter_thread, thread_id%num_inter_thread); //rank_base_addr, offset, length
     }
 
     return 0;
@@ -1947,6 +2749,7 @@ void *thread_reduce_scatter_cpu_x_rns_24(void *thread_parameter){
     uint32_t alltoall_comm_type=each_thread_all_to_all_x_parameter->p_alltoall_comm_type;
     uint32_t communication_buffer_offset=each_thread_all_to_all_x_parameter->p_communication_buffer_offset;
     uint32_t size = each_thread_all_to_all_x_parameter->size;
+    uint32_t reduce_type = each_thread_all_to_all_x_parameter->reduce_type;
     uint32_t thread_num = each_thread_all_to_all_x_parameter->thread_num;
 
     uint32_t total_iter_num=c*b/(8/a);
@@ -1978,18 +2781,17 @@ void *thread_reduce_scatter_cpu_x_rns_24(void *thread_parameter){
         rank_base_address_dst_array[0]=rank_base_address_src_dst;
         dst_rg_id_array[0]=src_dst_rg_id;
 
-        params_src_dst->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_src_dst, rank_base_address_dst_array, src_dst_rg_id, dst_rg_id_array, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, alltoall_comm_type, communication_buffer_offset, num_iter_dst, a, size);
+        params_src_dst->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_src_dst, rank_base_address_dst_array, src_dst_rg_id, dst_rg_id_array, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, alltoall_comm_type, communication_buffer_offset, num_iter_dst, a, size, reduce_type);
     }
     return 0;
 }
 
 static dpu_rank_status_e
-hw_reduce_scatter_cpu_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size){
+hw_reduce_scatter_cpu_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type){
 
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -2002,17 +2804,17 @@ hw_reduce_scatter_cpu_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_o
         thread_params[iter_thread].p_alltoall_comm_type=alltoall_comm_type;
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].size = size;
+        thread_params[iter_thread].reduce_type = reduce_type;
         thread_params[iter_thread].thread_num = thread_num;
-        if(a>4){
-            pthread_create(&array_thread[iter_thread], NULL, thread_reduce_scatter_cpu_x_rns, (void *) &thread_params[iter_thread]);
-        }
-        else{
-            pthread_create(&array_thread[iter_thread], NULL, thread_reduce_scatter_cpu_x_rns_24, (void *) &thread_params[iter_thread]);
-        }
     }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+    if(a>4){
+        thread_fn=thread_reduce_scatter_cpu_x_rns;
     }
+    else{
+        thread_fn=thread_reduce_scatter_cpu_x_rns_24;
+    }
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
 
     return DPU_RANK_SUCCESS;
 }
@@ -2030,6 +2832,7 @@ void *thread_reduce_scatter_cpu_y_rns(void *thread_parameter){
     uint32_t alltoall_comm_type=each_thread_all_to_all_x_parameter->p_alltoall_comm_type;
     uint32_t communication_buffer_offset=each_thread_all_to_all_x_parameter->p_communication_buffer_offset;
     uint32_t size = each_thread_all_to_all_x_parameter->size;
+    uint32_t reduce_type = each_thread_all_to_all_x_parameter->reduce_type;
     uint32_t thread_num = each_thread_all_to_all_x_parameter->thread_num;
 
 
@@ -2080,7 +2883,7 @@ void *thread_reduce_scatter_cpu_y_rns(void *thread_parameter){
         src_start_offset_iter = src_start_offset + iter_dst_b * 1 * dpu_byte_length;
         dst_start_offset_iter = dst_start_offset + iter_src_b * 1 * dpu_byte_length;
 
-        params_src->translate.trans_reduce_scatter_cpu_y_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, num_iter_src, alltoall_comm_type, communication_buffer_offset, size); //rank_base_addr, offset, length
+        params_src->translate.trans_reduce_scatter_cpu_y_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, num_iter_src, alltoall_comm_type, communication_buffer_offset, size, reduce_type); //rank_base_addr, offset, length
     }
     return 0;
 }
@@ -2098,6 +2901,7 @@ void *thread_reduce_scatter_cpu_y_rns_24(void *thread_parameter){
     uint32_t alltoall_comm_type=each_thread_all_to_all_x_parameter->p_alltoall_comm_type;
     uint32_t communication_buffer_offset=each_thread_all_to_all_x_parameter->p_communication_buffer_offset;
     uint32_t size = each_thread_all_to_all_x_parameter->size;
+    uint32_t reduce_type = each_thread_all_to_all_x_parameter->reduce_type;
     uint32_t thread_num = each_thread_all_to_all_x_parameter->thread_num;
     
     uint32_t total_iter_num=c * (b/(8/a));
@@ -2136,7 +2940,7 @@ void *thread_reduce_scatter_cpu_y_rns_24(void *thread_parameter){
             
             src_start_offset_iter = src_start_offset + iter_dst_b * (8/a) * dpu_byte_length;
             dst_start_offset_iter = dst_start_offset;
-            params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, alltoall_comm_type, communication_buffer_offset, num_iter_src, a, size);
+            params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, alltoall_comm_type, communication_buffer_offset, num_iter_src, a, size, reduce_type);
         }
     }
 
@@ -2144,12 +2948,11 @@ void *thread_reduce_scatter_cpu_y_rns_24(void *thread_parameter){
 }
 
 static dpu_rank_status_e
-hw_reduce_scatter_cpu_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size){
+hw_reduce_scatter_cpu_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type){
 
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -2162,17 +2965,17 @@ hw_reduce_scatter_cpu_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_o
         thread_params[iter_thread].p_alltoall_comm_type=alltoall_comm_type;
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].size=size;
+        thread_params[iter_thread].reduce_type = reduce_type;
         thread_params[iter_thread].thread_num = thread_num;
-        if(a>4){
-            pthread_create(&array_thread[iter_thread], NULL, thread_reduce_scatter_cpu_y_rns, (void *) &thread_params[iter_thread]);
-        }
-        else{
-            pthread_create(&array_thread[iter_thread], NULL, thread_reduce_scatter_cpu_y_rns_24, (void *) &thread_params[iter_thread]);
-        }
     }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+    if(a>4){
+        thread_fn=thread_reduce_scatter_cpu_y_rns;
     }
+    else{
+        thread_fn=thread_reduce_scatter_cpu_y_rns_24;
+    }
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     return DPU_RANK_SUCCESS;
 }
 
@@ -2187,6 +2990,7 @@ void *thread_reduce_scatter_rns(void *thread_parameter){
     uint32_t communication_buffer_offset=each_thread_comm_parameter->p_communication_buffer_offset;
     uint32_t num_thread=each_thread_comm_parameter->p_num_thread;
     uint32_t size = each_thread_comm_parameter->size;
+    uint32_t reduce_type = each_thread_comm_parameter->reduce_type;
 
     uint32_t dimension = each_thread_comm_parameter->dimension;
     uint32_t* axis_len = each_thread_comm_parameter->axis_len;
@@ -2279,21 +3083,17 @@ void *thread_reduce_scatter_rns(void *thread_parameter){
             if(dim == 1) temp_total_product *= (axis_len[0]/8);
             else if(dim>1) temp_total_product *= axis_len[dim-1];
 
-            dst_rank_id += iter_dst[dim]*temp_total_product/8;
             dst_rg_id += iter_dst[dim]*temp_total_product;
 
             for(uint32_t j=0; j<total_axis_product; j++){
                 if(comm_axis[dim] == 0){
-                    src_rank_id[j] += iter_src[dim] * temp_total_product/8;
                     src_rg_id[j] += iter_src[dim] * temp_total_product;
                 }
                 else{
                     if(dim == 0){
-                        src_rank_id[j] += (j % (axis_len[0]/8) ) * temp_total_product/8;
                         src_rg_id[j] += (j % (axis_len[0]/8) ) * temp_total_product;
                     }
                     else{
-                        src_rank_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product/8;
                         src_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
                     }
                 }
@@ -2304,7 +3104,11 @@ void *thread_reduce_scatter_rns(void *thread_parameter){
                 else if(dim>0) temp_comm_product *= axis_len[dim];
             }
         }
-        for(uint32_t j=0; j<total_axis_product; j++) src_rg_id[j] = src_rg_id[j] % 8;
+        for(uint32_t j=0; j<total_axis_product; j++){
+            src_rank_id[j] = src_rg_id[j] / 8;
+            src_rg_id[j] = src_rg_id[j] % 8;
+        }
+        dst_rank_id = dst_rg_id / 8;
         dst_rg_id = dst_rg_id % 8;
 
         void* rank_base_address_src[total_axis_product];
@@ -2320,8 +3124,8 @@ void *thread_reduce_scatter_rns(void *thread_parameter){
         params_dst = _this_params(comm_dpu_set->list.ranks[dst_rank_id] ->description);
         rank_base_address_dst=params_dst->ptr_region;
 
-        if(!comm_type) params_src->translate.trans_reduce_scatter_cpu_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, num_inter_thread, thread_id%num_inter_thread);
-        else params_src->translate.trans_reduce_scatter_cpu_y_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size);//, num_inter_thread, thread_id%num_inter_thread);
+        if(!comm_type) params_src->translate.trans_reduce_scatter_cpu_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, reduce_type, num_inter_thread, thread_id%num_inter_thread);
+        else params_src->translate.trans_reduce_scatter_cpu_y_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, reduce_type);//, num_inter_thread, thread_id%num_inter_thread);
         
     }
     return 0;
@@ -2338,6 +3142,7 @@ void *thread_reduce_scatter_24_rns(void *thread_parameter){
     uint32_t communication_buffer_offset=each_thread_comm_parameter->p_communication_buffer_offset;
     uint32_t num_thread=each_thread_comm_parameter->p_num_thread;
     uint32_t size = each_thread_comm_parameter->size;
+    uint32_t reduce_type = each_thread_comm_parameter->reduce_type;
 
     uint32_t dimension = each_thread_comm_parameter->dimension;
     uint32_t* axis_len = each_thread_comm_parameter->axis_len;
@@ -2443,21 +3248,17 @@ void *thread_reduce_scatter_24_rns(void *thread_parameter){
             if(dim == 2) temp_total_product *= (axis_len[0]*axis_len[1]/8);
             else if(dim>2) temp_total_product *= axis_len[dim-1];
 
-            dst_rank_id += iter_dst[dim]*temp_total_product/8;
             dst_rg_id += iter_dst[dim]*temp_total_product;
 
             for(uint32_t j=0; j<total_axis_product; j++){
                 if(comm_axis[dim] == 0){
-                    src_rank_id[j] += iter_src[dim] * temp_total_product/8;
                     src_rg_id[j] += iter_src[dim] * temp_total_product;
                 }
                 else{
                     if(dim == 1){
-                        src_rank_id[j] += (j % (axis_len[0]*axis_len[1]/8) ) * temp_total_product/8;
                         src_rg_id[j] += (j % (axis_len[0]*axis_len[1]/8) ) * temp_total_product;
                     }
                     else if (dim>1){
-                        src_rank_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product/8;
                         src_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
                     }
                 }
@@ -2468,7 +3269,11 @@ void *thread_reduce_scatter_24_rns(void *thread_parameter){
                 else if(dim>1) temp_comm_product *= axis_len[dim];
             }
         }
-        for(uint32_t j=0; j<total_axis_product; j++) src_rg_id[j] = src_rg_id[j] % 8;
+        for(uint32_t j=0; j<total_axis_product; j++){
+            src_rank_id[j] = src_rg_id[j] / 8;
+            src_rg_id[j] = src_rg_id[j] % 8;
+        }
+        dst_rank_id = dst_rg_id / 8;
         dst_rg_id = dst_rg_id % 8;
 
         void* rank_base_address_src[total_axis_product];
@@ -2485,10 +3290,10 @@ void *thread_reduce_scatter_24_rns(void *thread_parameter){
         rank_base_address_dst=params_dst->ptr_region;
 
         if(comm_axis[0] == comm_axis[1]){
-            if(!comm_type) params_src->translate.trans_reduce_scatter_cpu_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, num_inter_thread, thread_id%num_inter_thread);
-            else params_src->translate.trans_reduce_scatter_cpu_y_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size);//, num_inter_thread, thread_id%num_inter_thread);
+            if(!comm_type) params_src->translate.trans_reduce_scatter_cpu_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, reduce_type, num_inter_thread, thread_id%num_inter_thread);
+            else params_src->translate.trans_reduce_scatter_cpu_y_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, reduce_type);//, num_inter_thread, thread_id%num_inter_thread);
         }
-        else params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, axis_len[0], size);
+        else params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, axis_len[0], size, reduce_type);
         
     }
     return 0;
@@ -2505,6 +3310,7 @@ void *thread_reduce_scatter_22_rns(void *thread_parameter){
     uint32_t communication_buffer_offset=each_thread_comm_parameter->p_communication_buffer_offset;
     uint32_t num_thread=each_thread_comm_parameter->p_num_thread;
     uint32_t size = each_thread_comm_parameter->size;
+    uint32_t reduce_type = each_thread_comm_parameter->reduce_type;
 
     uint32_t dimension = each_thread_comm_parameter->dimension;
     uint32_t* axis_len = each_thread_comm_parameter->axis_len;
@@ -2635,21 +3441,17 @@ void *thread_reduce_scatter_22_rns(void *thread_parameter){
             if(dim == 3) temp_total_product *= (4*axis_len[2]/8);
             else if(dim>3) temp_total_product *= axis_len[dim-1];
 
-            dst_rank_id += iter_dst[dim]*temp_total_product/8;
             dst_rg_id += iter_dst[dim]*temp_total_product;
 
             for(uint32_t j=0; j<total_axis_product; j++){
                 if(comm_axis[dim] == 0){
-                    src_rank_id[j] += iter_src[dim] * temp_total_product/8;
                     src_rg_id[j] += iter_src[dim] * temp_total_product;
                 }
                 else{
                     if(dim == 1){
-                        src_rank_id[j] += (j % (4*axis_len[2]/8) ) * temp_total_product/8;
                         src_rg_id[j] += (j % (4*axis_len[2]/8) ) * temp_total_product;
                     }
                     else if (dim>1){
-                        src_rank_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product/8;
                         src_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
                     }
                 }
@@ -2660,7 +3462,11 @@ void *thread_reduce_scatter_22_rns(void *thread_parameter){
                 else if(dim>2) temp_comm_product *= axis_len[dim];
             }
         }
-        for(uint32_t j=0; j<total_axis_product; j++) src_rg_id[j] = src_rg_id[j] % 8;
+        for(uint32_t j=0; j<total_axis_product; j++){
+            src_rank_id[j] = src_rg_id[j] / 8;
+            src_rg_id[j] = src_rg_id[j] % 8;
+        }
+        dst_rank_id = dst_rg_id / 8;
         dst_rg_id = dst_rg_id % 8;
 
         void* rank_base_address_src[total_axis_product];
@@ -2678,22 +3484,22 @@ void *thread_reduce_scatter_22_rns(void *thread_parameter){
 
         if(!comm_type){
             if(comm_axis[1]==1){
-                if(comm_axis[2]==1) params_src->translate.trans_reduce_scatter_cpu_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, num_inter_thread, thread_id%num_inter_thread);
-                else params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 4, size);
+                if(comm_axis[2]==1) params_src->translate.trans_reduce_scatter_cpu_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, reduce_type, num_inter_thread, thread_id%num_inter_thread);
+                else params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 4, size, reduce_type);
             }
             else {
-                if(comm_axis[2]==1) params_src->translate.trans_reduce_scatter_cpu_rg_22(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_axis[0], comm_axis[1], comm_axis[2], communication_buffer_offset, total_axis_product, size);
-                else params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 2, size);
+                if(comm_axis[2]==1) params_src->translate.trans_reduce_scatter_cpu_rg_22(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_axis[0], comm_axis[1], comm_axis[2], communication_buffer_offset, total_axis_product, size, reduce_type);
+                else params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 2, size, reduce_type);
             }
         }
         else{
             if(comm_axis[1]==1){
-                if(comm_axis[2]==1) params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 2, size);
-                else params_src->translate.trans_reduce_scatter_cpu_rg_22(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_axis[0], comm_axis[1], comm_axis[2], communication_buffer_offset, total_axis_product, size);
+                if(comm_axis[2]==1) params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 2, size, reduce_type);
+                else params_src->translate.trans_reduce_scatter_cpu_rg_22(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_axis[0], comm_axis[1], comm_axis[2], communication_buffer_offset, total_axis_product, size, reduce_type);
             }
             else {
-                if(comm_axis[2]==1) params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 4, size);
-                else params_src->translate.trans_reduce_scatter_cpu_y_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size);//, num_inter_thread, thread_id%num_inter_thread);
+                if(comm_axis[2]==1) params_src->translate.trans_reduce_scatter_cpu_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 4, size, reduce_type);
+                else params_src->translate.trans_reduce_scatter_cpu_y_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, reduce_type);//, num_inter_thread, thread_id%num_inter_thread);
             }
         }
     }
@@ -2701,12 +3507,11 @@ void *thread_reduce_scatter_22_rns(void *thread_parameter){
 }
 
 static dpu_rank_status_e
-hw_reduce_scatter_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size){
+hw_reduce_scatter_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size, uint32_t reduce_type){
     
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -2720,14 +3525,13 @@ hw_reduce_scatter_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset,
         thread_params[iter_thread].axis_len=axis_len;
         thread_params[iter_thread].comm_axis=comm_axis;
         thread_params[iter_thread].size = size;
-        
-        if(axis_len[0] >=8) pthread_create(&array_thread[iter_thread], NULL, thread_reduce_scatter_rns, (void *) &thread_params[iter_thread]);
-        else if(axis_len[0]*axis_len[1] >= 8) pthread_create(&array_thread[iter_thread], NULL, thread_reduce_scatter_24_rns, (void *) &thread_params[iter_thread]);
-        else pthread_create(&array_thread[iter_thread], NULL, thread_reduce_scatter_22_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+        thread_params[iter_thread].reduce_type = reduce_type;
     }
+    if(axis_len[0] >=8) thread_fn=thread_reduce_scatter_rns;
+    else if(axis_len[0]*axis_len[1] >= 8) thread_fn=thread_reduce_scatter_24_rns;
+    else thread_fn=thread_reduce_scatter_22_rns;
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     return DPU_RANK_SUCCESS;
 }
 
@@ -2814,6 +3618,7 @@ void *thread_all_reduce_x_rns_24(void *thread_parameter){
     uint32_t alltoall_comm_type=each_thread_all_to_all_x_parameter->p_alltoall_comm_type;
     uint32_t communication_buffer_offset=each_thread_all_to_all_x_parameter->p_communication_buffer_offset;
     uint32_t size = each_thread_all_to_all_x_parameter->size;
+    uint32_t reduce_type = each_thread_all_to_all_x_parameter->reduce_type;
     uint32_t thread_num = each_thread_all_to_all_x_parameter->thread_num;
 
     uint32_t total_iter_num=c*b/(8/a);
@@ -2845,7 +3650,7 @@ void *thread_all_reduce_x_rns_24(void *thread_parameter){
         rank_base_address_dst_array[0]=rank_base_address_src_dst;
         dst_rg_id_array[0]=src_dst_rg_id;
 
-        params_src_dst->translate.trans_all_reduce_rg_24(rank_base_address_src_dst, rank_base_address_dst_array, src_dst_rg_id, dst_rg_id_array, 0, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, alltoall_comm_type, communication_buffer_offset, num_iter_dst, a, size);
+        params_src_dst->translate.trans_all_reduce_rg_24(rank_base_address_src_dst, rank_base_address_dst_array, src_dst_rg_id, dst_rg_id_array, 0, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, alltoall_comm_type, communication_buffer_offset, num_iter_dst, a, size, reduce_type);
     }
     return 0;
 }
@@ -2853,10 +3658,9 @@ void *thread_all_reduce_x_rns_24(void *thread_parameter){
 static dpu_rank_status_e
 hw_all_reduce_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type){
 
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -2871,16 +3675,15 @@ hw_all_reduce_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, u
         thread_params[iter_thread].size = size;
         thread_params[iter_thread].thread_num = thread_num;
         thread_params[iter_thread].reduce_type = reduce_type;
-        if(a>4){
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_reduce_x_rns, (void *) &thread_params[iter_thread]);
-        }
-        else{
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_reduce_x_rns_24, (void *) &thread_params[iter_thread]);
-        }
     }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+    if(a>4){
+        thread_fn=thread_all_reduce_x_rns;
     }
+    else{
+        thread_fn=thread_all_reduce_x_rns_24;
+    }
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     return DPU_RANK_SUCCESS;
 }
 
@@ -2965,6 +3768,7 @@ void *thread_all_reduce_y_rns_24(void *thread_parameter){
     uint32_t alltoall_comm_type=each_thread_all_to_all_x_parameter->p_alltoall_comm_type;
     uint32_t communication_buffer_offset=each_thread_all_to_all_x_parameter->p_communication_buffer_offset;
     uint32_t size = each_thread_all_to_all_x_parameter->size;
+    uint32_t reduce_type = each_thread_all_to_all_x_parameter->reduce_type;
     uint32_t thread_num = each_thread_all_to_all_x_parameter->thread_num;
 
     uint32_t total_iter_num=c;
@@ -2997,7 +3801,7 @@ void *thread_all_reduce_y_rns_24(void *thread_parameter){
             
             src_start_offset_iter = src_start_offset;
             dst_start_offset_iter = dst_start_offset;
-            params_src->translate.trans_all_reduce_rg_24(rank_base_address_src[0], rank_base_address_src, src_rg_id[0], src_rg_id, 0, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, alltoall_comm_type, communication_buffer_offset, num_iter_src, a, size);
+            params_src->translate.trans_all_reduce_rg_24(rank_base_address_src[0], rank_base_address_src, src_rg_id[0], src_rg_id, 0, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, alltoall_comm_type, communication_buffer_offset, num_iter_src, a, size, reduce_type);
         }
     }
     
@@ -3007,10 +3811,9 @@ void *thread_all_reduce_y_rns_24(void *thread_parameter){
 static dpu_rank_status_e
 hw_all_reduce_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t size, uint32_t reduce_type){
 
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -3025,16 +3828,15 @@ hw_all_reduce_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, u
         thread_params[iter_thread].size = size;
         thread_params[iter_thread].thread_num = thread_num;
         thread_params[iter_thread].reduce_type = reduce_type;
-        if(a>4){
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_reduce_y_rns, (void *) &thread_params[iter_thread]);
-        }
-        else{
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_reduce_y_rns_24, (void *) &thread_params[iter_thread]);
-        }
     }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+    if(a>4){
+        thread_fn=thread_all_reduce_y_rns;
     }
+    else{
+        thread_fn=thread_all_reduce_y_rns_24;
+    }
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     return DPU_RANK_SUCCESS;
 }
 
@@ -3144,21 +3946,17 @@ void *thread_all_reduce_rns(void *thread_parameter){
             if(dim == 1) temp_total_product *= (axis_len[0]/8);
             else if(dim>1) temp_total_product *= axis_len[dim-1];
 
-            dst_rank_id += iter_dst[dim]*temp_total_product/8;
             dst_rg_id += iter_dst[dim]*temp_total_product;
 
             for(uint32_t j=0; j<total_axis_product; j++){
                 if(comm_axis[dim] == 0){
-                    src_rank_id[j] += iter_src[dim] * temp_total_product/8;
                     src_rg_id[j] += iter_src[dim] * temp_total_product;
                 }
                 else{
                     if(dim == 0){
-                        src_rank_id[j] += (j % (axis_len[0]/8) ) * temp_total_product/8;
                         src_rg_id[j] += (j % (axis_len[0]/8) ) * temp_total_product;
                     }
                     else{
-                        src_rank_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product/8;
                         src_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
                     }
                 }
@@ -3169,7 +3967,11 @@ void *thread_all_reduce_rns(void *thread_parameter){
                 else if(dim>0) temp_comm_product *= axis_len[dim];
             }
         }
-        for(uint32_t j=0; j<total_axis_product; j++) src_rg_id[j] = src_rg_id[j] % 8;
+        for(uint32_t j=0; j<total_axis_product; j++){
+            src_rank_id[j] = src_rg_id[j] / 8;
+            src_rg_id[j] = src_rg_id[j] % 8;
+        }
+        dst_rank_id = dst_rg_id / 8;
         dst_rg_id = dst_rg_id % 8;
 
         void* rank_base_address_src[total_axis_product];
@@ -3310,21 +4112,17 @@ void *thread_all_reduce_rns_24(void *thread_parameter){
             if(dim == 2) temp_total_product *= (axis_len[0]*axis_len[1]/8);
             else if(dim>2) temp_total_product *= axis_len[dim-1];
 
-            dst_rank_id += iter_dst[dim]*temp_total_product/8;
             dst_rg_id += iter_dst[dim]*temp_total_product;
 
             for(uint32_t j=0; j<total_axis_product; j++){
                 if(comm_axis[dim] == 0){
-                    src_rank_id[j] += iter_src[dim] * temp_total_product/8;
                     src_rg_id[j] += iter_src[dim] * temp_total_product;
                 }
                 else{
                     if(dim == 1){
-                        src_rank_id[j] += (j % (axis_len[0]*axis_len[1]/8) ) * temp_total_product/8;
                         src_rg_id[j] += (j % (axis_len[0]*axis_len[1]/8) ) * temp_total_product;
                     }
                     else if (dim>1){
-                        src_rank_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product/8;
                         src_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
                     }
                 }
@@ -3335,7 +4133,11 @@ void *thread_all_reduce_rns_24(void *thread_parameter){
                 else if(dim>1) temp_comm_product *= axis_len[dim];
             }
         }
-        for(uint32_t j=0; j<total_axis_product; j++) src_rg_id[j] = src_rg_id[j] % 8;
+        for(uint32_t j=0; j<total_axis_product; j++){
+            src_rank_id[j] = src_rg_id[j] / 8;
+            src_rg_id[j] = src_rg_id[j] % 8;
+        }
+        dst_rank_id = dst_rg_id / 8;
         dst_rg_id = dst_rg_id % 8;
 
         void* rank_base_address_src[total_axis_product];
@@ -3355,7 +4157,7 @@ void *thread_all_reduce_rns_24(void *thread_parameter){
             if(!comm_type) params_src->translate.trans_all_reduce_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, reduce_type, num_inter_thread, thread_id%num_inter_thread);
             else params_src->translate.trans_all_reduce_y_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, reduce_type);//, num_inter_thread, thread_id%num_inter_thread);
         }
-        else params_src->translate.trans_all_reduce_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, axis_len[0], size);
+        else params_src->translate.trans_all_reduce_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, axis_len[0], size, reduce_type);
     }
     return 0;
 }
@@ -3503,21 +4305,17 @@ void *thread_all_reduce_rns_22(void *thread_parameter){
             if(dim == 3) temp_total_product *= (4*axis_len[2]/8);
             else if(dim>3) temp_total_product *= axis_len[dim-1];
 
-            dst_rank_id += iter_dst[dim]*temp_total_product/8;
             dst_rg_id += iter_dst[dim]*temp_total_product;
 
             for(uint32_t j=0; j<total_axis_product; j++){
                 if(comm_axis[dim] == 0){
-                    src_rank_id[j] += iter_src[dim] * temp_total_product/8;
                     src_rg_id[j] += iter_src[dim] * temp_total_product;
                 }
                 else{
                     if(dim == 1){
-                        src_rank_id[j] += (j % (4*axis_len[2]/8) ) * temp_total_product/8;
                         src_rg_id[j] += (j % (4*axis_len[2]/8) ) * temp_total_product;
                     }
                     else if (dim>1){
-                        src_rank_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product/8;
                         src_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
                     }
                 }
@@ -3528,7 +4326,11 @@ void *thread_all_reduce_rns_22(void *thread_parameter){
                 else if(dim>2) temp_comm_product *= axis_len[dim];
             }
         }
-        for(uint32_t j=0; j<total_axis_product; j++) src_rg_id[j] = src_rg_id[j] % 8;
+        for(uint32_t j=0; j<total_axis_product; j++){
+            src_rank_id[j] = src_rg_id[j] / 8;
+            src_rg_id[j] = src_rg_id[j] % 8;
+        }
+        dst_rank_id = dst_rg_id / 8;
         dst_rg_id = dst_rg_id % 8;
 
         void* rank_base_address_src[total_axis_product];
@@ -3547,20 +4349,20 @@ void *thread_all_reduce_rns_22(void *thread_parameter){
         if(!comm_type){
             if(comm_axis[1]==1){
                 if(comm_axis[2]==1) params_src->translate.trans_all_reduce_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, reduce_type, num_inter_thread, thread_id%num_inter_thread);
-                else params_src->translate.trans_all_reduce_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 4, size);
+                else params_src->translate.trans_all_reduce_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 4, size, reduce_type);
             }
             else {
-                if(comm_axis[2]==1) params_src->translate.trans_all_reduce_rg_22(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_axis[0], comm_axis[1], comm_axis[2], communication_buffer_offset, total_axis_product, size);
-                else params_src->translate.trans_all_reduce_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 2, size);
+                if(comm_axis[2]==1) params_src->translate.trans_all_reduce_rg_22(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_axis[0], comm_axis[1], comm_axis[2], communication_buffer_offset, total_axis_product, size, reduce_type);
+                else params_src->translate.trans_all_reduce_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 2, size, reduce_type);
             }
         }
         else{
             if(comm_axis[1]==1){
-                if(comm_axis[2]==1) params_src->translate.trans_all_reduce_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 2, size);
-                else params_src->translate.trans_all_reduce_rg_22(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_axis[0], comm_axis[1], comm_axis[2], communication_buffer_offset, total_axis_product, size);
+                if(comm_axis[2]==1) params_src->translate.trans_all_reduce_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 2, size, reduce_type);
+                else params_src->translate.trans_all_reduce_rg_22(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_axis[0], comm_axis[1], comm_axis[2], communication_buffer_offset, total_axis_product, size, reduce_type);
             }
             else {
-                if(comm_axis[2]==1) params_src->translate.trans_all_reduce_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 4, size);
+                if(comm_axis[2]==1) params_src->translate.trans_all_reduce_rg_24(rank_base_address_dst, rank_base_address_src, dst_rg_id, src_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, comm_type, communication_buffer_offset, total_axis_product, 4, size, reduce_type);
                 else params_src->translate.trans_all_reduce_y_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, cur_remain / total_axis_product, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, size, reduce_type);//, num_inter_thread, thread_id%num_inter_thread);
             }
         }
@@ -3572,10 +4374,9 @@ void *thread_all_reduce_rns_22(void *thread_parameter){
 static dpu_rank_status_e
 hw_all_reduce_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size, uint32_t reduce_type){
     
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -3590,14 +4391,189 @@ hw_all_reduce_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uin
         thread_params[iter_thread].comm_axis=comm_axis;
         thread_params[iter_thread].size = size;
         thread_params[iter_thread].reduce_type = reduce_type;
+    }
+    if(axis_len[0] >=8) thread_fn=thread_all_reduce_rns;
+    else if(axis_len[0]*axis_len[1] >= 8) thread_fn=thread_all_reduce_rns_24;
+    else thread_fn=thread_all_reduce_rns_22;
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
+    return DPU_RANK_SUCCESS;
+}
+
+//gather along any subset of the axes, filling the host buffers in the order thread_scatter_rns reads them
+void *thread_gather_rns(void *thread_parameter){
+    st_thread_parameter *each_thread_comm_parameter = (st_thread_parameter *)thread_parameter;
+    uint32_t thread_id = each_thread_comm_parameter->p_thread_id;
+    struct dpu_set_t *comm_dpu_set=each_thread_comm_parameter->p_comm_dpu_set;
+    uint32_t src_start_offset=each_thread_comm_parameter->p_src_start_offset;
+    uint32_t dst_start_offset=each_thread_comm_parameter->p_dst_start_offset;
+    uint32_t dpu_byte_length=each_thread_comm_parameter->p_dpu_byte_length;
+    uint32_t comm_type=each_thread_comm_parameter->p_comm_type;
+    uint32_t communication_buffer_offset=each_thread_comm_parameter->p_communication_buffer_offset;
+    uint32_t num_thread=each_thread_comm_parameter->p_num_thread;
+
+    void** host_buffer = each_thread_comm_parameter->p_host_buffer;
+
+    uint32_t dimension = each_thread_comm_parameter->dimension;
+    uint32_t* axis_len = each_thread_comm_parameter->axis_len;
+    uint32_t* comm_axis = each_thread_comm_parameter->comm_axis;
+
+    uint32_t num_inter_thread = 1;
+
+    uint32_t total_iter_num=1;
+    uint32_t total_axis_product=1;
+
+    for(uint32_t dim=0; dim<dimension; dim++){
+        total_iter_num *= axis_len[dim];
+        if(comm_axis[dim] == 1) {
+            total_axis_product *= axis_len[dim];
+        }
+    }
+    if(comm_type == 0) total_axis_product /= 8;
+
+    total_iter_num /=8;
+
+    uint32_t share=total_iter_num/(num_thread/num_inter_thread);
+    uint32_t remainder=total_iter_num%(num_thread/num_inter_thread);
+    uint32_t remain_iter=0;
+    uint32_t start_point = share*(thread_id/num_inter_thread);
+    uint32_t src_start_offset_iter, dst_start_offset_iter;
+
+    if((thread_id/num_inter_thread)<remainder){
+        remain_iter=1;
+        start_point+=(thread_id/num_inter_thread);
+    }
+    else{
+        start_point+=remainder;
+    }
+
+    uint32_t* iter_src = calloc(dimension, sizeof(uint32_t));
+    uint32_t* iter_dst = calloc(dimension, sizeof(uint32_t));
+    uint32_t cur_iter_num, cur_remain, cur_iter_src, cur_iter_dst;
+
+    for(uint32_t i=start_point; i<(start_point+(share+remain_iter)); i++){
+
+        cur_iter_num = total_iter_num*total_axis_product;
+        cur_remain = i * total_axis_product;
+        for(int dim = (int)dimension-1; dim>=0; dim--){
+            if(comm_axis[dim] == 0){
+                if(dim == 0) cur_iter_num /= (axis_len[0]/8);
+                else cur_iter_num/=axis_len[dim];
+                iter_src[dim] = cur_remain / cur_iter_num;
+                iter_dst[dim] = cur_remain / cur_iter_num;
+                cur_remain -= iter_src[dim] * cur_iter_num;
+            }
+        }
+
+        cur_iter_src = cur_remain % total_axis_product;
+        cur_iter_dst = cur_remain / total_axis_product;
+
+        if(!comm_type){
+            src_start_offset_iter = src_start_offset;
+            dst_start_offset_iter = dst_start_offset;
+        }
+        else{
+            src_start_offset_iter = src_start_offset + cur_iter_dst * 1 * dpu_byte_length;
+            dst_start_offset_iter = dst_start_offset + cur_iter_src * 1 * dpu_byte_length;
+        }
+
+        for(uint32_t dim = 0; dim<dimension; dim++){
+            if(comm_axis[dim] == 1){
+                if(dim==0){
+                    iter_src[dim] = cur_iter_src % (axis_len[dim]/8);
+                    iter_dst[dim] = cur_iter_dst % (axis_len[dim]/8);
+                    cur_iter_src = cur_iter_src / (axis_len[dim]/8);
+                    cur_iter_dst = cur_iter_dst / (axis_len[dim]/8);
+                }
+                else{
+                    iter_src[dim] = cur_iter_src % axis_len[dim];
+                    iter_dst[dim] = cur_iter_dst % axis_len[dim];
+                    cur_iter_src = cur_iter_src / axis_len[dim];
+                    cur_iter_dst = cur_iter_dst / axis_len[dim];
+                }
+            }
+        }
+
+        uint32_t* src_rank_id = calloc(total_axis_product, sizeof(uint32_t)); 
+        uint32_t dst_rank_id=0; 
+        uint32_t* src_rg_id = calloc(total_axis_product, sizeof(uint32_t)); 
+        uint32_t dst_rg_id=0;
+        uint32_t temp_total_product = 1;
+        uint32_t temp_comm_product = 1;
+        for(uint32_t dim=0; dim < dimension; dim++){
+
+            if(dim == 1) temp_total_product *= (axis_len[0]/8);
+            else if(dim>1) temp_total_product *= axis_len[dim-1];
+
+            dst_rg_id += iter_dst[dim]*temp_total_product;
+
+            for(uint32_t j=0; j<total_axis_product; j++){
+                if(comm_axis[dim] == 0){
+                    src_rg_id[j] += iter_src[dim] * temp_total_product;
+                }
+                else{
+                    if(dim == 0){
+                        src_rg_id[j] += (j % (axis_len[0]/8) ) * temp_total_product;
+                    }
+                    else{
+                        src_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
+                    }
+                }
+            }
+
+            if(comm_axis[dim] == 1){
+                if(dim == 0) temp_comm_product *= (axis_len[0]/8);
+                else if(dim>0) temp_comm_product *= axis_len[dim];
+            }
+        }
+        for(uint32_t j=0; j<total_axis_product; j++){
+            src_rank_id[j] = src_rg_id[j] / 8;
+            src_rg_id[j] = src_rg_id[j] % 8;
+        }
+        dst_rank_id = dst_rg_id / 8;
+        dst_rg_id = dst_rg_id % 8;
+
+        void* rank_base_address_src[total_axis_product];
+        uint8_t* rank_base_address_dst;
+        hw_dpu_rank_allocation_parameters_t params_src;
+        hw_dpu_rank_allocation_parameters_t params_dst;
+
+        for(uint32_t j=0; j<total_axis_product; j++){
+            params_src = _this_params(comm_dpu_set->list.ranks[src_rank_id[j]] ->description);
+            rank_base_address_src[j] = params_src->ptr_region;
+        }
+        params_src  = _this_params(comm_dpu_set->list.ranks[src_rank_id[0]] ->description);
+        params_dst = _this_params(comm_dpu_set->list.ranks[dst_rank_id] ->description);
+        rank_base_address_dst=params_dst->ptr_region;
+
+        params_src->translate.trans_gather_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_axis_product, comm_type, communication_buffer_offset, host_buffer, i);
         
-        if(axis_len[0] >=8) pthread_create(&array_thread[iter_thread], NULL, thread_all_reduce_rns, (void *) &thread_params[iter_thread]);
-        else if(axis_len[0]*axis_len[1] >= 8) pthread_create(&array_thread[iter_thread], NULL, thread_all_reduce_rns_24, (void *) &thread_params[iter_thread]);
-        else pthread_create(&array_thread[iter_thread], NULL, thread_all_reduce_rns_22, (void *) &thread_params[iter_thread]);
     }
+    return 0;
+}
+
+static dpu_rank_status_e
+hw_gather_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, void ** host_buffer){
+
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
+    st_thread_parameter thread_params[thread_num];
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+        thread_params[iter_thread].p_thread_id=iter_thread;
+        thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
+        thread_params[iter_thread].p_src_start_offset=src_start_offset;
+        thread_params[iter_thread].p_dst_start_offset=dst_start_offset;
+        thread_params[iter_thread].p_dpu_byte_length=dpu_byte_length;
+        thread_params[iter_thread].p_comm_type = comm_type;
+        thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
+        thread_params[iter_thread].p_num_thread=thread_num;
+        thread_params[iter_thread].dimension=dimension;
+        thread_params[iter_thread].axis_len=axis_len;
+        thread_params[iter_thread].comm_axis=comm_axis;
+        thread_params[iter_thread].p_host_buffer=host_buffer;
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_gather_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
+    
     return DPU_RANK_SUCCESS;
 }
 
@@ -3665,10 +4641,8 @@ void *thread_gather_x_rns(void *thread_parameter){
 static dpu_rank_status_e
 hw_gather_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void ** host_buffer){
     
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -3682,11 +4656,9 @@ hw_gather_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint3
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_host_buffer=host_buffer;
         thread_params[iter_thread].p_num_thread=thread_num;
-        pthread_create(&array_thread[iter_thread], NULL, thread_gather_x_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_gather_x_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     
     return DPU_RANK_SUCCESS;
 }
@@ -3762,10 +4734,8 @@ void *thread_gather_y_rns(void *thread_parameter){
 static dpu_rank_status_e
 hw_gather_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void **host_buffer){
 
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -3779,11 +4749,9 @@ hw_gather_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint3
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_host_buffer=(void **)host_buffer;
         thread_params[iter_thread].p_num_thread=thread_num;
-        pthread_create(&array_thread[iter_thread], NULL, thread_gather_y_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_gather_y_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     
     return DPU_RANK_SUCCESS;
 }
@@ -3870,10 +4838,8 @@ void *thread_gather_z_rns(void *thread_parameter){
 static dpu_rank_status_e
 hw_gather_z_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t target_dpu_index, void **host_buffer){
 
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -3888,11 +4854,9 @@ hw_gather_z_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint3
         thread_params[iter_thread].p_host_buffer=(void **)host_buffer;
         thread_params[iter_thread].p_target_dpu_index=target_dpu_index;
         thread_params[iter_thread].p_num_thread=thread_num;
-        pthread_create(&array_thread[iter_thread], NULL, thread_gather_z_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_gather_z_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
 
     return DPU_RANK_SUCCESS;
 }
@@ -3980,10 +4944,8 @@ void *thread_gather_xz_rns(void *thread_parameter){
 static dpu_rank_status_e
 hw_gather_xz_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, uint32_t target_dpu_index, void **host_buffer){
 
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -3998,11 +4960,9 @@ hw_gather_xz_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint
         thread_params[iter_thread].p_host_buffer=(void **)host_buffer;
         thread_params[iter_thread].p_target_dpu_index=target_dpu_index;
         thread_params[iter_thread].p_num_thread=thread_num;
-        pthread_create(&array_thread[iter_thread], NULL, thread_gather_xz_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_gather_xz_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
 
     return DPU_RANK_SUCCESS;
 }
@@ -4069,10 +5029,8 @@ void *thread_scatter_x_rns(void *thread_parameter){
 static dpu_rank_status_e
 hw_scatter_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void ** host_buffer){
 
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -4086,11 +5044,9 @@ hw_scatter_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_host_buffer=host_buffer;
         thread_params[iter_thread].p_num_thread=thread_num;
-        pthread_create(&array_thread[iter_thread], NULL, thread_scatter_x_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_scatter_x_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     
     return DPU_RANK_SUCCESS;
 }
@@ -4166,10 +5122,8 @@ void *thread_scatter_y_rns(void *thread_parameter){
 static dpu_rank_status_e
 hw_scatter_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset, void **host_buffer){
 
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -4183,11 +5137,9 @@ hw_scatter_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_host_buffer=(void **)host_buffer;
         thread_params[iter_thread].p_num_thread=thread_num;
-        pthread_create(&array_thread[iter_thread], NULL, thread_scatter_y_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_scatter_y_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     
     return DPU_RANK_SUCCESS;
 }
@@ -4296,21 +5248,17 @@ void *thread_scatter_rns(void *thread_parameter){
             if(dim == 1) temp_total_product *= (axis_len[0]/8);
             else if(dim>1) temp_total_product *= axis_len[dim-1];
 
-            dst_rank_id += iter_dst[dim]*temp_total_product/8;
             dst_rg_id += iter_dst[dim]*temp_total_product;
 
             for(uint32_t j=0; j<total_axis_product; j++){
                 if(comm_axis[dim] == 0){
-                    src_rank_id[j] += iter_src[dim] * temp_total_product/8;
                     src_rg_id[j] += iter_src[dim] * temp_total_product;
                 }
                 else{
                     if(dim == 0){
-                        src_rank_id[j] += (j % (axis_len[0]/8) ) * temp_total_product/8;
                         src_rg_id[j] += (j % (axis_len[0]/8) ) * temp_total_product;
                     }
                     else{
-                        src_rank_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product/8;
                         src_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
                     }
                 }
@@ -4321,7 +5269,11 @@ void *thread_scatter_rns(void *thread_parameter){
                 else if(dim>0) temp_comm_product *= axis_len[dim];
             }
         }
-        for(uint32_t j=0; j<total_axis_product; j++) src_rg_id[j] = src_rg_id[j] % 8;
+        for(uint32_t j=0; j<total_axis_product; j++){
+            src_rank_id[j] = src_rg_id[j] / 8;
+            src_rg_id[j] = src_rg_id[j] % 8;
+        }
+        dst_rank_id = dst_rg_id / 8;
         dst_rg_id = dst_rg_id % 8;
 
         void* rank_base_address_src[total_axis_product];
@@ -4346,10 +5298,8 @@ void *thread_scatter_rns(void *thread_parameter){
 static dpu_rank_status_e
 hw_scatter_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, void ** host_buffer){
 
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -4363,11 +5313,9 @@ hw_scatter_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32
         thread_params[iter_thread].axis_len=axis_len;
         thread_params[iter_thread].comm_axis=comm_axis;
         thread_params[iter_thread].p_host_buffer=host_buffer;
-        pthread_create(&array_thread[iter_thread], NULL, thread_scatter_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_scatter_rns, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     
     return DPU_RANK_SUCCESS;
 }
@@ -4384,6 +5332,7 @@ void *thread_reduce_rns(void *thread_parameter){
     uint32_t communication_buffer_offset=each_thread_comm_parameter->p_communication_buffer_offset;
     uint32_t num_thread=each_thread_comm_parameter->p_num_thread;
     uint32_t size = each_thread_comm_parameter->size;
+    uint32_t reduce_type = each_thread_comm_parameter->reduce_type;
 
     void **host_buffer=each_thread_comm_parameter->p_host_buffer;
 
@@ -4479,21 +5428,17 @@ void *thread_reduce_rns(void *thread_parameter){
             if(dim == 1) temp_total_product *= (axis_len[0]/8);
             else if(dim>1) temp_total_product *= axis_len[dim-1];
 
-            dst_rank_id += iter_dst[dim]*temp_total_product/8;
             dst_rg_id += iter_dst[dim]*temp_total_product;
 
             for(uint32_t j=0; j<total_axis_product; j++){
                 if(comm_axis[dim] == 0){
-                    src_rank_id[j] += iter_src[dim] * temp_total_product/8;
                     src_rg_id[j] += iter_src[dim] * temp_total_product;
                 }
                 else{
                     if(dim == 0){
-                        src_rank_id[j] += (j % (axis_len[0]/8) ) * temp_total_product/8;
                         src_rg_id[j] += (j % (axis_len[0]/8) ) * temp_total_product;
                     }
                     else{
-                        src_rank_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product/8;
                         src_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
                     }
                 }
@@ -4504,7 +5449,11 @@ void *thread_reduce_rns(void *thread_parameter){
                 else if(dim>0) temp_comm_product *= axis_len[dim];
             }
         }
-        for(uint32_t j=0; j<total_axis_product; j++) src_rg_id[j] = src_rg_id[j] % 8;
+        for(uint32_t j=0; j<total_axis_product; j++){
+            src_rank_id[j] = src_rg_id[j] / 8;
+            src_rg_id[j] = src_rg_id[j] % 8;
+        }
+        dst_rank_id = dst_rg_id / 8;
         dst_rg_id = dst_rg_id % 8;
 
         void* rank_base_address_src[total_axis_product];
@@ -4521,19 +5470,18 @@ void *thread_reduce_rns(void *thread_parameter){
         rank_base_address_dst=params_dst->ptr_region;
 
 
-        params_src->translate.trans_reduce_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_length, total_axis_product, comm_type, communication_buffer_offset, host_buffer, i, size);
+        params_src->translate.trans_reduce_rg(rank_base_address_src, rank_base_address_dst, src_rg_id, dst_rg_id, src_start_offset_iter, dst_start_offset_iter, dpu_byte_length, total_length, total_axis_product, comm_type, communication_buffer_offset, host_buffer, i, size, reduce_type);
 
     }
     return 0;
 }
 
 static dpu_rank_status_e
-hw_reduce_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t total_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size, void ** host_buffer){
+hw_reduce_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t total_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis, uint32_t size, uint32_t reduce_type, void ** host_buffer){
     
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -4548,13 +5496,12 @@ hw_reduce_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_
         thread_params[iter_thread].axis_len=axis_len;
         thread_params[iter_thread].comm_axis=comm_axis;
         thread_params[iter_thread].size = size;
+        thread_params[iter_thread].reduce_type = reduce_type;
         thread_params[iter_thread].p_host_buffer = host_buffer;
-        
-        if(axis_len[0] >=8) pthread_create(&array_thread[iter_thread], NULL, thread_reduce_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    if(axis_len[0] >=8) thread_fn=thread_reduce_rns;
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     return DPU_RANK_SUCCESS;
 }
 
@@ -4693,11 +5640,10 @@ void *thread_all_gather_x_rns_24(void *thread_parameter){
 static dpu_rank_status_e
 hw_all_gather_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset){
 
-    uint32_t num_thread=32;
+    uint32_t num_thread=comm_pool_acquire(comm_dpu_set);
 
-    st_thread_all_to_all_x_parameter thread_params[32];
-    int status;
-    pthread_t array_thread[32];
+    st_thread_all_to_all_x_parameter thread_params[num_thread];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<num_thread; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -4710,16 +5656,15 @@ hw_all_gather_x_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, u
         thread_params[iter_thread].p_alltoall_comm_type=alltoall_comm_type;
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_num_thread=num_thread;
-        if(a>4){
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_gather_x_rns, (void *) &thread_params[iter_thread]);
-        }
-        else{
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_gather_x_rns_24, (void *) &thread_params[iter_thread]);
-        }
     }
-    for(uint32_t iter_thread=0; iter_thread<num_thread; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+    if(a>4){
+        thread_fn=thread_all_gather_x_rns;
+    }
+    else{
+        thread_fn=thread_all_gather_x_rns_24;
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), num_thread);
+    comm_pool_release();
 
     return DPU_RANK_SUCCESS;
 }
@@ -4874,10 +5819,9 @@ void *thread_all_gather_y_rns_24(void *thread_parameter){
 static dpu_rank_status_e
 hw_all_gather_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset){
 
-    uint32_t num_thread=32;
+    uint32_t num_thread=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[num_thread];
-    int status;
-    pthread_t array_thread[num_thread];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<num_thread; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -4890,16 +5834,15 @@ hw_all_gather_y_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, u
         thread_params[iter_thread].p_alltoall_comm_type=alltoall_comm_type;
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_num_thread=num_thread;
-        if(a>4){
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_gather_y_rns, (void *) &thread_params[iter_thread]);
-        }
-        else{
-            pthread_create(&array_thread[iter_thread], NULL, thread_all_gather_y_rns_24, (void *) &thread_params[iter_thread]);
-        }
     }
-    for(uint32_t iter_thread=0; iter_thread<num_thread; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
+    if(a>4){
+        thread_fn=thread_all_gather_y_rns;
+    }
+    else{
+        thread_fn=thread_all_gather_y_rns_24;
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), num_thread);
+    comm_pool_release();
 
     return DPU_RANK_SUCCESS;
 }
@@ -4973,10 +5916,8 @@ void *thread_all_gather_z_rns(void *thread_parameter){
 static dpu_rank_status_e
 hw_all_gather_z_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset){
 
-    uint32_t num_thread=32;
+    uint32_t num_thread=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[num_thread];
-    int status;
-    pthread_t array_thread[num_thread];
     for(uint32_t iter_thread=0; iter_thread<num_thread; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -4989,11 +5930,9 @@ hw_all_gather_z_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, u
         thread_params[iter_thread].p_alltoall_comm_type=alltoall_comm_type;
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_num_thread=num_thread;
-        pthread_create(&array_thread[iter_thread], NULL, thread_all_gather_z_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<num_thread; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_all_gather_z_rns, thread_params, sizeof(thread_params[0]), num_thread);
+    comm_pool_release();
 
     return DPU_RANK_SUCCESS;
 }
@@ -5071,10 +6010,8 @@ void *thread_all_gather_xz_rns(void *thread_parameter){
 static dpu_rank_status_e
 hw_all_gather_xz_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t a, uint32_t b, uint32_t c, uint32_t alltoall_comm_type, uint32_t communication_buffer_offset){
 
-    uint32_t num_thread=32;
+    uint32_t num_thread=comm_pool_acquire(comm_dpu_set);
     st_thread_all_to_all_x_parameter thread_params[num_thread];
-    int status;
-    pthread_t array_thread[num_thread];
     for(uint32_t iter_thread=0; iter_thread<num_thread; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -5087,11 +6024,9 @@ hw_all_gather_xz_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset,
         thread_params[iter_thread].p_alltoall_comm_type=alltoall_comm_type;
         thread_params[iter_thread].p_communication_buffer_offset=communication_buffer_offset;
         thread_params[iter_thread].p_num_thread=num_thread;
-        pthread_create(&array_thread[iter_thread], NULL, thread_all_gather_xz_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<num_thread; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    comm_pool_do_jobs(comm_dpu_set, thread_all_gather_xz_rns, thread_params, sizeof(thread_params[0]), num_thread);
+    comm_pool_release();
     return DPU_RANK_SUCCESS;
 }
 
@@ -5199,21 +6134,17 @@ void *thread_all_gather_rns(void *thread_parameter){
             if(dim == 1) temp_total_product *= (axis_len[0]/8);
             else if(dim>1) temp_total_product *= axis_len[dim-1];
 
-            src_rank_id += iter_src[dim]*temp_total_product/8;
             src_rg_id += iter_src[dim]*temp_total_product;
 
             for(uint32_t j=0; j<total_axis_product; j++){
                 if(comm_axis[dim] == 0){
-                    dst_rank_id[j] += iter_dst[dim] * temp_total_product/8;
                     dst_rg_id[j] += iter_dst[dim] * temp_total_product;
                 }
                 else{
                     if(dim == 0){
-                        dst_rank_id[j] += (j % (axis_len[0]/8) ) * temp_total_product/8;
                         dst_rg_id[j] += (j % (axis_len[0]/8) ) * temp_total_product;
                     }
                     else{
-                        dst_rank_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product/8;
                         dst_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
                     }
                 }
@@ -5224,7 +6155,11 @@ void *thread_all_gather_rns(void *thread_parameter){
                 else if(dim>0) temp_comm_product *= axis_len[dim];
             }
         }
-        for(uint32_t j=0; j<total_axis_product; j++) dst_rg_id[j] = dst_rg_id[j] % 8;
+        for(uint32_t j=0; j<total_axis_product; j++){
+            dst_rank_id[j] = dst_rg_id[j] / 8;
+            dst_rg_id[j] = dst_rg_id[j] % 8;
+        }
+        src_rank_id = src_rg_id / 8;
         src_rg_id = src_rg_id % 8;
 
         void* rank_base_address_dst[total_axis_product];
@@ -5361,21 +6296,17 @@ void *thread_all_gather_24_rns(void *thread_parameter){
             if(dim == 2) temp_total_product *= (axis_len[0]*axis_len[1]/8);
             else if(dim>2) temp_total_product *= axis_len[dim-1];
 
-            src_rank_id += iter_src[dim]*temp_total_product/8;
             src_rg_id += iter_src[dim]*temp_total_product;
 
             for(uint32_t j=0; j<total_axis_product; j++){
                 if(comm_axis[dim] == 0){
-                    dst_rank_id[j] += iter_dst[dim] * temp_total_product/8;
                     dst_rg_id[j] += iter_dst[dim] * temp_total_product;
                 }
                 else{
                     if(dim == 1){
-                        dst_rank_id[j] += (j % (axis_len[0]*axis_len[1]/8) ) * temp_total_product/8;
                         dst_rg_id[j] += (j % (axis_len[0]*axis_len[1]/8) ) * temp_total_product;
                     }
                     else if (dim>1){
-                        dst_rank_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product/8;
                         dst_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
                     }
                 }
@@ -5386,7 +6317,11 @@ void *thread_all_gather_24_rns(void *thread_parameter){
                 else if(dim>1) temp_comm_product *= axis_len[dim];
             }
         }
-        for(uint32_t j=0; j<total_axis_product; j++) dst_rg_id[j] = dst_rg_id[j] % 8;
+        for(uint32_t j=0; j<total_axis_product; j++){
+            dst_rank_id[j] = dst_rg_id[j] / 8;
+            dst_rg_id[j] = dst_rg_id[j] % 8;
+        }
+        src_rank_id = src_rg_id / 8;
         src_rg_id = src_rg_id % 8;
 
         void* rank_base_address_dst[total_axis_product];
@@ -5548,21 +6483,17 @@ void *thread_all_gather_22_rns(void *thread_parameter){
             if(dim == 3) temp_total_product *= (4*axis_len[2]/8);
             else if(dim>3) temp_total_product *= axis_len[dim-1];
 
-            src_rank_id += iter_src[dim]*temp_total_product/8;
             src_rg_id += iter_src[dim]*temp_total_product;
 
             for(uint32_t j=0; j<total_axis_product; j++){
                 if(comm_axis[dim] == 0){
-                    dst_rank_id[j] += iter_dst[dim] * temp_total_product/8;
                     dst_rg_id[j] += iter_dst[dim] * temp_total_product;
                 }
                 else{
                     if(dim == 2){
-                        dst_rank_id[j] += (j % (4*axis_len[2]/8) ) * temp_total_product/8;
                         dst_rg_id[j] += (j % (4*axis_len[2]/8) ) * temp_total_product;
                     }
                     else if (dim>2){
-                        dst_rank_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product/8;
                         dst_rg_id[j] += ((j/temp_comm_product) % axis_len[dim]) * temp_total_product;
                     }
                 }
@@ -5573,7 +6504,11 @@ void *thread_all_gather_22_rns(void *thread_parameter){
                 else if(dim>2) temp_comm_product *= axis_len[dim];
             }
         }
-        for(uint32_t j=0; j<total_axis_product; j++) dst_rg_id[j] = dst_rg_id[j] % 8;
+        for(uint32_t j=0; j<total_axis_product; j++){
+            dst_rank_id[j] = dst_rg_id[j] / 8;
+            dst_rg_id[j] = dst_rg_id[j] % 8;
+        }
+        src_rank_id = src_rg_id / 8;
         src_rg_id = src_rg_id % 8;
 
         void* rank_base_address_dst[total_axis_product];
@@ -5618,10 +6553,9 @@ void *thread_all_gather_22_rns(void *thread_parameter){
 static dpu_rank_status_e
 hw_all_gather_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uint32_t dst_start_offset, uint32_t dpu_byte_length, uint32_t comm_type, uint32_t communication_buffer_offset, uint32_t dimension, uint32_t* axis_len, uint32_t* comm_axis){
     
-    uint32_t thread_num=32;
+    uint32_t thread_num=comm_pool_acquire(comm_dpu_set);
     st_thread_parameter thread_params[thread_num];
-    int status;
-    pthread_t array_thread[thread_num];
+    comm_pool_job_t thread_fn=NULL;
     for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
         thread_params[iter_thread].p_thread_id=iter_thread;
         thread_params[iter_thread].p_comm_dpu_set=comm_dpu_set;
@@ -5634,14 +6568,12 @@ hw_all_gather_rns(struct dpu_set_t *comm_dpu_set, uint32_t src_start_offset, uin
         thread_params[iter_thread].dimension=dimension;
         thread_params[iter_thread].axis_len=axis_len;
         thread_params[iter_thread].comm_axis=comm_axis;
-        
-        if(axis_len[0] >=8) pthread_create(&array_thread[iter_thread], NULL, thread_all_gather_rns, (void *) &thread_params[iter_thread]);
-        else if(axis_len[0]*axis_len[1] >= 8) pthread_create(&array_thread[iter_thread], NULL, thread_all_gather_24_rns, (void *) &thread_params[iter_thread]);
-        else pthread_create(&array_thread[iter_thread], NULL, thread_all_gather_22_rns, (void *) &thread_params[iter_thread]);
-    }
-    for(uint32_t iter_thread=0; iter_thread<thread_num; iter_thread++){
-        pthread_join(array_thread[iter_thread], (void **)&status);
     }
+    if(axis_len[0] >=8) thread_fn=thread_all_gather_rns;
+    else if(axis_len[0]*axis_len[1] >= 8) thread_fn=thread_all_gather_24_rns;
+    else thread_fn=thread_all_gather_22_rns;
+    comm_pool_do_jobs(comm_dpu_set, thread_fn, thread_params, sizeof(thread_params[0]), thread_num);
+    comm_pool_release();
     return DPU_RANK_SUCCESS;
 }
 
@@ -5772,6 +6704,16 @@ hw_fill_description_from_profile(dpu_properties_t properties, dpu_description_t
             DPU_XFER_THREAD_CONF_DEFAULT));
         parameters->translate.xfer_thread_conf = xfer_thread_conf;
     }
+    validate(fetch_integer_property(properties,
+        DPU_PROFILE_PROPERTY_NR_THREAD_PER_COMM_POOL,
+        &parameters->comm_pool_nb_threads,
+        DEFAULT_NB_THREAD_PER_COMM_POOL));
+    validate(fetch_integer_property(properties,
+        DPU_PROFILE_PROPERTY_NR_TASK_PER_COMM_THREAD,
+        &parameters->comm_pool_nb_tasks_per_thread,
+        DEFAULT_NB_TASK_PER_COMM_THREAD));
+    validate(fetch_boolean_property(
+        properties, DPU_PROFILE_PROPERTY_COMM_WORK_STEALING, &parameters->comm_pool_work_stealing, true));
 
     validate(fetch_boolean_property(properties, DPU_PROFILE_PROPERTY_MRAM_ACCESS_BY_DPU_ONLY, &mram_access_by_dpu_only, false));
 